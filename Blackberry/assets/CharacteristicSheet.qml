@@ -18,6 +18,11 @@ import bb.cascades 1.2
 Sheet {
     id: root
 
+    onClosed: {
+        // stops a reconnect still pending for the service this sheet showed
+        cmgr.endSession();
+    }
+
     Page {
         id: charPage
         property string statusMessage: ""
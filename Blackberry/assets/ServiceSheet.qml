@@ -414,6 +414,25 @@ Sheet {
                 onTriggered: {
                     root.close();
                 }
+            },
+            ActionItem {
+                id: action_crawl
+                title: "Crawl Device"
+                imageSource: "asset:///images/bt_scan.png"
+                ActionBar.placement: ActionBarPlacement.OnBar
+                enabled: !crawler.crawling
+                onTriggered: {
+                    crawler.crawlDevice();
+                }
+            },
+            ActionItem {
+                id: action_export
+                title: "Export Snapshot"
+                ActionBar.placement: ActionBarPlacement.InOverflow
+                enabled: !crawler.crawling
+                onTriggered: {
+                    crawler.exportSnapshot();
+                }
             }
         ]
 	}
@@ -3,40 +3,82 @@ BASEDIR =  $$quote($$_PRO_FILE_PWD_)
 
 device {
     CONFIG(debug, debug|release) {
-        SOURCES +=  $$quote($$BASEDIR/src/CharacteristicsManager.cpp) \
+        SOURCES +=  $$quote($$BASEDIR/src/BtApi.cpp) \
+                 $$quote($$BASEDIR/src/BtFault.cpp) \
+                 $$quote($$BASEDIR/src/BtTrace.cpp) \
+                 $$quote($$BASEDIR/src/CharacteristicsManager.cpp) \
                  $$quote($$BASEDIR/src/DataContainer.cpp) \
+                 $$quote($$BASEDIR/src/DeviceCrawler.cpp) \
                  $$quote($$BASEDIR/src/DevicesManager.cpp) \
+                 $$quote($$BASEDIR/src/GattScheduler.cpp) \
+                 $$quote($$BASEDIR/src/GattSnapshotCodec.cpp) \
+                 $$quote($$BASEDIR/src/PairingManager.cpp) \
                  $$quote($$BASEDIR/src/RemoteDeviceInfo.cpp) \
+                 $$quote($$BASEDIR/src/ScanDeduplicator.cpp) \
                  $$quote($$BASEDIR/src/ServicesManager.cpp) \
+                 $$quote($$BASEDIR/src/SignalCoalescer.cpp) \
+                 $$quote($$BASEDIR/src/StartupProfiler.cpp) \
                  $$quote($$BASEDIR/src/Timer.cpp) \
                  $$quote($$BASEDIR/src/applicationui.cpp) \
                  $$quote($$BASEDIR/src/main.cpp)
 
-        HEADERS +=  $$quote($$BASEDIR/src/CharacteristicsManager.hpp) \
+        HEADERS +=  $$quote($$BASEDIR/src/BtApi.hpp) \
+                 $$quote($$BASEDIR/src/BtFault.hpp) \
+                 $$quote($$BASEDIR/src/BtTrace.hpp) \
+                 $$quote($$BASEDIR/src/CharacteristicsManager.hpp) \
                  $$quote($$BASEDIR/src/DataContainer.hpp) \
+                 $$quote($$BASEDIR/src/DeviceCrawler.hpp) \
                  $$quote($$BASEDIR/src/DevicesManager.hpp) \
+                 $$quote($$BASEDIR/src/GattScheduler.hpp) \
+                 $$quote($$BASEDIR/src/GattSnapshot.hpp) \
+                 $$quote($$BASEDIR/src/GattSnapshotCodec.hpp) \
+                 $$quote($$BASEDIR/src/PairingManager.hpp) \
                  $$quote($$BASEDIR/src/RemoteDeviceInfo.hpp) \
+                 $$quote($$BASEDIR/src/ScanDeduplicator.hpp) \
                  $$quote($$BASEDIR/src/ServicesManager.hpp) \
+                 $$quote($$BASEDIR/src/SignalCoalescer.hpp) \
+                 $$quote($$BASEDIR/src/StartupProfiler.hpp) \
                  $$quote($$BASEDIR/src/Timer.hpp) \
                  $$quote($$BASEDIR/src/Types.hpp) \
                  $$quote($$BASEDIR/src/applicationui.hpp)
     }
 
     CONFIG(release, debug|release) {
-        SOURCES +=  $$quote($$BASEDIR/src/CharacteristicsManager.cpp) \
+        SOURCES +=  $$quote($$BASEDIR/src/BtApi.cpp) \
+                 $$quote($$BASEDIR/src/BtFault.cpp) \
+                 $$quote($$BASEDIR/src/BtTrace.cpp) \
+                 $$quote($$BASEDIR/src/CharacteristicsManager.cpp) \
                  $$quote($$BASEDIR/src/DataContainer.cpp) \
+                 $$quote($$BASEDIR/src/DeviceCrawler.cpp) \
                  $$quote($$BASEDIR/src/DevicesManager.cpp) \
+                 $$quote($$BASEDIR/src/GattScheduler.cpp) \
+                 $$quote($$BASEDIR/src/GattSnapshotCodec.cpp) \
+                 $$quote($$BASEDIR/src/PairingManager.cpp) \
                  $$quote($$BASEDIR/src/RemoteDeviceInfo.cpp) \
+                 $$quote($$BASEDIR/src/ScanDeduplicator.cpp) \
                  $$quote($$BASEDIR/src/ServicesManager.cpp) \
+                 $$quote($$BASEDIR/src/SignalCoalescer.cpp) \
+                 $$quote($$BASEDIR/src/StartupProfiler.cpp) \
                  $$quote($$BASEDIR/src/Timer.cpp) \
                  $$quote($$BASEDIR/src/applicationui.cpp) \
                  $$quote($$BASEDIR/src/main.cpp)
 
-        HEADERS +=  $$quote($$BASEDIR/src/CharacteristicsManager.hpp) \
+        HEADERS +=  $$quote($$BASEDIR/src/BtApi.hpp) \
+                 $$quote($$BASEDIR/src/BtFault.hpp) \
+                 $$quote($$BASEDIR/src/BtTrace.hpp) \
+                 $$quote($$BASEDIR/src/CharacteristicsManager.hpp) \
                  $$quote($$BASEDIR/src/DataContainer.hpp) \
+                 $$quote($$BASEDIR/src/DeviceCrawler.hpp) \
                  $$quote($$BASEDIR/src/DevicesManager.hpp) \
+                 $$quote($$BASEDIR/src/GattScheduler.hpp) \
+                 $$quote($$BASEDIR/src/GattSnapshot.hpp) \
+                 $$quote($$BASEDIR/src/GattSnapshotCodec.hpp) \
+                 $$quote($$BASEDIR/src/PairingManager.hpp) \
                  $$quote($$BASEDIR/src/RemoteDeviceInfo.hpp) \
+                 $$quote($$BASEDIR/src/ScanDeduplicator.hpp) \
                  $$quote($$BASEDIR/src/ServicesManager.hpp) \
+                 $$quote($$BASEDIR/src/SignalCoalescer.hpp) \
+                 $$quote($$BASEDIR/src/StartupProfiler.hpp) \
                  $$quote($$BASEDIR/src/Timer.hpp) \
                  $$quote($$BASEDIR/src/Types.hpp) \
                  $$quote($$BASEDIR/src/applicationui.hpp)
@@ -45,20 +87,41 @@ device {
 
 simulator {
     CONFIG(debug, debug|release) {
-        SOURCES +=  $$quote($$BASEDIR/src/CharacteristicsManager.cpp) \
+        SOURCES +=  $$quote($$BASEDIR/src/BtApi.cpp) \
+                 $$quote($$BASEDIR/src/BtFault.cpp) \
+                 $$quote($$BASEDIR/src/BtTrace.cpp) \
+                 $$quote($$BASEDIR/src/CharacteristicsManager.cpp) \
                  $$quote($$BASEDIR/src/DataContainer.cpp) \
+                 $$quote($$BASEDIR/src/DeviceCrawler.cpp) \
                  $$quote($$BASEDIR/src/DevicesManager.cpp) \
+                 $$quote($$BASEDIR/src/GattScheduler.cpp) \
+                 $$quote($$BASEDIR/src/GattSnapshotCodec.cpp) \
+                 $$quote($$BASEDIR/src/PairingManager.cpp) \
                  $$quote($$BASEDIR/src/RemoteDeviceInfo.cpp) \
+                 $$quote($$BASEDIR/src/ScanDeduplicator.cpp) \
                  $$quote($$BASEDIR/src/ServicesManager.cpp) \
+                 $$quote($$BASEDIR/src/SignalCoalescer.cpp) \
+                 $$quote($$BASEDIR/src/StartupProfiler.cpp) \
                  $$quote($$BASEDIR/src/Timer.cpp) \
                  $$quote($$BASEDIR/src/applicationui.cpp) \
                  $$quote($$BASEDIR/src/main.cpp)
 
-        HEADERS +=  $$quote($$BASEDIR/src/CharacteristicsManager.hpp) \
+        HEADERS +=  $$quote($$BASEDIR/src/BtApi.hpp) \
+                 $$quote($$BASEDIR/src/BtFault.hpp) \
+                 $$quote($$BASEDIR/src/BtTrace.hpp) \
+                 $$quote($$BASEDIR/src/CharacteristicsManager.hpp) \
                  $$quote($$BASEDIR/src/DataContainer.hpp) \
+                 $$quote($$BASEDIR/src/DeviceCrawler.hpp) \
                  $$quote($$BASEDIR/src/DevicesManager.hpp) \
+                 $$quote($$BASEDIR/src/GattScheduler.hpp) \
+                 $$quote($$BASEDIR/src/GattSnapshot.hpp) \
+                 $$quote($$BASEDIR/src/GattSnapshotCodec.hpp) \
+                 $$quote($$BASEDIR/src/PairingManager.hpp) \
                  $$quote($$BASEDIR/src/RemoteDeviceInfo.hpp) \
+                 $$quote($$BASEDIR/src/ScanDeduplicator.hpp) \
                  $$quote($$BASEDIR/src/ServicesManager.hpp) \
+                 $$quote($$BASEDIR/src/SignalCoalescer.hpp) \
+                 $$quote($$BASEDIR/src/StartupProfiler.hpp) \
                  $$quote($$BASEDIR/src/Timer.hpp) \
                  $$quote($$BASEDIR/src/Types.hpp) \
                  $$quote($$BASEDIR/src/applicationui.hpp)
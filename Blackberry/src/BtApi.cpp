@@ -0,0 +1,806 @@
+/*
+ * Copyright (c) 2011-2013 BlackBerry Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "BtApi.hpp"
+#include "BtFault.hpp"
+#include "BtTrace.hpp"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <QtCore/QtEndian>
+
+namespace
+{
+
+/*
+ * One traced call. Construct it before calling the stack so that the
+ * duration covers the call, then either replay() it or record() the result.
+ */
+class TracedCall
+{
+public:
+    TracedCall(BtTrace::Function function, const QByteArray &key)
+        : _trace(BtTrace::getInstance())
+        , _function(function)
+        , _key(key)
+        , _startUs(_trace->nowUs())
+    {
+    }
+
+    bool replaying() const
+    {
+        return BtTrace::mode() == BtTrace::Replay;
+    }
+
+    // false with errno = ENODATA if the log has no such call
+    bool replay(qint64 &ret, QByteArray *out = 0)
+    {
+        return _trace->replayCall(_function, _key, ret, out);
+    }
+
+    void record(qint64 ret, const QByteArray &out = QByteArray())
+    {
+        const int err = errno;
+        _trace->recordCall(_function, _key, _startUs, ret, err, out);
+        errno = err;
+    }
+
+private:
+    BtTrace *_trace;
+    BtTrace::Function _function;
+    QByteArray _key;
+    qint64 _startUs;
+};
+
+inline QByteArray handleKey(const void *handle)
+{
+    return BtTrace::key(qint64(reinterpret_cast<quintptr>(handle)));
+}
+
+inline int replayInt(TracedCall &call, QByteArray *out = 0)
+{
+    qint64 ret = -1;
+    return call.replay(ret, out) ? int(ret) : -1;
+}
+
+// copies a recorded string output back into the caller's buffer
+void copyString(const QByteArray &value, char *buffer, int length)
+{
+    if (buffer && length > 0) {
+        qstrncpy(buffer, value.constData(), uint(length));
+    }
+}
+
+void putU16(QByteArray &out, quint16 value)
+{
+    uchar bytes[2];
+    qToLittleEndian<quint16>(value, bytes);
+    out.append(reinterpret_cast<const char*>(bytes), sizeof(bytes));
+}
+
+quint16 getU16(const QByteArray &in, int offset)
+{
+    if (offset + 2 > in.size()) {
+        return 0;
+    }
+    return qFromLittleEndian<quint16>(reinterpret_cast<const uchar*>(in.constData() + offset));
+}
+
+int tracedBool(BtTrace::Function function, bt_remote_device_t *device, bool *value,
+        int (*stackCall)(bt_remote_device_t*, bool*))
+{
+    TracedCall call(function, handleKey(device));
+    if (call.replaying()) {
+        QByteArray out;
+        int rc = replayInt(call, &out);
+        if (value && !out.isEmpty()) {
+            *value = (out.at(0) != 0);
+        }
+        return rc;
+    }
+    int rc = stackCall(device, value);
+    call.record(rc, QByteArray(1, (value && *value) ? 1 : 0));
+    return rc;
+}
+
+}
+
+namespace BtApi
+{
+
+int device_init(void (*callback)(const int event, const char *address, const char *data))
+{
+    // always registered, a fault profile may be set after initialisation
+    callback = BtFault::getInstance()->faultDeviceCallback(callback);
+
+    if (!BtTrace::isActive()) {
+        return bt_device_init(callback);
+    }
+
+    BtTrace::DeviceCallback registered = BtTrace::getInstance()->traceDeviceCallback(callback);
+    TracedCall call(BtTrace::DeviceInit, QByteArray());
+    if (call.replaying()) {
+        return replayInt(call);
+    }
+    int rc = bt_device_init(registered);
+    call.record(rc);
+    return rc;
+}
+
+bool ldev_get_power()
+{
+    if (!BtTrace::isActive()) {
+        return bt_ldev_get_power();
+    }
+
+    TracedCall call(BtTrace::LdevGetPower, QByteArray());
+    if (call.replaying()) {
+        qint64 ret = 0;
+        return call.replay(ret) && ret != 0;
+    }
+    bool on = bt_ldev_get_power();
+    call.record(on);
+    return on;
+}
+
+int ldev_set_power(bool on)
+{
+    if (!BtTrace::isActive()) {
+        return bt_ldev_set_power(on);
+    }
+
+    TracedCall call(BtTrace::LdevSetPower, BtTrace::key(on ? 1 : 0));
+    if (call.replaying()) {
+        return replayInt(call);
+    }
+    int rc = bt_ldev_set_power(on);
+    call.record(rc);
+    return rc;
+}
+
+static int traced_disc_start_inquiry(int accessCode)
+{
+    if (!BtTrace::isActive()) {
+        return bt_disc_start_inquiry(accessCode);
+    }
+
+    TracedCall call(BtTrace::DiscStartInquiry, BtTrace::key(accessCode));
+    if (call.replaying()) {
+        return replayInt(call);
+    }
+    int rc = bt_disc_start_inquiry(accessCode);
+    call.record(rc);
+    return rc;
+}
+
+bt_remote_device_t** disc_retrieve_devices(int discoveryType, int *count)
+{
+    if (!BtTrace::isActive()) {
+        return bt_disc_retrieve_devices(discoveryType, count);
+    }
+
+    // out: the handles in the returned array, as i64 each
+    TracedCall call(BtTrace::DiscRetrieveDevices, BtTrace::key(discoveryType));
+    if (call.replaying()) {
+        qint64 ret = 0;
+        QByteArray out;
+        if (!call.replay(ret, &out) || ret == 0) {
+            return 0;
+        }
+        const int n = out.size() / 8;
+        bt_remote_device_t **devices = static_cast<bt_remote_device_t**>(calloc(n + 1, sizeof(bt_remote_device_t*)));
+        if (!devices) {
+            return 0;
+        }
+        for (int i = 0; i < n; i++) {
+            devices[i] = reinterpret_cast<bt_remote_device_t*>(quintptr(qFromLittleEndian<qint64>(reinterpret_cast<const uchar*>(out.constData() + i * 8))));
+        }
+        if (count) {
+            *count = n;
+        }
+        return devices;
+    }
+
+    bt_remote_device_t **devices = bt_disc_retrieve_devices(discoveryType, count);
+    QByteArray out;
+    for (int i = 0; devices && devices[i]; i++) {
+        out.append(handleKey(devices[i]));
+    }
+    call.record(qint64(reinterpret_cast<quintptr>(devices)), out);
+    return devices;
+}
+
+bt_remote_device_t* rdev_get_device(const char *address)
+{
+    if (!BtTrace::isActive()) {
+        return bt_rdev_get_device(address);
+    }
+
+    // the recorded handle comes back in replay, later calls are keyed by it
+    TracedCall call(BtTrace::RdevGetDevice, BtTrace::key(address));
+    if (call.replaying()) {
+        qint64 ret = 0;
+        return call.replay(ret) ? reinterpret_cast<bt_remote_device_t*>(quintptr(ret)) : 0;
+    }
+    bt_remote_device_t *device = bt_rdev_get_device(address);
+    call.record(qint64(reinterpret_cast<quintptr>(device)));
+    return device;
+}
+
+void rdev_free(bt_remote_device_t *device)
+{
+    if (BtTrace::mode() != BtTrace::Replay) {
+        bt_rdev_free(device);
+    }
+}
+
+int rdev_get_address(bt_remote_device_t *device, char *address)
+{
+    if (!BtTrace::isActive()) {
+        return bt_rdev_get_address(device, address);
+    }
+
+    TracedCall call(BtTrace::RdevGetAddress, handleKey(device));
+    if (call.replaying()) {
+        QByteArray out;
+        int rc = replayInt(call, &out);
+        // the btapi address buffer is 18 bytes, "xx:xx:xx:xx:xx:xx"
+        copyString(out, address, 18);
+        return rc;
+    }
+    int rc = bt_rdev_get_address(device, address);
+    call.record(rc, QByteArray(address));
+    return rc;
+}
+
+int rdev_get_type(bt_remote_device_t *device)
+{
+    if (!BtTrace::isActive()) {
+        return bt_rdev_get_type(device);
+    }
+
+    TracedCall call(BtTrace::RdevGetType, handleKey(device));
+    if (call.replaying()) {
+        return replayInt(call);
+    }
+    int rc = bt_rdev_get_type(device);
+    call.record(rc);
+    return rc;
+}
+
+int rdev_get_friendly_name(bt_remote_device_t *device, char *name, int length)
+{
+    if (!BtTrace::isActive()) {
+        return bt_rdev_get_friendly_name(device, name, length);
+    }
+
+    TracedCall call(BtTrace::RdevGetFriendlyName, handleKey(device));
+    if (call.replaying()) {
+        QByteArray out;
+        int rc = replayInt(call, &out);
+        copyString(out, name, length);
+        return rc;
+    }
+    int rc = bt_rdev_get_friendly_name(device, name, length);
+    call.record(rc, rc == 0 ? QByteArray(name) : QByteArray());
+    return rc;
+}
+
+int rdev_get_remote_name(bt_remote_device_t *device, char *name, int length)
+{
+    if (!BtTrace::isActive()) {
+        return bt_rdev_get_remote_name(device, name, length);
+    }
+
+    TracedCall call(BtTrace::RdevGetRemoteName, handleKey(device));
+    if (call.replaying()) {
+        QByteArray out;
+        int rc = replayInt(call, &out);
+        copyString(out, name, length);
+        return rc;
+    }
+    int rc = bt_rdev_get_remote_name(device, name, length);
+    call.record(rc, rc == 0 ? QByteArray(name) : QByteArray());
+    return rc;
+}
+
+int rdev_get_device_class(bt_remote_device_t *device, int type)
+{
+    if (!BtTrace::isActive()) {
+        return bt_rdev_get_device_class(device, type);
+    }
+
+    TracedCall call(BtTrace::RdevGetDeviceClass, BtTrace::key(qint64(reinterpret_cast<quintptr>(device)), type));
+    if (call.replaying()) {
+        return replayInt(call);
+    }
+    int rc = bt_rdev_get_device_class(device, type);
+    call.record(rc);
+    return rc;
+}
+
+int rdev_is_known(bt_remote_device_t *device, bool *known)
+{
+    if (!BtTrace::isActive()) {
+        return bt_rdev_is_known(device, known);
+    }
+    return tracedBool(BtTrace::RdevIsKnown, device, known, bt_rdev_is_known);
+}
+
+int rdev_is_paired(bt_remote_device_t *device, bool *paired)
+{
+    if (!BtTrace::isActive()) {
+        return bt_rdev_is_paired(device, paired);
+    }
+    return tracedBool(BtTrace::RdevIsPaired, device, paired, bt_rdev_is_paired);
+}
+
+int rdev_is_encrypted(bt_remote_device_t *device)
+{
+    if (!BtTrace::isActive()) {
+        return bt_rdev_is_encrypted(device);
+    }
+
+    TracedCall call(BtTrace::RdevIsEncrypted, handleKey(device));
+    if (call.replaying()) {
+        return replayInt(call);
+    }
+    int rc = bt_rdev_is_encrypted(device);
+    call.record(rc);
+    return rc;
+}
+
+int rdev_is_trusted(bt_remote_device_t *device)
+{
+    if (!BtTrace::isActive()) {
+        return bt_rdev_is_trusted(device);
+    }
+
+    TracedCall call(BtTrace::RdevIsTrusted, handleKey(device));
+    if (call.replaying()) {
+        return replayInt(call);
+    }
+    int rc = bt_rdev_is_trusted(device);
+    call.record(rc);
+    return rc;
+}
+
+int rdev_get_rssi(bt_remote_device_t *device, int *rssi)
+{
+    if (!BtTrace::isActive()) {
+        return bt_rdev_get_rssi(device, rssi);
+    }
+
+    TracedCall call(BtTrace::RdevGetRssi, handleKey(device));
+    if (call.replaying()) {
+        QByteArray out;
+        int rc = replayInt(call, &out);
+        if (rssi && out.size() >= 4) {
+            *rssi = qFromLittleEndian<qint32>(reinterpret_cast<const uchar*>(out.constData()));
+        }
+        return rc;
+    }
+    int rc = bt_rdev_get_rssi(device, rssi);
+    uchar bytes[4];
+    qToLittleEndian<qint32>(rssi ? *rssi : 0, bytes);
+    call.record(rc, QByteArray(reinterpret_cast<const char*>(bytes), sizeof(bytes)));
+    return rc;
+}
+
+int rdev_get_le_conn_params(bt_remote_device_t *device, uint16_t *minConnInt, uint16_t *maxConnInt, uint16_t *latency, uint16_t *superTimeout)
+{
+    if (!BtTrace::isActive()) {
+        return bt_rdev_get_le_conn_params(device, minConnInt, maxConnInt, latency, superTimeout);
+    }
+
+    TracedCall call(BtTrace::RdevGetLeConnParams, handleKey(device));
+    if (call.replaying()) {
+        QByteArray out;
+        int rc = replayInt(call, &out);
+        *minConnInt = getU16(out, 0);
+        *maxConnInt = getU16(out, 2);
+        *latency = getU16(out, 4);
+        *superTimeout = getU16(out, 6);
+        return rc;
+    }
+    int rc = bt_rdev_get_le_conn_params(device, minConnInt, maxConnInt, latency, superTimeout);
+    QByteArray out;
+    putU16(out, *minConnInt);
+    putU16(out, *maxConnInt);
+    putU16(out, *latency);
+    putU16(out, *superTimeout);
+    call.record(rc, out);
+    return rc;
+}
+
+int rdev_get_le_info(bt_remote_device_t *device, uint16_t *appearance, uint8_t *flags, uint8_t *connectable)
+{
+    if (!BtTrace::isActive()) {
+        return bt_rdev_get_le_info(device, appearance, flags, connectable);
+    }
+
+    TracedCall call(BtTrace::RdevGetLeInfo, handleKey(device));
+    if (call.replaying()) {
+        QByteArray out;
+        int rc = replayInt(call, &out);
+        *appearance = getU16(out, 0);
+        *flags = (out.size() > 2) ? uint8_t(out.at(2)) : 0;
+        *connectable = (out.size() > 3) ? uint8_t(out.at(3)) : 0;
+        return rc;
+    }
+    int rc = bt_rdev_get_le_info(device, appearance, flags, connectable);
+    QByteArray out;
+    putU16(out, *appearance);
+    out.append(char(*flags));
+    out.append(char(*connectable));
+    call.record(rc, out);
+    return rc;
+}
+
+static char** traced_rdev_get_services_gatt(bt_remote_device_t *device)
+{
+    if (!BtTrace::isActive()) {
+        return bt_rdev_get_services_gatt(device);
+    }
+
+    // out: the service UUIDs, each NUL terminated
+    TracedCall call(BtTrace::RdevGetServicesGatt, handleKey(device));
+    if (call.replaying()) {
+        qint64 ret = 0;
+        QByteArray out;
+        if (!call.replay(ret, &out) || ret == 0) {
+            return 0;
+        }
+        QList<QByteArray> uuids = out.split('\0');
+        uuids.removeLast();
+        char **services = static_cast<char**>(calloc(uuids.size() + 1, sizeof(char*)));
+        for (int i = 0; services && i < uuids.size(); i++) {
+            services[i] = strdup(uuids.at(i).constData());
+        }
+        return services;
+    }
+
+    char **services = bt_rdev_get_services_gatt(device);
+    QByteArray out;
+    for (int i = 0; services && services[i]; i++) {
+        out.append(services[i]);
+        out.append('\0');
+    }
+    call.record(qint64(reinterpret_cast<quintptr>(services)), out);
+    return services;
+}
+
+void rdev_free_services(char **services)
+{
+    if (BtTrace::mode() != BtTrace::Replay) {
+        bt_rdev_free_services(services);
+        return;
+    }
+
+    // allocated by rdev_get_services_gatt() above
+    for (int i = 0; services && services[i]; i++) {
+        free(services[i]);
+    }
+    free(services);
+}
+
+static int traced_rdev_pair(bt_remote_device_t *device)
+{
+    if (!BtTrace::isActive()) {
+        return bt_rdev_pair(device);
+    }
+
+    TracedCall call(BtTrace::RdevPair, handleKey(device));
+    if (call.replaying()) {
+        return replayInt(call);
+    }
+    int rc = bt_rdev_pair(device);
+    call.record(rc);
+    return rc;
+}
+
+int gatt_init(bt_gatt_callbacks_t *callbacks)
+{
+    callbacks = BtFault::getInstance()->faultGattCallbacks(callbacks);
+
+    if (!BtTrace::isActive()) {
+        return bt_gatt_init(callbacks);
+    }
+
+    bt_gatt_callbacks_t *registered = BtTrace::getInstance()->traceGattCallbacks(callbacks);
+    TracedCall call(BtTrace::GattInit, QByteArray());
+    if (call.replaying()) {
+        return replayInt(call);
+    }
+    int rc = bt_gatt_init(registered);
+    call.record(rc);
+    return rc;
+}
+
+void gatt_deinit()
+{
+    if (BtTrace::mode() != BtTrace::Replay) {
+        bt_gatt_deinit();
+    }
+}
+
+static int traced_gatt_connect_service(const char *address, const char *service, void *reserved, bt_gatt_conn_parm_t *parameters, void *userData)
+{
+    if (!BtTrace::isActive()) {
+        return bt_gatt_connect_service(address, service, reserved, parameters, userData);
+    }
+
+    // out: the userData pointer, so that replayed callbacks can be mapped
+    // back onto whoever connects now
+    TracedCall call(BtTrace::GattConnectService, BtTrace::key(address, service));
+    if (call.replaying()) {
+        QByteArray out;
+        int rc = replayInt(call, &out);
+        if (out.size() >= 8) {
+            BtTrace::getInstance()->mapUserData(qFromLittleEndian<quint64>(reinterpret_cast<const uchar*>(out.constData())), userData);
+        }
+        return rc;
+    }
+    int rc = bt_gatt_connect_service(address, service, reserved, parameters, userData);
+    call.record(rc, handleKey(userData));
+    return rc;
+}
+
+static int traced_gatt_disconnect_instance(int instance)
+{
+    if (!BtTrace::isActive()) {
+        return bt_gatt_disconnect_instance(instance);
+    }
+
+    TracedCall call(BtTrace::GattDisconnectInstance, BtTrace::key(instance));
+    if (call.replaying()) {
+        return replayInt(call);
+    }
+    int rc = bt_gatt_disconnect_instance(instance);
+    call.record(rc);
+    return rc;
+}
+
+static int traced_gatt_characteristics_count(int instance)
+{
+    if (!BtTrace::isActive()) {
+        return bt_gatt_characteristics_count(instance);
+    }
+
+    TracedCall call(BtTrace::GattCharacteristicsCount, BtTrace::key(instance));
+    if (call.replaying()) {
+        return replayInt(call);
+    }
+    int rc = bt_gatt_characteristics_count(instance);
+    call.record(rc);
+    return rc;
+}
+
+static int traced_gatt_characteristics(int instance, bt_gatt_characteristic_t *characteristics, int size)
+{
+    if (!BtTrace::isActive()) {
+        return bt_gatt_characteristics(instance, characteristics, size);
+    }
+
+    // out: the filled-in structs as they are, the log is only ever replayed
+    // by a build of the same app on the same platform
+    TracedCall call(BtTrace::GattCharacteristics, BtTrace::key(instance));
+    if (call.replaying()) {
+        QByteArray out;
+        int rc = replayInt(call, &out);
+        const int bytes = qMin(out.size(), int(size * sizeof(bt_gatt_characteristic_t)));
+        memcpy(characteristics, out.constData(), bytes);
+        return rc;
+    }
+    int rc = bt_gatt_characteristics(instance, characteristics, size);
+    QByteArray out;
+    if (rc > 0) {
+        out = QByteArray(reinterpret_cast<const char*>(characteristics), qMin(rc, size) * sizeof(bt_gatt_characteristic_t));
+    }
+    call.record(rc, out);
+    return rc;
+}
+
+static int traced_gatt_read_value(int instance, uint16_t handle, uint16_t offset, uint8_t *buffer, size_t length, int reserved)
+{
+    if (!BtTrace::isActive()) {
+        return bt_gatt_read_value(instance, handle, offset, buffer, length, reserved);
+    }
+
+    TracedCall call(BtTrace::GattReadValue, BtTrace::key(instance, (qint64(handle) << 16) | offset));
+    if (call.replaying()) {
+        QByteArray out;
+        int rc = replayInt(call, &out);
+        memcpy(buffer, out.constData(), qMin(size_t(out.size()), length));
+        return rc;
+    }
+    int rc = bt_gatt_read_value(instance, handle, offset, buffer, length, reserved);
+    call.record(rc, rc > 0 ? QByteArray(reinterpret_cast<const char*>(buffer), qMin(size_t(rc), length)) : QByteArray());
+    return rc;
+}
+
+static int traced_gatt_write_value(int instance, uint16_t handle, uint16_t offset, const uint8_t *data, size_t length)
+{
+    if (!BtTrace::isActive()) {
+        return bt_gatt_write_value(instance, handle, offset, data, length);
+    }
+
+    // the value written goes into the key, a replay only matches the same write
+    QByteArray key = BtTrace::key(instance, (qint64(handle) << 16) | offset);
+    key.append(reinterpret_cast<const char*>(data), int(length));
+    TracedCall call(BtTrace::GattWriteValue, key);
+    if (call.replaying()) {
+        return replayInt(call);
+    }
+    int rc = bt_gatt_write_value(instance, handle, offset, data, length);
+    call.record(rc);
+    return rc;
+}
+
+// the calls that go out over the air, where BtFault may step in
+
+static bool admit(BtTrace::Function function, int instance = -1)
+{
+    BtFault *fault = BtFault::getInstance();
+    if (fault->admit(function, instance)) {
+        return true;
+    }
+
+    // dropped instances go away on the stack too, as with a real link loss
+    const int err = errno;
+    foreach (int dropped, fault->takeDropped()) {
+        traced_gatt_disconnect_instance(dropped);
+    }
+    errno = err;
+    return false;
+}
+
+static void completed(BtTrace::Function function, bool ok, int bytes = 0)
+{
+    BtFault::getInstance()->completed(function, ok, bytes);
+}
+
+int disc_start_inquiry(int accessCode)
+{
+    if (!BtFault::isActive()) {
+        return traced_disc_start_inquiry(accessCode);
+    }
+
+    if (!admit(BtTrace::DiscStartInquiry)) {
+        return -1;
+    }
+    int rc = traced_disc_start_inquiry(accessCode);
+    completed(BtTrace::DiscStartInquiry, rc == 0);
+    return rc;
+}
+
+char** rdev_get_services_gatt(bt_remote_device_t *device)
+{
+    if (!BtFault::isActive()) {
+        return traced_rdev_get_services_gatt(device);
+    }
+
+    if (!admit(BtTrace::RdevGetServicesGatt)) {
+        return 0;
+    }
+    char **services = traced_rdev_get_services_gatt(device);
+    completed(BtTrace::RdevGetServicesGatt, services != 0);
+    return services;
+}
+
+int rdev_pair(bt_remote_device_t *device)
+{
+    if (!BtFault::isActive()) {
+        return traced_rdev_pair(device);
+    }
+
+    if (!admit(BtTrace::RdevPair)) {
+        return -1;
+    }
+    int rc = traced_rdev_pair(device);
+    completed(BtTrace::RdevPair, rc == 0);
+    return rc;
+}
+
+int gatt_connect_service(const char *address, const char *service, void *reserved, bt_gatt_conn_parm_t *parameters, void *userData)
+{
+    if (!BtFault::isActive()) {
+        return traced_gatt_connect_service(address, service, reserved, parameters, userData);
+    }
+
+    if (!admit(BtTrace::GattConnectService)) {
+        return -1;
+    }
+    int rc = traced_gatt_connect_service(address, service, reserved, parameters, userData);
+    completed(BtTrace::GattConnectService, rc == 0);
+    return rc;
+}
+
+int gatt_disconnect_instance(int instance)
+{
+    // a dropped instance has been released on the stack already
+    if (BtFault::getInstance()->isDropped(instance)) {
+        return 0;
+    }
+
+    if (!BtFault::isActive()) {
+        return traced_gatt_disconnect_instance(instance);
+    }
+
+    admit(BtTrace::GattDisconnectInstance, instance);
+    return traced_gatt_disconnect_instance(instance);
+}
+
+int gatt_characteristics_count(int instance)
+{
+    if (!BtFault::isActive()) {
+        return traced_gatt_characteristics_count(instance);
+    }
+
+    if (!admit(BtTrace::GattCharacteristicsCount, instance)) {
+        return -1;
+    }
+    int rc = traced_gatt_characteristics_count(instance);
+    completed(BtTrace::GattCharacteristicsCount, rc >= 0);
+    return rc;
+}
+
+int gatt_characteristics(int instance, bt_gatt_characteristic_t *characteristics, int size)
+{
+    if (!BtFault::isActive()) {
+        return traced_gatt_characteristics(instance, characteristics, size);
+    }
+
+    if (!admit(BtTrace::GattCharacteristics, instance)) {
+        return -1;
+    }
+    int rc = traced_gatt_characteristics(instance, characteristics, size);
+    completed(BtTrace::GattCharacteristics, rc >= 0);
+    return rc;
+}
+
+int gatt_read_value(int instance, uint16_t handle, uint16_t offset, uint8_t *buffer, size_t length, int reserved)
+{
+    if (!BtFault::isActive()) {
+        return traced_gatt_read_value(instance, handle, offset, buffer, length, reserved);
+    }
+
+    if (!admit(BtTrace::GattReadValue, instance)) {
+        return -1;
+    }
+    int rc = traced_gatt_read_value(instance, handle, offset, buffer, length, reserved);
+    completed(BtTrace::GattReadValue, rc >= 0, rc);
+    return rc;
+}
+
+
+int gatt_write_value(int instance, uint16_t handle, uint16_t offset, const uint8_t *data, size_t length)
+{
+    if (!BtFault::isActive()) {
+        return traced_gatt_write_value(instance, handle, offset, data, length);
+    }
+
+    if (!admit(BtTrace::GattWriteValue, instance)) {
+        return -1;
+    }
+    int rc = traced_gatt_write_value(instance, handle, offset, data, length);
+    completed(BtTrace::GattWriteValue, rc >= 0);
+    return rc;
+}
+
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2011-2013 BlackBerry Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef BTAPI_H
+#define BTAPI_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <btapi/btdevice.h>
+#include <btapi/btgatt.h>
+
+/*
+ * The btapi calls the app makes, under the same names without the bt_
+ * prefix. With BtTrace off each one is a plain pass-through; otherwise the
+ * call is recorded or answered from a replay log (see BtTrace.hpp), and
+ * with a BtFault profile set the calls that go over the air may be delayed
+ * or failed first. Everything in the app talks to the stack through here.
+ */
+namespace BtApi
+{
+    int device_init(void (*callback)(const int event, const char *address, const char *data));
+    bool ldev_get_power();
+    int ldev_set_power(bool on);
+    int disc_start_inquiry(int accessCode);
+    bt_remote_device_t** disc_retrieve_devices(int discoveryType, int *count);
+
+    bt_remote_device_t* rdev_get_device(const char *address);
+    void rdev_free(bt_remote_device_t *device);
+    int rdev_get_address(bt_remote_device_t *device, char *address);
+    int rdev_get_type(bt_remote_device_t *device);
+    int rdev_get_friendly_name(bt_remote_device_t *device, char *name, int length);
+    int rdev_get_remote_name(bt_remote_device_t *device, char *name, int length);
+    int rdev_get_device_class(bt_remote_device_t *device, int type);
+    int rdev_is_known(bt_remote_device_t *device, bool *known);
+    int rdev_is_paired(bt_remote_device_t *device, bool *paired);
+    int rdev_is_encrypted(bt_remote_device_t *device);
+    int rdev_is_trusted(bt_remote_device_t *device);
+    int rdev_get_rssi(bt_remote_device_t *device, int *rssi);
+    int rdev_get_le_conn_params(bt_remote_device_t *device, uint16_t *minConnInt, uint16_t *maxConnInt, uint16_t *latency, uint16_t *superTimeout);
+    int rdev_get_le_info(bt_remote_device_t *device, uint16_t *appearance, uint8_t *flags, uint8_t *connectable);
+    char** rdev_get_services_gatt(bt_remote_device_t *device);
+    void rdev_free_services(char **services);
+    int rdev_pair(bt_remote_device_t *device);
+
+    int gatt_init(bt_gatt_callbacks_t *callbacks);
+    void gatt_deinit();
+    int gatt_connect_service(const char *address, const char *service, void *reserved, bt_gatt_conn_parm_t *parameters, void *userData);
+    int gatt_disconnect_instance(int instance);
+    int gatt_characteristics_count(int instance);
+    int gatt_characteristics(int instance, bt_gatt_characteristic_t *characteristics, int size);
+    int gatt_read_value(int instance, uint16_t handle, uint16_t offset, uint8_t *buffer, size_t length, int reserved);
+    int gatt_write_value(int instance, uint16_t handle, uint16_t offset, const uint8_t *data, size_t length);
+}
+
+#endif // ifndef BTAPI_H
@@ -0,0 +1,758 @@
+/*
+ * Copyright (c) 2011-2013 BlackBerry Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "BtFault.hpp"
+
+#include <errno.h>
+#include <math.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <QtCore/QMetaObject>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QStringList>
+
+BtFault* BtFault::_instance;
+volatile bool BtFault::_active = false;
+
+static const struct {
+    const char *name;
+    const char *spec;
+} BUILT_IN_PROFILES[] = {
+    { "clean",     "" },
+    { "congested", "latency=lognormal:30:0.8,busy=0.05,reorder=20" },
+    { "lossy",     "latency=exp:15,timeout=0.05,timeout_ms=1000,drop=0.02" },
+    { "storm",     "latency=uniform:5:50,busy=0.1,drop=0.05,storm=0.5,reorder=100" }
+};
+
+static void faultDeviceEvent(const int event, const char *address, const char *data)
+{
+    BtFault::getInstance()->onDeviceEvent(event, address, data);
+}
+
+static void faultGattConnected(const char *bdaddr, const char *service, int instance, int err, uint16_t connInt, uint16_t latency, uint16_t superTimeout, void *userData)
+{
+    BtFault::getInstance()->onGattConnected(bdaddr, service, instance, err, connInt, latency, superTimeout, userData);
+}
+
+static void faultGattDisconnected(const char *bdaddr, const char *service, int instance, int reason, void *userData)
+{
+    BtFault::getInstance()->onGattDisconnected(bdaddr, service, instance, reason, userData);
+}
+
+static void faultGattUpdated(const char *bdaddr, int instance, uint16_t connInt, uint16_t latency, uint16_t superTimeout, void *userData)
+{
+    BtFault::getInstance()->onGattUpdated(bdaddr, instance, connInt, latency, superTimeout, userData);
+}
+
+static bt_gatt_callbacks_t faultGattCallbackTable = { faultGattConnected, faultGattDisconnected, faultGattUpdated };
+
+static QByteArray connectionKey(const QByteArray &address, const QByteArray &service)
+{
+    return address + '/' + service;
+}
+
+BtFault::BtFault(QObject *parent)
+    : QObject(parent)
+    , _rng(1)
+    , _startedUs(0)
+    , _sequence(0)
+    , _lastDelivered(0)
+    , _deviceCallback(0)
+    , _gattCallbacks(0)
+{
+    _clock.start();
+    _deliveryTimer.setSingleShot(true);
+    QObject::connect(&_deliveryTimer, SIGNAL(timeout()), this, SLOT(deliverDue()));
+}
+
+BtFault::~BtFault()
+{
+    // held back callbacks are not delivered, the managers may be gone already
+    if (_active) {
+        logStatistics();
+        _active = false;
+    }
+    _instance = 0;
+}
+
+BtFault* BtFault::getInstance(QObject *parent)
+{
+    if (_instance == 0) {
+        _instance = new BtFault(parent);
+    }
+
+    return _instance;
+}
+
+void BtFault::startFromEnvironment()
+{
+    const char *profile = getenv("BTFAULT_PROFILE");
+
+    if (profile && *profile) {
+        setProfile(QString::fromLocal8Bit(profile));
+    }
+}
+
+bool BtFault::setProfile(const QString &spec)
+{
+    Profile profile;
+    if (!parseProfile(spec, profile)) {
+        qDebug() << "XXXX BtFault::setProfile() - bad profile" << spec << endl;
+        return false;
+    }
+
+    if (_active) {
+        logStatistics();
+    }
+
+    QMutexLocker locker(&_mutex);
+
+    _profile = profile;
+    _rng = profile.seed ? profile.seed : 1;
+    _stats = Statistics();
+    _startedUs = _clock.nsecsElapsed() / 1000;
+    _failingSince.clear();
+    _droppedSince.clear();
+    _active = true;
+
+    qDebug() << "XXXX BtFault::setProfile() - injecting faults:" << spec << endl;
+    return true;
+}
+
+void BtFault::clearProfile()
+{
+    if (!_active) {
+        return;
+    }
+
+    logStatistics();
+
+    QList<Pending> pending;
+    {
+        QMutexLocker locker(&_mutex);
+        _active = false;
+        _profile = Profile();
+        pending.swap(_pending);
+    }
+
+    // nothing is held back any more
+    foreach (const Pending &p, pending) {
+        deliver(p);
+    }
+}
+
+QString BtFault::profile() const
+{
+    QMutexLocker locker(&_mutex);
+    return _active ? _profile.spec : QString();
+}
+
+bool BtFault::parseProfile(const QString &spec, Profile &profile)
+{
+    profile = Profile();
+    profile.spec = spec.trimmed();
+
+    QStringList entries = profile.spec.split(',', QString::SkipEmptyParts);
+
+    if (!entries.isEmpty() && !entries.first().contains('=')) {
+        const QString name = entries.takeFirst().trimmed();
+        bool found = false;
+        for (size_t i = 0; i < sizeof(BUILT_IN_PROFILES) / sizeof(BUILT_IN_PROFILES[0]); i++) {
+            if (name == QLatin1String(BUILT_IN_PROFILES[i].name)) {
+                entries = QString::fromLatin1(BUILT_IN_PROFILES[i].spec).split(',', QString::SkipEmptyParts) + entries;
+                found = true;
+                break;
+            }
+        }
+        if (!found) {
+            return false;
+        }
+    }
+
+    foreach (const QString &entry, entries) {
+        if (!parseEntry(entry.trimmed(), profile)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool BtFault::parseEntry(const QString &entry, Profile &profile)
+{
+    const int eq = entry.indexOf('=');
+    if (eq <= 0) {
+        return false;
+    }
+
+    const QString name = entry.left(eq);
+    const QString value = entry.mid(eq + 1);
+    bool ok = true;
+
+    if (name == "seed") {
+        profile.seed = value.toULongLong(&ok);
+    } else if (name == "latency") {
+        QStringList parts = value.split(':');
+        const QString kind = parts.takeFirst();
+        bool okA = true;
+        bool okB = true;
+        double a = parts.size() > 0 ? parts.at(0).toDouble(&okA) : 0;
+        double b = parts.size() > 1 ? parts.at(1).toDouble(&okB) : 0;
+        ok = okA && okB;
+        if (kind == "none") {
+            profile.latency = NoLatency;
+        } else if (kind == "fixed" && parts.size() == 1) {
+            profile.latency = FixedLatency;
+        } else if (kind == "uniform" && parts.size() == 2 && a <= b) {
+            profile.latency = UniformLatency;
+        } else if (kind == "exp" && parts.size() == 1) {
+            profile.latency = ExponentialLatency;
+        } else if (kind == "lognormal" && parts.size() == 2 && a > 0) {
+            profile.latency = LognormalLatency;
+        } else {
+            ok = false;
+        }
+        profile.latencyA = a;
+        profile.latencyB = b;
+    } else if (name == "busy") {
+        profile.busy = value.toDouble(&ok);
+    } else if (name == "timeout") {
+        profile.timeout = value.toDouble(&ok);
+    } else if (name == "timeout_ms") {
+        profile.timeoutMs = value.toInt(&ok);
+    } else if (name == "drop") {
+        profile.drop = value.toDouble(&ok);
+    } else if (name == "storm") {
+        profile.storm = value.toDouble(&ok);
+    } else if (name == "reorder") {
+        profile.reorderMs = value.toInt(&ok);
+    } else {
+        ok = false;
+    }
+
+    return ok;
+}
+
+double BtFault::random()
+{
+    // xorshift64*, so that a seed gives the same run on every device
+    _rng ^= _rng >> 12;
+    _rng ^= _rng << 25;
+    _rng ^= _rng >> 27;
+    return double((_rng * Q_UINT64_C(2685821657736338717)) >> 11) / double(Q_UINT64_C(1) << 53);
+}
+
+qint64 BtFault::latencyUs()
+{
+    double ms = 0;
+
+    switch (_profile.latency) {
+        case NoLatency:
+            break;
+        case FixedLatency:
+            ms = _profile.latencyA;
+            break;
+        case UniformLatency:
+            ms = _profile.latencyA + random() * (_profile.latencyB - _profile.latencyA);
+            break;
+        case ExponentialLatency:
+            ms = -_profile.latencyA * log(1.0 - random());
+            break;
+        case LognormalLatency: {
+            // Box-Muller
+            const double u = 1.0 - random();
+            const double v = random();
+            const double normal = sqrt(-2.0 * log(u)) * cos(2.0 * M_PI * v);
+            ms = _profile.latencyA * exp(_profile.latencyB * normal);
+            break;
+        }
+    }
+
+    return qint64(ms * 1000);
+}
+
+bool BtFault::admit(BtTrace::Function function, int instance)
+{
+    if (!_active) {
+        return true;
+    }
+
+    int err = 0;
+    qint64 delayUs = 0;
+    bool schedule = false;
+    {
+        QMutexLocker locker(&_mutex);
+
+        if (!_active) {
+            return true;
+        }
+
+        const qint64 now = _clock.nsecsElapsed() / 1000;
+        const int queued = _pending.size();
+        _stats.calls++;
+        delayUs = latencyUs();
+
+        if (function == BtTrace::GattDisconnectInstance) {
+            // releasing an instance always works, only latency applies
+        } else if (instance >= 0 && _dropped.contains(instance)) {
+            err = ENOTCONN;
+            _stats.notConnected++;
+        } else if (instance >= 0 && random() < _profile.drop) {
+            if (random() < _profile.storm) {
+                _stats.storms++;
+                foreach (int open, _connections.keys()) {
+                    dropLocked(open, now);
+                }
+            }
+            dropLocked(instance, now);
+            err = ENOTCONN;
+        } else {
+            const double r = random();
+            if (r < _profile.busy) {
+                err = EBUSY;
+                _stats.busy++;
+            } else if (r < _profile.busy + _profile.timeout) {
+                err = ETIMEDOUT;
+                _stats.timeouts++;
+                delayUs += qint64(_profile.timeoutMs) * 1000;
+            }
+        }
+
+        if (err != 0 && !_failingSince.contains(function)) {
+            _failingSince.insert(function, now);
+        }
+
+        _stats.latencyUs += delayUs;
+        schedule = (_pending.size() != queued);
+    }
+
+    if (schedule) {
+        QMetaObject::invokeMethod(this, "scheduleDelivery", Qt::QueuedConnection);
+    }
+
+    while (delayUs > 0) {
+        qint64 step = qMin<qint64>(delayUs, 500000);
+        usleep(useconds_t(step));
+        delayUs -= step;
+    }
+
+    errno = err;
+    return err == 0;
+}
+
+void BtFault::completed(BtTrace::Function function, bool ok, int bytes)
+{
+    if (!_active || !ok) {
+        return;
+    }
+
+    QMutexLocker locker(&_mutex);
+
+    _stats.succeeded++;
+    _stats.bytes += quint64(qMax(bytes, 0));
+
+    QHash<int, qint64>::iterator i = _failingSince.find(function);
+    if (i != _failingSince.end()) {
+        const qint64 recoveryUs = _clock.nsecsElapsed() / 1000 - i.value();
+        _stats.recoveries++;
+        _stats.recoveryUs += recoveryUs;
+        _stats.maxRecoveryUs = qMax(_stats.maxRecoveryUs, recoveryUs);
+        _failingSince.erase(i);
+    }
+}
+
+void BtFault::dropLocked(int instance, qint64 now)
+{
+    if (_dropped.contains(instance)) {
+        return;
+    }
+
+    _dropped.insert(instance);
+    _toRelease.append(instance);
+    _stats.drops++;
+
+    // the app hears about it the way it would hear about a real link loss
+    Pending pending;
+    pending.function = BtTrace::GattServiceDisconnected;
+    pending.event = 0;
+    pending.instance = instance;
+    pending.err = ECONNRESET;
+    pending.connInt = 0;
+    pending.latency = 0;
+    pending.superTimeout = 0;
+    pending.userData = 0;
+
+    QHash<int, Connection>::const_iterator i = _connections.constFind(instance);
+    if (i != _connections.constEnd()) {
+        pending.address = i.value().address;
+        pending.service = i.value().service;
+        pending.userData = i.value().userData;
+        const QByteArray key = connectionKey(pending.address, pending.service);
+        if (!_droppedSince.contains(key)) {
+            _droppedSince.insert(key, now);
+        }
+    }
+
+    enqueueLocked(pending);
+}
+
+QList<int> BtFault::takeDropped()
+{
+    QMutexLocker locker(&_mutex);
+    QList<int> dropped;
+    dropped.swap(_toRelease);
+    return dropped;
+}
+
+bool BtFault::isDropped(int instance) const
+{
+    QMutexLocker locker(&_mutex);
+    return _dropped.contains(instance);
+}
+
+BtFault::DeviceCallback BtFault::faultDeviceCallback(DeviceCallback callback)
+{
+    QMutexLocker locker(&_mutex);
+    _deviceCallback = callback;
+    return faultDeviceEvent;
+}
+
+bt_gatt_callbacks_t* BtFault::faultGattCallbacks(bt_gatt_callbacks_t *callbacks)
+{
+    QMutexLocker locker(&_mutex);
+    _gattCallbacks = callbacks;
+    return &faultGattCallbackTable;
+}
+
+void BtFault::enqueueLocked(Pending &pending)
+{
+    const qint64 now = _clock.nsecsElapsed() / 1000;
+    const qint64 delayUs = (_profile.reorderMs > 0) ? qint64(random() * _profile.reorderMs * 1000) : 0;
+
+    pending.sequence = ++_sequence;
+    pending.dueUs = now + delayUs;
+    if (delayUs > 0) {
+        _stats.delayed++;
+    }
+
+    _pending.append(pending);
+}
+
+void BtFault::onDeviceEvent(int event, const char *address, const char *data)
+{
+    QMutexLocker locker(&_mutex);
+    _stats.callbacks++;
+
+    if (!_active || _profile.reorderMs <= 0) {
+        DeviceCallback callback = _deviceCallback;
+        locker.unlock();
+        if (callback) {
+            callback(event, address, data);
+        }
+        return;
+    }
+
+    Pending pending;
+    pending.function = BtTrace::DeviceEvent;
+    pending.event = event;
+    pending.instance = -1;
+    pending.err = 0;
+    pending.connInt = 0;
+    pending.latency = 0;
+    pending.superTimeout = 0;
+    pending.address = address;
+    pending.data = data;
+    pending.userData = 0;
+    enqueueLocked(pending);
+
+    locker.unlock();
+    QMetaObject::invokeMethod(this, "scheduleDelivery", Qt::QueuedConnection);
+}
+
+void BtFault::onGattConnected(const char *address, const char *service, int instance, int err, uint16_t connInt, uint16_t latency, uint16_t superTimeout, void *userData)
+{
+    QMutexLocker locker(&_mutex);
+    _stats.callbacks++;
+
+    // connections are tracked even without a profile so that one set later
+    // can drop them
+    if (err == 0) {
+        Connection connection;
+        connection.address = address;
+        connection.service = service;
+        connection.userData = userData;
+        _connections.insert(instance, connection);
+        // the stack has handed the instance number out again
+        _dropped.remove(instance);
+
+        QHash<QByteArray, qint64>::iterator i = _droppedSince.find(connectionKey(connection.address, connection.service));
+        if (i != _droppedSince.end()) {
+            const qint64 reconnectUs = _clock.nsecsElapsed() / 1000 - i.value();
+            _stats.reconnects++;
+            _stats.reconnectUs += reconnectUs;
+            _stats.maxReconnectUs = qMax(_stats.maxReconnectUs, reconnectUs);
+            _droppedSince.erase(i);
+        }
+    }
+
+    if (!_active || _profile.reorderMs <= 0) {
+        bt_gatt_callbacks_t *callbacks = _gattCallbacks;
+        locker.unlock();
+        if (callbacks && callbacks->connected) {
+            callbacks->connected(address, service, instance, err, connInt, latency, superTimeout, userData);
+        }
+        return;
+    }
+
+    Pending pending;
+    pending.function = BtTrace::GattServiceConnected;
+    pending.event = 0;
+    pending.instance = instance;
+    pending.err = err;
+    pending.connInt = connInt;
+    pending.latency = latency;
+    pending.superTimeout = superTimeout;
+    pending.address = address;
+    pending.service = service;
+    pending.userData = userData;
+    enqueueLocked(pending);
+
+    locker.unlock();
+    QMetaObject::invokeMethod(this, "scheduleDelivery", Qt::QueuedConnection);
+}
+
+void BtFault::onGattDisconnected(const char *address, const char *service, int instance, int reason, void *userData)
+{
+    QMutexLocker locker(&_mutex);
+    _stats.callbacks++;
+
+    if (_dropped.contains(instance)) {
+        // the app was told when the instance was dropped
+        _stats.swallowed++;
+        return;
+    }
+
+    _connections.remove(instance);
+
+    if (!_active || _profile.reorderMs <= 0) {
+        bt_gatt_callbacks_t *callbacks = _gattCallbacks;
+        locker.unlock();
+        if (callbacks && callbacks->disconnected) {
+            callbacks->disconnected(address, service, instance, reason, userData);
+        }
+        return;
+    }
+
+    Pending pending;
+    pending.function = BtTrace::GattServiceDisconnected;
+    pending.event = 0;
+    pending.instance = instance;
+    pending.err = reason;
+    pending.connInt = 0;
+    pending.latency = 0;
+    pending.superTimeout = 0;
+    pending.address = address;
+    pending.service = service;
+    pending.userData = userData;
+    enqueueLocked(pending);
+
+    locker.unlock();
+    QMetaObject::invokeMethod(this, "scheduleDelivery", Qt::QueuedConnection);
+}
+
+void BtFault::onGattUpdated(const char *address, int instance, uint16_t connInt, uint16_t latency, uint16_t superTimeout, void *userData)
+{
+    QMutexLocker locker(&_mutex);
+    _stats.callbacks++;
+
+    if (_dropped.contains(instance)) {
+        _stats.swallowed++;
+        return;
+    }
+
+    if (!_active || _profile.reorderMs <= 0) {
+        bt_gatt_callbacks_t *callbacks = _gattCallbacks;
+        locker.unlock();
+        if (callbacks && callbacks->updated) {
+            callbacks->updated(address, instance, connInt, latency, superTimeout, userData);
+        }
+        return;
+    }
+
+    Pending pending;
+    pending.function = BtTrace::GattServiceUpdated;
+    pending.event = 0;
+    pending.instance = instance;
+    pending.err = 0;
+    pending.connInt = connInt;
+    pending.latency = latency;
+    pending.superTimeout = superTimeout;
+    pending.address = address;
+    pending.userData = userData;
+    enqueueLocked(pending);
+
+    locker.unlock();
+    QMetaObject::invokeMethod(this, "scheduleDelivery", Qt::QueuedConnection);
+}
+
+void BtFault::scheduleDelivery()
+{
+    QMutexLocker locker(&_mutex);
+
+    if (_pending.isEmpty()) {
+        return;
+    }
+
+    qint64 earliest = _pending.first().dueUs;
+    foreach (const Pending &p, _pending) {
+        earliest = qMin(earliest, p.dueUs);
+    }
+
+    const qint64 waitUs = earliest - _clock.nsecsElapsed() / 1000;
+    const int waitMs = (waitUs > 0) ? int(waitUs / 1000) + 1 : 0;
+
+    if (!_deliveryTimer.isActive() || _deliveryTimer.interval() > waitMs) {
+        _deliveryTimer.start(waitMs);
+    }
+}
+
+void BtFault::deliverDue()
+{
+    QList<Pending> due;
+    {
+        QMutexLocker locker(&_mutex);
+        const qint64 now = _clock.nsecsElapsed() / 1000;
+
+        // earliest first, in arrival order where due at the same time
+        for (int i = 0; i < _pending.size();) {
+            if (_pending.at(i).dueUs > now) {
+                i++;
+                continue;
+            }
+            const Pending p = _pending.takeAt(i);
+            int j = due.size();
+            while (j > 0 && due.at(j - 1).dueUs > p.dueUs) {
+                j--;
+            }
+            due.insert(j, p);
+        }
+
+        foreach (const Pending &p, due) {
+            if (p.sequence < _lastDelivered) {
+                _stats.reordered++;
+            }
+            _lastDelivered = qMax(_lastDelivered, p.sequence);
+        }
+    }
+
+    foreach (const Pending &p, due) {
+        deliver(p);
+    }
+
+    scheduleDelivery();
+}
+
+void BtFault::deliver(const Pending &pending)
+{
+    DeviceCallback deviceCallback;
+    bt_gatt_callbacks_t *gattCallbacks;
+    {
+        QMutexLocker locker(&_mutex);
+        deviceCallback = _deviceCallback;
+        gattCallbacks = _gattCallbacks;
+    }
+
+    const char *address = pending.address.isNull() ? 0 : pending.address.constData();
+
+    switch (pending.function) {
+        case BtTrace::DeviceEvent:
+            if (deviceCallback) {
+                deviceCallback(pending.event, address, pending.data.isNull() ? 0 : pending.data.constData());
+            }
+            break;
+        case BtTrace::GattServiceConnected:
+            if (gattCallbacks && gattCallbacks->connected) {
+                gattCallbacks->connected(address, pending.service.constData(), pending.instance, pending.err,
+                        pending.connInt, pending.latency, pending.superTimeout, pending.userData);
+            }
+            break;
+        case BtTrace::GattServiceDisconnected:
+            if (gattCallbacks && gattCallbacks->disconnected) {
+                gattCallbacks->disconnected(address, pending.service.constData(), pending.instance, pending.err, pending.userData);
+            }
+            break;
+        case BtTrace::GattServiceUpdated:
+            if (gattCallbacks && gattCallbacks->updated) {
+                gattCallbacks->updated(address, pending.instance, pending.connInt, pending.latency, pending.superTimeout, pending.userData);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+QVariantMap BtFault::statistics() const
+{
+    QMutexLocker locker(&_mutex);
+    QVariantMap stats;
+
+    const double seconds = qMax<qint64>(_clock.nsecsElapsed() / 1000 - _startedUs, 1) / 1e6;
+
+    stats["profile"] = _profile.spec;
+    stats["seconds"] = seconds;
+    stats["calls"] = _stats.calls;
+    stats["succeeded"] = _stats.succeeded;
+    stats["callsPerSecond"] = _stats.succeeded / seconds;
+    stats["bytesPerSecond"] = _stats.bytes / seconds;
+    stats["busy"] = _stats.busy;
+    stats["timeouts"] = _stats.timeouts;
+    stats["notConnected"] = _stats.notConnected;
+    stats["drops"] = _stats.drops;
+    stats["storms"] = _stats.storms;
+    stats["injectedLatencyMs"] = _stats.latencyUs / 1000;
+    stats["callbacks"] = _stats.callbacks;
+    stats["delayedCallbacks"] = _stats.delayed;
+    stats["reorderedCallbacks"] = _stats.reordered;
+    stats["swallowedCallbacks"] = _stats.swallowed;
+    stats["recoveries"] = _stats.recoveries;
+    stats["meanRecoveryMs"] = _stats.recoveries ? double(_stats.recoveryUs) / _stats.recoveries / 1000 : 0.0;
+    stats["maxRecoveryMs"] = double(_stats.maxRecoveryUs) / 1000;
+    stats["unrecovered"] = _failingSince.size();
+    stats["reconnects"] = _stats.reconnects;
+    stats["meanReconnectMs"] = _stats.reconnects ? double(_stats.reconnectUs) / _stats.reconnects / 1000 : 0.0;
+    stats["maxReconnectMs"] = double(_stats.maxReconnectUs) / 1000;
+    stats["notReconnected"] = _droppedSince.size();
+
+    return stats;
+}
+
+void BtFault::logStatistics() const
+{
+    const QVariantMap stats = statistics();
+
+    qDebug() << "XXXX BtFault - profile" << stats["profile"].toString() << "over" << stats["seconds"].toDouble() << "s:"
+             << stats["succeeded"].toULongLong() << "of" << stats["calls"].toULongLong() << "calls succeeded,"
+             << stats["callsPerSecond"].toDouble() << "calls/s," << stats["bytesPerSecond"].toDouble() << "bytes/s" << endl;
+    qDebug() << "XXXX BtFault - injected" << stats["busy"].toULongLong() << "EBUSY," << stats["timeouts"].toULongLong() << "ETIMEDOUT,"
+             << stats["drops"].toULongLong() << "drops in" << stats["storms"].toULongLong() << "storms,"
+             << stats["injectedLatencyMs"].toLongLong() << "ms latency," << stats["reorderedCallbacks"].toULongLong() << "of"
+             << stats["callbacks"].toULongLong() << "callbacks reordered" << endl;
+    qDebug() << "XXXX BtFault - recovery after failed call: mean" << stats["meanRecoveryMs"].toDouble() << "ms max"
+             << stats["maxRecoveryMs"].toDouble() << "ms," << stats["unrecovered"].toInt() << "not recovered;"
+             << "reconnect after drop: mean" << stats["meanReconnectMs"].toDouble() << "ms max"
+             << stats["maxReconnectMs"].toDouble() << "ms," << stats["notReconnected"].toInt() << "not reconnected" << endl;
+}
@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) 2011-2013 BlackBerry Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef BTFAULT_H
+#define BTFAULT_H
+
+#include "BtTrace.hpp"
+
+#include <stdint.h>
+
+#include <QObject>
+#include <QtCore/QByteArray>
+#include <QtCore/QDebug>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QMutex>
+#include <QtCore/QSet>
+#include <QtCore/QString>
+#include <QtCore/QTimer>
+#include <QtCore/QVariantMap>
+
+#include <btapi/btdevice.h>
+#include <btapi/btgatt.h>
+
+/*
+ * Simulates bad RF between the managers and btapi. BtApi asks admit() before
+ * each call that goes out over the air; depending on the active profile the
+ * call is delayed, failed with EBUSY or ETIMEDOUT, or the GATT instance it is
+ * made on is dropped - the app gets a disconnected callback and every further
+ * call on that instance fails with ENOTCONN. Callbacks from the stack pass
+ * through here as well and can be held back for a random time, which
+ * reorders them.
+ *
+ * A profile is a comma separated list, optionally starting with the name of
+ * one of the built-in profiles which the remaining entries then override:
+ *
+ *   seed=<n>                      random seed, the same seed gives the same faults
+ *   latency=fixed:<ms>            added to every call
+ *          =uniform:<min>:<max>
+ *          =exp:<mean>
+ *          =lognormal:<median>:<sigma>
+ *   busy=<p>                      probability a call fails with EBUSY
+ *   timeout=<p>                   probability a call fails with ETIMEDOUT ...
+ *   timeout_ms=<ms>               ... after blocking this long
+ *   drop=<p>                      probability a call on a GATT instance drops it
+ *   storm=<p>                     probability a drop takes every instance with it
+ *   reorder=<ms>                  callbacks are held back up to this long
+ *
+ * e.g. BTFAULT_PROFILE="lossy,seed=7,reorder=50". Statistics - throughput and
+ * how long it takes to get going again after an injected fault - are kept per
+ * profile and logged whenever the profile changes.
+ */
+class BtFault : public QObject
+{
+    Q_OBJECT
+
+public:
+    typedef void (*DeviceCallback)(const int event, const char *address, const char *data);
+
+    static BtFault* getInstance(QObject *parent = 0);
+
+    // cheap check for the BtApi wrappers
+    static bool isActive() { return _active; }
+
+    void startFromEnvironment();
+
+    Q_INVOKABLE bool setProfile(const QString &profile);
+    Q_INVOKABLE void clearProfile();
+    Q_INVOKABLE QString profile() const;
+
+    // false with errno set if the call is to fail; may block to add latency
+    bool admit(BtTrace::Function function, int instance = -1);
+    void completed(BtTrace::Function function, bool ok, int bytes = 0);
+
+    // instances dropped since the last call, still to be released on the stack
+    QList<int> takeDropped();
+    bool isDropped(int instance) const;
+
+    // the callbacks to hand on to btapi (through BtTrace)
+    DeviceCallback faultDeviceCallback(DeviceCallback callback);
+    bt_gatt_callbacks_t* faultGattCallbacks(bt_gatt_callbacks_t *callbacks);
+
+    QVariantMap statistics() const;
+    void logStatistics() const;
+
+    // called by the callback trampolines, on the btapi thread
+    void onDeviceEvent(int event, const char *address, const char *data);
+    void onGattConnected(const char *address, const char *service, int instance, int err, uint16_t connInt, uint16_t latency, uint16_t superTimeout, void *userData);
+    void onGattDisconnected(const char *address, const char *service, int instance, int reason, void *userData);
+    void onGattUpdated(const char *address, int instance, uint16_t connInt, uint16_t latency, uint16_t superTimeout, void *userData);
+
+private slots:
+    void scheduleDelivery();
+    void deliverDue();
+
+private:
+    BtFault(QObject *parent = 0);
+    virtual ~BtFault();
+
+    enum Latency {
+        NoLatency,
+        FixedLatency,
+        UniformLatency,
+        ExponentialLatency,
+        LognormalLatency
+    };
+
+    struct Profile {
+        Profile() : seed(1), latency(NoLatency), latencyA(0), latencyB(0), busy(0), timeout(0), timeoutMs(1000), drop(0), storm(0), reorderMs(0) {}
+        QString spec;
+        quint64 seed;
+        Latency latency;
+        double latencyA;
+        double latencyB;
+        double busy;
+        double timeout;
+        int timeoutMs;
+        double drop;
+        double storm;
+        int reorderMs;
+    };
+
+    struct Connection {
+        QByteArray address;
+        QByteArray service;
+        void *userData;
+    };
+
+    // a callback on its way to the app
+    struct Pending {
+        BtTrace::Function function;
+        quint64 sequence;
+        qint64 dueUs;
+        int event;
+        int instance;
+        int err;
+        uint16_t connInt;
+        uint16_t latency;
+        uint16_t superTimeout;
+        QByteArray address;
+        QByteArray service;
+        QByteArray data;
+        void *userData;
+    };
+
+    struct Statistics {
+        Statistics() : calls(0), succeeded(0), bytes(0), busy(0), timeouts(0), notConnected(0), drops(0), storms(0),
+                latencyUs(0), callbacks(0), delayed(0), reordered(0), swallowed(0), recoveries(0), recoveryUs(0), maxRecoveryUs(0),
+                reconnects(0), reconnectUs(0), maxReconnectUs(0) {}
+        quint64 calls;
+        quint64 succeeded;
+        quint64 bytes;
+        quint64 busy;
+        quint64 timeouts;
+        quint64 notConnected;
+        quint64 drops;
+        quint64 storms;
+        qint64 latencyUs;
+        quint64 callbacks;
+        quint64 delayed;
+        quint64 reordered;
+        quint64 swallowed;
+        quint64 recoveries;
+        qint64 recoveryUs;
+        qint64 maxRecoveryUs;
+        quint64 reconnects;
+        qint64 reconnectUs;
+        qint64 maxReconnectUs;
+    };
+
+    static bool parseProfile(const QString &spec, Profile &profile);
+    static bool parseEntry(const QString &entry, Profile &profile);
+
+    double random();
+    qint64 latencyUs();
+    void dropLocked(int instance, qint64 now);
+    void enqueueLocked(Pending &pending);
+    void deliver(const Pending &pending);
+
+    static BtFault *_instance;
+    static volatile bool _active;
+
+    mutable QMutex _mutex;
+    QElapsedTimer _clock;
+    Profile _profile;
+    quint64 _rng;
+
+    Statistics _stats;
+    qint64 _startedUs;
+    QHash<int, qint64> _failingSince;
+    QHash<QByteArray, qint64> _droppedSince;
+
+    QHash<int, Connection> _connections;
+    QSet<int> _dropped;
+    QList<int> _toRelease;
+
+    QList<Pending> _pending;
+    quint64 _sequence;
+    quint64 _lastDelivered;
+    QTimer _deliveryTimer;
+
+    DeviceCallback _deviceCallback;
+    bt_gatt_callbacks_t *_gattCallbacks;
+};
+
+#endif // ifndef BTFAULT_H
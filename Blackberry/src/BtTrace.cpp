@@ -0,0 +1,789 @@
+/*
+ * Copyright (c) 2011-2013 BlackBerry Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "BtTrace.hpp"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <QtCore/QDateTime>
+#include <QtCore/QMetaObject>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QtEndian>
+
+BtTrace* BtTrace::_instance;
+volatile BtTrace::Mode BtTrace::_mode = BtTrace::Off;
+
+static const char TRACE_MAGIC[4] = { 'B', 'T', 'R', 'C' };
+static const int FLUSH_THRESHOLD = 64 * 1024;
+
+static inline void putU16(QByteArray &out, quint16 value)
+{
+    uchar raw[2];
+    qToLittleEndian<quint16>(value, raw);
+    out.append(reinterpret_cast<const char *>(raw), 2);
+}
+
+static inline void putU32(QByteArray &out, quint32 value)
+{
+    uchar raw[4];
+    qToLittleEndian<quint32>(value, raw);
+    out.append(reinterpret_cast<const char *>(raw), 4);
+}
+
+static inline void putI64(QByteArray &out, qint64 value)
+{
+    uchar raw[8];
+    qToLittleEndian<qint64>(value, raw);
+    out.append(reinterpret_cast<const char *>(raw), 8);
+}
+
+static inline void putBytes(QByteArray &out, const QByteArray &value)
+{
+    putU32(out, value.size());
+    out.append(value);
+}
+
+static inline void putString(QByteArray &out, const char *value)
+{
+    putBytes(out, value ? QByteArray(value) : QByteArray());
+}
+
+/*
+ * Bounds-checked reader over a log or a callback payload
+ */
+class TraceReader
+{
+public:
+    TraceReader(const QByteArray &buffer) : _data(buffer.constData()), _remaining(buffer.size()), _failed(false) {}
+
+    bool failed() const { return _failed; }
+    bool atEnd() const { return _remaining == 0; }
+
+    const char* take(int count)
+    {
+        if (_failed || count < 0 || count > _remaining) {
+            _failed = true;
+            return 0;
+        }
+        const char *p = _data;
+        _data += count;
+        _remaining -= count;
+        return p;
+    }
+
+    quint16 u16() { const char *p = take(2); return p ? qFromLittleEndian<quint16>(reinterpret_cast<const uchar *>(p)) : 0; }
+    quint32 u32() { const char *p = take(4); return p ? qFromLittleEndian<quint32>(reinterpret_cast<const uchar *>(p)) : 0; }
+    qint64 i64() { const char *p = take(8); return p ? qFromLittleEndian<qint64>(reinterpret_cast<const uchar *>(p)) : 0; }
+
+    QByteArray bytes()
+    {
+        quint32 length = u32();
+        const char *p = take(length);
+        return p ? QByteArray(p, length) : QByteArray();
+    }
+
+private:
+    const char *_data;
+    int _remaining;
+    bool _failed;
+};
+
+// forwarding callbacks registered with btapi while recording
+static BtTrace::DeviceCallback appDeviceCallback = 0;
+static bt_gatt_callbacks_t *appGattCallbacks = 0;
+
+static void tracedDeviceEvent(const int event, const char *address, const char *data)
+{
+    QByteArray payload;
+    putU32(payload, event);
+    putString(payload, address);
+    putString(payload, data);
+    BtTrace::getInstance()->recordCallback(BtTrace::DeviceEvent, payload);
+
+    if (appDeviceCallback) {
+        appDeviceCallback(event, address, data);
+    }
+}
+
+static void tracedGattConnected(const char *bdaddr, const char *service, int instance, int err, uint16_t connInt, uint16_t latency, uint16_t superTimeout, void *userData)
+{
+    QByteArray payload;
+    putString(payload, bdaddr);
+    putString(payload, service);
+    putU32(payload, instance);
+    putU32(payload, err);
+    putU16(payload, connInt);
+    putU16(payload, latency);
+    putU16(payload, superTimeout);
+    putI64(payload, reinterpret_cast<quintptr>(userData));
+    BtTrace::getInstance()->recordCallback(BtTrace::GattServiceConnected, payload);
+
+    if (appGattCallbacks && appGattCallbacks->connected) {
+        appGattCallbacks->connected(bdaddr, service, instance, err, connInt, latency, superTimeout, userData);
+    }
+}
+
+static void tracedGattDisconnected(const char *bdaddr, const char *service, int instance, int reason, void *userData)
+{
+    QByteArray payload;
+    putString(payload, bdaddr);
+    putString(payload, service);
+    putU32(payload, instance);
+    putU32(payload, reason);
+    putI64(payload, reinterpret_cast<quintptr>(userData));
+    BtTrace::getInstance()->recordCallback(BtTrace::GattServiceDisconnected, payload);
+
+    if (appGattCallbacks && appGattCallbacks->disconnected) {
+        appGattCallbacks->disconnected(bdaddr, service, instance, reason, userData);
+    }
+}
+
+static void tracedGattUpdated(const char *bdaddr, int instance, uint16_t connInt, uint16_t latency, uint16_t superTimeout, void *userData)
+{
+    QByteArray payload;
+    putString(payload, bdaddr);
+    putU32(payload, instance);
+    putU16(payload, connInt);
+    putU16(payload, latency);
+    putU16(payload, superTimeout);
+    putI64(payload, reinterpret_cast<quintptr>(userData));
+    BtTrace::getInstance()->recordCallback(BtTrace::GattServiceUpdated, payload);
+
+    if (appGattCallbacks && appGattCallbacks->updated) {
+        appGattCallbacks->updated(bdaddr, instance, connInt, latency, superTimeout, userData);
+    }
+}
+
+static bt_gatt_callbacks_t tracedGattCallbacks = { tracedGattConnected, tracedGattDisconnected, tracedGattUpdated };
+
+static QByteArray queueKey(int function, const QByteArray &key)
+{
+    QByteArray composite;
+    composite.reserve(key.size() + 2);
+    putU16(composite, function);
+    composite.append(key);
+    return composite;
+}
+
+BtTrace::BtTrace(QObject *parent)
+    : QObject(parent)
+    , _recordedCalls(0)
+    , _recordedCallbacks(0)
+    , _nextCallback(0)
+    , _replayedCalls(0)
+    , _divergences(0)
+    , _realtime(true)
+    , _recordedDurationUs(0)
+    , _deviceCallback(0)
+    , _gattCallbacks(0)
+{
+    _pumpTimer.setSingleShot(true);
+    _stallTimer.setSingleShot(true);
+    _stallTimer.setInterval(STALL_TIMEOUT_MS);
+    _flushTimer.setInterval(FLUSH_INTERVAL_MS);
+
+    QObject::connect(&_pumpTimer, SIGNAL(timeout()), this, SLOT(pumpCallbacks()));
+    QObject::connect(&_stallTimer, SIGNAL(timeout()), this, SLOT(replayStalled()));
+    QObject::connect(&_flushTimer, SIGNAL(timeout()), this, SLOT(flushRecording()));
+}
+
+BtTrace::~BtTrace()
+{
+    stopRecording();
+    stopReplay();
+    _instance = 0;
+}
+
+BtTrace* BtTrace::getInstance(QObject *parent)
+{
+    if (_instance == 0) {
+        _instance = new BtTrace(parent);
+    }
+
+    return _instance;
+}
+
+const char* BtTrace::functionName(int function)
+{
+    switch (function) {
+        case DeviceInit:                return "bt_device_init";
+        case LdevGetPower:              return "bt_ldev_get_power";
+        case LdevSetPower:              return "bt_ldev_set_power";
+        case DiscStartInquiry:          return "bt_disc_start_inquiry";
+        case DiscRetrieveDevices:       return "bt_disc_retrieve_devices";
+        case RdevGetDevice:             return "bt_rdev_get_device";
+        case RdevGetAddress:            return "bt_rdev_get_address";
+        case RdevGetType:               return "bt_rdev_get_type";
+        case RdevGetFriendlyName:       return "bt_rdev_get_friendly_name";
+        case RdevGetRemoteName:         return "bt_rdev_get_remote_name";
+        case RdevGetDeviceClass:        return "bt_rdev_get_device_class";
+        case RdevIsKnown:               return "bt_rdev_is_known";
+        case RdevIsPaired:              return "bt_rdev_is_paired";
+        case RdevIsEncrypted:           return "bt_rdev_is_encrypted";
+        case RdevIsTrusted:             return "bt_rdev_is_trusted";
+        case RdevGetRssi:               return "bt_rdev_get_rssi";
+        case RdevGetLeConnParams:       return "bt_rdev_get_le_conn_params";
+        case RdevGetLeInfo:             return "bt_rdev_get_le_info";
+        case RdevGetServicesGatt:       return "bt_rdev_get_services_gatt";
+        case RdevPair:                  return "bt_rdev_pair";
+        case GattInit:                  return "bt_gatt_init";
+        case GattConnectService:        return "bt_gatt_connect_service";
+        case GattDisconnectInstance:    return "bt_gatt_disconnect_instance";
+        case GattCharacteristicsCount:  return "bt_gatt_characteristics_count";
+        case GattCharacteristics:       return "bt_gatt_characteristics";
+        case GattReadValue:             return "bt_gatt_read_value";
+        case GattWriteValue:            return "bt_gatt_write_value";
+        case DeviceEvent:               return "device event";
+        case GattServiceConnected:      return "gatt connected";
+        case GattServiceDisconnected:   return "gatt disconnected";
+        case GattServiceUpdated:        return "gatt updated";
+        default:                        return "unknown";
+    }
+}
+
+void BtTrace::startFromEnvironment()
+{
+    const char *record = getenv("BTTRACE_RECORD");
+    const char *replay = getenv("BTTRACE_REPLAY");
+    const char *fast = getenv("BTTRACE_REPLAY_FAST");
+
+    if (replay && *replay) {
+        startReplay(QString::fromLocal8Bit(replay), !(fast && atoi(fast) != 0));
+    } else if (record && *record) {
+        startRecording(QString::fromLocal8Bit(record));
+    }
+}
+
+qint64 BtTrace::nowUs() const
+{
+    return _clock.nsecsElapsed() / 1000;
+}
+
+bool BtTrace::startRecording(const QString &path)
+{
+    QMutexLocker locker(&_mutex);
+
+    if (_mode != Off) {
+        qDebug() << "XXXX BtTrace::startRecording() - already active" << endl;
+        return false;
+    }
+
+    _file.setFileName(path);
+    if (!_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qDebug() << "XXXX BtTrace::startRecording() - cannot open" << path << ":" << _file.errorString() << endl;
+        return false;
+    }
+
+    _buffer.clear();
+    _buffer.reserve(FLUSH_THRESHOLD + 1024);
+    _buffer.append(TRACE_MAGIC, sizeof(TRACE_MAGIC));
+    putU16(_buffer, VERSION);
+    putU16(_buffer, 0);
+    putI64(_buffer, QDateTime::currentMSecsSinceEpoch());
+
+    _recordedCalls = 0;
+    _recordedCallbacks = 0;
+    _clock.start();
+    _mode = Record;
+    _flushTimer.start();
+
+    qDebug() << "XXXX BtTrace::startRecording() - recording btapi traffic to" << path << endl;
+    return true;
+}
+
+void BtTrace::stopRecording()
+{
+    QMutexLocker locker(&_mutex);
+
+    if (_mode != Record) {
+        return;
+    }
+
+    _mode = Off;
+    _flushTimer.stop();
+    flushLocked();
+    _file.close();
+
+    qDebug() << "XXXX BtTrace::stopRecording() - " << _recordedCalls << "calls," << _recordedCallbacks << "callbacks in" << nowUs() / 1000 << "ms" << endl;
+}
+
+void BtTrace::flushLocked()
+{
+    if (_buffer.isEmpty() || !_file.isOpen()) {
+        return;
+    }
+    if (_file.write(_buffer) != _buffer.size()) {
+        qDebug() << "XXXX BtTrace::flushLocked() - write failed:" << _file.errorString() << endl;
+    }
+    _file.flush();
+    _buffer.clear();
+}
+
+void BtTrace::flushRecording()
+{
+    QMutexLocker locker(&_mutex);
+
+    if (_mode == Record) {
+        flushLocked();
+    }
+}
+
+void BtTrace::appendRecord(const Record &record)
+{
+    putU16(_buffer, record.kind);
+    putU16(_buffer, record.function);
+    putI64(_buffer, record.timeUs);
+    putI64(_buffer, record.durationUs);
+    putI64(_buffer, record.ret);
+    putU32(_buffer, record.err);
+    putBytes(_buffer, record.key);
+    putBytes(_buffer, record.out);
+
+    // a callback is rare and is what a crash report needs most, calls wait
+    // for the timer unless they pile up
+    if (record.kind == Callback || _buffer.size() >= FLUSH_THRESHOLD) {
+        flushLocked();
+    }
+}
+
+void BtTrace::recordCall(Function function, const QByteArray &key, qint64 startUs, qint64 ret, int err, const QByteArray &out)
+{
+    if (_mode != Record) {
+        return;
+    }
+
+    const int savedErrno = errno;
+    {
+        QMutexLocker locker(&_mutex);
+
+        Record record;
+        record.kind = Call;
+        record.function = function;
+        record.timeUs = startUs;
+        record.durationUs = nowUs() - startUs;
+        record.ret = ret;
+        record.err = err;
+        record.key = key;
+        record.out = out;
+        appendRecord(record);
+
+        _recordedCalls++;
+    }
+    errno = savedErrno;
+}
+
+void BtTrace::recordCallback(Function function, const QByteArray &payload)
+{
+    if (_mode != Record) {
+        return;
+    }
+
+    const int savedErrno = errno;
+    {
+        QMutexLocker locker(&_mutex);
+
+        Record record;
+        record.kind = Callback;
+        record.function = function;
+        record.timeUs = nowUs();
+        record.out = payload;
+        appendRecord(record);
+
+        _recordedCallbacks++;
+    }
+    errno = savedErrno;
+}
+
+bool BtTrace::loadLog(const QByteArray &log)
+{
+    TraceReader reader(log);
+
+    const char *magic = reader.take(sizeof(TRACE_MAGIC));
+    if (!magic || memcmp(magic, TRACE_MAGIC, sizeof(TRACE_MAGIC)) != 0) {
+        qDebug() << "XXXX BtTrace::loadLog() - not a trace log" << endl;
+        return false;
+    }
+    quint16 version = reader.u16();
+    reader.u16();
+    reader.i64();
+    if (version != VERSION) {
+        qDebug() << "XXXX BtTrace::loadLog() - unsupported version" << version << endl;
+        return false;
+    }
+
+    int calls = 0;
+    while (!reader.atEnd() && !reader.failed()) {
+        Record record;
+        record.kind = reader.u16();
+        record.function = reader.u16();
+        record.timeUs = reader.i64();
+        record.durationUs = reader.i64();
+        record.ret = reader.i64();
+        record.err = reader.u32();
+        record.key = reader.bytes();
+        record.out = reader.bytes();
+
+        if (reader.failed()) {
+            // a log cut short by a crash still replays up to the damage
+            qDebug() << "XXXX BtTrace::loadLog() - truncated record after" << _records.size() << "records" << endl;
+            break;
+        }
+
+        int index = _records.size();
+        if (record.kind == Call) {
+            _calls[queueKey(record.function, record.key)].enqueue(index);
+            calls++;
+        } else {
+            record.callsBefore = calls;
+            _callbacks.append(index);
+        }
+        _recordedDurationUs = qMax(_recordedDurationUs, record.timeUs + record.durationUs);
+        _records.append(record);
+    }
+
+    qDebug() << "XXXX BtTrace::loadLog() - " << calls << "calls," << _callbacks.size() << "callbacks over" << _recordedDurationUs / 1000 << "ms" << endl;
+    return !_records.isEmpty();
+}
+
+bool BtTrace::startReplay(const QString &path, bool realtime)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qDebug() << "XXXX BtTrace::startReplay() - cannot open" << path << ":" << file.errorString() << endl;
+        return false;
+    }
+    QByteArray log = file.readAll();
+
+    {
+        QMutexLocker locker(&_mutex);
+
+        if (_mode != Off) {
+            qDebug() << "XXXX BtTrace::startReplay() - already active" << endl;
+            return false;
+        }
+
+        _records.clear();
+        _calls.clear();
+        _callbacks.clear();
+        _userData.clear();
+        _nextCallback = 0;
+        _replayedCalls = 0;
+        _divergences = 0;
+        _recordedDurationUs = 0;
+
+        if (!loadLog(log)) {
+            return false;
+        }
+
+        _realtime = realtime;
+        _clock.start();
+        _mode = Replay;
+    }
+
+    qDebug() << "XXXX BtTrace::startReplay() - replaying" << path << (realtime ? "at recorded speed" : "as fast as possible") << endl;
+    schedulePump();
+    return true;
+}
+
+void BtTrace::stopReplay()
+{
+    if (_mode != Replay) {
+        return;
+    }
+
+    _pumpTimer.stop();
+    _stallTimer.stop();
+    logStatistics();
+
+    QMutexLocker locker(&_mutex);
+    _mode = Off;
+    _records.clear();
+    _calls.clear();
+    _callbacks.clear();
+    _userData.clear();
+}
+
+bool BtTrace::replayCall(Function function, const QByteArray &key, qint64 &ret, QByteArray *out)
+{
+    int err = 0;
+    qint64 durationUs = 0;
+    {
+        QMutexLocker locker(&_mutex);
+
+        if (_mode != Replay) {
+            return false;
+        }
+
+        QHash<QByteArray, QQueue<int> >::iterator i = _calls.find(queueKey(function, key));
+        if (i == _calls.end() || i.value().isEmpty()) {
+            _divergences++;
+            qDebug() << "XXXX BtTrace::replayCall() - diverged, no recorded" << functionName(function) << "for key" << key.toHex() << endl;
+            errno = ENODATA;
+            return false;
+        }
+
+        const Record &record = _records.at(i.value().dequeue());
+        ret = record.ret;
+        err = record.err;
+        durationUs = _realtime ? record.durationUs : 0;
+        if (out) {
+            *out = record.out;
+        }
+        _replayedCalls++;
+    }
+
+    // stand in for the time the stack took, the caller would have blocked as long
+    while (durationUs > 0) {
+        qint64 step = qMin<qint64>(durationUs, 500000);
+        usleep(useconds_t(step));
+        durationUs -= step;
+    }
+
+    schedulePump();
+    errno = err;
+    return true;
+}
+
+void BtTrace::mapUserData(quint64 recorded, void *live)
+{
+    QMutexLocker locker(&_mutex);
+    _userData[recorded] = live;
+}
+
+BtTrace::DeviceCallback BtTrace::traceDeviceCallback(DeviceCallback callback)
+{
+    QMutexLocker locker(&_mutex);
+
+    _deviceCallback = callback;
+    appDeviceCallback = callback;
+
+    return (_mode == Record) ? tracedDeviceEvent : callback;
+}
+
+bt_gatt_callbacks_t* BtTrace::traceGattCallbacks(bt_gatt_callbacks_t *callbacks)
+{
+    QMutexLocker locker(&_mutex);
+
+    _gattCallbacks = callbacks;
+    appGattCallbacks = callbacks;
+
+    return (_mode == Record) ? &tracedGattCallbacks : callbacks;
+}
+
+QByteArray BtTrace::key(qint64 value)
+{
+    QByteArray k;
+    putI64(k, value);
+    return k;
+}
+
+QByteArray BtTrace::key(qint64 first, qint64 second)
+{
+    QByteArray k;
+    putI64(k, first);
+    putI64(k, second);
+    return k;
+}
+
+QByteArray BtTrace::key(const char *text)
+{
+    return QByteArray(text ? text : "");
+}
+
+QByteArray BtTrace::key(const char *first, const char *second)
+{
+    QByteArray k;
+    putString(k, first);
+    putString(k, second);
+    return k;
+}
+
+void BtTrace::schedulePump()
+{
+    // replayed calls arrive on any thread, callbacks are delivered on ours
+    const int savedErrno = errno;
+    QMetaObject::invokeMethod(this, "pumpCallbacks", Qt::QueuedConnection);
+    errno = savedErrno;
+}
+
+void BtTrace::pumpCallbacks()
+{
+    QMutexLocker locker(&_mutex);
+
+    if (_mode != Replay) {
+        return;
+    }
+
+    while (_nextCallback < _callbacks.size()) {
+        const Record &record = _records.at(_callbacks.at(_nextCallback));
+
+        if (_replayedCalls < record.callsBefore) {
+            // the app hasn't got as far as it had when this callback arrived
+            if (!_stallTimer.isActive()) {
+                _stallTimer.start();
+            }
+            return;
+        }
+
+        if (_realtime) {
+            qint64 dueUs = record.timeUs - nowUs();
+            if (dueUs > 0) {
+                _pumpTimer.start(int(dueUs / 1000) + 1);
+                return;
+            }
+        }
+
+        _nextCallback++;
+        _stallTimer.stop();
+
+        Record copy = record;
+        locker.unlock();
+        dispatch(copy);
+        locker.relock();
+
+        if (_mode != Replay) {
+            return;
+        }
+    }
+
+    if (_nextCallback == _callbacks.size() && !_callbacks.isEmpty()) {
+        _nextCallback++;
+        locker.unlock();
+        qDebug() << "XXXX BtTrace::pumpCallbacks() - all recorded callbacks delivered" << endl;
+        logStatistics();
+    }
+}
+
+void BtTrace::replayStalled()
+{
+    {
+        QMutexLocker locker(&_mutex);
+
+        if (_mode != Replay || _nextCallback >= _callbacks.size()) {
+            return;
+        }
+
+        Record &record = _records[_callbacks.at(_nextCallback)];
+        qDebug() << "XXXX BtTrace::replayStalled() - " << functionName(record.function) << "waited" << STALL_TIMEOUT_MS << "ms for"
+                 << (record.callsBefore - _replayedCalls) << "calls, delivering it anyway" << endl;
+        _divergences++;
+        record.callsBefore = 0;
+    }
+
+    pumpCallbacks();
+}
+
+void BtTrace::dispatch(const Record &record)
+{
+    TraceReader payload(record.out);
+
+    void (*deviceCallback)(const int, const char *, const char *);
+    bt_gatt_callbacks_t *gattCallbacks;
+    {
+        QMutexLocker locker(&_mutex);
+        deviceCallback = _deviceCallback;
+        gattCallbacks = _gattCallbacks;
+    }
+
+    switch (record.function) {
+        case DeviceEvent: {
+            int event = int(payload.u32());
+            QByteArray address = payload.bytes();
+            QByteArray data = payload.bytes();
+            if (deviceCallback && !payload.failed()) {
+                deviceCallback(event, address.isNull() ? 0 : address.constData(), data.isNull() ? 0 : data.constData());
+                return;
+            }
+            break;
+        }
+        case GattServiceConnected: {
+            QByteArray address = payload.bytes();
+            QByteArray service = payload.bytes();
+            int instance = int(payload.u32());
+            int err = int(payload.u32());
+            uint16_t connInt = payload.u16();
+            uint16_t latency = payload.u16();
+            uint16_t superTimeout = payload.u16();
+            quint64 userData = payload.i64();
+            if (gattCallbacks && gattCallbacks->connected && !payload.failed()) {
+                QMutexLocker locker(&_mutex);
+                void *live = _userData.value(userData, 0);
+                locker.unlock();
+                gattCallbacks->connected(address.constData(), service.constData(), instance, err, connInt, latency, superTimeout, live);
+                return;
+            }
+            break;
+        }
+        case GattServiceDisconnected: {
+            QByteArray address = payload.bytes();
+            QByteArray service = payload.bytes();
+            int instance = int(payload.u32());
+            int reason = int(payload.u32());
+            quint64 userData = payload.i64();
+            if (gattCallbacks && gattCallbacks->disconnected && !payload.failed()) {
+                QMutexLocker locker(&_mutex);
+                void *live = _userData.value(userData, 0);
+                locker.unlock();
+                gattCallbacks->disconnected(address.constData(), service.constData(), instance, reason, live);
+                return;
+            }
+            break;
+        }
+        case GattServiceUpdated: {
+            QByteArray address = payload.bytes();
+            int instance = int(payload.u32());
+            uint16_t connInt = payload.u16();
+            uint16_t latency = payload.u16();
+            uint16_t superTimeout = payload.u16();
+            quint64 userData = payload.i64();
+            if (gattCallbacks && gattCallbacks->updated && !payload.failed()) {
+                QMutexLocker locker(&_mutex);
+                void *live = _userData.value(userData, 0);
+                locker.unlock();
+                gattCallbacks->updated(address.constData(), instance, connInt, latency, superTimeout, live);
+                return;
+            }
+            break;
+        }
+        default:
+            break;
+    }
+
+    QMutexLocker locker(&_mutex);
+    _divergences++;
+    qDebug() << "XXXX BtTrace::dispatch() - dropped" << functionName(record.function) << "- no callback registered or bad payload" << endl;
+}
+
+void BtTrace::logStatistics() const
+{
+    QMutexLocker locker(&_mutex);
+
+    if (_mode == Record) {
+        qDebug() << "XXXX BtTrace - recorded" << _recordedCalls << "calls," << _recordedCallbacks << "callbacks so far" << endl;
+    } else if (_mode == Replay) {
+        int pendingCalls = 0;
+        QHashIterator<QByteArray, QQueue<int> > i(_calls);
+        while (i.hasNext()) {
+            pendingCalls += i.next().value().size();
+        }
+        qDebug() << "XXXX BtTrace - replayed" << _replayedCalls << "calls," << qMin(_nextCallback, _callbacks.size()) << "of" << _callbacks.size()
+                 << "callbacks in" << nowUs() / 1000 << "ms (recorded" << _recordedDurationUs / 1000 << "ms)," << pendingCalls
+                 << "calls not reached," << _divergences << "divergences" << endl;
+    }
+}
@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2011-2013 BlackBerry Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef BTTRACE_H
+#define BTTRACE_H
+
+#include <stdint.h>
+
+#include <QObject>
+#include <QtCore/QByteArray>
+#include <QtCore/QDebug>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QQueue>
+#include <QtCore/QString>
+#include <QtCore/QTimer>
+#include <QtCore/QVector>
+
+#include <btapi/btdevice.h>
+#include <btapi/btgatt.h>
+
+/*
+ * Records every btapi call made through BtApi - arguments, return value,
+ * errno, output parameters - and every btapi callback, with monotonic
+ * timestamps, into a compact binary log. The same log can be replayed: BtApi
+ * then answers each call from the log instead of the stack and the recorded
+ * callbacks are delivered to the registered callback functions, so the
+ * managers run exactly as they did in the field.
+ *
+ * Log layout, all integers little-endian:
+ *
+ *   header   : "BTRC" u16 version u16 reserved i64 startedAtMs
+ *   record   : u16 kind u16 function i64 timeUs i64 durationUs i64 ret i32 errno bytes key bytes out
+ *
+ *   bytes    : u32 length + raw bytes
+ *
+ * A call's key identifies what it was called on (handle, address, instance),
+ * replayed calls are matched by function and key in recorded order, so calls
+ * made from different threads may interleave differently without the replay
+ * going wrong. At recorded speed a replayed call takes as long as the stack
+ * took to answer it, so only the time spent in the app itself changes between
+ * runs. A callback is delivered once as many calls as preceded it in the log
+ * have been replayed; at recorded speed it also waits for its recorded time.
+ *
+ * While recording, a callback is written out as soon as it is logged and
+ * calls at least every FLUSH_INTERVAL_MS, so a log cut short by a crash
+ * still holds what led up to it.
+ *
+ * Set BTTRACE_RECORD=<file> or BTTRACE_REPLAY=<file> (plus
+ * BTTRACE_REPLAY_FAST=1 to ignore recorded timing) in the environment to
+ * enable either mode at startup.
+ */
+class BtTrace : public QObject
+{
+    Q_OBJECT
+
+public:
+    typedef void (*DeviceCallback)(const int event, const char *address, const char *data);
+
+    enum Mode {
+        Off,
+        Record,
+        Replay
+    };
+
+    enum Kind {
+        Call = 0,
+        Callback = 1
+    };
+
+    // values are stored in logs, append only
+    enum Function {
+        DeviceInit = 1,
+        LdevGetPower,
+        LdevSetPower,
+        DiscStartInquiry,
+        DiscRetrieveDevices,
+        RdevGetDevice,
+        RdevGetAddress,
+        RdevGetType,
+        RdevGetFriendlyName,
+        RdevGetRemoteName,
+        RdevGetDeviceClass,
+        RdevIsKnown,
+        RdevIsPaired,
+        RdevIsEncrypted,
+        RdevIsTrusted,
+        RdevGetRssi,
+        RdevGetLeConnParams,
+        RdevGetLeInfo,
+        RdevGetServicesGatt,
+        RdevPair,
+        GattInit,
+        GattConnectService,
+        GattDisconnectInstance,
+        GattCharacteristicsCount,
+        GattCharacteristics,
+        GattReadValue,
+        GattWriteValue,
+
+        DeviceEvent = 100,
+        GattServiceConnected,
+        GattServiceDisconnected,
+        GattServiceUpdated
+    };
+
+    static const uint16_t VERSION = 1;
+    static const int STALL_TIMEOUT_MS = 2000;
+    static const int FLUSH_INTERVAL_MS = 250;
+
+    static BtTrace* getInstance(QObject *parent = 0);
+    static const char* functionName(int function);
+
+    // cheap check for the BtApi wrappers
+    static bool isActive() { return _mode != Off; }
+    static Mode mode() { return _mode; }
+
+    void startFromEnvironment();
+
+    Q_INVOKABLE bool startRecording(const QString &path);
+    Q_INVOKABLE void stopRecording();
+    Q_INVOKABLE bool startReplay(const QString &path, bool realtime = true);
+    Q_INVOKABLE void stopReplay();
+
+    // microseconds since recording or replay started
+    qint64 nowUs() const;
+
+    // recording
+    void recordCall(Function function, const QByteArray &key, qint64 startUs, qint64 ret, int err, const QByteArray &out = QByteArray());
+    void recordCallback(Function function, const QByteArray &payload);
+
+    // replay - returns false when the log has no further call matching
+    // function and key; errno is set to the recorded value
+    bool replayCall(Function function, const QByteArray &key, qint64 &ret, QByteArray *out = 0);
+
+    // userData handed to bt_gatt_connect_service() at record time -> now
+    void mapUserData(quint64 recorded, void *live);
+
+    // the callbacks to register with btapi: while recording they log each
+    // callback before passing it on, in replay the log is delivered to them
+    DeviceCallback traceDeviceCallback(DeviceCallback callback);
+    bt_gatt_callbacks_t* traceGattCallbacks(bt_gatt_callbacks_t *callbacks);
+
+    // call keys
+    static QByteArray key(qint64 value);
+    static QByteArray key(qint64 first, qint64 second);
+    static QByteArray key(const char *text);
+    static QByteArray key(const char *first, const char *second);
+
+    void logStatistics() const;
+
+private slots:
+    void pumpCallbacks();
+    void replayStalled();
+    void flushRecording();
+
+private:
+    BtTrace(QObject *parent = 0);
+    virtual ~BtTrace();
+
+    struct Record {
+        Record() : kind(Call), function(0), timeUs(0), durationUs(0), ret(0), err(0), callsBefore(0) {}
+        quint8 kind;
+        quint16 function;
+        qint64 timeUs;
+        qint64 durationUs;
+        qint64 ret;
+        qint32 err;
+        QByteArray key;
+        QByteArray out;
+        int callsBefore;
+    };
+
+    void appendRecord(const Record &record);
+    void flushLocked();
+    bool loadLog(const QByteArray &log);
+    void dispatch(const Record &record);
+    void schedulePump();
+
+    static BtTrace *_instance;
+    static volatile Mode _mode;
+
+    mutable QMutex _mutex;
+    QElapsedTimer _clock;
+
+    // recording
+    QFile _file;
+    QByteArray _buffer;
+    QTimer _flushTimer;
+    quint64 _recordedCalls;
+    quint64 _recordedCallbacks;
+
+    // replay
+    QVector<Record> _records;
+    QHash<QByteArray, QQueue<int> > _calls;
+    QVector<int> _callbacks;
+    int _nextCallback;
+    int _replayedCalls;
+    int _divergences;
+    bool _realtime;
+    QTimer _pumpTimer;
+    QTimer _stallTimer;
+    QHash<quint64, void*> _userData;
+    qint64 _recordedDurationUs;
+
+    DeviceCallback _deviceCallback;
+    bt_gatt_callbacks_t *_gattCallbacks;
+};
+
+#endif // ifndef BTTRACE_H
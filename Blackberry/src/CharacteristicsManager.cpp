@@ -15,6 +15,11 @@
  */
 
 #include "CharacteristicsManager.hpp"
+#include "SignalCoalescer.hpp"
+#include "BtApi.hpp"
+#include "GattScheduler.hpp"
+
+#include <unistd.h>
 
 CharacteristicsManager* CharacteristicsManager::_instance;
 
@@ -36,6 +41,25 @@ QString CharacteristicsManager::KEY_CHARACTERISTIC_PROP_EXT_PROP = "characterist
 
 static CharacteristicsManager *thisInstancCallbackHook = NULL;
 
+// reconnect backoff: doubling from the base up to the cap, each delay
+// jittered over its upper half so that several apps don't retry in lockstep
+static const int RECONNECT_BASE_MS = 250;
+static const int RECONNECT_MAX_MS = 8000;
+static const int MAX_RECONNECT_ATTEMPTS = 6;
+
+// how long a characteristic read may queue before it is given up on
+static const int READ_DEADLINE_MS = 5000;
+
+// bt_gatt_characteristics() answers EBUSY for a while after connecting;
+// retried this many times, the delay doubling from the base
+static const int ENUMERATE_BUSY_RETRIES = 5;
+static const int ENUMERATE_BUSY_BASE_MS = 10;
+
+static bool isLinkLoss(int err)
+{
+    return (err == ENOTCONN) || (err == ECONNRESET) || (err == ECONNABORTED) || (err == ETIMEDOUT) || (err == EHOSTDOWN);
+}
+
 void gattServiceConnected(const char *bdaddr, const char *service, int instance, int err, uint16_t connInt, uint16_t latency, uint16_t superTimeout, void *userData)
 {
     if (thisInstancCallbackHook) {
@@ -62,19 +86,18 @@ bt_gatt_callbacks_t gattCallbacks = { gattServiceConnected, gattServiceDisconnec
 CharacteristicsManager::CharacteristicsManager(QObject *parent) :
         QObject(parent), _serviceUuid(QString("")), _serviceDescription(QString("")), _model(
                 new GroupDataModel(QStringList() << KEY_CHARACTERISTIC_UUID << KEY_CHARACTERISTIC_DESCRIPTION << KEY_CHARACTERISTIC_HANDLE << KEY_CHARACTERISTIC_VALUEHANDLE, this)), _selectedServiceInstance(
-                0)
+                0), _gattInitialised(false), _sessionActive(false), _enumerated(false), _nextCharacteristic(0), _reconnectAttempt(0), _linksLost(0), _reconnectAttempts(
+                0), _reconnects(0), _abandoned(0), _recoveryMs(0), _maxRecoveryMs(0), _salvagedCharacteristics(0), _salvagedEnumerations(0)
 {
     qRegisterMetaType<CharacteristicsList_t>("CharacteristicsList");
     qRegisterMetaType<DescriptorList_t>("DescriptorList");
     qRegisterMetaType<uint16_t>("uint16_t");
 
-    createWellKnownCharacteristicsList();
-    createWellKnownDescriptorList();
-
     _model->setSortingKeys(QStringList() << KEY_CHARACTERISTIC_UUID << KEY_CHARACTERISTIC_HANDLE);
     _model->setGrouping(ItemGrouping::None);
 
-    initialiseGatt();
+    // the well-known lists and bt_gatt_init() are deferred until a service is
+    // opened - neither is needed for the first screen
 
     QObject::connect(this, SIGNAL(gattServiceConnected(QString, QString, int, int, uint16_t, uint16_t, uint16_t, void *)), this,
             SLOT(handleGattServiceConnected(QString, QString, int, int, uint16_t, uint16_t, uint16_t, void *)));
@@ -84,10 +107,14 @@ CharacteristicsManager::CharacteristicsManager(QObject *parent) :
     QObject::connect(this, SIGNAL(gattServiceUpdated(QString, int, uint16_t, uint16_t, uint16_t, void *)), this, SLOT(handleGattServiceUpdated(QString, int, uint16_t, uint16_t, uint16_t, void *)));
 
     QObject::connect(ServicesManager::getInstance(), SIGNAL(serviceSelected(const QString)), this, SLOT(serviceSelected(const QString)));
+
+    _reconnectTimer.setSingleShot(true);
+    QObject::connect(&_reconnectTimer, SIGNAL(timeout()), this, SLOT(reconnect()));
 }
 
 CharacteristicsManager::~CharacteristicsManager()
 {
+    logReconnectStatistics();
     terminateGatt();
     _instance = 0;
 }
@@ -101,19 +128,53 @@ CharacteristicsManager* CharacteristicsManager::getInstance(QObject *parent)
     return _instance;
 }
 
+int CharacteristicsManager::enumerateCharacteristics(int instance, bt_gatt_characteristic_t *characteristics, int size)
+{
+    int number = 0;
+    for (int retry = 0; ; retry++) {
+        number = BtApi::gatt_characteristics(instance, characteristics, size);
+        if ((number != -1) || (errno != EBUSY) || (retry == ENUMERATE_BUSY_RETRIES)) {
+            return number;
+        }
+        usleep((ENUMERATE_BUSY_BASE_MS << retry) * 1000);
+    }
+}
+
 void CharacteristicsManager::initialiseGatt()
 {
+    if (_gattInitialised) {
+        return;
+    }
+
+    qDebug() << "XXXX CharacteristicsManager::initialiseGatt()" << endl;
+
     thisInstancCallbackHook = this;
-    bt_gatt_init(&gattCallbacks);
+    BtApi::gatt_init(&gattCallbacks);
+    _gattInitialised = true;
 }
 
 void CharacteristicsManager::terminateGatt()
 {
-    bt_gatt_deinit();
+    if (!_gattInitialised) {
+        return;
+    }
+
+    BtApi::gatt_deinit();
     thisInstancCallbackHook = NULL;
+    _gattInitialised = false;
+}
+
+void CharacteristicsManager::ensureWellKnownLists()
+{
+    if (_wellKnownCharacteristics.isEmpty()) {
+        createWellKnownCharacteristicsList();
+    }
+    if (_wellKnownDescriptors.isEmpty()) {
+        createWellKnownDescriptorList();
+    }
 }
 
-void CharacteristicsManager::connectToSelectedService(const QString &serviceUuid)
+bool CharacteristicsManager::connectToSelectedService(const QString &serviceUuid)
 {
     bool ok = false;
 
@@ -126,10 +187,12 @@ void CharacteristicsManager::connectToSelectedService(const QString &serviceUuid
     conParm.latency = 0;
     conParm.superTimeout = 50;
 
+    initialiseGatt();
+
     errno= 0;
     if (!_selectedServiceInstance) {
         qDebug() << "XXXX CharacteristicsManager::connectToSelectedService() - calling bt_gatt_connect_service()" << endl;
-        ok = (bt_gatt_connect_service(ServicesManager::getInstance()->peripheralAddress().toAscii().constData(), serviceUuid.toAscii().constData(), NULL, &conParm, this) == EOK);
+        ok = (BtApi::gatt_connect_service(_sessionAddress.toAscii().constData(), serviceUuid.toAscii().constData(), NULL, &conParm, this) == EOK);
         emit scanStarted(ServicesManager::getInstance()->peripheralName(), serviceDescription());
 
         if (ok) {
@@ -140,6 +203,8 @@ void CharacteristicsManager::connectToSelectedService(const QString &serviceUuid
     } else {
         qDebug() << "XXXX CharacteristicsManager::connectToSelectedService() - invalid service instance" << endl;
     }
+
+    return ok;
 }
 
 void CharacteristicsManager::disconnectFromSelectedService()
@@ -147,7 +212,7 @@ void CharacteristicsManager::disconnectFromSelectedService()
     bool ok = false;
     errno= 0;
     if (_selectedServiceInstance) {
-        ok = (bt_gatt_disconnect_instance(_selectedServiceInstance) == EOK);
+        ok = (BtApi::gatt_disconnect_instance(_selectedServiceInstance) == EOK);
         if (ok) {
             qDebug() << "XXXX CharacteristicsManager::disconnectFromSelectedService() - disconnected OK" << endl;
         } else {
@@ -184,78 +249,239 @@ void CharacteristicsManager::handleGattServiceConnected(const QString &bdaddr, c
     Q_UNUSED(connInt)
     Q_UNUSED(latency)
     Q_UNUSED(superTimeout)
-    Q_UNUSED(userData)
+
+    if (userData != this) {
+        // not one of ours - DeviceCrawler shares the same GATT callbacks
+        return;
+    }
 
     qDebug() << "XXXX CharacteristicsManager::handleGattServiceConnected() - " << instance << ", " << bdaddr << ", " << service << endl;
 
     emit scanStopped();
 
+    if (!_sessionActive) {
+        // the sheet was closed while the connect was on its way
+        if (err == EOK) {
+            BtApi::gatt_disconnect_instance(instance);
+        }
+        return;
+    }
+
     if (err == EOK) {
         _selectedServiceInstance = instance;
+
+        if (_reconnectAttempt > 0) {
+            const qint64 recoveryMs = _linkLostTimer.elapsed();
+            qDebug() << "XXXX CharacteristicsManager::handleGattServiceConnected() - reconnected after" << _reconnectAttempt << "attempts," << recoveryMs << "ms, resuming at characteristic" << _nextCharacteristic << endl;
+            _reconnects++;
+            _recoveryMs += recoveryMs;
+            _maxRecoveryMs = qMax(_maxRecoveryMs, recoveryMs);
+            _reconnectAttempt = 0;
+        }
+
         emit selectedServiceConnected();
+        runSession();
+    } else if (_reconnectAttempt > 0) {
+        qDebug() << "XXXX CharacteristicsManager::handleGattServiceConnected() - reconnect attempt" << _reconnectAttempt << "failed - err=" << strerror(err) << endl;
+        scheduleReconnect();
+    } else {
+        _selectedServiceInstance = 0;
+        _sessionActive = false;
+        qDebug() << "XXXX CharacteristicsManager::handleGattServiceConnected() - not connected - err=" << strerror(err) << endl;
+        QString errorMessage = QString("Unable to connect to selected Bluetooth LE service (\"%1\") ... please ensure the device is powered on and try again").arg(strerror(err));
 
-        int numCharacteristics = bt_gatt_characteristics_count(instance);
-        if (numCharacteristics > -1) {
-            qDebug() << "XXXX CharacteristicsManager::handleGattServiceConnected() - #characteristics=" << numCharacteristics << endl;
+        bb::system::SystemToast toast;
+        toast.setBody(errorMessage);
+        toast.setPosition(bb::system::SystemUiPosition::MiddleCenter);
+        toast.exec();
+
+        emit connectionError(errorMessage);
+    }
+}
 
-            bt_gatt_characteristic_t *characteristicList;
+void CharacteristicsManager::runSession()
+{
+    const int instance = _selectedServiceInstance;
 
-            characteristicList = (bt_gatt_characteristic_t*) malloc(numCharacteristics * sizeof(bt_gatt_characteristic_t));
-            if (!characteristicList) {
-                qDebug() << "XXXX CharacteristicsManager::handleGattServiceConnected() - malloc fail" << endl;
+    if (!_enumerated) {
+        int numCharacteristics = BtApi::gatt_characteristics_count(instance);
+        if (numCharacteristics < 0) {
+            if (isLinkLoss(errno)) {
+                linkLost();
                 return;
             }
+            qDebug() << "XXXX CharacteristicsManager::runSession() Failed to determine number of characteristics" << endl;
+            qDebug() << "XXXX CharacteristicsManager::runSession() errno=" << errno<< endl;
+            qDebug() << "XXXX CharacteristicsManager::runSession() errno=" << strerror(errno) << endl;
+            _sessionActive = false;
+            return;
+        }
 
-            /* BEGIN WORKAROUND - Temporary fix to address race condition */
+        qDebug() << "XXXX CharacteristicsManager::runSession() - #characteristics=" << numCharacteristics << endl;
 
-            int number = 0;
-            do {
-                number = bt_gatt_characteristics(instance, characteristicList, numCharacteristics);
-            } while ((number == -1) && (errno== EBUSY));
+        _characteristics.resize(numCharacteristics);
 
-            int characteristicListSize = number;
+        /* BEGIN WORKAROUND - Temporary fix to address race condition */
 
-            qDebug() << "XXXX CharacteristicsManager::handleGattServiceConnected() - Characteristics:" << endl;
-            for (int i = 0; i < characteristicListSize; i++) {
-                qDebug() << "XXXX characteristic name: " << characteristicDescription(characteristicList[i].uuid) << endl;
-                qDebug() << "XXXX characteristic UUID: " << characteristicList[i].uuid << endl;
-                qDebug() << "XXXX characteristic handle: " << characteristicList[i].handle << endl;
-                qDebug() << "XXXX characteristic value_handle: " << characteristicList[i].value_handle << endl;
-                qDebug() << "XXXX characteristic properties: " << characteristicList[i].properties << endl;
-                addCharacteristic(characteristicList[i].uuid, characteristicList[i].handle, characteristicList[i].value_handle, characteristicList[i].properties);
-            }
+        int number = enumerateCharacteristics(instance, _characteristics.data(), numCharacteristics);
 
-            /* END WORKAROUND */
+        /* END WORKAROUND */
 
-            if (characteristicList) {
-                free(characteristicList);
-                characteristicList = NULL;
+        if (number < 0) {
+            _characteristics.clear();
+            if (isLinkLoss(errno)) {
+                linkLost();
+                return;
             }
+            number = 0;
+        }
 
-            disconnectFromSelectedService();
+        _characteristics.resize(qMin(number, numCharacteristics));
+        _enumerated = true;
+    }
 
-        } else {
-            qDebug() << "XXXX CharacteristicsManager::handleGattServiceConnected() Failed to determine number of characteristics" << endl;
-            qDebug() << "XXXX CharacteristicsManager::handleGattServiceConnected() errno=" << errno<< endl;
-            qDebug() << "XXXX CharacteristicsManager::handleGattServiceConnected() errno=" << strerror(errno) << endl;
+    qDebug() << "XXXX CharacteristicsManager::runSession() - Characteristics:" << endl;
+    while (_nextCharacteristic < _characteristics.size()) {
+        const bt_gatt_characteristic_t &characteristic = _characteristics.at(_nextCharacteristic);
+        qDebug() << "XXXX characteristic name: " << characteristicDescription(characteristic.uuid) << endl;
+        qDebug() << "XXXX characteristic UUID: " << characteristic.uuid << endl;
+        qDebug() << "XXXX characteristic handle: " << characteristic.handle << endl;
+        qDebug() << "XXXX characteristic value_handle: " << characteristic.value_handle << endl;
+        qDebug() << "XXXX characteristic properties: " << characteristic.properties << endl;
+
+        bool lost = false;
+        const QString hexValue = getCharacteristicHexValue(characteristic.value_handle, &lost);
+        if (lost) {
+            linkLost();
+            return;
         }
-    } else {
+        addCharacteristic(characteristic.uuid, characteristic.handle, characteristic.value_handle, characteristic.properties, hexValue);
+        _nextCharacteristic++;
+    }
+
+    _sessionActive = false;
+    disconnectFromSelectedService();
+}
+
+void CharacteristicsManager::linkLost()
+{
+    qDebug() << "XXXX CharacteristicsManager::linkLost() - lost instance" << _selectedServiceInstance << "at characteristic" << _nextCharacteristic << "of" << _characteristics.size() << "- errno=" << strerror(errno) << endl;
+
+    if (_selectedServiceInstance) {
+        BtApi::gatt_disconnect_instance(_selectedServiceInstance);
         _selectedServiceInstance = 0;
-        qDebug() << "XXXX CharacteristicsManager::handleGattServiceConnected() - not connected - err=" << strerror(err) << endl;
-        QString errorMessage = QString("Unable to connect to selected Bluetooth LE service (\"%1\") ... please ensure the device is powered on and try again").arg(strerror(err));
+    }
 
-        bb::system::SystemToast toast;
-        toast.setBody(errorMessage);
-        toast.setPosition(bb::system::SystemUiPosition::MiddleCenter);
-        toast.exec();
+    if (_reconnectAttempt == 0) {
+        _linkLostTimer.start();
+        _linksLost++;
+        // everything done so far is kept, the reconnect picks up from here
+        _salvagedCharacteristics += _nextCharacteristic;
+        if (_enumerated) {
+            _salvagedEnumerations++;
+        }
+    }
 
-        emit connectionError(errorMessage);
+    scheduleReconnect();
+}
+
+void CharacteristicsManager::scheduleReconnect()
+{
+    if (_reconnectAttempt >= MAX_RECONNECT_ATTEMPTS) {
+        giveUpReconnecting();
+        return;
+    }
+
+    const int ceiling = qMin(RECONNECT_MAX_MS, RECONNECT_BASE_MS << _reconnectAttempt);
+    const int delay = ceiling / 2 + qrand() % (ceiling / 2 + 1);
+    _reconnectAttempt++;
+
+    qDebug() << "XXXX CharacteristicsManager::scheduleReconnect() - attempt" << _reconnectAttempt << "in" << delay << "ms" << endl;
+    _reconnectTimer.start(delay);
+}
+
+void CharacteristicsManager::reconnect()
+{
+    if (!_sessionActive) {
+        return;
+    }
+
+    _reconnectAttempts++;
+    if (!connectToSelectedService(_serviceUuid)) {
+        scheduleReconnect();
+    }
+}
+
+void CharacteristicsManager::endSession()
+{
+    if (!_sessionActive) {
+        return;
+    }
+
+    qDebug() << "XXXX CharacteristicsManager::endSession() - at characteristic" << _nextCharacteristic << "of" << _characteristics.size() << endl;
+
+    _reconnectTimer.stop();
+    _reconnectAttempt = 0;
+    _sessionActive = false;
+    if (_selectedServiceInstance) {
+        disconnectFromSelectedService();
+    }
+}
+
+void CharacteristicsManager::giveUpReconnecting()
+{
+    qDebug() << "XXXX CharacteristicsManager::giveUpReconnecting() - no connection after" << _reconnectAttempt << "attempts" << endl;
+
+    _abandoned++;
+    _sessionActive = false;
+    _reconnectAttempt = 0;
+    logReconnectStatistics();
+
+    emit scanStopped();
+    emit selectedServiceDisconnected();
+
+    QString errorMessage = QString("Lost the connection to the selected Bluetooth LE service ... please ensure the device is in range and try again");
+
+    bb::system::SystemToast toast;
+    toast.setBody(errorMessage);
+    toast.setPosition(bb::system::SystemUiPosition::MiddleCenter);
+    toast.exec();
+
+    emit connectionError(errorMessage);
+}
+
+QVariantMap CharacteristicsManager::reconnectStatistics() const
+{
+    QVariantMap stats;
+
+    stats["linksLost"] = _linksLost;
+    stats["reconnectAttempts"] = _reconnectAttempts;
+    stats["reconnects"] = _reconnects;
+    stats["abandoned"] = _abandoned;
+    stats["meanRecoveryMs"] = _reconnects ? double(_recoveryMs) / _reconnects : 0.0;
+    stats["maxRecoveryMs"] = _maxRecoveryMs;
+    stats["salvagedCharacteristics"] = _salvagedCharacteristics;
+    stats["salvagedEnumerations"] = _salvagedEnumerations;
+
+    return stats;
+}
+
+void CharacteristicsManager::logReconnectStatistics() const
+{
+    if (_linksLost == 0) {
+        return;
     }
+
+    qDebug() << "XXXX CharacteristicsManager - links lost" << _linksLost << "reconnect attempts" << _reconnectAttempts << "reconnected" << _reconnects
+             << "abandoned" << _abandoned << "recovery mean" << (_reconnects ? _recoveryMs / _reconnects : 0) << "ms max" << _maxRecoveryMs << "ms"
+             << "salvaged" << _salvagedCharacteristics << "characteristics and" << _salvagedEnumerations << "enumerations" << endl;
 }
 
 void CharacteristicsManager::handleGattServiceDisconnected(const QString &bdaddr, const QString &service, int instance, int reason, void *userData)
 {
-    Q_UNUSED(userData)
+    if (userData != this) {
+        return;
+    }
 
     emit scanStopped();
 
@@ -269,7 +495,12 @@ void CharacteristicsManager::handleGattServiceDisconnected(const QString &bdaddr
     if (instance == _selectedServiceInstance) {
         qDebug() << "XXXX CharacteristicsManager::handleGattServiceDisconnected() - selected Service disconnected" << endl;
         _selectedServiceInstance = 0;
-        emit selectedServiceDisconnected();
+        if (_sessionActive) {
+            // dropped before we were done with it
+            linkLost();
+        } else {
+            emit selectedServiceDisconnected();
+        }
     }
 }
 
@@ -295,10 +526,15 @@ void CharacteristicsManager::setServiceUuid(const QString &uuid)
 {
     _serviceUuid = uuid;
 
-    emit serviceUuidChanged();
+    SignalCoalescer::getInstance()->post(this, "serviceUuidChanged");
 }
 
 void CharacteristicsManager::addCharacteristic(const QString &uuid, uint16_t handle, uint16_t valueHandle, bt_gatt_char_prop_mask properties)
+{
+    addCharacteristic(uuid, handle, valueHandle, properties, getCharacteristicHexValue(valueHandle));
+}
+
+void CharacteristicsManager::addCharacteristic(const QString &uuid, uint16_t handle, uint16_t valueHandle, bt_gatt_char_prop_mask properties, const QString &hexValue)
 {
     QVariantMap map;
 
@@ -306,9 +542,7 @@ void CharacteristicsManager::addCharacteristic(const QString &uuid, uint16_t han
     map[KEY_CHARACTERISTIC_DESCRIPTION] = characteristicDescription(uuid);
     map[KEY_CHARACTERISTIC_HANDLE] = handle;
     map[KEY_CHARACTERISTIC_VALUEHANDLE] = valueHandle;
-
-    QString hex_value = getCharacteristicHexValue(valueHandle);
-    map[KEY_CHARACTERISTIC_HEX_VALUE] = hex_value;
+    map[KEY_CHARACTERISTIC_HEX_VALUE] = hexValue;
 
 
     if (properties & BT_GATT_CHARACTERISTIC_PROP_BROADCAST) {
@@ -391,7 +625,7 @@ void CharacteristicsManager::setServiceDescription(const QString &description)
 {
     _serviceDescription = description;
 
-    emit serviceDescriptionChanged();
+    SignalCoalescer::getInstance()->post(this, "serviceDescriptionChanged");
 }
 
 QString CharacteristicsManager::serviceUuid() const
@@ -416,22 +650,35 @@ void CharacteristicsManager::reset()
 
     _model->clear();
 
-    emit serviceUuidChanged();
-    emit serviceDescriptionChanged();
+    SignalCoalescer::getInstance()->post(this, "serviceUuidChanged");
+    SignalCoalescer::getInstance()->post(this, "serviceDescriptionChanged");
 }
 
 void CharacteristicsManager::serviceSelected(const QString &uuid)
 {
+    // a new service starts a new session, whatever was left of the last one
+    _reconnectTimer.stop();
+    _reconnectAttempt = 0;
+    _sessionActive = true;
+    _sessionAddress = ServicesManager::getInstance()->peripheralAddress();
+    _enumerated = false;
+    _characteristics.clear();
+    _nextCharacteristic = 0;
+
     _model->clear();
 
     _serviceUuid = uuid;
     _serviceDescription = ServicesManager::getInstance()->serviceDescription(uuid);
 
-    connectToSelectedService(uuid);
+    if (!connectToSelectedService(uuid)) {
+        _sessionActive = false;
+    }
 }
 
 QString CharacteristicsManager::characteristicDescription(const QString &uuid)
 {
+    ensureWellKnownLists();
+
     QListIterator<CharacteristicsItem_t> cit(_wellKnownCharacteristics);
 
     while (cit.hasNext()) {
@@ -447,6 +694,8 @@ QString CharacteristicsManager::characteristicDescription(const QString &uuid)
 
 QString CharacteristicsManager::descriptorDescription(const QString &uuid)
 {
+    ensureWellKnownLists();
+
     QListIterator<DescriptorItem_t> dit(_wellKnownDescriptors);
 
     while (dit.hasNext()) {
@@ -462,6 +711,8 @@ QString CharacteristicsManager::descriptorDescription(const QString &uuid)
 
 bool CharacteristicsManager::isWellKnownCharacteristic(const QString &uuid)
 {
+    ensureWellKnownLists();
+
     QListIterator<CharacteristicsItem_t> cit(_wellKnownCharacteristics);
 
     while (cit.hasNext()) {
@@ -477,6 +728,8 @@ bool CharacteristicsManager::isWellKnownCharacteristic(const QString &uuid)
 
 bool CharacteristicsManager::isWellKnownDescriptor(const QString &uuid)
 {
+    ensureWellKnownLists();
+
     QListIterator<DescriptorItem_t> dit(_wellKnownDescriptors);
 
     while (dit.hasNext()) {
@@ -808,21 +1061,24 @@ void CharacteristicsManager::createWellKnownDescriptorList()
     _wellKnownDescriptors.append(di);
 }
 
-QString CharacteristicsManager::getCharacteristicHexValue(uint16_t handle)
+QString CharacteristicsManager::getCharacteristicHexValue(uint16_t handle, bool *linkLost)
 {
-    int max_len = 256;
+    const int max_len = 256;
     QString hex_value("");
-    uint8_t *characteristic_bytes;
-    characteristic_bytes = (uint8_t*) calloc(max_len, sizeof(uint8_t));
-    errno= 0;
-    int bytes_read = bt_gatt_read_value(_selectedServiceInstance, handle, 0, characteristic_bytes, max_len, 0);
-    if (bytes_read < 0) {
-        qDebug() << "XXXX bt_gatt_read_value - errno=(" << errno<< ") :" << strerror(errno);
+
+    // the user is looking at this service, so it goes ahead of any crawl
+    GattOperation read = GattOperation::read(_sessionAddress, _selectedServiceInstance, handle, max_len, GattOperation::Interactive, this);
+    read.deadlineMs = READ_DEADLINE_MS;
+    read = GattScheduler::getInstance()->execute(read);
+
+    if (read.result < 0) {
+        if (linkLost && isLinkLoss(read.error)) {
+            *linkLost = true;
+        }
+        qDebug() << "XXXX bt_gatt_read_value - errno=(" << read.error << ") :" << strerror(read.error);
+        errno = read.error;
     } else {
-        QByteArray ba = QByteArray::fromRawData(reinterpret_cast<const char *>(characteristic_bytes), max_len);
-        hex_value = QString::fromAscii(ba.toHex());
-        hex_value = hex_value.mid(0, bytes_read * 2);
+        hex_value = QString::fromAscii(read.data.toHex());
     }
-    free(characteristic_bytes);
     return hex_value;
 }
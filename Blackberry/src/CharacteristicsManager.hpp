@@ -22,8 +22,11 @@
 #include <QObject>
 #include <QtCore/QString>
 #include <QtCore/QDebug>
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QMap>
+#include <QtCore/QTimer>
 #include <QtCore/QVariant>
+#include <QtCore/QVector>
 #include <bb/cascades/GroupDataModel>
 #include <bb/system/SystemDialog>
 #include <bb/system/SystemToast>
@@ -77,6 +80,19 @@ public:
 	bool isWellKnownDescriptor(const QString &uuid);
 	bool matchesWellKnownUuid(const QString &wellKnownUuid, const QString &uuidToCheck);
 
+	// bt_gatt_init() on first use, safe to call repeatedly
+	void initialiseGatt();
+
+	// bt_gatt_characteristics(), retried a bounded number of times while the
+	// stack answers EBUSY; -1 with errno set once it gives up
+	static int enumerateCharacteristics(int instance, bt_gatt_characteristic_t *characteristics, int size);
+
+	// reconnects after a dropped link and what they salvaged, over all sessions
+	Q_INVOKABLE QVariantMap reconnectStatistics() const;
+	// the characteristics sheet was closed: no more reconnects for this session
+	Q_INVOKABLE void endSession();
+	void logReconnectStatistics() const;
+
     static QString KEY_CHARACTERISTIC_UUID;
     static QString KEY_CHARACTERISTIC_HANDLE;
     static QString KEY_CHARACTERISTIC_VALUEHANDLE;
@@ -117,10 +133,15 @@ private:
 
 	void createWellKnownCharacteristicsList();
 	void createWellKnownDescriptorList();
-	void initialiseGatt();
+	void ensureWellKnownLists();
 	void terminateGatt();
-	void connectToSelectedService(const QString &serviceUuid);
+	bool connectToSelectedService(const QString &serviceUuid);
 	void disconnectFromSelectedService();
+	void runSession();
+	void linkLost();
+	void scheduleReconnect();
+	void giveUpReconnecting();
+	void addCharacteristic(const QString &uuid, uint16_t handle, uint16_t valueHandle, bt_gatt_char_prop_mask properties, const QString &hexValue);
 
 	static CharacteristicsManager* _instance;
 
@@ -130,7 +151,29 @@ private:
     DescriptorList_t _wellKnownDescriptors;
     GroupDataModel* _model;
     int _selectedServiceInstance;
-    QString getCharacteristicHexValue(uint16_t handle);
+    bool _gattInitialised;
+    QString getCharacteristicHexValue(uint16_t handle, bool *linkLost = 0);
+
+    // the service being explored - survives a dropped link so that a
+    // reconnect carries on with the characteristic it stopped at
+    bool _sessionActive;
+    // taken when the session starts, the selected device may change meanwhile
+    QString _sessionAddress;
+    bool _enumerated;
+    QVector<bt_gatt_characteristic_t> _characteristics;
+    int _nextCharacteristic;
+    int _reconnectAttempt;
+    QTimer _reconnectTimer;
+    QElapsedTimer _linkLostTimer;
+
+    int _linksLost;
+    int _reconnectAttempts;
+    int _reconnects;
+    int _abandoned;
+    qint64 _recoveryMs;
+    qint64 _maxRecoveryMs;
+    int _salvagedCharacteristics;
+    int _salvagedEnumerations;
 
 signals:
 	void serviceUuidChanged();
@@ -163,6 +206,7 @@ public slots:
 
 private slots:
 	void serviceSelected(const QString &serviceUuid);
+	void reconnect();
 	void handleGattServiceConnected(
 			const QString &bdaddr, const QString &service, int instance,
 			int err, uint16_t connInt, uint16_t latency,
@@ -126,6 +126,16 @@ QString DataContainer::getDeviceAddr(int device_inx) {
     }
 }
 
+int DataContainer::getDeviceIndex(const QString &device_addr) {
+    // bounded by the list, not _device_count: a scan looks devices up before
+    // it sets the count
+    for (int i = 0; i < _list_of_devices.size(); i++) {
+        if (_list_of_devices.at(i).value("device_addr").toString().compare(device_addr, Qt::CaseInsensitive) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
 
 int DataContainer::getDeviceCount() {
     return _device_count;
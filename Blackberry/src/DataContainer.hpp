@@ -59,6 +59,7 @@ public:
 	void clearDeviceList();
 	Q_INVOKABLE	QString getDeviceName(int device_inx);
 	Q_INVOKABLE	QString getDeviceAddr(int device_inx);
+	int getDeviceIndex(const QString &device_addr);
     Q_INVOKABLE int getDeviceCount();
 
 	bt_remote_device_t* getCurrentDevice();
@@ -0,0 +1,489 @@
+/*
+ * Copyright (c) 2011-2013 BlackBerry Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "DeviceCrawler.hpp"
+#include "BtApi.hpp"
+#include "ServicesManager.hpp"
+#include "CharacteristicsManager.hpp"
+#include "GattSnapshotCodec.hpp"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QRunnable>
+#include <QtCore/QThreadPool>
+#include <bb/system/SystemToast>
+
+DeviceCrawler* DeviceCrawler::_instance;
+
+DeviceCrawler::DeviceCrawler(QObject *parent)
+    : QObject(parent)
+    , _crawling(false)
+    , _exporting(false)
+    , _inFlight(0)
+    , _completed(0)
+    , _watchdog(new QTimer(this))
+{
+    _watchdog->setSingleShot(true);
+    _watchdog->setInterval(CRAWL_TIMEOUT_MS);
+
+    QObject::connect(_watchdog, SIGNAL(timeout()), this, SLOT(crawlTimedOut()));
+
+    // GATT callbacks are delivered through CharacteristicsManager; we only act on
+    // the ones whose userData identifies a connection we asked for.
+    CharacteristicsManager *cm = CharacteristicsManager::getInstance();
+
+    QObject::connect(cm, SIGNAL(gattServiceConnected(QString, QString, int, int, uint16_t, uint16_t, uint16_t, void *)), this,
+            SLOT(handleGattServiceConnected(QString, QString, int, int, uint16_t, uint16_t, uint16_t, void *)));
+
+    QObject::connect(cm, SIGNAL(gattServiceDisconnected(QString, QString, int, int, void *)), this,
+            SLOT(handleGattServiceDisconnected(QString, QString, int, int, void *)));
+
+    QObject::connect(GattScheduler::getInstance(), SIGNAL(finished(GattOperation)), this, SLOT(handleReadFinished(GattOperation)));
+}
+
+DeviceCrawler::~DeviceCrawler()
+{
+    qDeleteAll(_connects);
+    _instance = 0;
+}
+
+DeviceCrawler* DeviceCrawler::getInstance(QObject *parent)
+{
+    if (_instance == 0) {
+        _instance = new DeviceCrawler(parent);
+    }
+
+    return _instance;
+}
+
+bool DeviceCrawler::isCrawling() const
+{
+    return _crawling;
+}
+
+const GattDeviceSnapshot& DeviceCrawler::snapshot() const
+{
+    return _snapshot;
+}
+
+void DeviceCrawler::crawlDevice()
+{
+    if (_crawling) {
+        qDebug() << "XXXX DeviceCrawler::crawlDevice() - crawl already in progress" << endl;
+        return;
+    }
+
+    ServicesManager *sm = ServicesManager::getInstance();
+    QString address = sm->peripheralAddress();
+
+    if (address.isEmpty()) {
+        qDebug() << "XXXX DeviceCrawler::crawlDevice() - no device selected" << endl;
+        return;
+    }
+
+    bt_remote_device_t *remoteDevice = BtApi::rdev_get_device(address.toAscii().constData());
+    if (!remoteDevice) {
+        qDebug() << "XXXX DeviceCrawler::crawlDevice() - invalid remote device" << endl;
+        return;
+    }
+
+    _snapshot.clear();
+    _snapshot.address = address;
+    _snapshot.name = sm->peripheralName();
+    _snapshot.capturedAtMs = QDateTime::currentMSecsSinceEpoch();
+
+    _pendingServices.clear();
+    _openInstances.clear();
+    _inFlight = 0;
+    _completed = 0;
+
+    char **servicesArray = BtApi::rdev_get_services_gatt(remoteDevice);
+    if (servicesArray) {
+        for (int i = 0; servicesArray[i]; i++) {
+            GattServiceSnapshot service;
+            service.uuid = QString(servicesArray[i]);
+            _snapshot.services.append(service);
+            _pendingServices.enqueue(_snapshot.services.size() - 1);
+        }
+        BtApi::rdev_free_services(servicesArray);
+    } else {
+        qDebug() << "XXXX DeviceCrawler::crawlDevice() - unable to get service list - errno : " << strerror(errno) << endl;
+    }
+    BtApi::rdev_free(remoteDevice);
+
+    if (_snapshot.services.isEmpty()) {
+        qDebug() << "XXXX DeviceCrawler::crawlDevice() - nothing to crawl" << endl;
+        return;
+    }
+
+    qDebug() << "XXXX DeviceCrawler::crawlDevice() - crawling " << _snapshot.services.size() << " services on " << address << endl;
+
+    CharacteristicsManager::getInstance()->initialiseGatt();
+
+    _crawling = true;
+    _crawlTimer.start();
+    _watchdog->start();
+
+    emit crawlingChanged();
+    emit crawlStarted(address, _snapshot.services.size());
+
+    connectNextServices();
+}
+
+void DeviceCrawler::cancelCrawl()
+{
+    if (!_crawling) {
+        return;
+    }
+
+    qDebug() << "XXXX DeviceCrawler::cancelCrawl()" << endl;
+
+    while (!_pendingServices.isEmpty()) {
+        _snapshot.services[_pendingServices.dequeue()].connectError = ECANCELED;
+    }
+    foreach (ConnectRequest *request, _connects) {
+        if (!request->cancelled) {
+            _snapshot.services[request->service].connectError = ECANCELED;
+        }
+    }
+    finishCrawl();
+}
+
+void DeviceCrawler::connectNextServices()
+{
+    bt_gatt_conn_parm_t conParm;
+    conParm.minConn = 0x30;
+    conParm.maxConn = 0x50;
+    conParm.latency = 0;
+    conParm.superTimeout = 50;
+
+    const QByteArray address = _snapshot.address.toAscii();
+
+    while (_inFlight < CONNECT_WINDOW && !_pendingServices.isEmpty()) {
+        int index = _pendingServices.dequeue();
+        GattServiceSnapshot &service = _snapshot.services[index];
+
+        ConnectRequest *request = new ConnectRequest;
+        request->service = index;
+        request->cancelled = false;
+        request->timer.start();
+
+        errno = 0;
+        if (BtApi::gatt_connect_service(address.constData(), service.uuid.toAscii().constData(), NULL, &conParm, request) == EOK) {
+            _connects.insert(request);
+            _inFlight++;
+        } else {
+            qDebug() << "XXXX DeviceCrawler::connectNextServices() - connect request failed for " << service.uuid << " - errno=(" << errno << ") :" << strerror(errno) << endl;
+            service.connectError = (errno != 0) ? errno : EIO;
+            delete request;
+            _completed++;
+        }
+    }
+
+    // reads go through GattScheduler and answer later, so every connect
+    // having answered is not the end of the crawl
+    if (_inFlight == 0 && _pendingServices.isEmpty() && _pendingReads.isEmpty() && _readsOutstanding.isEmpty()) {
+        finishCrawl();
+    }
+}
+
+void DeviceCrawler::handleGattServiceConnected(const QString &bdaddr, const QString &service, int instance, int err, uint16_t connInt, uint16_t latency, uint16_t superTimeout, void *userData)
+{
+    Q_UNUSED(bdaddr)
+    Q_UNUSED(connInt)
+    Q_UNUSED(latency)
+    Q_UNUSED(superTimeout)
+
+    ConnectRequest *request = static_cast<ConnectRequest*>(userData);
+    if (!_connects.remove(request)) {
+        return;
+    }
+
+    const int index = request->service;
+    const bool cancelled = request->cancelled;
+    const qint64 connectMs = request->timer.elapsed();
+    delete request;
+
+    if (cancelled) {
+        // a late answer for a crawl that already timed out or was cancelled
+        qDebug() << "XXXX DeviceCrawler::handleGattServiceConnected() - " << service << " answered after the crawl" << endl;
+        if (err == EOK) {
+            BtApi::gatt_disconnect_instance(instance);
+        }
+        return;
+    }
+
+    GattServiceSnapshot &serviceSnapshot = _snapshot.services[index];
+    serviceSnapshot.connectMs = connectMs;
+    _inFlight--;
+    _completed++;
+
+    if (err == EOK) {
+        serviceSnapshot.instance = instance;
+        _openInstances.append(instance);
+        readService(index);
+    } else {
+        qDebug() << "XXXX DeviceCrawler::handleGattServiceConnected() - " << service << " not connected - err=" << strerror(err) << endl;
+        serviceSnapshot.connectError = err;
+        serviceDone(index);
+    }
+}
+
+void DeviceCrawler::serviceDone(int index)
+{
+    const GattServiceSnapshot &service = _snapshot.services.at(index);
+    emit serviceCrawled(service.uuid, service.characteristics.size(), service.connectMs, service.readMs);
+
+    // connectNextServices() decides whether anything is left
+    connectNextServices();
+}
+
+void DeviceCrawler::handleGattServiceDisconnected(const QString &bdaddr, const QString &service, int instance, int reason, void *userData)
+{
+    Q_UNUSED(bdaddr)
+    Q_UNUSED(userData)
+
+    // the request behind userData is gone once connected, only our open
+    // instances are in the list
+    if (_openInstances.removeAll(instance) > 0) {
+        qDebug() << "XXXX DeviceCrawler::handleGattServiceDisconnected() - " << service << " dropped - reason=" << strerror(reason) << endl;
+    }
+}
+
+void DeviceCrawler::crawlTimedOut()
+{
+    qDebug() << "XXXX DeviceCrawler::crawlTimedOut() - " << _completed << " of " << _snapshot.services.size() << " services done" << endl;
+
+    while (!_pendingServices.isEmpty()) {
+        _snapshot.services[_pendingServices.dequeue()].connectError = ETIMEDOUT;
+    }
+    foreach (ConnectRequest *request, _connects) {
+        if (!request->cancelled) {
+            _snapshot.services[request->service].connectError = ETIMEDOUT;
+        }
+    }
+    finishCrawl();
+}
+
+void DeviceCrawler::readService(int index)
+{
+    GattServiceSnapshot &service = _snapshot.services[index];
+    _readTimers[index].start();
+
+    errno = 0;
+    int numCharacteristics = BtApi::gatt_characteristics_count(service.instance);
+    if (numCharacteristics <= 0) {
+        qDebug() << "XXXX DeviceCrawler::readService() - no characteristics in " << service.uuid << endl;
+        if (numCharacteristics < 0) {
+            service.readError = (errno != 0) ? errno : EIO;
+        }
+        service.readMs = _readTimers.take(index).elapsed();
+        serviceDone(index);
+        return;
+    }
+
+    bt_gatt_characteristic_t *characteristicList = (bt_gatt_characteristic_t*) malloc(numCharacteristics * sizeof(bt_gatt_characteristic_t));
+    if (!characteristicList) {
+        qDebug() << "XXXX DeviceCrawler::readService() - malloc fail" << endl;
+        service.readMs = _readTimers.take(index).elapsed();
+        serviceDone(index);
+        return;
+    }
+
+    errno = 0;
+    int number = CharacteristicsManager::enumerateCharacteristics(service.instance, characteristicList, numCharacteristics);
+    if (number < 0) {
+        qDebug() << "XXXX DeviceCrawler::readService() - unable to list characteristics of " << service.uuid << " - errno=(" << errno << ") :" << strerror(errno) << endl;
+        service.readError = (errno != 0) ? errno : EIO;
+    }
+
+    GattScheduler *scheduler = GattScheduler::getInstance();
+    int queued = 0;
+
+    for (int i = 0; i < number; i++) {
+        GattCharacteristicSnapshot characteristic;
+        characteristic.uuid = QString(characteristicList[i].uuid);
+        characteristic.handle = characteristicList[i].handle;
+        characteristic.valueHandle = characteristicList[i].value_handle;
+        characteristic.properties = characteristicList[i].properties;
+        service.characteristics.append(characteristic);
+
+        if (characteristic.properties & BT_GATT_CHARACTERISTIC_PROP_READ) {
+            int id = scheduler->submit(GattOperation::read(_snapshot.address, service.instance, characteristic.valueHandle, MAX_VALUE_LENGTH, GattOperation::Background, this));
+            _pendingReads.insert(id, qMakePair(index, service.characteristics.size() - 1));
+            queued++;
+        }
+    }
+
+    free(characteristicList);
+
+    if (queued == 0) {
+        service.readMs = _readTimers.take(index).elapsed();
+        serviceDone(index);
+    } else {
+        _readsOutstanding[index] = queued;
+    }
+}
+
+void DeviceCrawler::handleReadFinished(const GattOperation &operation)
+{
+    if (operation.owner != this || !_pendingReads.contains(operation.id)) {
+        return;
+    }
+
+    const QPair<int, int> target = _pendingReads.take(operation.id);
+    GattServiceSnapshot &service = _snapshot.services[target.first];
+    GattCharacteristicSnapshot &characteristic = service.characteristics[target.second];
+
+    if (operation.result < 0) {
+        characteristic.readError = operation.error;
+    } else {
+        characteristic.value = operation.data;
+    }
+
+    if (--_readsOutstanding[target.first] == 0) {
+        _readsOutstanding.remove(target.first);
+        service.readMs = _readTimers.take(target.first).elapsed();
+        serviceDone(target.first);
+    }
+}
+
+void DeviceCrawler::finishCrawl()
+{
+    _watchdog->stop();
+
+    // reads still queued are of no use any more; one already with the stack
+    // finishes and is ignored
+    _pendingReads.clear();
+    _readsOutstanding.clear();
+    _readTimers.clear();
+    GattScheduler::getInstance()->cancelAll(this);
+
+    for (int i = 0; i < _openInstances.size(); i++) {
+        errno = 0;
+        if (BtApi::gatt_disconnect_instance(_openInstances.at(i)) != EOK) {
+            qDebug() << "XXXX DeviceCrawler::finishCrawl() - disconnect failed - errno=(" << errno << ") :" << strerror(errno) << endl;
+        }
+    }
+    _openInstances.clear();
+    _pendingServices.clear();
+
+    // connects still with the stack are kept until they answer, so the
+    // instance they open can be closed again
+    foreach (ConnectRequest *request, _connects) {
+        request->cancelled = true;
+    }
+    _inFlight = 0;
+
+    _snapshot.totalMs = _crawlTimer.elapsed();
+
+    int characteristicCount = 0;
+    qDebug() << "XXXX DeviceCrawler::finishCrawl() - " << _snapshot.address << " crawled in " << _snapshot.totalMs << "ms" << endl;
+    for (int i = 0; i < _snapshot.services.size(); i++) {
+        const GattServiceSnapshot &service = _snapshot.services.at(i);
+        characteristicCount += service.characteristics.size();
+        qDebug() << "XXXX    " << service.uuid << " characteristics=" << service.characteristics.size()
+                 << " connect=" << service.connectMs << "ms read=" << service.readMs << "ms err=" << service.connectError << "/" << service.readError << endl;
+    }
+
+    _crawling = false;
+    emit crawlingChanged();
+    emit crawlFinished(_snapshot.address, _snapshot.services.size(), characteristicCount, _snapshot.totalMs);
+
+    bb::system::SystemToast toast;
+    toast.setBody(QString("Read %1 characteristics from %2 services in %3 ms").arg(characteristicCount).arg(_snapshot.services.size()).arg(_snapshot.totalMs));
+    toast.setPosition(bb::system::SystemUiPosition::MiddleCenter);
+    toast.exec();
+}
+
+// Writes one snapshot to disk away from the UI thread. It works on its own
+// copy, so a new crawl may start meanwhile.
+class SnapshotExporter : public QRunnable
+{
+public:
+    SnapshotExporter(DeviceCrawler *crawler, const GattDeviceSnapshot &snapshot, const QString &directory)
+        : _crawler(crawler)
+        , _snapshot(snapshot)
+        , _directory(directory)
+    {
+    }
+
+    void run()
+    {
+        QString baseName = QDir(_directory).filePath(QString(_snapshot.address).remove(':'));
+        bool ok = write(baseName);
+        QMetaObject::invokeMethod(_crawler, "handleExportFinished", Qt::QueuedConnection, Q_ARG(QString, baseName), Q_ARG(bool, ok));
+    }
+
+private:
+    bool write(const QString &baseName)
+    {
+        QDir dir(_directory);
+        if (!dir.exists() && !dir.mkpath(".")) {
+            qDebug() << "XXXX SnapshotExporter::write() - unable to create " << dir.path() << endl;
+            return false;
+        }
+
+        QByteArray encoded = GattSnapshotWriter::encode(_snapshot);
+        QFile binFile(baseName + ".gsnp");
+        if (!binFile.open(QIODevice::WriteOnly | QIODevice::Truncate) || binFile.write(encoded) != encoded.size()) {
+            qDebug() << "XXXX SnapshotExporter::write() - unable to write " << binFile.fileName() << endl;
+            return false;
+        }
+        binFile.close();
+
+        QFile jsonFile(baseName + ".json");
+        if (!jsonFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            qDebug() << "XXXX SnapshotExporter::write() - unable to write " << jsonFile.fileName() << endl;
+            return false;
+        }
+        GattSnapshotJsonWriter json(&jsonFile);
+        bool jsonOk = json.write(_snapshot);
+        jsonFile.close();
+
+        qDebug() << "XXXX SnapshotExporter::write() - " << baseName << " binary=" << encoded.size() << "B json=" << json.bytesWritten() << "B" << endl;
+        return jsonOk;
+    }
+
+    DeviceCrawler *_crawler;
+    GattDeviceSnapshot _snapshot;
+    QString _directory;
+};
+
+bool DeviceCrawler::exportSnapshot(const QString &directory)
+{
+    if (_snapshot.address.isEmpty() || _crawling) {
+        return false;
+    }
+    if (_exporting) {
+        qDebug() << "XXXX DeviceCrawler::exportSnapshot() - an export is still running" << endl;
+        return false;
+    }
+
+    _exporting = true;
+    QThreadPool::globalInstance()->start(new SnapshotExporter(this, _snapshot, directory.isEmpty() ? QDir::homePath() + "/snapshots" : directory));
+    return true;
+}
+
+void DeviceCrawler::handleExportFinished(const QString &baseName, bool ok)
+{
+    _exporting = false;
+    emit snapshotExported(baseName, ok);
+}
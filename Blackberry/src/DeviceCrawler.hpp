@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2011-2013 BlackBerry Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef DEVICECRAWLER_H
+#define DEVICECRAWLER_H
+
+#include <stdint.h>
+#include <errno.h>
+
+#include <QObject>
+#include <QtCore/QString>
+#include <QtCore/QDebug>
+#include <QtCore/QHash>
+#include <QtCore/QMap>
+#include <QtCore/QPair>
+#include <QtCore/QQueue>
+#include <QtCore/QSet>
+#include <QtCore/QTimer>
+#include <QtCore/QElapsedTimer>
+
+#include <btapi/btgatt.h>
+#include <btapi/btdevice.h>
+
+#include "GattScheduler.hpp"
+#include "GattSnapshot.hpp"
+
+/*
+ * Reads a whole peripheral in one pass. Every GATT service of the selected
+ * device is connected and kept open until the crawl is over, so the LE link
+ * is brought up once rather than once per service. Connection requests for
+ * the next services are already in flight while the current one is being
+ * read. Values are read at background priority through GattScheduler, so
+ * anything the user asks for meanwhile goes first.
+ */
+class DeviceCrawler : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(bool crawling
+               READ isCrawling
+               NOTIFY crawlingChanged)
+
+public:
+    static DeviceCrawler* getInstance(QObject *parent = 0);
+
+    bool isCrawling() const;
+    const GattDeviceSnapshot& snapshot() const;
+
+    Q_INVOKABLE void crawlDevice();
+    Q_INVOKABLE void cancelCrawl();
+    // writes the last snapshot as <address>.gsnp and .json on a pool thread;
+    // false if there is nothing to export or an export is still running
+    Q_INVOKABLE bool exportSnapshot(const QString &directory = QString());
+
+    static const int CONNECT_WINDOW = 3;
+    static const int CRAWL_TIMEOUT_MS = 60000;
+    static const int MAX_VALUE_LENGTH = 512;
+
+signals:
+    void crawlingChanged();
+    void crawlStarted(const QString &address, int serviceCount);
+    void serviceCrawled(const QString &uuid, int characteristicCount, qint64 connectMs, qint64 readMs);
+    void crawlFinished(const QString &address, int serviceCount, int characteristicCount, qint64 totalMs);
+    void snapshotExported(const QString &baseName, bool ok);
+
+private slots:
+    void handleGattServiceConnected(
+            const QString &bdaddr, const QString &service, int instance,
+            int err, uint16_t connInt, uint16_t latency,
+            uint16_t superTimeout, void *userData
+            );
+    void handleGattServiceDisconnected(
+            const QString &bdaddr, const QString &service,
+            int instance, int reason, void *userData
+            );
+    void crawlTimedOut();
+    void handleReadFinished(const GattOperation &operation);
+    void handleExportFinished(const QString &baseName, bool ok);
+
+private:
+    DeviceCrawler(QObject *parent = 0);
+    virtual ~DeviceCrawler();
+
+    void connectNextServices();
+    void readService(int index);
+    void serviceDone(int index);
+    void finishCrawl();
+
+    static DeviceCrawler* _instance;
+
+    bool _crawling;
+    bool _exporting;
+    GattDeviceSnapshot _snapshot;
+    QQueue<int> _pendingServices;
+    // One per connect request, passed as its userData. A device may expose
+    // the same service UUID more than once, so the answer is matched by the
+    // request rather than by the UUID it names.
+    struct ConnectRequest {
+        int service;
+        bool cancelled;
+        QElapsedTimer timer;
+    };
+    // requests still waiting for their callback, cancelled ones included
+    QSet<ConnectRequest*> _connects;
+    QList<int> _openInstances;
+    int _inFlight;
+    int _completed;
+    // read id -> (service, characteristic)
+    QHash<int, QPair<int, int> > _pendingReads;
+    QMap<int, int> _readsOutstanding;
+    QMap<int, QElapsedTimer> _readTimers;
+    QElapsedTimer _crawlTimer;
+    QTimer *_watchdog;
+};
+
+#endif // ifndef DEVICECRAWLER_H
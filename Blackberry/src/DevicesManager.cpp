@@ -15,8 +15,10 @@
  */
 
 #include "DevicesManager.hpp"
+#include "BtApi.hpp"
 #include "DataContainer.hpp"
 #include "RemoteDeviceInfo.hpp"
+#include "SignalCoalescer.hpp"
 #include <btapi/btdevice.h>
 
 DevicesManager* DevicesManager::_instance;
@@ -117,35 +119,55 @@ void DevicesManager::findBleDevices()
     if (!bt_initialised) {
 
         // Initialise the Bluetooth device and allocate the required resources for the library. Specify a call back function for Bluetooth events.
-        bt_device_init(btEvent);
+        BtApi::device_init(btEvent);
         // make sure the Bluetooth radio is switched on
-        if (!bt_ldev_get_power()) {
-            bt_ldev_set_power(true);
+        if (!BtApi::ldev_get_power()) {
+            BtApi::ldev_set_power(true);
         }
         bt_initialised = true;
     }
 
     DataContainer *dc = DataContainer::getInstance();
     dc->clearDeviceList();
+    _scanDedup.clear();
     // note that this is a blocking call. For each device discovered however, a call back is made to btEvent with event type BT_EVT_DEVICE_ADDED
-    bt_disc_start_inquiry(BT_INQUIRY_GIAC);
+    BtApi::disc_start_inquiry(BT_INQUIRY_GIAC);
 
     bt_remote_device_t **remoteDeviceArray = 0;
     bt_remote_device_t *remoteDevice = 0;
 
-    remoteDeviceArray = bt_disc_retrieve_devices(BT_DISCOVERY_ALL, 0);
+    remoteDeviceArray = BtApi::disc_retrieve_devices(BT_DISCOVERY_ALL, 0);
 
     int device_count;
     device_count=0;
 
     if (remoteDeviceArray) {
         for (int i = 0; (remoteDevice = remoteDeviceArray[i]); ++i) {
-            const int deviceType = bt_rdev_get_type(remoteDevice);
+            const int deviceType = BtApi::rdev_get_type(remoteDevice);
             if ((deviceType == BT_DEVICE_TYPE_LE_PUBLIC) || (deviceType == BT_DEVICE_TYPE_LE_PRIVATE)) {
-                device_count++;
-                DevicesManager::getDevicesManager()->extractAndStoreBleDeviceAttributes(remoteDevice);
+                char address[128];
+                BtApi::rdev_get_address(remoteDevice, address);
+
+                bool isNew = false;
+                switch (_scanDedup.lookup(address)) {
+                    case ScanDeduplicator::New:
+                        isNew = true;
+                        break;
+                    case ScanDeduplicator::Seen:
+                        break;
+                    case ScanDeduplicator::Unsure:
+                        // filter hit but evicted from the LRU table, check the list itself
+                        isNew = (dc->getDeviceIndex(QString::fromLatin1(address)) < 0);
+                        _scanDedup.confirm(isNew);
+                        break;
+                }
+
+                if (isNew) {
+                    device_count++;
+                    DevicesManager::getDevicesManager()->extractAndStoreBleDeviceAttributes(remoteDevice);
+                }
             }
-            bt_rdev_free(remoteDevice);
+            BtApi::rdev_free(remoteDevice);
         }
 //        qDebug() << "YYYY DevicesManager::findBleDevices() - freeing buffer";
 //        if (remoteDeviceArray) {
@@ -154,9 +176,10 @@ void DevicesManager::findBleDevices()
     }
 
     qDebug() << "XXXX number of devices found=" << device_count;
+    _scanDedup.logStats();
     dc->setDeviceCount(device_count);
 
-    emit setDeviceCount(QVariant(device_count));
+    SignalCoalescer::getInstance()->post(this, "setDeviceCount", QVariantList() << QVariant(device_count));
     emit finishedScanningForDevices();
 
 }
@@ -167,7 +190,7 @@ void DevicesManager::extractAndStoreBleDeviceAttributes(bt_remote_device_t *remo
     qDebug() << "XXXX DevicesManager::extractAndStoreBleDeviceAttributes";
 
     char buffer[128];
-    bt_rdev_get_address(remoteDevice, buffer);
+    BtApi::rdev_get_address(remoteDevice, buffer);
     _remoteDeviceInfo->populateWithDeviceAttributes(QString::fromLatin1(buffer));
 
     DataContainer::getInstance()->addDevice(_remoteDeviceInfo->property("name").toString().toLatin1().data(), _remoteDeviceInfo->property("address").toString().toLatin1().data(),
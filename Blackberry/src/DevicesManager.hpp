@@ -25,6 +25,7 @@
 #include <bb/system/SystemDialog>
 #include <bb/system/SystemToast>
 #include "RemoteDeviceInfo.hpp"
+#include "ScanDeduplicator.hpp"
 
 #include <btapi/btdevice.h>
 
@@ -45,6 +46,7 @@ private:
     virtual ~DevicesManager();
     static DevicesManager *_instance;
     RemoteDeviceInfo *_remoteDeviceInfo;
+    ScanDeduplicator _scanDedup;
 
     int _item_count;
 
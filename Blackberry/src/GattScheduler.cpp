@@ -0,0 +1,440 @@
+/*
+ * Copyright (c) 2011-2013 BlackBerry Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "GattScheduler.hpp"
+#include "BtApi.hpp"
+
+#include <errno.h>
+#include <unistd.h>
+
+#include <QtCore/QMutexLocker>
+#include <QtCore/QRunnable>
+
+GattScheduler* GattScheduler::_instance;
+
+static const char *PRIORITY_NAMES[GattOperation::PRIORITY_COUNT] = { "interactive", "notification", "background" };
+
+GattOperation GattOperation::read(const QString &address, int instance, uint16_t handle, int length, Priority priority, QObject *owner)
+{
+    GattOperation operation;
+    operation.kind = Read;
+    operation.priority = priority;
+    operation.address = address;
+    operation.instance = instance;
+    operation.handle = handle;
+    operation.length = length;
+    operation.owner = owner;
+    return operation;
+}
+
+GattOperation GattOperation::write(const QString &address, int instance, uint16_t handle, const QByteArray &data, Priority priority, QObject *owner)
+{
+    GattOperation operation;
+    operation.kind = Write;
+    operation.priority = priority;
+    operation.address = address;
+    operation.instance = instance;
+    operation.handle = handle;
+    operation.length = data.size();
+    operation.data = data;
+    operation.owner = owner;
+    return operation;
+}
+
+class GattOperationRunner : public QRunnable
+{
+public:
+    GattOperationRunner(GattScheduler *scheduler, const GattOperation &operation)
+        : _scheduler(scheduler)
+        , _operation(operation)
+    {
+    }
+
+    void run()
+    {
+        _scheduler->perform(_operation);
+        _scheduler->complete(_operation);
+    }
+
+private:
+    GattScheduler *_scheduler;
+    GattOperation _operation;
+};
+
+GattScheduler::GattScheduler(QObject *parent)
+    : QObject(parent)
+    , _nextId(0)
+{
+    qRegisterMetaType<GattOperation>("GattOperation");
+
+    _clock.start();
+    _pool.setMaxThreadCount(MAX_THREADS);
+}
+
+GattScheduler::~GattScheduler()
+{
+    {
+        QMutexLocker locker(&_mutex);
+        QList<GattOperation> dropped;
+        QMutableHashIterator<QString, Device> i(_devices);
+        while (i.hasNext()) {
+            Device &device = i.next().value();
+            for (int p = 0; p < GattOperation::PRIORITY_COUNT; p++) {
+                while (!device.queues[p].isEmpty()) {
+                    GattOperation operation = device.queues[p].takeFirst();
+                    abandonLocked(operation, ECANCELED, dropped);
+                }
+            }
+        }
+    }
+    _pool.waitForDone();
+
+    logStatistics();
+    _instance = 0;
+}
+
+GattScheduler* GattScheduler::getInstance(QObject *parent)
+{
+    if (_instance == 0) {
+        _instance = new GattScheduler(parent);
+    }
+
+    return _instance;
+}
+
+qint64 GattScheduler::nowUs() const
+{
+    return _clock.nsecsElapsed() / 1000;
+}
+
+int GattScheduler::submit(const GattOperation &operation)
+{
+    return enqueue(operation, false);
+}
+
+GattOperation GattScheduler::execute(const GattOperation &operation)
+{
+    const qint64 startUs = nowUs();
+    const int id = enqueue(operation, true);
+
+    QMutexLocker locker(&_mutex);
+
+    while (!_results.contains(id)) {
+        if (operation.deadlineMs <= 0) {
+            _done.wait(&_mutex);
+            continue;
+        }
+
+        const qint64 remainingMs = operation.deadlineMs - (nowUs() - startUs) / 1000;
+        if (remainingMs > 0) {
+            _done.wait(&_mutex, (unsigned long) remainingMs);
+            continue;
+        }
+
+        // past the deadline: a queued operation is taken out, one with the
+        // stack finishes on its own and is dropped then
+        GattOperation timedOut;
+        if (!removeLocked(id, timedOut)) {
+            timedOut = operation;
+            timedOut.id = id;
+            _abandoned.insert(id);
+        }
+        _synchronous.remove(id);
+        _stats[timedOut.priority].deadlineMissed++;
+
+        timedOut.result = -1;
+        timedOut.error = ETIMEDOUT;
+        timedOut.finishedUs = nowUs();
+        return timedOut;
+    }
+
+    return _results.take(id);
+}
+
+int GattScheduler::enqueue(const GattOperation &operation, bool synchronous)
+{
+    QList<GattOperation> failed;
+    int id;
+    {
+        QMutexLocker locker(&_mutex);
+
+        GattOperation queued = operation;
+        queued.id = id = ++_nextId;
+        queued.queuedUs = nowUs();
+        queued.result = -1;
+        queued.error = 0;
+        queued.retries = 0;
+
+        if (synchronous) {
+            _synchronous.insert(id);
+        }
+
+        Device &device = _devices[queued.address];
+        _stats[queued.priority].submitted++;
+        if (device.busy && device.inFlightPriority > queued.priority) {
+            // has to sit out the less urgent operation already on the air
+            _stats[queued.priority].behindLower++;
+        }
+
+        device.queues[queued.priority].append(queued);
+        dispatchLocked(queued.address, failed);
+        pruneLocked(queued.address);
+    }
+
+    deliver(failed);
+    return id;
+}
+
+void GattScheduler::dispatchLocked(const QString &address, QList<GattOperation> &failed)
+{
+    Device &device = _devices[address];
+
+    while (!device.busy) {
+        int priority = 0;
+        while (priority < GattOperation::PRIORITY_COUNT && device.queues[priority].isEmpty()) {
+            priority++;
+        }
+        if (priority == GattOperation::PRIORITY_COUNT) {
+            return;
+        }
+
+        GattOperation operation = device.queues[priority].takeFirst();
+        const qint64 now = nowUs();
+
+        if (operation.deadlineMs > 0 && now - operation.queuedUs > qint64(operation.deadlineMs) * 1000) {
+            _stats[priority].deadlineMissed++;
+            abandonLocked(operation, ETIMEDOUT, failed);
+            continue;
+        }
+
+        const qint64 queueUs = now - operation.queuedUs;
+        _stats[priority].queueUs += queueUs;
+        _stats[priority].maxQueueUs = qMax(_stats[priority].maxQueueUs, queueUs);
+
+        operation.startedUs = now;
+        device.busy = true;
+        device.inFlightPriority = priority;
+        _pool.start(new GattOperationRunner(this, operation));
+    }
+}
+
+void GattScheduler::perform(GattOperation &operation)
+{
+    for (;;) {
+        errno = 0;
+
+        if (operation.kind == GattOperation::Write) {
+            operation.result = BtApi::gatt_write_value(operation.instance, operation.handle, operation.offset,
+                    reinterpret_cast<const uint8_t*>(operation.data.constData()), operation.data.size());
+        } else {
+            QByteArray buffer(qMax(operation.length, 1), '\0');
+            operation.result = BtApi::gatt_read_value(operation.instance, operation.handle, operation.offset,
+                    reinterpret_cast<uint8_t*>(buffer.data()), operation.length, 0);
+            operation.data = (operation.result > 0) ? buffer.left(qMin(operation.result, operation.length)) : QByteArray();
+        }
+        operation.error = (operation.result < 0) ? ((errno != 0) ? errno : EIO) : 0;
+
+        // someone outside this app has the link, give it a moment
+        if (operation.error != EBUSY || operation.retries >= MAX_BUSY_RETRIES) {
+            break;
+        }
+        usleep(useconds_t(BUSY_BACKOFF_MS * 1000) << operation.retries);
+        operation.retries++;
+    }
+
+    operation.finishedUs = nowUs();
+}
+
+void GattScheduler::complete(const GattOperation &operation)
+{
+    QList<GattOperation> delivered;
+    {
+        QMutexLocker locker(&_mutex);
+
+        Statistics &stats = _stats[operation.priority];
+        const qint64 serviceUs = operation.finishedUs - operation.startedUs;
+        stats.completed++;
+        stats.busyRetries += operation.retries;
+        stats.serviceUs += serviceUs;
+        stats.maxServiceUs = qMax(stats.maxServiceUs, serviceUs);
+        if (operation.result < 0) {
+            stats.failed++;
+        }
+
+        if (_abandoned.remove(operation.id)) {
+            // execute() has returned ETIMEDOUT for it already
+        } else if (_synchronous.remove(operation.id)) {
+            _results.insert(operation.id, operation);
+            _done.wakeAll();
+        } else {
+            delivered.append(operation);
+        }
+
+        _devices[operation.address].busy = false;
+        dispatchLocked(operation.address, delivered);
+        pruneLocked(operation.address);
+    }
+
+    deliver(delivered);
+}
+
+void GattScheduler::pruneLocked(const QString &address)
+{
+    // a peripheral with nothing queued or on the air is forgotten, so the
+    // table does not keep every device ever talked to
+    QHash<QString, Device>::iterator i = _devices.find(address);
+    if (i == _devices.end() || i.value().busy) {
+        return;
+    }
+    for (int p = 0; p < GattOperation::PRIORITY_COUNT; p++) {
+        if (!i.value().queues[p].isEmpty()) {
+            return;
+        }
+    }
+    _devices.erase(i);
+}
+
+void GattScheduler::abandonLocked(GattOperation &operation, int error, QList<GattOperation> &failed)
+{
+    operation.result = -1;
+    operation.error = error;
+    operation.finishedUs = operation.startedUs = nowUs();
+
+    if (_synchronous.remove(operation.id)) {
+        _results.insert(operation.id, operation);
+        _done.wakeAll();
+    } else {
+        failed.append(operation);
+    }
+}
+
+bool GattScheduler::removeLocked(int id, GattOperation &operation)
+{
+    QMutableHashIterator<QString, Device> i(_devices);
+
+    while (i.hasNext()) {
+        Device &device = i.next().value();
+        for (int p = 0; p < GattOperation::PRIORITY_COUNT; p++) {
+            for (int j = 0; j < device.queues[p].size(); j++) {
+                if (device.queues[p].at(j).id == id) {
+                    operation = device.queues[p].takeAt(j);
+                    return true;
+                }
+            }
+        }
+    }
+
+    return false;
+}
+
+bool GattScheduler::cancel(int id)
+{
+    QList<GattOperation> cancelled;
+    {
+        QMutexLocker locker(&_mutex);
+
+        GattOperation operation;
+        if (!removeLocked(id, operation)) {
+            return false;
+        }
+        _stats[operation.priority].cancelled++;
+        abandonLocked(operation, ECANCELED, cancelled);
+    }
+
+    deliver(cancelled);
+    return true;
+}
+
+int GattScheduler::cancelAll(QObject *owner)
+{
+    QList<GattOperation> cancelled;
+    int count = 0;
+    {
+        QMutexLocker locker(&_mutex);
+
+        QMutableHashIterator<QString, Device> i(_devices);
+        while (i.hasNext()) {
+            Device &device = i.next().value();
+            for (int p = 0; p < GattOperation::PRIORITY_COUNT; p++) {
+                QMutableListIterator<GattOperation> j(device.queues[p]);
+                while (j.hasNext()) {
+                    GattOperation &operation = j.next();
+                    if (operation.owner != owner) {
+                        continue;
+                    }
+                    GattOperation taken = operation;
+                    j.remove();
+                    _stats[p].cancelled++;
+                    abandonLocked(taken, ECANCELED, cancelled);
+                    count++;
+                }
+            }
+        }
+    }
+
+    deliver(cancelled);
+    return count;
+}
+
+void GattScheduler::deliver(const QList<GattOperation> &operations)
+{
+    foreach (const GattOperation &operation, operations) {
+        emit finished(operation);
+    }
+}
+
+QVariantMap GattScheduler::statistics() const
+{
+    QMutexLocker locker(&_mutex);
+    QVariantMap stats;
+
+    for (int p = 0; p < GattOperation::PRIORITY_COUNT; p++) {
+        const Statistics &s = _stats[p];
+        QVariantMap entry;
+        entry["submitted"] = s.submitted;
+        entry["completed"] = s.completed;
+        entry["failed"] = s.failed;
+        entry["cancelled"] = s.cancelled;
+        entry["deadlineMissed"] = s.deadlineMissed;
+        entry["busyRetries"] = s.busyRetries;
+        entry["behindLowerPriority"] = s.behindLower;
+        entry["meanQueueMs"] = s.completed ? double(s.queueUs) / s.completed / 1000 : 0.0;
+        entry["maxQueueMs"] = double(s.maxQueueUs) / 1000;
+        entry["meanServiceMs"] = s.completed ? double(s.serviceUs) / s.completed / 1000 : 0.0;
+        entry["maxServiceMs"] = double(s.maxServiceUs) / 1000;
+        stats[PRIORITY_NAMES[p]] = entry;
+    }
+
+    return stats;
+}
+
+void GattScheduler::logStatistics() const
+{
+    const QVariantMap stats = statistics();
+
+    for (int p = 0; p < GattOperation::PRIORITY_COUNT; p++) {
+        const QVariantMap entry = stats[PRIORITY_NAMES[p]].toMap();
+        if (entry["submitted"].toULongLong() == 0) {
+            continue;
+        }
+        qDebug() << "XXXX GattScheduler -" << PRIORITY_NAMES[p] << "submitted" << entry["submitted"].toULongLong()
+                 << "completed" << entry["completed"].toULongLong() << "failed" << entry["failed"].toULongLong()
+                 << "cancelled" << entry["cancelled"].toULongLong() << "past deadline" << entry["deadlineMissed"].toULongLong()
+                 << "EBUSY retries" << entry["busyRetries"].toULongLong() << "behind lower priority" << entry["behindLowerPriority"].toULongLong()
+                 << "queue mean" << entry["meanQueueMs"].toDouble() << "ms max" << entry["maxQueueMs"].toDouble() << "ms"
+                 << "service mean" << entry["meanServiceMs"].toDouble() << "ms max" << entry["maxServiceMs"].toDouble() << "ms" << endl;
+    }
+}
@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) 2011-2013 BlackBerry Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef GATTSCHEDULER_H
+#define GATTSCHEDULER_H
+
+#include <stdint.h>
+
+#include <QObject>
+#include <QtCore/QByteArray>
+#include <QtCore/QDebug>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QMetaType>
+#include <QtCore/QMutex>
+#include <QtCore/QSet>
+#include <QtCore/QString>
+#include <QtCore/QThreadPool>
+#include <QtCore/QVariantMap>
+#include <QtCore/QWaitCondition>
+
+/*
+ * One GATT request on an open service instance. Descriptors are read by
+ * handle like values, ReadDescriptor only tells the owner what it asked for.
+ */
+struct GattOperation
+{
+    enum Kind {
+        Read,
+        ReadDescriptor,
+        Write
+    };
+
+    // most urgent first
+    enum Priority {
+        Interactive,
+        Notification,
+        Background,
+        PRIORITY_COUNT
+    };
+
+    GattOperation()
+        : id(0), kind(Read), priority(Background), instance(0), handle(0), offset(0), length(0), deadlineMs(0), owner(0),
+          result(-1), error(0), retries(0), queuedUs(0), startedUs(0), finishedUs(0) {}
+
+    static GattOperation read(const QString &address, int instance, uint16_t handle, int length, Priority priority, QObject *owner = 0);
+    static GattOperation write(const QString &address, int instance, uint16_t handle, const QByteArray &data, Priority priority, QObject *owner = 0);
+
+    int id;
+    Kind kind;
+    Priority priority;
+    QString address;
+    int instance;
+    uint16_t handle;
+    uint16_t offset;
+    int length;
+    // the value read, or the value to write
+    QByteArray data;
+    // from submission, 0 for none - an operation still queued when it
+    // expires fails with ETIMEDOUT without going out
+    int deadlineMs;
+    QObject *owner;
+
+    int result;
+    int error;
+    int retries;
+    qint64 queuedUs;
+    qint64 startedUs;
+    qint64 finishedUs;
+};
+
+Q_DECLARE_METATYPE(GattOperation)
+
+/*
+ * GATT allows one outstanding request per link. All reads and writes go
+ * through here: each peripheral has its own queue per priority class, only
+ * one operation per peripheral is with the stack at a time, and the most
+ * urgent queued operation goes next - an interactive read waits for at most
+ * the one background read already on the air, never for the rest of a crawl.
+ * Operations run on a small thread pool so peripherals proceed in parallel
+ * and the UI thread is not blocked by asynchronous work.
+ *
+ * submit() queues an operation and finished() reports it, owners pick their
+ * own operations out by owner as with the btapi callbacks. execute() waits
+ * for the result instead, no longer than the operation's deadline: one still
+ * with the stack then is left to finish unreported and execute() returns
+ * ETIMEDOUT.
+ */
+class GattScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    static GattScheduler* getInstance(QObject *parent = 0);
+
+    static const int MAX_THREADS = 4;
+    static const int MAX_BUSY_RETRIES = 5;
+    static const int BUSY_BACKOFF_MS = 10;
+
+    // returns the operation's id
+    int submit(const GattOperation &operation);
+    GattOperation execute(const GattOperation &operation);
+
+    // only queued operations can be cancelled, they finish with ECANCELED
+    bool cancel(int id);
+    int cancelAll(QObject *owner);
+
+    Q_INVOKABLE QVariantMap statistics() const;
+    void logStatistics() const;
+
+signals:
+    void finished(const GattOperation &operation);
+
+private:
+    friend class GattOperationRunner;
+
+    GattScheduler(QObject *parent = 0);
+    virtual ~GattScheduler();
+
+    struct Device {
+        Device() : busy(false), inFlightPriority(GattOperation::Background) {}
+        QList<GattOperation> queues[GattOperation::PRIORITY_COUNT];
+        bool busy;
+        int inFlightPriority;
+    };
+
+    struct Statistics {
+        Statistics() : submitted(0), completed(0), failed(0), cancelled(0), deadlineMissed(0), busyRetries(0), behindLower(0),
+                queueUs(0), maxQueueUs(0), serviceUs(0), maxServiceUs(0) {}
+        quint64 submitted;
+        quint64 completed;
+        quint64 failed;
+        quint64 cancelled;
+        quint64 deadlineMissed;
+        quint64 busyRetries;
+        quint64 behindLower;
+        qint64 queueUs;
+        qint64 maxQueueUs;
+        qint64 serviceUs;
+        qint64 maxServiceUs;
+    };
+
+    qint64 nowUs() const;
+    int enqueue(const GattOperation &operation, bool synchronous);
+    void perform(GattOperation &operation);
+    void complete(const GattOperation &operation);
+    void dispatchLocked(const QString &address, QList<GattOperation> &failed);
+    void pruneLocked(const QString &address);
+    void abandonLocked(GattOperation &operation, int error, QList<GattOperation> &failed);
+    bool removeLocked(int id, GattOperation &operation);
+    void deliver(const QList<GattOperation> &operations);
+
+    static GattScheduler* _instance;
+
+    mutable QMutex _mutex;
+    QWaitCondition _done;
+    QElapsedTimer _clock;
+    QThreadPool _pool;
+    int _nextId;
+
+    QHash<QString, Device> _devices;
+    QSet<int> _synchronous;
+    QHash<int, GattOperation> _results;
+    // execute() gave up on these while they were with the stack
+    QSet<int> _abandoned;
+
+    Statistics _stats[GattOperation::PRIORITY_COUNT];
+};
+
+#endif // ifndef GATTSCHEDULER_H
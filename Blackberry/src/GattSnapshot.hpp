@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2011-2013 BlackBerry Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef GATTSNAPSHOT_H
+#define GATTSNAPSHOT_H
+
+#include <stdint.h>
+#include <errno.h>
+
+#include <QtCore/QString>
+#include <QtCore/QList>
+#include <QtCore/QByteArray>
+
+#include <btapi/btgatt.h>
+
+/*
+ * In-memory copy of a peripheral's GATT tree as captured by DeviceCrawler.
+ * Plain value types so a snapshot can be copied, queued and serialised
+ * without touching the btapi handles it was read from.
+ */
+struct GattCharacteristicSnapshot
+{
+    GattCharacteristicSnapshot()
+        : handle(0), valueHandle(0), properties(0), readError(EOK) {}
+
+    QString uuid;
+    uint16_t handle;
+    uint16_t valueHandle;
+    bt_gatt_char_prop_mask properties;
+    QByteArray value;
+    int readError;
+};
+
+struct GattServiceSnapshot
+{
+    GattServiceSnapshot()
+        : instance(0), connectError(EOK), readError(EOK), connectMs(-1), readMs(-1) {}
+
+    QString uuid;
+    int instance;
+    int connectError;
+    int readError;          // the characteristics could not be listed
+    qint64 connectMs;
+    qint64 readMs;
+    QList<GattCharacteristicSnapshot> characteristics;
+};
+
+struct GattDeviceSnapshot
+{
+    GattDeviceSnapshot()
+        : capturedAtMs(0), totalMs(-1) {}
+
+    void clear()
+    {
+        address.clear();
+        name.clear();
+        capturedAtMs = 0;
+        totalMs = -1;
+        services.clear();
+    }
+
+    QString address;
+    QString name;
+    qint64 capturedAtMs;
+    qint64 totalMs;
+    QList<GattServiceSnapshot> services;
+};
+
+#endif // ifndef GATTSNAPSHOT_H
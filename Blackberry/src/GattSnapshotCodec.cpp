@@ -0,0 +1,477 @@
+/*
+ * Copyright (c) 2011-2013 BlackBerry Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "GattSnapshotCodec.hpp"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <QtCore/QtEndian>
+
+static const char SNAPSHOT_MAGIC[4] = { 'G', 'S', 'N', 'P' };
+
+static inline void putU16(QByteArray &out, uint16_t value)
+{
+    uchar raw[2];
+    qToLittleEndian<quint16>(value, raw);
+    out.append(reinterpret_cast<const char *>(raw), 2);
+}
+
+static inline void putU32(QByteArray &out, uint32_t value)
+{
+    uchar raw[4];
+    qToLittleEndian<quint32>(value, raw);
+    out.append(reinterpret_cast<const char *>(raw), 4);
+}
+
+static inline void putI64(QByteArray &out, qint64 value)
+{
+    uchar raw[8];
+    qToLittleEndian<qint64>(value, raw);
+    out.append(reinterpret_cast<const char *>(raw), 8);
+}
+
+static inline void putString(QByteArray &out, const QString &value)
+{
+    QByteArray utf8 = value.toUtf8();
+    if (utf8.size() > 0xFFFF) {
+        utf8.truncate(0xFFFF);
+    }
+    putU16(out, utf8.size());
+    out.append(utf8);
+}
+
+static inline void putBytes(QByteArray &out, const QByteArray &value)
+{
+    putU32(out, value.size());
+    out.append(value);
+}
+
+QByteArray GattSnapshotWriter::encode(const GattDeviceSnapshot &snapshot)
+{
+    QByteArray out;
+    encode(snapshot, out);
+    return out;
+}
+
+void GattSnapshotWriter::encode(const GattDeviceSnapshot &snapshot, QByteArray &out)
+{
+    // rough size guess so the common case needs a single allocation
+    int estimate = 64 + snapshot.address.size() + snapshot.name.size();
+    for (int i = 0; i < snapshot.services.size(); i++) {
+        estimate += 80 + snapshot.services.at(i).characteristics.size() * 64;
+    }
+    out.clear();
+    out.reserve(estimate);
+
+    out.append(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    putU16(out, VERSION);
+    putU16(out, 0);
+
+    putString(out, snapshot.address);
+    putString(out, snapshot.name);
+    putI64(out, snapshot.capturedAtMs);
+    putI64(out, snapshot.totalMs);
+    putU32(out, snapshot.services.size());
+
+    for (int i = 0; i < snapshot.services.size(); i++) {
+        const GattServiceSnapshot &service = snapshot.services.at(i);
+
+        putString(out, service.uuid);
+        putU32(out, service.instance);
+        putU32(out, service.connectError);
+        putU32(out, service.readError);
+        putI64(out, service.connectMs);
+        putI64(out, service.readMs);
+        putU32(out, service.characteristics.size());
+
+        for (int j = 0; j < service.characteristics.size(); j++) {
+            const GattCharacteristicSnapshot &characteristic = service.characteristics.at(j);
+
+            putString(out, characteristic.uuid);
+            putU16(out, characteristic.handle);
+            putU16(out, characteristic.valueHandle);
+            putU32(out, characteristic.properties);
+            putU32(out, characteristic.readError);
+            putBytes(out, characteristic.value);
+        }
+    }
+}
+
+GattSnapshotReader::GattSnapshotReader(const char *data, int length)
+    : _data(data)
+    , _length(length)
+    , _pos(0)
+    , _failed(data == 0 || length < 0)
+{
+}
+
+GattSnapshotReader::GattSnapshotReader(const QByteArray &buffer)
+    : _data(buffer.constData())
+    , _length(buffer.size())
+    , _pos(0)
+    , _failed(false)
+{
+}
+
+bool GattSnapshotReader::atEnd() const
+{
+    return _pos >= _length;
+}
+
+bool GattSnapshotReader::failed() const
+{
+    return _failed;
+}
+
+bool GattSnapshotReader::take(int count, const char **out)
+{
+    if (_failed || count < 0 || count > _length - _pos) {
+        _failed = true;
+        return false;
+    }
+    *out = _data + _pos;
+    _pos += count;
+    return true;
+}
+
+bool GattSnapshotReader::readU16(uint16_t &value)
+{
+    const char *p;
+    if (!take(2, &p)) {
+        return false;
+    }
+    value = qFromLittleEndian<quint16>(reinterpret_cast<const uchar *>(p));
+    return true;
+}
+
+bool GattSnapshotReader::readU32(uint32_t &value)
+{
+    const char *p;
+    if (!take(4, &p)) {
+        return false;
+    }
+    value = qFromLittleEndian<quint32>(reinterpret_cast<const uchar *>(p));
+    return true;
+}
+
+bool GattSnapshotReader::readI64(qint64 &value)
+{
+    const char *p;
+    if (!take(8, &p)) {
+        return false;
+    }
+    value = qFromLittleEndian<qint64>(reinterpret_cast<const uchar *>(p));
+    return true;
+}
+
+bool GattSnapshotReader::readString(GattByteView &view)
+{
+    uint16_t length;
+    if (!readU16(length) || !take(length, &view.data)) {
+        return false;
+    }
+    view.length = length;
+    return true;
+}
+
+bool GattSnapshotReader::readBytes(GattByteView &view)
+{
+    uint32_t length;
+    if (!readU32(length) || length > (uint32_t) (_length - _pos) || !take((int) length, &view.data)) {
+        _failed = true;
+        return false;
+    }
+    view.length = (int) length;
+    return true;
+}
+
+bool GattSnapshotReader::readDevice(GattDeviceRecord &device)
+{
+    const char *magic;
+    uint16_t version;
+    uint16_t reserved;
+
+    if (!take(sizeof(SNAPSHOT_MAGIC), &magic) || memcmp(magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0) {
+        _failed = true;
+        return false;
+    }
+    if (!readU16(version) || !readU16(reserved) || version != GattSnapshotWriter::VERSION) {
+        _failed = true;
+        return false;
+    }
+
+    return readString(device.address)
+        && readString(device.name)
+        && readI64(device.capturedAtMs)
+        && readI64(device.totalMs)
+        && readU32(device.serviceCount);
+}
+
+bool GattSnapshotReader::nextService(GattServiceRecord &service)
+{
+    uint32_t instance;
+    uint32_t connectError;
+    uint32_t readError;
+
+    if (!readString(service.uuid)
+            || !readU32(instance)
+            || !readU32(connectError)
+            || !readU32(readError)
+            || !readI64(service.connectMs)
+            || !readI64(service.readMs)
+            || !readU32(service.characteristicCount)) {
+        return false;
+    }
+    service.instance = (int32_t) instance;
+    service.connectError = (int32_t) connectError;
+    service.readError = (int32_t) readError;
+    return true;
+}
+
+bool GattSnapshotReader::nextCharacteristic(GattCharacteristicRecord &characteristic)
+{
+    uint32_t readError;
+
+    if (!readString(characteristic.uuid)
+            || !readU16(characteristic.handle)
+            || !readU16(characteristic.valueHandle)
+            || !readU32(characteristic.properties)
+            || !readU32(readError)
+            || !readBytes(characteristic.value)) {
+        return false;
+    }
+    characteristic.readError = (int32_t) readError;
+    return true;
+}
+
+bool GattSnapshotReader::decode(const QByteArray &buffer, GattDeviceSnapshot &snapshot)
+{
+    GattSnapshotReader reader(buffer);
+    GattDeviceRecord device;
+
+    snapshot.clear();
+
+    if (!reader.readDevice(device)) {
+        return false;
+    }
+    snapshot.address = device.address.toString();
+    snapshot.name = device.name.toString();
+    snapshot.capturedAtMs = device.capturedAtMs;
+    snapshot.totalMs = device.totalMs;
+
+    for (uint32_t i = 0; i < device.serviceCount; i++) {
+        GattServiceRecord serviceRecord;
+        if (!reader.nextService(serviceRecord)) {
+            return false;
+        }
+
+        GattServiceSnapshot service;
+        service.uuid = serviceRecord.uuid.toString();
+        service.instance = serviceRecord.instance;
+        service.connectError = serviceRecord.connectError;
+        service.readError = serviceRecord.readError;
+        service.connectMs = serviceRecord.connectMs;
+        service.readMs = serviceRecord.readMs;
+
+        for (uint32_t j = 0; j < serviceRecord.characteristicCount; j++) {
+            GattCharacteristicRecord characteristicRecord;
+            if (!reader.nextCharacteristic(characteristicRecord)) {
+                return false;
+            }
+
+            GattCharacteristicSnapshot characteristic;
+            characteristic.uuid = characteristicRecord.uuid.toString();
+            characteristic.handle = characteristicRecord.handle;
+            characteristic.valueHandle = characteristicRecord.valueHandle;
+            characteristic.properties = (bt_gatt_char_prop_mask) characteristicRecord.properties;
+            characteristic.readError = characteristicRecord.readError;
+            characteristic.value = characteristicRecord.value.toByteArray();
+            service.characteristics.append(characteristic);
+        }
+
+        snapshot.services.append(service);
+    }
+
+    return true;
+}
+
+GattSnapshotJsonWriter::GattSnapshotJsonWriter(QIODevice *device)
+    : _device(device)
+    , _used(0)
+    , _written(0)
+    , _ok(device != 0)
+{
+}
+
+GattSnapshotJsonWriter::~GattSnapshotJsonWriter()
+{
+    flush();
+}
+
+qint64 GattSnapshotJsonWriter::bytesWritten() const
+{
+    return _written;
+}
+
+void GattSnapshotJsonWriter::flush()
+{
+    if (_used > 0 && _ok) {
+        // a short write still put some bytes in the file, count only those
+        qint64 written = _device->write(_buffer, _used);
+        if (written > 0) {
+            _written += written;
+        }
+        if (written != _used) {
+            _ok = false;
+        }
+    }
+    _used = 0;
+}
+
+void GattSnapshotJsonWriter::append(const char *text, int length)
+{
+    while (length > 0) {
+        if (_used == BUFFER_SIZE) {
+            flush();
+        }
+        int chunk = qMin(length, BUFFER_SIZE - _used);
+        memcpy(_buffer + _used, text, chunk);
+        _used += chunk;
+        text += chunk;
+        length -= chunk;
+    }
+}
+
+void GattSnapshotJsonWriter::append(const char *text)
+{
+    append(text, strlen(text));
+}
+
+void GattSnapshotJsonWriter::appendString(const QString &value)
+{
+    static const char hex[] = "0123456789abcdef";
+
+    QByteArray utf8 = value.toUtf8();
+    const char *p = utf8.constData();
+    int start = 0;
+
+    append("\"", 1);
+    for (int i = 0; i < utf8.size(); i++) {
+        unsigned char c = (unsigned char) p[i];
+        if (c >= 0x20 && c != '"' && c != '\\') {
+            continue;
+        }
+        append(p + start, i - start);
+        start = i + 1;
+        switch (c) {
+        case '"':  append("\\\"", 2); break;
+        case '\\': append("\\\\", 2); break;
+        case '\n': append("\\n", 2); break;
+        case '\r': append("\\r", 2); break;
+        case '\t': append("\\t", 2); break;
+        default: {
+            char escaped[6] = { '\\', 'u', '0', '0', hex[c >> 4], hex[c & 0x0F] };
+            append(escaped, 6);
+            break;
+        }
+        }
+    }
+    append(p + start, utf8.size() - start);
+    append("\"", 1);
+}
+
+void GattSnapshotJsonWriter::appendNumber(qint64 value)
+{
+    char digits[24];
+    int length = snprintf(digits, sizeof(digits), "%lld", (long long) value);
+    append(digits, length);
+}
+
+void GattSnapshotJsonWriter::appendHex(const QByteArray &value)
+{
+    static const char hex[] = "0123456789ABCDEF";
+    char pair[2];
+
+    append("\"", 1);
+    for (int i = 0; i < value.size(); i++) {
+        unsigned char c = (unsigned char) value.at(i);
+        pair[0] = hex[c >> 4];
+        pair[1] = hex[c & 0x0F];
+        append(pair, 2);
+    }
+    append("\"", 1);
+}
+
+void GattSnapshotJsonWriter::appendKey(const char *key, bool first)
+{
+    if (!first) {
+        append(",", 1);
+    }
+    append("\"", 1);
+    append(key);
+    append("\":", 2);
+}
+
+bool GattSnapshotJsonWriter::write(const GattDeviceSnapshot &snapshot)
+{
+    append("{", 1);
+    appendKey("address", true);   appendString(snapshot.address);
+    appendKey("name");            appendString(snapshot.name);
+    appendKey("capturedAtMs");    appendNumber(snapshot.capturedAtMs);
+    appendKey("totalMs");         appendNumber(snapshot.totalMs);
+    appendKey("services");
+    append("[", 1);
+
+    for (int i = 0; i < snapshot.services.size(); i++) {
+        const GattServiceSnapshot &service = snapshot.services.at(i);
+
+        if (i > 0) {
+            append(",", 1);
+        }
+        append("{", 1);
+        appendKey("uuid", true);      appendString(service.uuid);
+        appendKey("connectError");    appendNumber(service.connectError);
+        appendKey("readError");       appendNumber(service.readError);
+        appendKey("connectMs");       appendNumber(service.connectMs);
+        appendKey("readMs");          appendNumber(service.readMs);
+        appendKey("characteristics");
+        append("[", 1);
+
+        for (int j = 0; j < service.characteristics.size(); j++) {
+            const GattCharacteristicSnapshot &characteristic = service.characteristics.at(j);
+
+            if (j > 0) {
+                append(",", 1);
+            }
+            append("{", 1);
+            appendKey("uuid", true);  appendString(characteristic.uuid);
+            appendKey("handle");      appendNumber(characteristic.handle);
+            appendKey("valueHandle"); appendNumber(characteristic.valueHandle);
+            appendKey("properties");  appendNumber(characteristic.properties);
+            appendKey("readError");   appendNumber(characteristic.readError);
+            appendKey("value");       appendHex(characteristic.value);
+            append("}", 1);
+        }
+
+        append("]}", 2);
+    }
+
+    append("]}\n", 3);
+    flush();
+
+    return _ok;
+}
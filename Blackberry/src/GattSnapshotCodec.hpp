@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2011-2013 BlackBerry Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef GATTSNAPSHOTCODEC_H
+#define GATTSNAPSHOTCODEC_H
+
+#include <stdint.h>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QIODevice>
+#include <QtCore/QString>
+
+#include "GattSnapshot.hpp"
+
+/*
+ * Binary layout, all integers little-endian:
+ *
+ *   header   : "GSNP" u16 version u16 reserved
+ *   device   : str address, str name, i64 capturedAtMs, i64 totalMs, u32 serviceCount
+ *   service  : str uuid, i32 instance, i32 connectError, i32 readError, i64 connectMs, i64 readMs, u32 characteristicCount
+ *   char     : str uuid, u16 handle, u16 valueHandle, u32 properties, i32 readError, bytes value
+ *
+ *   str      : u16 length + UTF-8 bytes
+ *   bytes    : u32 length + raw bytes
+ *
+ * Services follow the device record and each service is immediately followed
+ * by its characteristics, so a reader can walk the buffer front to back.
+ */
+class GattSnapshotWriter
+{
+public:
+    static const uint16_t VERSION = 2;
+
+    static QByteArray encode(const GattDeviceSnapshot &snapshot);
+    static void encode(const GattDeviceSnapshot &snapshot, QByteArray &out);
+};
+
+/*
+ * A run of bytes inside the buffer handed to GattSnapshotReader. Nothing is
+ * copied; the view is only valid while that buffer is alive.
+ */
+struct GattByteView
+{
+    GattByteView() : data(0), length(0) {}
+
+    const char *data;
+    int length;
+
+    QString toString() const { return QString::fromUtf8(data, length); }
+    QByteArray toByteArray() const { return QByteArray(data, length); }
+    QByteArray rawData() const { return QByteArray::fromRawData(data, length); }
+};
+
+struct GattDeviceRecord
+{
+    GattByteView address;
+    GattByteView name;
+    qint64 capturedAtMs;
+    qint64 totalMs;
+    uint32_t serviceCount;
+};
+
+struct GattServiceRecord
+{
+    GattByteView uuid;
+    int32_t instance;
+    int32_t connectError;
+    int32_t readError;
+    qint64 connectMs;
+    qint64 readMs;
+    uint32_t characteristicCount;
+};
+
+struct GattCharacteristicRecord
+{
+    GattByteView uuid;
+    uint16_t handle;
+    uint16_t valueHandle;
+    uint32_t properties;
+    int32_t readError;
+    GattByteView value;
+};
+
+/*
+ * Walks an encoded snapshot in place. Call readDevice() once, then for each
+ * service nextService() followed by its characteristicCount calls to
+ * nextCharacteristic(). Every call returns false, and the reader stays in
+ * the failed state, as soon as the buffer turns out to be short or malformed.
+ */
+class GattSnapshotReader
+{
+public:
+    GattSnapshotReader(const char *data, int length);
+    explicit GattSnapshotReader(const QByteArray &buffer);
+
+    bool readDevice(GattDeviceRecord &device);
+    bool nextService(GattServiceRecord &service);
+    bool nextCharacteristic(GattCharacteristicRecord &characteristic);
+
+    bool atEnd() const;
+    bool failed() const;
+
+    static bool decode(const QByteArray &buffer, GattDeviceSnapshot &snapshot);
+
+private:
+    bool take(int count, const char **out);
+    bool readU16(uint16_t &value);
+    bool readU32(uint32_t &value);
+    bool readI64(qint64 &value);
+    bool readString(GattByteView &view);
+    bool readBytes(GattByteView &view);
+
+    const char *_data;
+    int _length;
+    int _pos;
+    bool _failed;
+};
+
+/*
+ * Writes a snapshot as JSON straight to a QIODevice. Output goes through a
+ * small fixed buffer rather than a QVariantMap tree, so memory use does not
+ * grow with the size of the peripheral's database.
+ */
+class GattSnapshotJsonWriter
+{
+public:
+    explicit GattSnapshotJsonWriter(QIODevice *device);
+    ~GattSnapshotJsonWriter();
+
+    bool write(const GattDeviceSnapshot &snapshot);
+    qint64 bytesWritten() const;
+
+private:
+    void append(const char *text, int length);
+    void append(const char *text);
+    void appendString(const QString &value);
+    void appendNumber(qint64 value);
+    void appendHex(const QByteArray &value);
+    void appendKey(const char *key, bool first = false);
+    void flush();
+
+    static const int BUFFER_SIZE = 4096;
+
+    QIODevice *_device;
+    char _buffer[BUFFER_SIZE];
+    int _used;
+    qint64 _written;
+    bool _ok;
+};
+
+#endif // ifndef GATTSNAPSHOTCODEC_H
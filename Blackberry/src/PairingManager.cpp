@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2011-2013 BlackBerry Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "PairingManager.hpp"
+#include "BtApi.hpp"
+
+#include <QtCore/QtConcurrentRun>
+
+PairingManager* PairingManager::_instance;
+
+// runs on a pool thread - bt_rdev_pair() blocks until bonding completes or fails
+static int pairRemoteDevice(const QString &address)
+{
+    bt_remote_device_t *remoteDevice = BtApi::rdev_get_device(address.toAscii().constData());
+
+    if (!remoteDevice) {
+        return ENODEV;
+    }
+
+    errno = 0;
+    int err = EOK;
+    if (BtApi::rdev_pair(remoteDevice) != EOK) {
+        err = (errno != 0) ? errno : EIO;
+    }
+    BtApi::rdev_free(remoteDevice);
+
+    return err;
+}
+
+PairingManager::PairingManager(QObject *parent)
+    : QObject(parent)
+{
+}
+
+PairingManager::~PairingManager()
+{
+    QMapIterator<QFutureWatcher<int>*, QString> i(_pendingPairings);
+    while (i.hasNext()) {
+        i.next();
+        i.key()->waitForFinished();
+    }
+    _instance = 0;
+}
+
+PairingManager* PairingManager::getInstance(QObject *parent)
+{
+    if (_instance == 0) {
+        _instance = new PairingManager(parent);
+    }
+
+    return _instance;
+}
+
+PairingManager::BondState PairingManager::bondState(const QString &address) const
+{
+    return _bondCache.value(address).state;
+}
+
+bool PairingManager::isKnown(const QString &address) const
+{
+    return _bondCache.value(address).known;
+}
+
+bool PairingManager::isPaired(const QString &address) const
+{
+    return _bondCache.value(address).paired;
+}
+
+qint64 PairingManager::lastPairingDuration(const QString &address) const
+{
+    return _bondCache.value(address).lastPairingMs;
+}
+
+void PairingManager::refreshBondState(const QString &address, bool known, bool paired)
+{
+    BondEntry &entry = _bondCache[address];
+
+    if (entry.state == Bonding) {
+        // the worker will report the final state when it finishes
+        return;
+    }
+
+    bool changed = (entry.state == BondUnknown) || (entry.known != known) || (entry.paired != paired);
+
+    entry.known = known;
+    entry.paired = paired;
+    entry.state = (paired || known) ? Bonded : BondNone;
+
+    if (changed) {
+        emit bondStateChanged(address, known, paired);
+    }
+}
+
+void PairingManager::pairIfRequired(const QString &address)
+{
+    BondEntry &entry = _bondCache[address];
+
+    if (entry.paired) {
+        qDebug() << "XXXX PairingManager::pairIfRequired() - device already paired" << endl;
+        return;
+    }
+    if (entry.known) {
+        qDebug() << "XXXX PairingManager::pairIfRequired() - device already known" << endl;
+        return;
+    }
+    if (entry.state == Bonding) {
+        qDebug() << "XXXX PairingManager::pairIfRequired() - pairing already in progress" << endl;
+        return;
+    }
+
+    qDebug() << "XXXX PairingManager::pairIfRequired() - need to pair device " << address << endl;
+
+    entry.state = Bonding;
+    entry.pairingTimer.start();
+
+    QFutureWatcher<int> *watcher = new QFutureWatcher<int>(this);
+    _pendingPairings.insert(watcher, address);
+    QObject::connect(watcher, SIGNAL(finished()), this, SLOT(handlePairingFinished()));
+    watcher->setFuture(QtConcurrent::run(pairRemoteDevice, address));
+}
+
+void PairingManager::handlePairingFinished()
+{
+    QFutureWatcher<int> *watcher = static_cast<QFutureWatcher<int>*>(sender());
+    if (!watcher || !_pendingPairings.contains(watcher)) {
+        return;
+    }
+
+    QString address = _pendingPairings.take(watcher);
+    int err = watcher->result();
+    watcher->deleteLater();
+
+    BondEntry &entry = _bondCache[address];
+    entry.lastPairingMs = entry.pairingTimer.elapsed();
+
+    // re-query rather than trusting the return code, the stack may have bonded anyway
+    bool known = false;
+    bool paired = false;
+    bt_remote_device_t *remoteDevice = BtApi::rdev_get_device(address.toAscii().constData());
+    if (remoteDevice) {
+        BtApi::rdev_is_known(remoteDevice, &known);
+        BtApi::rdev_is_paired(remoteDevice, &paired);
+        BtApi::rdev_free(remoteDevice);
+    }
+
+    entry.known = known;
+    entry.paired = paired;
+    entry.state = (paired || known) ? Bonded : BondFailed;
+
+    if (err == EOK) {
+        qDebug() << "XXXX PairingManager::handlePairingFinished() - " << address << " paired in " << entry.lastPairingMs << "ms" << endl;
+    } else {
+        qDebug() << "XXXX PairingManager::handlePairingFinished() - " << address << " bt_rdev_pair() failed after " << entry.lastPairingMs << "ms errno=(" << err << ") " << strerror(err) << endl;
+    }
+
+    emit bondStateChanged(address, known, paired);
+    emit pairingFinished(address, (err == EOK), entry.lastPairingMs);
+}
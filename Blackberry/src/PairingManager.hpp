@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2011-2013 BlackBerry Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef PAIRINGMANAGER_H
+#define PAIRINGMANAGER_H
+
+#include <stdint.h>
+#include <errno.h>
+
+#include <QObject>
+#include <QtCore/QString>
+#include <QtCore/QDebug>
+#include <QtCore/QMap>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFutureWatcher>
+
+#include <btapi/btdevice.h>
+
+/*
+ * Runs bt_rdev_pair() off the UI thread so that service enumeration does not
+ * have to wait for bonding to complete. The known/paired state of every
+ * device we have seen is cached here keyed by Bluetooth address.
+ */
+class PairingManager : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum BondState {
+        BondUnknown,
+        BondNone,
+        Bonding,
+        Bonded,
+        BondFailed
+    };
+
+    static PairingManager* getInstance(QObject *parent = 0);
+
+    BondState bondState(const QString &address) const;
+    bool isKnown(const QString &address) const;
+    bool isPaired(const QString &address) const;
+    qint64 lastPairingDuration(const QString &address) const;
+
+    void refreshBondState(const QString &address, bool known, bool paired);
+    void pairIfRequired(const QString &address);
+
+signals:
+    void bondStateChanged(const QString &address, bool known, bool paired);
+    void pairingFinished(const QString &address, bool ok, qint64 elapsedMs);
+
+private slots:
+    void handlePairingFinished();
+
+private:
+    PairingManager(QObject *parent = 0);
+    virtual ~PairingManager();
+
+    struct BondEntry {
+        BondEntry() : state(BondUnknown), known(false), paired(false), lastPairingMs(-1) {}
+        BondState state;
+        bool known;
+        bool paired;
+        qint64 lastPairingMs;
+        QElapsedTimer pairingTimer;
+    };
+
+    static PairingManager *_instance;
+
+    QMap<QString, BondEntry> _bondCache;
+    QMap<QFutureWatcher<int>*, QString> _pendingPairings;
+};
+
+#endif // ifndef PAIRINGMANAGER_H
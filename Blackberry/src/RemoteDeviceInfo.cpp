@@ -14,6 +14,7 @@
  */
 
 #include "RemoteDeviceInfo.hpp"
+#include "BtApi.hpp"
 
 #include <btapi/btdevice.h>
 #include <btapi/btspp.h>
@@ -28,7 +29,7 @@ RemoteDeviceInfo::RemoteDeviceInfo(QObject *parent)
 
 void RemoteDeviceInfo::populateWithDeviceAttributes(const QString &deviceAddress)
 {
-    bt_remote_device_t *remoteDevice = bt_rdev_get_device(deviceAddress.toAscii());
+    bt_remote_device_t *remoteDevice = BtApi::rdev_get_device(deviceAddress.toAscii());
 
     qDebug() << "YYYY RemoteDeviceInfo::populateWithDeviceAttributes : deviceAddress" << deviceAddress;
 
@@ -42,7 +43,7 @@ void RemoteDeviceInfo::populateWithDeviceAttributes(const QString &deviceAddress
     const QString unknown = "Unknown";
     const QString notAvailable = tr("N/A");
 
-    ok = (bt_rdev_get_friendly_name(remoteDevice, buffer, bufferSize) == 0);
+    ok = (BtApi::rdev_get_friendly_name(remoteDevice, buffer, bufferSize) == 0);
 
     qDebug() << "YYYY RemoteDeviceInfo::getting device name";
     _name = (ok ? QString::fromLatin1(buffer) : unknown);
@@ -50,7 +51,7 @@ void RemoteDeviceInfo::populateWithDeviceAttributes(const QString &deviceAddress
 
     _address = deviceAddress;
 
-    const int deviceClass = bt_rdev_get_device_class(remoteDevice, BT_COD_DEVICECLASS);
+    const int deviceClass = BtApi::rdev_get_device_class(remoteDevice, BT_COD_DEVICECLASS);
     if (deviceClass >= 0) {
         _deviceClass.sprintf("0x%x", deviceClass);
     } else {
@@ -58,31 +59,31 @@ void RemoteDeviceInfo::populateWithDeviceAttributes(const QString &deviceAddress
     }
     _deviceClassInt = deviceClass;
 
-    const int deviceType = bt_rdev_get_type(remoteDevice);
+    const int deviceType = BtApi::rdev_get_type(remoteDevice);
     _deviceType = ((deviceType == BT_DEVICE_TYPE_LE_PUBLIC || deviceType == BT_DEVICE_TYPE_LE_PUBLIC) ? tr("Low energy") : tr("Regular"));
     _deviceTypeInt = deviceType;
 
     bool known = false;
-    ok = (bt_rdev_is_known(remoteDevice, &known) == 0);
+    ok = (BtApi::rdev_is_known(remoteDevice, &known) == 0);
     _known = (ok ? (known ? tr("true") : tr("false")) : unknown);
     _knownBool = known;
 
-    _encrypted = ((bt_rdev_is_encrypted(remoteDevice) >= 0) ? tr("true") : tr("false"));
-    _encryptedBool = bt_rdev_is_encrypted(remoteDevice);
+    _encrypted = ((BtApi::rdev_is_encrypted(remoteDevice) >= 0) ? tr("true") : tr("false"));
+    _encryptedBool = BtApi::rdev_is_encrypted(remoteDevice);
 
     bool paired = false;
-    ok = (bt_rdev_is_paired(remoteDevice, &paired) == 0);
+    ok = (BtApi::rdev_is_paired(remoteDevice, &paired) == 0);
     _paired = (ok ? (paired ? tr("true") : tr("false")) : unknown);
     _pairedBool = paired;
 
-    _trusted = (bt_rdev_is_trusted(remoteDevice) ? tr("true") : tr("false"));
+    _trusted = (BtApi::rdev_is_trusted(remoteDevice) ? tr("true") : tr("false"));
 
     int rssi = 0;
-    ok = (bt_rdev_get_rssi(remoteDevice, &rssi) == 0);
+    ok = (BtApi::rdev_get_rssi(remoteDevice, &rssi) == 0);
     _rssi = (ok ? QString::number(rssi) : unknown);
 
     uint16_t minConnIvl, maxConnIvl, latency, superTmo, appearance;
-    ok = (bt_rdev_get_le_conn_params(remoteDevice, &minConnIvl, &maxConnIvl, &latency, &superTmo) == 0);
+    ok = (BtApi::rdev_get_le_conn_params(remoteDevice, &minConnIvl, &maxConnIvl, &latency, &superTmo) == 0);
 
     _minimumConnectionInterval = (ok ? QString::number(minConnIvl) : notAvailable);
     _maximumConnectionInterval = (ok ? QString::number(maxConnIvl) : notAvailable);
@@ -90,7 +91,7 @@ void RemoteDeviceInfo::populateWithDeviceAttributes(const QString &deviceAddress
     _supervisoryTimeout = (ok ? QString::number(superTmo) : notAvailable);
 
     uint8_t flags, connectable;
-    ok = (bt_rdev_get_le_info(remoteDevice, &appearance, &flags, &connectable) == 0);
+    ok = (BtApi::rdev_get_le_info(remoteDevice, &appearance, &flags, &connectable) == 0);
 
     _appearance = (ok ? QString::number(appearance) : notAvailable);
     _flags = (ok ? QString::number(flags) : notAvailable);
@@ -98,7 +99,7 @@ void RemoteDeviceInfo::populateWithDeviceAttributes(const QString &deviceAddress
 
     _model->clear();
 
-    bt_rdev_free(remoteDevice);
+    BtApi::rdev_free(remoteDevice);
 
     emit changed();
 
@@ -0,0 +1,248 @@
+/*
+ * Copyright (c) 2011-2013 BlackBerry Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ScanDeduplicator.hpp"
+
+#include <QtCore/QElapsedTimer>
+
+ScanDeduplicator::ScanDeduplicator(int capacity)
+    : _bloom(BLOOM_BITS / 8)
+    , _entries(qMax(capacity, 1))
+    , _slotMask(0)
+    , _capacity(qMax(capacity, 1))
+    , _count(0)
+    , _head(NIL)
+    , _tail(NIL)
+{
+    // keep the index at most half full so probe sequences stay short
+    int slotCount = 1;
+    while (slotCount < _capacity * 2) {
+        slotCount <<= 1;
+    }
+    _slots.resize(slotCount);
+    _slotMask = slotCount - 1;
+
+    clear();
+}
+
+void ScanDeduplicator::clear()
+{
+    _bloom.fill(0);
+    _slots.fill(NIL);
+    _count = 0;
+    _head = NIL;
+    _tail = NIL;
+    _stats = Stats();
+}
+
+const ScanDeduplicator::Stats& ScanDeduplicator::stats() const
+{
+    return _stats;
+}
+
+// "AA:BB:CC:DD:EE:FF" packs into 48 bits, anything else is FNV-1a hashed
+quint64 ScanDeduplicator::addressKey(const char *address)
+{
+    quint64 key = 0;
+    int digits = 0;
+    const char *p;
+
+    for (p = address; *p; p++) {
+        char c = *p;
+        int v = (c >= '0' && c <= '9') ? c - '0' : (c >= 'a' && c <= 'f') ? c - 'a' + 10 : (c >= 'A' && c <= 'F') ? c - 'A' + 10 : -1;
+        if (v >= 0) {
+            key = (key << 4) | quint64(v);
+            digits++;
+        } else if (c != ':' && c != '-') {
+            break;
+        }
+    }
+
+    if (!*p && digits == 12) {
+        return key;
+    }
+
+    key = Q_UINT64_C(1469598103934665603);
+    for (p = address; *p; p++) {
+        key ^= quint8(*p);
+        key *= Q_UINT64_C(1099511628211);
+    }
+    return key | (Q_UINT64_C(1) << 63);
+}
+
+quint64 ScanDeduplicator::mix(quint64 x)
+{
+    x ^= x >> 30;
+    x *= Q_UINT64_C(0xbf58476d1ce4e5b9);
+    x ^= x >> 27;
+    x *= Q_UINT64_C(0x94d049bb133111eb);
+    x ^= x >> 31;
+    return x;
+}
+
+bool ScanDeduplicator::bloomTestAndSet(quint64 hash)
+{
+    quint32 h1 = quint32(hash);
+    quint32 h2 = quint32(hash >> 32) | 1;
+    bool present = true;
+
+    for (int i = 0; i < BLOOM_PROBES; i++) {
+        quint32 bit = (h1 + i * h2) & (BLOOM_BITS - 1);
+        quint8 mask = 1 << (bit & 7);
+        if (!(_bloom[bit >> 3] & mask)) {
+            present = false;
+            _bloom[bit >> 3] |= mask;
+        }
+    }
+    return present;
+}
+
+int ScanDeduplicator::findSlot(quint64 key, quint64 hash) const
+{
+    int slot = int(hash & _slotMask);
+
+    while (_slots[slot] != NIL && _entries[_slots[slot]].key != key) {
+        slot = (slot + 1) & _slotMask;
+    }
+    return slot;
+}
+
+// linear probing delete with backward shift, no tombstones
+void ScanDeduplicator::removeSlot(int slot)
+{
+    int next = slot;
+
+    _slots[slot] = NIL;
+    for (;;) {
+        next = (next + 1) & _slotMask;
+        if (_slots[next] == NIL) {
+            return;
+        }
+
+        int home = int(mix(_entries[_slots[next]].key) & _slotMask);
+        bool movable = (slot <= next) ? (home <= slot || home > next) : (home <= slot && home > next);
+        if (movable) {
+            _slots[slot] = _slots[next];
+            _slots[next] = NIL;
+            slot = next;
+        }
+    }
+}
+
+void ScanDeduplicator::unlink(int index)
+{
+    Entry &e = _entries[index];
+
+    if (e.prev != NIL) {
+        _entries[e.prev].next = e.next;
+    } else {
+        _head = e.next;
+    }
+    if (e.next != NIL) {
+        _entries[e.next].prev = e.prev;
+    } else {
+        _tail = e.prev;
+    }
+    e.prev = e.next = NIL;
+}
+
+void ScanDeduplicator::pushFront(int index)
+{
+    Entry &e = _entries[index];
+
+    e.prev = NIL;
+    e.next = _head;
+    if (_head != NIL) {
+        _entries[_head].prev = index;
+    }
+    _head = index;
+    if (_tail == NIL) {
+        _tail = index;
+    }
+}
+
+void ScanDeduplicator::remember(quint64 key, quint64 hash)
+{
+    int index;
+
+    if (_count < _capacity) {
+        index = _count++;
+    } else {
+        index = _tail;
+        quint64 oldKey = _entries[index].key;
+        removeSlot(findSlot(oldKey, mix(oldKey)));
+        unlink(index);
+        _stats.evictions++;
+    }
+
+    _entries[index].key = key;
+    _slots[findSlot(key, hash)] = index;
+    pushFront(index);
+}
+
+ScanDeduplicator::Result ScanDeduplicator::lookup(const char *address)
+{
+    if (!address) {
+        return Unsure;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    Result result;
+    quint64 key = addressKey(address);
+    quint64 hash = mix(key);
+
+    _stats.lookups++;
+
+    if (!bloomTestAndSet(hash)) {
+        remember(key, hash);
+        _stats.newAddresses++;
+        result = New;
+    } else {
+        int index = _slots[findSlot(key, hash)];
+        if (index != NIL) {
+            unlink(index);
+            pushFront(index);
+            _stats.lruHits++;
+            result = Seen;
+        } else {
+            remember(key, hash);
+            _stats.unsure++;
+            result = Unsure;
+        }
+    }
+
+    _stats.lookupNs += timer.nsecsElapsed();
+    return result;
+}
+
+void ScanDeduplicator::confirm(bool wasNew)
+{
+    if (wasNew) {
+        _stats.falsePositives++;
+        _stats.newAddresses++;
+    }
+}
+
+void ScanDeduplicator::logStats() const
+{
+    qDebug() << "XXXX ScanDeduplicator - lookups=" << _stats.lookups << " new=" << _stats.newAddresses
+             << " lruHits=" << _stats.lruHits << " unsure=" << _stats.unsure
+             << " falsePositives=" << _stats.falsePositives << " evictions=" << _stats.evictions
+             << " table=" << _count << "/" << _capacity
+             << " avg=" << (_stats.lookups ? _stats.lookupNs / _stats.lookups : 0) << "ns" << endl;
+}
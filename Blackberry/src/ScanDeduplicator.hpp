@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2011-2013 BlackBerry Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef SCANDEDUPLICATOR_H
+#define SCANDEDUPLICATOR_H
+
+#include <stdint.h>
+
+#include <QtCore/QDebug>
+#include <QtCore/QVector>
+
+/*
+ * Answers "has this address been seen during the current scan" in constant
+ * time. A bloom filter rejects addresses that were never seen, a fixed size
+ * LRU table confirms the recently seen ones. When the filter matches but the
+ * address has already been evicted from the table the result is Unsure and
+ * the caller has to check its own list, then report back with confirm().
+ * All storage is sized in the constructor; lookup() does not allocate.
+ */
+class ScanDeduplicator
+{
+public:
+    enum Result {
+        New,
+        Seen,
+        Unsure
+    };
+
+    struct Stats {
+        Stats() : lookups(0), newAddresses(0), lruHits(0), unsure(0), falsePositives(0), evictions(0), lookupNs(0) {}
+        quint64 lookups;
+        quint64 newAddresses;
+        quint64 lruHits;
+        quint64 unsure;
+        quint64 falsePositives;
+        quint64 evictions;
+        quint64 lookupNs;
+    };
+
+    explicit ScanDeduplicator(int capacity = 4096);
+
+    void clear();
+    Result lookup(const char *address);
+    void confirm(bool wasNew);
+
+    const Stats& stats() const;
+    void logStats() const;
+
+private:
+    static const int BLOOM_BITS = 1 << 16;
+    static const int BLOOM_PROBES = 3;
+    static const int NIL = -1;
+
+    struct Entry {
+        Entry() : key(0), prev(NIL), next(NIL) {}
+        quint64 key;
+        int prev;
+        int next;
+    };
+
+    static quint64 addressKey(const char *address);
+    static quint64 mix(quint64 x);
+
+    bool bloomTestAndSet(quint64 hash);
+    int findSlot(quint64 key, quint64 hash) const;
+    void removeSlot(int slot);
+    void unlink(int index);
+    void pushFront(int index);
+    void remember(quint64 key, quint64 hash);
+
+    QVector<quint8> _bloom;
+    QVector<Entry> _entries;
+    QVector<int> _slots;
+    int _slotMask;
+    int _capacity;
+    int _count;
+    int _head;
+    int _tail;
+    Stats _stats;
+};
+
+#endif // ifndef SCANDEDUPLICATOR_H
@@ -15,7 +15,10 @@
  */
 
 #include "ServicesManager.hpp"
+#include "BtApi.hpp"
 #include "CharacteristicsManager.hpp"
+#include "PairingManager.hpp"
+#include "SignalCoalescer.hpp"
 
 ServicesManager* ServicesManager::_instance;
 QString ServicesManager::KEY_SERVICE_UUID = "service_uuid";
@@ -36,10 +39,15 @@ ServicesManager::ServicesManager(QObject *parent)
 {
 	qRegisterMetaType<ServiceList_t>("ServiceList");
 
-	createWellKnownServiceList();
+	// the well-known service list is built on first use, it isn't needed for the first screen
 
 	QObject::connect(parent, SIGNAL(deviceSelected(QVariant,QVariant)),
 					   this,   SLOT(deviceSelected(QVariant,QVariant)));
+
+	QObject::connect(PairingManager::getInstance(), SIGNAL(bondStateChanged(QString,bool,bool)),
+					   this,   SLOT(bondStateChanged(QString,bool,bool)));
+	QObject::connect(PairingManager::getInstance(), SIGNAL(pairingFinished(QString,bool,qint64)),
+					   this,   SLOT(pairingFinished(QString,bool,qint64)));
 }
 
 ServicesManager::~ServicesManager()
@@ -70,7 +78,7 @@ void ServicesManager::enumerateServices(bt_remote_device_t *remoteDevice)
 	int rc = 0;
 	char btAddress[18];
 
-	rc = bt_rdev_get_address(remoteDevice, btAddress);
+	rc = BtApi::rdev_get_address(remoteDevice, btAddress);
 	if (rc == EOK) {
 	    qDebug() << "XXXX ServicesManager::enumerateServices() - setting address : " << btAddress << endl;
 		setPeripheralAddress(btAddress);
@@ -79,7 +87,7 @@ void ServicesManager::enumerateServices(bt_remote_device_t *remoteDevice)
 	}
 
 	char btName[256];
-	rc = bt_rdev_get_remote_name(remoteDevice, btName, sizeof(btName));
+	rc = BtApi::rdev_get_remote_name(remoteDevice, btName, sizeof(btName));
 	if (rc == EOK) {
 	    qDebug() << "XXXX ServicesManager::enumerateServices() - setting name : " << btName << endl;
 		setPeripheralName(btName);
@@ -90,36 +98,31 @@ void ServicesManager::enumerateServices(bt_remote_device_t *remoteDevice)
 	_peripheralKnown = false;
 	_peripheralPaired = false;
 
-	bt_rdev_is_known(remoteDevice, &_peripheralKnown);
-	bt_rdev_is_paired(remoteDevice, &_peripheralPaired);
+	BtApi::rdev_is_known(remoteDevice, &_peripheralKnown);
+	BtApi::rdev_is_paired(remoteDevice, &_peripheralPaired);
 
     qDebug() << "XXXX ServicesManager::enumerateServices() - _peripheralKnown: " << _peripheralKnown <<  ", _peripheralPaired: " << _peripheralPaired << endl;
 
-	pairDeviceIfRequired(remoteDevice);
-
-	bt_rdev_is_known(remoteDevice, &_peripheralKnown);
-	bt_rdev_is_paired(remoteDevice, &_peripheralPaired);
+	// Pairing runs asynchronously - the outcome arrives via bondStateChanged() while
+	// we carry on listing the services the stack already knows about
 
-    qDebug() << "XXXX ServicesManager::enumerateServices() - _peripheralKnown: " << _peripheralKnown <<  ", _peripheralPaired: " << _peripheralPaired << endl;
-
-	// Let DataContainer know that paired or known status may have changed as a result
-
-	DataContainer::getInstance()->setKnown(_peripheralIndex, _peripheralKnown);
-	DataContainer::getInstance()->setPaired(_peripheralIndex, _peripheralPaired);
+	PairingManager *pm = PairingManager::getInstance();
+	pm->refreshBondState(_peripheralAddress, _peripheralKnown, _peripheralPaired);
+	pm->pairIfRequired(_peripheralAddress);
 
 	int numberOfServices = 0;
-    const int deviceType = bt_rdev_get_type(remoteDevice);
+    const int deviceType = BtApi::rdev_get_type(remoteDevice);
 
     if ((deviceType == BT_DEVICE_TYPE_LE_PUBLIC) || (deviceType == BT_DEVICE_TYPE_LE_PRIVATE)) {
 	    qDebug() << "XXXX ServicesManager::enumerateServices() - suitable BTLE device type" << endl;
-		char **servicesArray = bt_rdev_get_services_gatt(remoteDevice);
+		char **servicesArray = BtApi::rdev_get_services_gatt(remoteDevice);
 		if (servicesArray) {
 			for (int i = 0; servicesArray[i]; i++) {
 				numberOfServices++;
 				addService(QString(servicesArray[i]));
 			    qDebug() << "XXXX ServicesManager::enumerateServices() - adding service : " << servicesArray[i] << endl;
 			}
-			bt_rdev_free_services(servicesArray);
+			BtApi::rdev_free_services(servicesArray);
 		} else {
 		    qDebug() << "XXXX ServicesManager::enumerateServices() - unable to get service list - errno : " << strerror(errno) << endl;
 		}
@@ -131,43 +134,49 @@ void ServicesManager::enumerateServices(bt_remote_device_t *remoteDevice)
 
 	_numberOfServices = numberOfServices;
 
-	emit setServiceCount(QVariant(_numberOfServices));
-    emit servicesChanged();
+	SignalCoalescer::getInstance()->post(this, "setServiceCount", QVariantList() << QVariant(_numberOfServices));
+    SignalCoalescer::getInstance()->post(this, "servicesChanged");
 }
 
-void ServicesManager::pairDeviceIfRequired(bt_remote_device_t *remoteDevice)
+void ServicesManager::bondStateChanged(const QString &address, bool known, bool paired)
 {
-    qDebug() << "XXXX ServicesManager::pairDevice()" << endl;
-
-    if (remoteDevice) {
-    	if (_peripheralPaired) {
-            qDebug() << "XXXX BlueToothLe::pairDevice() - device already paired" << endl;
-
-    	} else if (_peripheralKnown) {
-            qDebug() << "XXXX BlueToothLe::pairDevice() - device already known" << endl;
-
-    	} else {
-            qDebug() << "XXXX BlueToothLe::pairDevice() - need to pair device" << endl;
-            errno = 0;
-            if ((bt_rdev_pair(remoteDevice) == EOK)) {
-                qDebug() << "XXXX BlueToothLe::pairDevice() - bt_rdev_pair() request success" << endl;
-            } else {
-                qDebug() << "XXXX BlueToothLe::pairDevice() - bt_rdev_pair() failed errno=(" << errno << ") " << strerror(errno) << endl;
-            }
-        }
-    }
+	if (address.compare(_peripheralAddress, Qt::CaseInsensitive) != 0) {
+		return;
+	}
+
+	_peripheralKnown = known;
+	_peripheralPaired = paired;
+
+    qDebug() << "XXXX ServicesManager::bondStateChanged() - _peripheralKnown: " << _peripheralKnown <<  ", _peripheralPaired: " << _peripheralPaired << endl;
+
+	// Let DataContainer know that paired or known status may have changed as a result
+
+	DataContainer *dc = DataContainer::getInstance();
+	int deviceIndex = dc->getDeviceIndex(address);
+	if (deviceIndex < 0) {
+		deviceIndex = _peripheralIndex;
+	}
+	dc->setKnown(deviceIndex, _peripheralKnown);
+	dc->setPaired(deviceIndex, _peripheralPaired);
+}
+
+void ServicesManager::pairingFinished(const QString &address, bool ok, qint64 elapsedMs)
+{
+    qDebug() << "XXXX ServicesManager::pairingFinished() - " << address << (ok ? " paired" : " not paired") << " in " << elapsedMs << "ms" << endl;
+
+	emit peripheralPairingFinished(address, ok, elapsedMs);
 }
 
 void ServicesManager::setPeripheralAddress(const QString &address)
 {
 	_peripheralAddress = address;
-	emit peripheralAddressChanged(address);
+	SignalCoalescer::getInstance()->post(this, "peripheralAddressChanged", QVariantList() << address);
 }
 
 void ServicesManager::setPeripheralName(const QString &name)
 {
 	_peripheralName = name;
-	emit peripheralNameChanged(name);
+	SignalCoalescer::getInstance()->post(this, "peripheralNameChanged", QVariantList() << name);
 }
 
 QString ServicesManager::peripheralName() const
@@ -196,6 +205,7 @@ void ServicesManager::addService(const QString &uuid)
     qDebug() << "XXXX ServicesManager::addService() : " << uuid << endl;
     qDebug() << "XXXX ServicesManager::addService() : " << serviceDescription(uuid) << endl;
 
+    // one emission per service, each with its own data, so not coalesced
     emit foundService(uuid, serviceDescription(uuid));
 }
 
@@ -206,7 +216,7 @@ void ServicesManager::resetServices()
 
 	_services.clear();
 
-	emit servicesChanged();
+	SignalCoalescer::getInstance()->post(this, "servicesChanged");
 }
 
 
@@ -250,7 +260,7 @@ void ServicesManager::deviceSelected(const QVariant &device_index, const QVarian
 
     qDebug() << "XXXX ServicesManager::deviceSelected() - device index : " << _peripheralIndex << endl;
 
-    bt_remote_device_t *remoteDevice = bt_rdev_get_device(deviceAddress.toString().toAscii().constData());
+    bt_remote_device_t *remoteDevice = BtApi::rdev_get_device(deviceAddress.toString().toAscii().constData());
 
     if (remoteDevice != NULL) {
 
@@ -259,11 +269,20 @@ void ServicesManager::deviceSelected(const QVariant &device_index, const QVarian
     } else {
         qDebug() << "XXXX ServicesManager::deviceSelected() invalid remote device" << endl;
     }
-    bt_rdev_free(remoteDevice);
+    BtApi::rdev_free(remoteDevice);
+}
+
+void ServicesManager::ensureWellKnownServices()
+{
+	if (_wellKnownServices.isEmpty()) {
+		createWellKnownServiceList();
+	}
 }
 
 QString ServicesManager::serviceDescription(const QString &uuid)
 {
+	ensureWellKnownServices();
+
 	QListIterator<ServiceItem_t> sit(_wellKnownServices);
 
 	while (sit.hasNext()) {
@@ -278,6 +297,8 @@ QString ServicesManager::serviceDescription(const QString &uuid)
 
 QString ServicesManager::serviceIcon(const QString &uuid)
 {
+	ensureWellKnownServices();
+
 	QListIterator<ServiceItem_t> sit(_wellKnownServices);
 
 	while (sit.hasNext()) {
@@ -292,6 +313,8 @@ QString ServicesManager::serviceIcon(const QString &uuid)
 
 bool ServicesManager::isWellKnownService(const QString &uuid)
 {
+	ensureWellKnownServices();
+
 	QListIterator<ServiceItem_t> sit(_wellKnownServices);
 
 	while (sit.hasNext()) {
@@ -81,9 +81,9 @@ private:
 	ServicesManager(QObject *parent = 0);
 	virtual ~ServicesManager();
 	void createWellKnownServiceList();
+	void ensureWellKnownServices();
 
 	void enumerateServices(bt_remote_device_t *remoteDevice);
-	void pairDeviceIfRequired(bt_remote_device_t *remoteDevice);
 
 	static QString DEFAULT_SERVICE_ICON;
 	static ServicesManager *_instance;
@@ -104,10 +104,15 @@ signals:
 	void serviceSelected(const QString &uuid);
 	void foundService(const QString &uuid, const QString &description);
     void setServiceCount(QVariant count);
+    void peripheralPairingFinished(const QString &address, bool ok, qint64 elapsedMs);
 
 public slots:
     void selectService(const QString &uuid);
     void deviceSelected(const QVariant &device_index, const QVariant &deviceAddress);
+
+private slots:
+    void bondStateChanged(const QString &address, bool known, bool paired);
+    void pairingFinished(const QString &address, bool ok, qint64 elapsedMs);
 };
 
 #endif // ifndef SERVICESMANAGER_H
@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2011-2013 BlackBerry Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "SignalCoalescer.hpp"
+
+#include <QtCore/QMetaMethod>
+#include <QtCore/QMetaObject>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QThread>
+
+SignalCoalescer* SignalCoalescer::_instance;
+
+// QMetaObject::invokeMethod() takes at most ten arguments
+static const int MAX_SIGNAL_ARGS = 10;
+
+static QString counterName(const QObject *sender, const char *signal)
+{
+    return QString("%1::%2").arg(sender->metaObject()->className()).arg(signal);
+}
+
+SignalCoalescer::SignalCoalescer(QObject *parent)
+    : QObject(parent)
+    , _flushScheduled(false)
+{
+    _frameTimer.setSingleShot(true);
+    _frameTimer.setInterval(FRAME_INTERVAL_MS);
+    QObject::connect(&_frameTimer, SIGNAL(timeout()), this, SLOT(flush()));
+}
+
+SignalCoalescer::~SignalCoalescer()
+{
+    logStatistics();
+    _instance = 0;
+}
+
+SignalCoalescer* SignalCoalescer::getInstance(QObject *parent)
+{
+    if (_instance == 0) {
+        _instance = new SignalCoalescer(parent);
+    }
+
+    return _instance;
+}
+
+void SignalCoalescer::post(QObject *sender, const char *signal, const QVariantList &args)
+{
+    if (!sender || !signal) {
+        return;
+    }
+
+    const QString name = counterName(sender, signal);
+    const QString key = name + '@' + QString::number(reinterpret_cast<quintptr>(sender), 16);
+    bool schedule = false;
+
+    {
+        QMutexLocker locker(&_mutex);
+
+        Pending &pending = _pending[key];
+        pending.sender = sender;
+        pending.name = name;
+        pending.signal = signal;
+        pending.args = args;
+
+        // re-posting moves the signal to the back so that signals are delivered
+        // in the order of their last posting
+        _order.removeOne(key);
+        _order.append(key);
+
+        _counters[name].posted++;
+
+        if (!_flushScheduled) {
+            _flushScheduled = true;
+            schedule = true;
+        }
+    }
+
+    if (schedule) {
+        if (QThread::currentThread() == thread()) {
+            scheduleFlush();
+        } else {
+            QMetaObject::invokeMethod(this, "scheduleFlush", Qt::QueuedConnection);
+        }
+    }
+}
+
+void SignalCoalescer::scheduleFlush()
+{
+    if (!_frameTimer.isActive()) {
+        _frameTimer.start();
+    }
+}
+
+void SignalCoalescer::flush()
+{
+    QList<QString> order;
+    QHash<QString, Pending> pending;
+
+    {
+        QMutexLocker locker(&_mutex);
+        order.swap(_order);
+        pending.swap(_pending);
+        _flushScheduled = false;
+    }
+
+    // emitted without the lock held - a handler is free to post again, that
+    // simply lands in the next frame
+    foreach (const QString &key, order) {
+        const Pending &p = pending[key];
+        if (p.sender.isNull() || !emitPending(p)) {
+            continue;
+        }
+
+        QMutexLocker locker(&_mutex);
+        _counters[p.name].emitted++;
+    }
+}
+
+bool SignalCoalescer::emitPending(const Pending &pending)
+{
+    const QMetaObject *meta = pending.sender->metaObject();
+    int index = -1;
+
+    for (int i = 0; i < meta->methodCount() && index < 0; i++) {
+        QMetaMethod method = meta->method(i);
+        if (method.methodType() != QMetaMethod::Signal) {
+            continue;
+        }
+        QByteArray signature(method.signature());
+        if (signature.left(signature.indexOf('(')) == pending.signal
+                && method.parameterTypes().size() == pending.args.size()) {
+            index = i;
+        }
+    }
+
+    if (index < 0 || pending.args.size() > MAX_SIGNAL_ARGS) {
+        qDebug() << "XXXX SignalCoalescer::emitPending() - no signal" << pending.signal << "with" << pending.args.size() << "arguments on" << meta->className() << endl;
+        return false;
+    }
+
+    // convert every argument to the declared parameter type so that e.g. an
+    // int posted for a qint64 parameter still matches the signature
+    QList<QByteArray> types = meta->method(index).parameterTypes();
+    QVariantList values = pending.args;
+    QGenericArgument arguments[MAX_SIGNAL_ARGS];
+
+    for (int i = 0; i < values.size(); i++) {
+        if (types[i] == "QVariant") {
+            arguments[i] = QGenericArgument("QVariant", &values[i]);
+            continue;
+        }
+        int type = QMetaType::type(types[i].constData());
+        if (type < int(QVariant::UserType) && !values[i].convert(QVariant::Type(type))) {
+            qDebug() << "XXXX SignalCoalescer::emitPending() - cannot convert argument" << i << "of" << pending.signal << "to" << types[i] << endl;
+            return false;
+        }
+        arguments[i] = QGenericArgument(types[i].constData(), values[i].constData());
+    }
+
+    return QMetaObject::invokeMethod(pending.sender, pending.signal.constData(), Qt::DirectConnection,
+            arguments[0], arguments[1], arguments[2], arguments[3], arguments[4],
+            arguments[5], arguments[6], arguments[7], arguments[8], arguments[9]);
+}
+
+QVariantMap SignalCoalescer::statistics() const
+{
+    QMutexLocker locker(&_mutex);
+    QVariantMap stats;
+
+    QHashIterator<QString, Counter> i(_counters);
+    while (i.hasNext()) {
+        i.next();
+        QVariantMap entry;
+        entry["posted"] = i.value().posted;
+        entry["emitted"] = i.value().emitted;
+        entry["absorbed"] = i.value().posted - i.value().emitted;
+        stats[i.key()] = entry;
+    }
+
+    return stats;
+}
+
+void SignalCoalescer::resetStatistics()
+{
+    QMutexLocker locker(&_mutex);
+    _counters.clear();
+}
+
+void SignalCoalescer::logStatistics() const
+{
+    QMutexLocker locker(&_mutex);
+
+    QHashIterator<QString, Counter> i(_counters);
+    while (i.hasNext()) {
+        i.next();
+        qDebug() << "XXXX SignalCoalescer -" << i.key() << "posted" << i.value().posted
+                 << "emitted" << i.value().emitted << "absorbed" << (i.value().posted - i.value().emitted) << endl;
+    }
+}
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2011-2013 BlackBerry Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef SIGNALCOALESCER_H
+#define SIGNALCOALESCER_H
+
+#include <QObject>
+#include <QtCore/QString>
+#include <QtCore/QDebug>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QMutex>
+#include <QtCore/QPointer>
+#include <QtCore/QTimer>
+#include <QtCore/QVariant>
+
+/*
+ * Merges bursts of UI-facing signals into at most one emission per signal per
+ * frame. Instead of emitting directly, a manager posts the signal by name:
+ *
+ *     SignalCoalescer::getInstance()->post(this, "setServiceCount", QVariantList() << count);
+ *
+ * The last arguments posted win. Once per frame the pending signals are
+ * emitted on the sender, in the order they were last posted, so connections
+ * and QML handlers see exactly the same signals as before, only fewer of
+ * them. Only state-like signals should go through here - counts and *Changed
+ * notifications, where the latest value is all a receiver needs. Events such
+ * as scanStarted()/scanStopped() or connected/disconnected pairs, and anything
+ * where each emission carries distinct data, must still be emitted directly.
+ *
+ * post() may be called from any thread; the signals are emitted on the
+ * thread the coalescer lives in.
+ */
+class SignalCoalescer : public QObject
+{
+    Q_OBJECT
+
+public:
+    static SignalCoalescer* getInstance(QObject *parent = 0);
+
+    static const int FRAME_INTERVAL_MS = 16;
+
+    void post(QObject *sender, const char *signal, const QVariantList &args = QVariantList());
+
+    // emissions posted and actually delivered per "Class::signal"
+    Q_INVOKABLE QVariantMap statistics() const;
+    Q_INVOKABLE void resetStatistics();
+    void logStatistics() const;
+
+public slots:
+    void flush();
+
+private slots:
+    void scheduleFlush();
+
+private:
+    SignalCoalescer(QObject *parent = 0);
+    virtual ~SignalCoalescer();
+
+    struct Pending {
+        QPointer<QObject> sender;
+        QString name;           // counter name, kept since a handler may delete the sender
+        QByteArray signal;
+        QVariantList args;
+    };
+
+    struct Counter {
+        Counter() : posted(0), emitted(0) {}
+        quint64 posted;
+        quint64 emitted;
+    };
+
+    bool emitPending(const Pending &pending);
+
+    static SignalCoalescer *_instance;
+
+    mutable QMutex _mutex;
+    QList<QString> _order;
+    QHash<QString, Pending> _pending;
+    QHash<QString, Counter> _counters;
+    bool _flushScheduled;
+    QTimer _frameTimer;
+};
+
+#endif // ifndef SIGNALCOALESCER_H
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2011-2013 BlackBerry Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "StartupProfiler.hpp"
+
+#include <stdlib.h>
+
+StartupProfiler* StartupProfiler::_instance;
+
+StartupProfiler::StartupProfiler()
+    : _lastMarkMs(0)
+    , _firstFrameMs(-1)
+    , _budgetMs(DEFAULT_BUDGET_MS)
+{
+    const char *budget = getenv("STARTUP_BUDGET_MS");
+    if (budget && atoi(budget) > 0) {
+        _budgetMs = atoi(budget);
+    }
+}
+
+StartupProfiler* StartupProfiler::getInstance()
+{
+    if (_instance == 0) {
+        _instance = new StartupProfiler;
+    }
+    return _instance;
+}
+
+void StartupProfiler::start()
+{
+    _phases.clear();
+    _lastMarkMs = 0;
+    _firstFrameMs = -1;
+    _clock.start();
+}
+
+void StartupProfiler::mark(const QString &phase)
+{
+    if (!_clock.isValid()) {
+        return;
+    }
+
+    qint64 now = _clock.elapsed();
+
+    Phase p;
+    p.name = phase;
+    p.durationMs = now - _lastMarkMs;
+    p.beforeFirstFrame = (_firstFrameMs < 0);
+    _phases.append(p);
+
+    _lastMarkMs = now;
+}
+
+void StartupProfiler::firstFrame()
+{
+    mark("first frame");
+    _firstFrameMs = _lastMarkMs;
+}
+
+void StartupProfiler::report() const
+{
+    qDebug() << "XXXX StartupProfiler - phase breakdown, budget" << _budgetMs << "ms" << endl;
+
+    qint64 total = 0;
+    foreach (const Phase &p, _phases) {
+        total += p.durationMs;
+        qDebug() << "XXXX StartupProfiler -" << (p.beforeFirstFrame ? "  " : "+ ") << p.name << ":" << p.durationMs << "ms"
+                 << "(" << (_budgetMs > 0 ? (100 * p.durationMs) / _budgetMs : 0) << "% of budget )" << endl;
+    }
+
+    if (_firstFrameMs < 0) {
+        qDebug() << "XXXX StartupProfiler - first frame not reached after" << total << "ms" << endl;
+    } else if (isOverBudget()) {
+        qDebug() << "XXXX StartupProfiler - OVER BUDGET: first frame after" << _firstFrameMs << "ms, budget" << _budgetMs << "ms" << endl;
+    } else {
+        qDebug() << "XXXX StartupProfiler - first frame after" << _firstFrameMs << "ms, within budget of" << _budgetMs << "ms" << endl;
+    }
+    qDebug() << "XXXX StartupProfiler - deferred work (+) done after" << total << "ms" << endl;
+}
+
+void StartupProfiler::setBudget(int ms)
+{
+    _budgetMs = ms;
+}
+
+int StartupProfiler::budget() const
+{
+    return _budgetMs;
+}
+
+qint64 StartupProfiler::timeToFirstFrame() const
+{
+    return _firstFrameMs;
+}
+
+bool StartupProfiler::isOverBudget() const
+{
+    return _firstFrameMs > _budgetMs;
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2011-2013 BlackBerry Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef STARTUPPROFILER_H
+#define STARTUPPROFILER_H
+
+#include <QtCore/QDebug>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QList>
+#include <QtCore/QString>
+
+/*
+ * Times the phases of application startup. start() is called first thing in
+ * main(), mark() at the end of each phase and firstFrame() once the scene has
+ * been handed to Cascades and the event loop is running. report() logs a
+ * breakdown of every phase and checks the time to first frame against the
+ * budget, which defaults to DEFAULT_BUDGET_MS and can be overridden with the
+ * STARTUP_BUDGET_MS environment variable.
+ */
+class StartupProfiler
+{
+public:
+    static StartupProfiler* getInstance();
+
+    static const int DEFAULT_BUDGET_MS = 500;
+
+    void start();
+    void mark(const QString &phase);
+    void firstFrame();
+    void report() const;
+
+    void setBudget(int ms);
+    int budget() const;
+    qint64 timeToFirstFrame() const;
+    bool isOverBudget() const;
+
+private:
+    StartupProfiler();
+
+    struct Phase {
+        QString name;
+        qint64 durationMs;
+        bool beforeFirstFrame;
+    };
+
+    static StartupProfiler *_instance;
+
+    QElapsedTimer _clock;
+    qint64 _lastMarkMs;
+    qint64 _firstFrameMs;
+    int _budgetMs;
+    QList<Phase> _phases;
+};
+
+#endif // ifndef STARTUPPROFILER_H
@@ -15,9 +15,16 @@
 
 #include "applicationui.hpp"
 
+#include "BtFault.hpp"
+#include "BtTrace.hpp"
 #include "DevicesManager.hpp"
 #include "ServicesManager.hpp"
 #include "CharacteristicsManager.hpp"
+#include "PairingManager.hpp"
+#include "DeviceCrawler.hpp"
+#include "GattScheduler.hpp"
+#include "SignalCoalescer.hpp"
+#include "StartupProfiler.hpp"
 #include "Timer.hpp"
 
 #include <bb/cascades/Application>
@@ -28,6 +35,7 @@
 #include <bb/cascades/SceneCover>
 
 #include <bb/device/DisplayInfo>
+#include <QTimer>
 #include <unistd.h>
 
 using namespace bb::cascades;
@@ -35,8 +43,10 @@ using namespace bb::cascades;
 static AbstractPane *_root = 0;
 
 ApplicationUI::ApplicationUI(bb::cascades::Application *app) :
-        QObject(app)
+        QObject(app), _mainPage(0)
 {
+    StartupProfiler *profiler = StartupProfiler::getInstance();
+
     // prepare the localization
     m_pTranslator = new QTranslator(this);
     m_pLocaleHandler = new LocaleHandler(this);
@@ -54,16 +64,25 @@ ApplicationUI::ApplicationUI(bb::cascades::Application *app) :
     // want to instantiate these singletons here first so they're hooked
     // into QObject hierarchy under this QObject.
 
+    SignalCoalescer::getInstance(this);
+    // before any btapi call so that a recording or replay covers the session
+    BtTrace::getInstance(this)->startFromEnvironment();
+    BtFault::getInstance(this)->startFromEnvironment();
+    GattScheduler::getInstance(this);
     DevicesManager *dm = DevicesManager::getInstance(this);
+    PairingManager::getInstance(this);
     ServicesManager *sm = ServicesManager::getInstance(this);
     CharacteristicsManager *cm = CharacteristicsManager::getInstance(this);
+    DeviceCrawler *crawler = DeviceCrawler::getInstance(this);
     DataContainer *dc = DataContainer::getInstance();
 
     Q_ASSERT(sm != NULL);
     Q_ASSERT(cm != NULL);
+    profiler->mark("singletons");
 
     // initial load
     onSystemLanguageChanged();
+    profiler->mark("translations");
 
     qmlRegisterType<QTimer>("utils", 1, 0, "QTimer");
     qmlRegisterType<QPropertyAnimation>("bb.cascades", 1, 0, "QPropertyAnimation");
@@ -77,34 +96,58 @@ ApplicationUI::ApplicationUI(bb::cascades::Application *app) :
     QmlDocument::defaultDeclarativeEngine()->rootContext()->setContextProperty("smgr", sm);
     QmlDocument::defaultDeclarativeEngine()->rootContext()->setContextProperty("cmgr", cm);
     QmlDocument::defaultDeclarativeEngine()->rootContext()->setContextProperty("cmgrModel", cm->model());
-
-    // set up the application's cover
-    qDebug() << "XXXX setting up active frame";
-    QmlDocument *qmlCover = QmlDocument::create("asset:///cover.qml").parent(this);
-    qmlCover->setContextProperty("data", dc);
-    Container *coverContainer = qmlCover->createRootObject<Container>();
-    SceneCover *cover = SceneCover::create().content(coverContainer);
-    Application::instance()->setCover(cover);
+    QmlDocument::defaultDeclarativeEngine()->rootContext()->setContextProperty("crawler", crawler);
 
     // Create root object for the UI
     _root = qml->createRootObject<AbstractPane>();
+    profiler->mark("main.qml");
 
     // Set created root object as the application scene
     app->setScene(_root);
-    QObject *mainPage = _root->findChild<QObject*>((const QString) "mainPage");
+    _mainPage = _root->findChild<QObject*>((const QString) "mainPage");
 
-    if (mainPage) {
+    if (_mainPage) {
         qDebug() << "XXXX found deviceCarousel";
-        QObject::connect(dm, SIGNAL(setDeviceCount(QVariant)), mainPage, SLOT(setDeviceCount(QVariant)), Qt::QueuedConnection);
-        QObject::connect(dm, SIGNAL(setDeviceCount(QVariant)), coverContainer, SLOT(setDeviceCount(QVariant)), Qt::QueuedConnection);
-        QObject::connect(dm, SIGNAL(finishedScanningForDevices()), mainPage, SLOT(stopActivityIndicator()), Qt::QueuedConnection);
-        QObject::connect(dm, SIGNAL(startedScanningForDevices()), mainPage, SLOT(startActivityIndicator()), Qt::QueuedConnection);
+        QObject::connect(dm, SIGNAL(setDeviceCount(QVariant)), _mainPage, SLOT(setDeviceCount(QVariant)), Qt::QueuedConnection);
+        QObject::connect(dm, SIGNAL(finishedScanningForDevices()), _mainPage, SLOT(stopActivityIndicator()), Qt::QueuedConnection);
+        QObject::connect(dm, SIGNAL(startedScanningForDevices()), _mainPage, SLOT(startActivityIndicator()), Qt::QueuedConnection);
     } else {
         qDebug() << "XXXX NOT found deviceCarousel";
     }
+    profiler->mark("scene");
+
+    // the cover and the device scan wait until the first screen is up - this
+    // runs on the first pass through the event loop after the scene is set
+    QTimer::singleShot(0, this, SLOT(onFirstFrame()));
+}
+
+void ApplicationUI::onFirstFrame()
+{
+    StartupProfiler *profiler = StartupProfiler::getInstance();
+    profiler->firstFrame();
+
+    createCover();
+    profiler->mark("cover.qml");
 
     findBleDevices();
+    profiler->mark("scan started");
+
+    profiler->report();
+}
+
+void ApplicationUI::createCover()
+{
+    // set up the application's cover
+    qDebug() << "XXXX setting up active frame";
+    QmlDocument *qmlCover = QmlDocument::create("asset:///cover.qml").parent(this);
+    qmlCover->setContextProperty("data", DataContainer::getInstance());
+    Container *coverContainer = qmlCover->createRootObject<Container>();
+    SceneCover *cover = SceneCover::create().content(coverContainer);
+    Application::instance()->setCover(cover);
 
+    if (_mainPage) {
+        QObject::connect(DevicesManager::getInstance(), SIGNAL(setDeviceCount(QVariant)), coverContainer, SLOT(setDeviceCount(QVariant)), Qt::QueuedConnection);
+    }
 }
 
 void ApplicationUI::findBleDevices() {
@@ -52,13 +52,17 @@ signals:
 private slots:
     void onSystemLanguageChanged();
     void finishedSearching();
+    void onFirstFrame();
 
 private:
+    void createCover();
+
     QTranslator* m_pTranslator;
     bb::cascades::LocaleHandler* m_pLocaleHandler;
     QFuture<void> *_future;
     QFutureWatcher<void> *_watcher;
     QMutex _mutex;
+    QObject *_mainPage;
 };
 
 #endif /* ApplicationUI_HPP_ */
@@ -19,6 +19,7 @@
 #include <QLocale>
 #include <QTranslator>
 #include "applicationui.hpp"
+#include "StartupProfiler.hpp"
 
 #include <Qt/qdeclarativedebug.h>
 
@@ -26,7 +27,10 @@ using namespace bb::cascades;
 
 Q_DECL_EXPORT int main(int argc, char **argv)
 {
+    StartupProfiler::getInstance()->start();
+
     Application app(argc, argv);
+    StartupProfiler::getInstance()->mark("application");
 
     // Create the Application UI object, this is where the main.qml file
     // is loaded and the application scene is set.
@@ -0,0 +1,197 @@
+/*******************************************************************************
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the License);
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *******************************************************************************/
+
+
+/**
+ * @file util_adv_data.h
+ * @since_tizen 2.3
+ * @brief
+ * Advertising data (AD structure) parser
+ *
+ * @debugtag UTIL_ADV
+ *
+ * Walks the length/type/value structures of an advertising or scan response
+ * payload in place. Nothing is copied or allocated: every field handed back
+ * points into the caller's buffer and is only valid while that buffer is.
+ * All functions take the payload length explicitly, so payloads containing
+ * zero bytes are handled correctly and a malformed length never reads past
+ * the end of the buffer.
+ * @example
+
+	util_adv_iter iter;
+	util_adv_field field;
+	util_adv_type_set types;
+
+	util_adv_type_set_clear(&types);
+	util_adv_type_set_add(&types, UTIL_ADV_TYPE_MANUFACTURER_DATA);
+
+	util_adv_iter_init(&iter, info->adv_data, info->adv_data_len);
+	while (util_adv_iter_next_matching(&iter, &types, &field))
+	{
+		...
+	}
+
+ */
+
+#ifndef _UTIL_ADV_DATA_H_
+#define _UTIL_ADV_DATA_H_
+
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <tizen.h>
+#include "logger.h"
+#include <stdlib.h>
+
+
+/**
+ * AD types from the Bluetooth assigned numbers
+ * @since_tizen 2.3
+ */
+typedef enum
+{
+	UTIL_ADV_TYPE_FLAGS = 0x01,
+	UTIL_ADV_TYPE_UUID16_INCOMPLETE = 0x02,
+	UTIL_ADV_TYPE_UUID16_COMPLETE = 0x03,
+	UTIL_ADV_TYPE_UUID32_INCOMPLETE = 0x04,
+	UTIL_ADV_TYPE_UUID32_COMPLETE = 0x05,
+	UTIL_ADV_TYPE_UUID128_INCOMPLETE = 0x06,
+	UTIL_ADV_TYPE_UUID128_COMPLETE = 0x07,
+	UTIL_ADV_TYPE_NAME_SHORT = 0x08,
+	UTIL_ADV_TYPE_NAME_COMPLETE = 0x09,
+	UTIL_ADV_TYPE_TX_POWER = 0x0A,
+	UTIL_ADV_TYPE_SERVICE_DATA16 = 0x16,
+	UTIL_ADV_TYPE_SERVICE_DATA32 = 0x20,
+	UTIL_ADV_TYPE_SERVICE_DATA128 = 0x21,
+	UTIL_ADV_TYPE_MANUFACTURER_DATA = 0xFF
+} util_adv_type_e;
+
+
+/**
+ * Cursor over one payload
+ * @since_tizen 2.3
+ */
+typedef struct
+{
+	const uint8_t *data;
+	int len;
+	int pos;
+	bool malformed;
+} util_adv_iter;
+
+
+/**
+ * One AD structure. value points into the payload.
+ * @since_tizen 2.3
+ */
+typedef struct
+{
+	uint8_t type;
+	const uint8_t *value;
+	int len;
+} util_adv_field;
+
+
+/**
+ * Set of AD types, one bit per type byte
+ * @since_tizen 2.3
+ */
+typedef struct
+{
+	uint32_t bits[8];
+} util_adv_type_set;
+
+
+/**
+ * Start iterating over data[0..len)
+ * @since_tizen 2.3
+ */
+void util_adv_iter_init(util_adv_iter *iter, const char *data, int len);
+
+
+/**
+ * Next AD structure, false at the end of the payload or on a malformed length
+ * @since_tizen 2.3
+ */
+bool util_adv_iter_next(util_adv_iter *iter, util_adv_field *field);
+
+
+/**
+ * Next AD structure whose type is in types. Only the length/type header of
+ * the skipped structures is touched.
+ * @since_tizen 2.3
+ */
+bool util_adv_iter_next_matching(util_adv_iter *iter, const util_adv_type_set *types, util_adv_field *field);
+
+
+/**
+ * Type set helpers
+ * @since_tizen 2.3
+ */
+void util_adv_type_set_clear(util_adv_type_set *types);
+void util_adv_type_set_add(util_adv_type_set *types, uint8_t type);
+bool util_adv_type_set_has(const util_adv_type_set *types, uint8_t type);
+
+
+/**
+ * Collect the set of AD types present in a payload in one pass
+ * @since_tizen 2.3
+ */
+void util_adv_types_present(const char *data, int len, util_adv_type_set *present);
+
+
+/**
+ * First structure of the given type
+ * @since_tizen 2.3
+ */
+bool util_adv_find(const char *data, int len, uint8_t type, util_adv_field *field);
+
+
+/**
+ * Typed accessors. Each returns false if the structure is absent or too short.
+ * @since_tizen 2.3
+ */
+bool util_adv_get_flags(const char *data, int len, uint8_t *flags);
+bool util_adv_get_tx_power(const char *data, int len, int8_t *tx_power);
+bool util_adv_get_local_name(const char *data, int len, const char **name, int *name_len, bool *complete);
+bool util_adv_get_manufacturer_data(const char *data, int len, uint16_t *company_id, const uint8_t **payload, int *payload_len);
+bool util_adv_get_service_data16(const char *data, int len, uint16_t uuid16, const uint8_t **payload, int *payload_len);
+
+
+/**
+ * Whether any of the UUID list structures (16, 32 or 128 bit, complete or
+ * incomplete) contains the given UUID. uuid128 is in the big-endian textual
+ * order, 16 and 32 bit UUIDs are matched against the Bluetooth base UUID.
+ * @since_tizen 2.3
+ */
+bool util_adv_has_service_uuid(const char *data, int len, const uint8_t uuid128[16]);
+bool util_adv_has_service_uuid16(const char *data, int len, uint16_t uuid16);
+
+
+/**
+ * Expand a 16 bit UUID onto the Bluetooth base UUID
+ * @since_tizen 2.3
+ */
+void util_adv_uuid16_to_uuid128(uint16_t uuid16, uint8_t uuid128[16]);
+
+
+/**
+ * Fuzz and throughput check for this module (tag:UTIL_ADV)
+ */
+void util_adv_data_test();
+
+
+#endif // _UTIL_ADV_DATA_H_
@@ -0,0 +1,159 @@
+/*******************************************************************************
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the License);
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *******************************************************************************/
+
+
+/**
+ * @file util_advertiser.h
+ * @since_tizen 2.3
+ * @brief
+ * One LE advertiser with payloads updated in place
+ *
+ * @debugtag UTIL_ADVERTISER
+ *
+ * Owns a single bt_advertiser_h for its whole life. The advertising packet
+ * carries service data taken from a few payload slots: changing the slot on
+ * air rewrites the packet while advertising continues, and with a rotation
+ * period the slots are put on air one after the other, the way beacons
+ * alternate their frames. Advertising is only restarted when the stack
+ * refuses an update while running. The scan response carries the device
+ * name. Starts, restarts and the time each update takes are counted.
+ * @example
+
+	util_advertiser *adv = util_advertiser_create(500);
+
+	util_advertiser_set_payload(adv, 0, "180f", &level, 1);
+	util_advertiser_set_payload(adv, 1, "feaa", tlm, sizeof(tlm));
+	util_advertiser_rotate(adv, 2.0, NULL, NULL);
+	util_advertiser_start(adv);
+
+	// later, only the packet changes
+	util_advertiser_set_payload(adv, 0, "180f", &level, 1);
+
+	util_advertiser_destroy(adv);
+
+ */
+
+#ifndef _UTIL_ADVERTISER_H_
+#define _UTIL_ADVERTISER_H_
+
+
+#include <stdbool.h>
+#include <tizen.h>
+#include "logger.h"
+#include <stdlib.h>
+
+
+#define UTIL_ADVERTISER_SLOTS 4
+#define UTIL_ADVERTISER_MAX_DATA 24	// service data bytes that fit the 31 byte packet next to the flags
+
+
+typedef struct _util_advertiser util_advertiser;
+
+
+/**
+ * Called before the rotation puts slot on air, a payload that ages (uptime, counters) can be refreshed here
+ * @since_tizen 2.3
+ */
+typedef void (*util_advertiser_rotate_cb)(util_advertiser *adv, int slot, void *data);
+
+
+/**
+ * Counters since the advertiser was created
+ * @since_tizen 2.3
+ */
+typedef struct
+{
+	unsigned long starts;
+	unsigned long restarts;		/**< stop and start forced by a refused update */
+	unsigned long updates;
+	unsigned long failed_updates;
+	unsigned long rotations;
+	unsigned long long update_us;
+	unsigned long long max_update_us;
+} util_advertiser_stats;
+
+
+/**
+ * Create the advertiser, advertising every interval_ms once started
+ * @since_tizen 2.3
+ */
+util_advertiser* util_advertiser_create(int interval_ms);
+
+
+/**
+ * Stop advertising and destroy the advertiser
+ * @since_tizen 2.3
+ */
+void util_advertiser_destroy(util_advertiser *adv);
+
+
+/**
+ * Set the service data of slot. If the slot is on air the packet is rewritten now.
+ * @since_tizen 2.3
+ */
+bool util_advertiser_set_payload(util_advertiser *adv, int slot, const char *uuid, const void *data, int len);
+
+
+/**
+ * Empty slot, it is skipped by the rotation
+ * @since_tizen 2.3
+ */
+void util_advertiser_clear_payload(util_advertiser *adv, int slot);
+
+
+/**
+ * Put the next non empty slot on air every period seconds, 0 keeps the current one. cb may be NULL.
+ * @since_tizen 2.3
+ */
+bool util_advertiser_rotate(util_advertiser *adv, double period, util_advertiser_rotate_cb cb, void *data);
+
+
+/**
+ * Start advertising, nothing is done if it already is
+ * @since_tizen 2.3
+ */
+bool util_advertiser_start(util_advertiser *adv);
+
+
+/**
+ * Stop advertising, the advertiser is kept for the next start
+ * @since_tizen 2.3
+ */
+void util_advertiser_stop(util_advertiser *adv);
+
+
+/**
+ * true between a successful start and the stop
+ * @since_tizen 2.3
+ */
+bool util_advertiser_is_advertising(util_advertiser *adv);
+
+
+/**
+ * Copy the counters
+ * @since_tizen 2.3
+ */
+void util_advertiser_get_stats(util_advertiser *adv, util_advertiser_stats *stats);
+
+
+/**
+ * Dump the counters (tag:UTIL_ADVERTISER)
+ * @since_tizen 2.3
+ */
+void util_advertiser_info(util_advertiser *adv);
+
+
+#endif // _UTIL_ADVERTISER_H_
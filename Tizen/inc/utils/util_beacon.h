@@ -0,0 +1,186 @@
+/*******************************************************************************
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the License);
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *******************************************************************************/
+
+
+/**
+ * @file util_beacon.h
+ * @since_tizen 2.3
+ * @brief
+ * iBeacon / Eddystone decoder and proximity ranging
+ *
+ * @debugtag UTIL_BEACON
+ *
+ * util_beacon_decode() classifies an advertising payload straight from its
+ * bytes. The tracker keeps a smoothed RSSI per beacon, keyed by device
+ * address, and turns it into a distance estimate with the log-distance path
+ * loss model d = 10 ^ ((txPower@1m - rssi) / (10 * n)).
+ * Updating the tracker does not allocate; the ranked list is produced on
+ * demand, typically from a periodic timer.
+ * @example
+
+	util_beacon_tracker *tracker = util_beacon_tracker_create(128, 2.0, 10000);
+	util_beacon_frame frame;
+
+	if (util_beacon_decode(info->adv_data, info->adv_data_len, &frame))
+		util_beacon_tracker_update(tracker, info->remote_address, &frame, info->rssi);
+
+	util_beacon_range ranked[5];
+	int n = util_beacon_tracker_rank(tracker, ranked, 5);
+
+ */
+
+#ifndef _UTIL_BEACON_H_
+#define _UTIL_BEACON_H_
+
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <tizen.h>
+#include "logger.h"
+#include <stdlib.h>
+
+
+#define UTIL_BEACON_URL_SIZE 64		// a decoded Eddystone-URL with its terminator
+#define UTIL_BEACON_ID_SIZE UTIL_BEACON_URL_SIZE	// the URL is the longest id
+
+
+/**
+ * Beacon frame kinds
+ * @since_tizen 2.3
+ */
+typedef enum
+{
+	UTIL_BEACON_NONE,
+	UTIL_BEACON_IBEACON,
+	UTIL_BEACON_EDDYSTONE_UID,
+	UTIL_BEACON_EDDYSTONE_URL,
+	UTIL_BEACON_EDDYSTONE_TLM
+} util_beacon_type_e;
+
+
+/**
+ * One decoded frame. tx_power_1m is normalised to 1 m for every frame type
+ * that carries a calibrated power (TLM frames do not).
+ * @since_tizen 2.3
+ */
+typedef struct
+{
+	util_beacon_type_e type;
+	bool has_tx_power;
+	int8_t tx_power_1m;
+
+	// iBeacon
+	uint8_t proximity_uuid[16];
+	uint16_t major;
+	uint16_t minor;
+
+	// Eddystone-UID
+	uint8_t namespace_id[10];
+	uint8_t instance_id[6];
+
+	// Eddystone-URL
+	char url[UTIL_BEACON_URL_SIZE];
+
+	// Eddystone-TLM
+	uint16_t battery_mv;
+	int16_t temperature_8_8;
+	uint32_t adv_count;
+	uint32_t uptime_ds;
+} util_beacon_frame;
+
+
+/**
+ * Ranging state of one beacon as returned by util_beacon_tracker_rank()
+ * @since_tizen 2.3
+ */
+typedef struct
+{
+	char address[18];
+	util_beacon_type_e type;
+	char id[UTIL_BEACON_ID_SIZE];
+	double rssi;
+	int8_t tx_power_1m;
+	double distance_m;
+	unsigned long frames;
+	unsigned long long last_seen_ms;
+	bool has_telemetry;
+	uint16_t battery_mv;
+	int16_t temperature_8_8;
+} util_beacon_range;
+
+
+typedef struct _util_beacon_tracker util_beacon_tracker;
+
+
+/**
+ * Classify and decode an advertising payload
+ * @since_tizen 2.3
+ */
+bool util_beacon_decode(const char *data, int len, util_beacon_frame *frame);
+
+
+/**
+ * Human readable name of a frame type
+ * @since_tizen 2.3
+ */
+const char *util_beacon_type_name(util_beacon_type_e type);
+
+
+/**
+ * Create a tracker for up to capacity beacons. Beacons not heard for
+ * timeout_ms are dropped on the next util_beacon_tracker_rank().
+ * @since_tizen 2.3
+ */
+util_beacon_tracker* util_beacon_tracker_create(int capacity, double path_loss_exponent, int timeout_ms);
+
+
+/**
+ * Destroy the tracker
+ * @since_tizen 2.3
+ */
+void util_beacon_tracker_destroy(util_beacon_tracker *tracker);
+
+
+/**
+ * Forget every beacon
+ * @since_tizen 2.3
+ */
+void util_beacon_tracker_clear(util_beacon_tracker *tracker);
+
+
+/**
+ * Feed one decoded frame. Returns false if the tracker is full.
+ * @since_tizen 2.3
+ */
+bool util_beacon_tracker_update(util_beacon_tracker *tracker, const char *address, const util_beacon_frame *frame, int rssi);
+
+
+/**
+ * Drop stale beacons and fill out with up to max beacons, nearest first.
+ * Returns the number written.
+ * @since_tizen 2.3
+ */
+int util_beacon_tracker_rank(util_beacon_tracker *tracker, util_beacon_range *out, int max);
+
+
+/**
+ * Number of beacons currently tracked
+ * @since_tizen 2.3
+ */
+int util_beacon_tracker_count(util_beacon_tracker *tracker);
+
+
+#endif // _UTIL_BEACON_H_
@@ -0,0 +1,49 @@
+/*******************************************************************************
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the License);
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *******************************************************************************/
+
+
+/**
+ * @file util_clock.h
+ * @since_tizen 2.3
+ * @brief
+ * Monotonic clock
+ *
+ * One clock for every util module that times something, so latencies,
+ * intervals and journal stamps are all measured the same way. The clock
+ * does not jump with the wall time and only differences are meaningful.
+ * @example
+
+	unsigned long long start = util_clock_now_us();
+	do_work();
+	unsigned long long spent = util_clock_now_us() - start;
+
+ */
+
+#ifndef _UTIL_CLOCK_H_
+#define _UTIL_CLOCK_H_
+
+
+#include <tizen.h>
+
+
+/**
+ * Monotonic clock in microseconds
+ * @since_tizen 2.3
+ */
+unsigned long long util_clock_now_us();
+
+
+#endif // _UTIL_CLOCK_H_
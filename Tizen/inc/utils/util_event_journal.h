@@ -0,0 +1,176 @@
+/*******************************************************************************
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the License);
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *******************************************************************************/
+
+
+/**
+ * @file util_event_journal.h
+ * @since_tizen 2.3
+ * @brief
+ * Binary event journal flushed in the background
+ *
+ * @debugtag UTIL_EVENT_JOURNAL
+ *
+ * Every event is one 24 byte record: monotonic time, type, link, attribute,
+ * length and result. Records go into a ring allocated once, adding one is a
+ * struct copy. A timer, or the ring filling up to half, hands the pending
+ * records to an Ecore thread that appends them to the file with at most two
+ * writes; the main loop never waits on the disk. While a flush is running
+ * the records it writes are left alone, a full ring drops the new event and
+ * counts it, so the file keeps the order of what it has.
+ *
+ * A session starts with a UTIL_EVENT_SESSION record holding the wall clock
+ * at open, each address is written once as a UTIL_EVENT_ADDRESS record and
+ * then referred to by its index. tools/tbt_journal_decode.py prints the file
+ * as a timeline.
+ * @example
+
+	util_event_journal *journal = util_event_journal_create(path, 1024, 1.0);
+
+	int link = util_event_journal_address(journal, remote_address);
+	util_event_journal_add(journal, UTIL_EVENT_READ_DONE, link, attribute, len, result);
+
+	util_event_journal_destroy(journal);
+
+ */
+
+#ifndef _UTIL_EVENT_JOURNAL_H_
+#define _UTIL_EVENT_JOURNAL_H_
+
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <tizen.h>
+#include "logger.h"
+#include <stdlib.h>
+
+
+#define UTIL_EVENT_JOURNAL_MAGIC 0x4A544254	// "TBTJ" in the file
+#define UTIL_EVENT_JOURNAL_VERSION 1
+#define UTIL_EVENT_JOURNAL_MAX_ADDRESSES 64
+#define UTIL_EVENT_NO_LINK 0xFFFF
+#define UTIL_EVENT_NO_HANDLE 0xFFFFFFFF
+
+
+typedef struct _util_event_journal util_event_journal;
+
+
+/**
+ * Event types, the numbers are part of the file format
+ * @since_tizen 2.3
+ */
+typedef enum
+{
+	UTIL_EVENT_SESSION = 0,		/**< link: version, handle: wall clock seconds, length: microseconds, result: magic */
+	UTIL_EVENT_ADDRESS = 1,		/**< link: index, handle: first four address bytes, length: last two */
+	UTIL_EVENT_SCAN_START = 2,
+	UTIL_EVENT_SCAN_STOP = 3,
+	UTIL_EVENT_CONNECT = 4,
+	UTIL_EVENT_CONNECTED = 5,
+	UTIL_EVENT_DISCONNECTED = 6,
+	UTIL_EVENT_READ = 7,
+	UTIL_EVENT_READ_DONE = 8,
+	UTIL_EVENT_WRITE = 9,
+	UTIL_EVENT_WRITE_DONE = 10,
+	UTIL_EVENT_NOTIFY = 11,
+	UTIL_EVENT_MTU = 12,		/**< length: the new MTU */
+	UTIL_EVENT_READ_ALL = 13,	/**< length: reads queued */
+	UTIL_EVENT_READ_ALL_DONE = 14,	/**< length: reads done, result: reads failed */
+	UTIL_EVENT_NOTIFY_SENT = 15
+} util_event_type;
+
+
+/**
+ * One record as it is stored in the file, little endian
+ * @since_tizen 2.3
+ */
+typedef struct
+{
+	uint64_t time_us;		/**< monotonic clock */
+	uint16_t type;			/**< util_event_type */
+	uint16_t link;			/**< address index, UTIL_EVENT_NO_LINK if none */
+	uint32_t handle;		/**< attribute index, UTIL_EVENT_NO_HANDLE if none */
+	uint32_t length;
+	int32_t result;
+} util_event_record;
+
+
+/**
+ * Counters since the journal was created
+ * @since_tizen 2.3
+ */
+typedef struct
+{
+	unsigned long records;
+	unsigned long dropped;		/**< added while the ring was full */
+	unsigned long flushes;
+	unsigned long write_errors;
+	unsigned long long bytes;	/**< written to the file */
+	unsigned long long flush_us;
+	unsigned long long max_flush_us;
+	int max_pending;
+} util_event_journal_stats;
+
+
+/**
+ * Open path for appending and start a session. The ring holds capacity records, flushed every flush_interval seconds.
+ * @since_tizen 2.3
+ */
+util_event_journal* util_event_journal_create(const char *path, int capacity, double flush_interval);
+
+
+/**
+ * Flush what is left and close the file. A flush still running finishes first, the journal goes with it.
+ * @since_tizen 2.3
+ */
+void util_event_journal_destroy(util_event_journal *journal);
+
+
+/**
+ * Index of an address, recorded the first time it is seen. UTIL_EVENT_NO_LINK once the table is full.
+ * @since_tizen 2.3
+ */
+int util_event_journal_address(util_event_journal *journal, const char *address);
+
+
+/**
+ * Record an event. journal may be NULL, nothing is recorded then.
+ * @since_tizen 2.3
+ */
+void util_event_journal_add(util_event_journal *journal, util_event_type type, int link, unsigned int handle, unsigned int length, int result);
+
+
+/**
+ * Hand the pending records to the flush thread now, nothing is done if one is running
+ * @since_tizen 2.3
+ */
+void util_event_journal_flush(util_event_journal *journal);
+
+
+/**
+ * Copy the counters
+ * @since_tizen 2.3
+ */
+void util_event_journal_get_stats(util_event_journal *journal, util_event_journal_stats *stats);
+
+
+/**
+ * Dump the counters (tag:UTIL_EVENT_JOURNAL)
+ * @since_tizen 2.3
+ */
+void util_event_journal_info(util_event_journal *journal);
+
+
+#endif // _UTIL_EVENT_JOURNAL_H_
@@ -0,0 +1,149 @@
+/*******************************************************************************
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the License);
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *******************************************************************************/
+
+
+/**
+ * @file util_gatt_arena.h
+ * @since_tizen 2.3
+ * @brief
+ * Attribute database of one GATT connection
+ *
+ * @debugtag UTIL_GATT_ARENA
+ *
+ * Services, characteristics and descriptors of a remote device in one
+ * contiguous array, in the order they were discovered. The tree is kept as
+ * indices (parent, first child, next sibling), never as pointers, so the
+ * array can grow by doubling without fixing anything up. Attributes are
+ * found by the stack's handle or by UUID through hash indexes. All of it is
+ * released with one util_gatt_arena_destroy() when the connection goes away.
+ * @example
+
+	util_gatt_arena *arena = util_gatt_arena_create(64);
+
+	int svc = util_gatt_arena_add(arena, UTIL_GATT_ATTR_SERVICE, -1, svc_h, "180F");
+	int chr = util_gatt_arena_add(arena, UTIL_GATT_ATTR_CHARACTERISTIC, svc, chr_h, "2A19");
+
+	for (i = util_gatt_arena_find_uuid(arena, "2902"); i >= 0; i = util_gatt_arena_get(arena, i)->next_same_uuid)
+	{
+		enable_notifications(util_gatt_arena_get(arena, i)->handle);
+	}
+
+	util_gatt_arena_destroy(arena);
+
+ */
+
+#ifndef _UTIL_GATT_ARENA_H_
+#define _UTIL_GATT_ARENA_H_
+
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <tizen.h>
+#include "logger.h"
+#include <stdlib.h>
+
+
+typedef struct _util_gatt_arena util_gatt_arena;
+
+
+/**
+ * Kind of attribute
+ * @since_tizen 2.3
+ */
+typedef enum
+{
+	UTIL_GATT_ATTR_SERVICE,			/**< primary or included service */
+	UTIL_GATT_ATTR_CHARACTERISTIC,
+	UTIL_GATT_ATTR_DESCRIPTOR
+} util_gatt_attr_type;
+
+
+/**
+ * One attribute. Links are indices into the arena, -1 for none.
+ * @since_tizen 2.3
+ */
+typedef struct
+{
+	util_gatt_attr_type type;
+	void *handle;			/**< the stack's bt_gatt_h, owned by the stack */
+	int parent;
+	int first_child;
+	int last_child;
+	int next_sibling;
+	int next_same_uuid;		/**< next attribute with the same UUID, in discovery order */
+	int short_uuid;			/**< 16 bit value, -1 for vendor UUIDs */
+	uint8_t uuid[16];
+} util_gatt_attr;
+
+
+/**
+ * Create an empty arena sized for capacity attributes, it grows as needed
+ * @since_tizen 2.3
+ */
+util_gatt_arena* util_gatt_arena_create(int capacity);
+
+
+/**
+ * Release the arena and every attribute in it
+ * @since_tizen 2.3
+ */
+void util_gatt_arena_destroy(util_gatt_arena *arena);
+
+
+/**
+ * Add an attribute under parent (-1 for a top level service). Returns its index, the existing one
+ * if handle is already in the arena, -1 on a malformed UUID or when memory runs out.
+ * @since_tizen 2.3
+ */
+int util_gatt_arena_add(util_gatt_arena *arena, util_gatt_attr_type type, int parent, void *handle, const char *uuid);
+
+
+/**
+ * Number of attributes
+ * @since_tizen 2.3
+ */
+int util_gatt_arena_count(util_gatt_arena *arena);
+
+
+/**
+ * The attribute at index. The pointer is only good until the next util_gatt_arena_add().
+ * @since_tizen 2.3
+ */
+const util_gatt_attr* util_gatt_arena_get(util_gatt_arena *arena, int index);
+
+
+/**
+ * Index of the attribute with this handle, -1 if there is none
+ * @since_tizen 2.3
+ */
+int util_gatt_arena_find_handle(util_gatt_arena *arena, void *handle);
+
+
+/**
+ * Index of the first attribute with this UUID (any form), -1 if there is none. Follow next_same_uuid for the others.
+ * @since_tizen 2.3
+ */
+int util_gatt_arena_find_uuid(util_gatt_arena *arena, const char *uuid);
+
+
+/**
+ * Dump the size of the arena (tag:UTIL_GATT_ARENA)
+ * @since_tizen 2.3
+ */
+void util_gatt_arena_info(util_gatt_arena *arena);
+
+
+#endif // _UTIL_GATT_ARENA_H_
@@ -0,0 +1,138 @@
+/*******************************************************************************
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the License);
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *******************************************************************************/
+
+
+/**
+ * @file util_gatt_format.h
+ * @since_tizen 2.3
+ * @brief
+ * Characteristic values decoded by their Presentation Format
+ *
+ * @debugtag UTIL_GATT_FORMAT
+ *
+ * The Characteristic Presentation Format descriptor (0x2904) says how a
+ * value is encoded: integer width and sign, IEEE-754 or IEEE-11073 float,
+ * UTF-8 text, a decimal exponent and a unit. Parse it once per
+ * characteristic and keep it in the cache, every later value is decoded
+ * from the table entry of its format straight into a number, and written
+ * into the caller's buffer with the unit symbol. Nothing is allocated per
+ * value. Without a descriptor the value is shown as text if it is
+ * printable UTF-8, as hex otherwise.
+ * @example
+
+	util_gatt_format fmt;
+	if (util_gatt_format_parse(desc_value, desc_len, &fmt))
+	{
+		util_gatt_format_cache_put(cache, chr_h, &fmt);
+	}
+
+	char text[64];
+	util_gatt_format_value(util_gatt_format_cache_get(cache, chr_h), value, len, text, sizeof(text));	// "23.50 °C"
+
+ */
+
+#ifndef _UTIL_GATT_FORMAT_H_
+#define _UTIL_GATT_FORMAT_H_
+
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <tizen.h>
+#include "logger.h"
+#include <stdlib.h>
+
+
+typedef struct _util_gatt_format_cache util_gatt_format_cache;
+
+
+/**
+ * A parsed Presentation Format descriptor
+ * @since_tizen 2.3
+ */
+typedef struct
+{
+	uint8_t format;			/**< 0x01 boolean .. 0x1B struct, 0 when the characteristic has no descriptor */
+	int8_t exponent;		/**< value = raw * 10^exponent, integer formats only */
+	uint16_t unit;			/**< 0x27xx unit UUID */
+	uint8_t name_space;
+	uint16_t description;
+} util_gatt_format;
+
+
+/**
+ * Parse the 7 bytes of a 0x2904 descriptor
+ * @since_tizen 2.3
+ */
+bool util_gatt_format_parse(const void *data, int len, util_gatt_format *fmt);
+
+
+/**
+ * Decode a numeric value with its exponent applied. false for text, structs and values too short.
+ * @since_tizen 2.3
+ */
+bool util_gatt_format_decode(const util_gatt_format *fmt, const void *data, int len, double *value);
+
+
+/**
+ * Write the value as text: number and unit, string, or hex. fmt may be NULL. Returns the length written.
+ * @since_tizen 2.3
+ */
+int util_gatt_format_value(const util_gatt_format *fmt, const void *data, int len, char *buf, int size);
+
+
+/**
+ * Create a cache of formats keyed by characteristic handle, it grows as needed
+ * @since_tizen 2.3
+ */
+util_gatt_format_cache* util_gatt_format_cache_create(int capacity);
+
+
+/**
+ * Destroy the cache
+ * @since_tizen 2.3
+ */
+void util_gatt_format_cache_destroy(util_gatt_format_cache *cache);
+
+
+/**
+ * Remember the format of a characteristic, fmt NULL remembers that it has none
+ * @since_tizen 2.3
+ */
+bool util_gatt_format_cache_put(util_gatt_format_cache *cache, void *handle, const util_gatt_format *fmt);
+
+
+/**
+ * true if the characteristic was put in the cache, with or without a format
+ * @since_tizen 2.3
+ */
+bool util_gatt_format_cache_has(util_gatt_format_cache *cache, void *handle);
+
+
+/**
+ * The format of a characteristic, NULL if it has none or was never put
+ * @since_tizen 2.3
+ */
+const util_gatt_format* util_gatt_format_cache_get(util_gatt_format_cache *cache, void *handle);
+
+
+/**
+ * Dump the cache size and hit rate (tag:UTIL_GATT_FORMAT)
+ * @since_tizen 2.3
+ */
+void util_gatt_format_cache_info(util_gatt_format_cache *cache);
+
+
+#endif // _UTIL_GATT_FORMAT_H_
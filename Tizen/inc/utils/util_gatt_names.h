@@ -0,0 +1,91 @@
+/*******************************************************************************
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the License);
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *******************************************************************************/
+
+
+/**
+ * @file util_gatt_names.h
+ * @since_tizen 2.3
+ * @brief
+ * Names of GATT services, characteristics and descriptors
+ *
+ * @debugtag UTIL_GATT_NAMES
+ *
+ * Accepts UUIDs as the stack hands them out: "180F", "0000180f" or the full
+ * "0000180f-0000-1000-8000-00805f9b34fb", in any case. UUIDs built on the
+ * Bluetooth Base UUID are looked up by their 16 bit value in tables laid out
+ * at compile time, one array index per lookup. Anything else is a vendor UUID
+ * and is looked up in a hash table holding a few well known ones plus
+ * whatever the application registers. Nothing is allocated per lookup, the
+ * returned names are static.
+ * @example
+
+	char label[64];
+	util_gatt_describe(uuid, label, sizeof(label));	// "180F Battery Service"
+
+	if (util_gatt_short_uuid(uuid) == 0x2904)
+	{
+		// presentation format descriptor
+	}
+
+ */
+
+#ifndef _UTIL_GATT_NAMES_H_
+#define _UTIL_GATT_NAMES_H_
+
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <tizen.h>
+#include "logger.h"
+#include <stdlib.h>
+
+
+/**
+ * Parse any UUID form into 16 bytes, most significant first. Short forms are expanded on the Base UUID.
+ * @since_tizen 2.3
+ */
+bool util_gatt_uuid_parse(const char *uuid, uint8_t bytes[16]);
+
+
+/**
+ * The 16 bit value of a UUID built on the Base UUID, -1 for vendor UUIDs and malformed strings
+ * @since_tizen 2.3
+ */
+int util_gatt_short_uuid(const char *uuid);
+
+
+/**
+ * The name of a service, characteristic or descriptor, NULL if it is not known
+ * @since_tizen 2.3
+ */
+const char* util_gatt_name(const char *uuid);
+
+
+/**
+ * Write "<short uuid> <name>", the short UUID alone or the full UUID for an unknown vendor one
+ * @since_tizen 2.3
+ */
+void util_gatt_describe(const char *uuid, char *buf, int size);
+
+
+/**
+ * Name a vendor UUID. name must stay valid, it is not copied.
+ * @since_tizen 2.3
+ */
+bool util_gatt_names_register(const char *uuid, const char *name);
+
+
+#endif // _UTIL_GATT_NAMES_H_
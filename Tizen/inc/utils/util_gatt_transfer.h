@@ -0,0 +1,150 @@
+/*******************************************************************************
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the License);
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *******************************************************************************/
+
+
+/**
+ * @file util_gatt_transfer.h
+ * @since_tizen 2.3
+ * @brief
+ * Timing of GATT reads and writes per ATT MTU
+ *
+ * @debugtag UTIL_GATT_TRANSFER
+ *
+ * A value longer than one PDU takes several round trips: a read goes on
+ * with Read Blob requests, a write with Prepare Write requests and one
+ * Execute Write. The count depends on the ATT MTU, so the transfers are
+ * timed and counted per MTU: when the negotiated MTU changes, the figures
+ * of the old one are logged and a new period starts, which gives the
+ * before and after of the exchange side by side in the log.
+ * @example
+
+	util_gatt_transfer *transfers = util_gatt_transfer_create(UTIL_GATT_DEFAULT_MTU);
+
+	util_gatt_transfer_set_mtu(transfers, mtu);
+	util_gatt_transfer_begin(transfers, UTIL_GATT_TRANSFER_READ, chr_h);
+
+	// in the read callback
+	double ms = util_gatt_transfer_end(transfers, UTIL_GATT_TRANSFER_READ, chr_h, result, len);
+
+	util_gatt_transfer_destroy(transfers);
+
+ */
+
+#ifndef _UTIL_GATT_TRANSFER_H_
+#define _UTIL_GATT_TRANSFER_H_
+
+
+#include <stdbool.h>
+#include <tizen.h>
+#include "logger.h"
+#include <stdlib.h>
+
+
+#define UTIL_GATT_DEFAULT_MTU 23
+#define UTIL_GATT_MAX_MTU 517		// 512 byte attribute plus the 5 byte Prepare Write header
+
+
+typedef struct _util_gatt_transfer util_gatt_transfer;
+
+
+typedef enum
+{
+	UTIL_GATT_TRANSFER_READ,
+	UTIL_GATT_TRANSFER_WRITE,
+	UTIL_GATT_TRANSFER_OPS
+} util_gatt_transfer_op;
+
+
+/**
+ * Counters of one operation since the MTU was last set
+ * @since_tizen 2.3
+ */
+typedef struct
+{
+	unsigned long transfers;
+	unsigned long failed;
+	unsigned long round_trips;	/**< ATT requests the completed transfers took */
+	unsigned long long bytes;
+	unsigned long long us;
+	unsigned long long max_us;
+	int max_len;
+} util_gatt_transfer_stats;
+
+
+/**
+ * Create the counters for an ATT MTU, UTIL_GATT_DEFAULT_MTU before any exchange
+ * @since_tizen 2.3
+ */
+util_gatt_transfer* util_gatt_transfer_create(int mtu);
+
+
+/**
+ * Log the counters and destroy them
+ * @since_tizen 2.3
+ */
+void util_gatt_transfer_destroy(util_gatt_transfer *transfers);
+
+
+/**
+ * Set the negotiated MTU. On a change the counters are logged and restarted.
+ * @since_tizen 2.3
+ */
+void util_gatt_transfer_set_mtu(util_gatt_transfer *transfers, int mtu);
+
+
+/**
+ * The MTU the counters are for
+ * @since_tizen 2.3
+ */
+int util_gatt_transfer_get_mtu(util_gatt_transfer *transfers);
+
+
+/**
+ * ATT requests a value of len bytes takes at mtu
+ * @since_tizen 2.3
+ */
+int util_gatt_transfer_round_trips(util_gatt_transfer_op op, int len, int mtu);
+
+
+/**
+ * Start timing op on handle, one transfer of each op is timed at a time
+ * @since_tizen 2.3
+ */
+void util_gatt_transfer_begin(util_gatt_transfer *transfers, util_gatt_transfer_op op, void *handle);
+
+
+/**
+ * Stop timing op on handle. Returns the milliseconds it took, -1 if it was not begun.
+ * @since_tizen 2.3
+ */
+double util_gatt_transfer_end(util_gatt_transfer *transfers, util_gatt_transfer_op op, void *handle, int result, int len);
+
+
+/**
+ * Copy the counters of op
+ * @since_tizen 2.3
+ */
+void util_gatt_transfer_get_stats(util_gatt_transfer *transfers, util_gatt_transfer_op op, util_gatt_transfer_stats *stats);
+
+
+/**
+ * Dump the counters (tag:UTIL_GATT_TRANSFER)
+ * @since_tizen 2.3
+ */
+void util_gatt_transfer_info(util_gatt_transfer *transfers);
+
+
+#endif // _UTIL_GATT_TRANSFER_H_
@@ -0,0 +1,154 @@
+/*******************************************************************************
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the License);
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *******************************************************************************/
+
+
+/**
+ * @file util_notify_ring.h
+ * @since_tizen 2.3
+ * @brief
+ * Bounded store of GATT notifications
+ *
+ * @debugtag UTIL_NOTIFY_RING
+ *
+ * A fixed number of slots, each holding a monotonic timestamp and up to
+ * max_payload bytes of the value as it came in. All memory is taken at
+ * creation, pushing a notification is a copy into the next slot. When the
+ * ring is full the oldest notification is overwritten and counted, longer
+ * payloads are cut and counted too. Alongside it keeps the notification and
+ * byte rates over the last second, the mean interval between notifications
+ * and its jitter.
+ * @example
+
+	util_notify_ring *ring = util_notify_ring_create(256, 20);
+
+	// in the value changed callback
+	util_notify_ring_push(ring, value, len);
+
+	// on the next refresh
+	for (i = 0; i < 5; i++)
+	{
+		const util_notify_entry *e = util_notify_ring_latest(ring, i);
+		if (e == NULL) break;
+		show(e->data, e->len);
+	}
+
+	util_notify_ring_destroy(ring);
+
+ */
+
+#ifndef _UTIL_NOTIFY_RING_H_
+#define _UTIL_NOTIFY_RING_H_
+
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <tizen.h>
+#include "logger.h"
+#include <stdlib.h>
+
+
+typedef struct _util_notify_ring util_notify_ring;
+
+
+/**
+ * One stored notification
+ * @since_tizen 2.3
+ */
+typedef struct
+{
+	unsigned long long time_us;		/**< CLOCK_MONOTONIC when it was pushed */
+	int len;				/**< bytes in data */
+	int received_len;			/**< bytes the stack delivered, more than len if cut */
+	const uint8_t *data;
+} util_notify_entry;
+
+
+/**
+ * Counters and rates
+ * @since_tizen 2.3
+ */
+typedef struct
+{
+	unsigned long notifications;
+	unsigned long long bytes;
+	unsigned long overwritten;		/**< dropped to make room for newer ones */
+	unsigned long truncated;
+	double per_second;			/**< over the last complete one second window */
+	double bytes_per_second;
+	double interval_us;			/**< smoothed time between notifications */
+	double jitter_us;			/**< smoothed variation of that time */
+	unsigned long long max_interval_us;
+} util_notify_stats;
+
+
+/**
+ * Create a ring of capacity notifications keeping up to max_payload bytes of each
+ * @since_tizen 2.3
+ */
+util_notify_ring* util_notify_ring_create(int capacity, int max_payload);
+
+
+/**
+ * Destroy the ring
+ * @since_tizen 2.3
+ */
+void util_notify_ring_destroy(util_notify_ring *ring);
+
+
+/**
+ * Store a notification, stamped with the current time
+ * @since_tizen 2.3
+ */
+void util_notify_ring_push(util_notify_ring *ring, const void *data, int len);
+
+
+/**
+ * Drop every notification and reset the counters, e.g. when another characteristic is watched
+ * @since_tizen 2.3
+ */
+void util_notify_ring_clear(util_notify_ring *ring);
+
+
+/**
+ * Number of notifications held
+ * @since_tizen 2.3
+ */
+int util_notify_ring_count(util_notify_ring *ring);
+
+
+/**
+ * The notification age places back from the newest (0 is the newest), NULL past the oldest.
+ * The entry is only good until the next push.
+ * @since_tizen 2.3
+ */
+const util_notify_entry* util_notify_ring_latest(util_notify_ring *ring, int age);
+
+
+/**
+ * Copy the counters, the rates are brought up to date first
+ * @since_tizen 2.3
+ */
+void util_notify_ring_get_stats(util_notify_ring *ring, util_notify_stats *stats);
+
+
+/**
+ * Dump the counters (tag:UTIL_NOTIFY_RING)
+ * @since_tizen 2.3
+ */
+void util_notify_ring_info(util_notify_ring *ring);
+
+
+#endif // _UTIL_NOTIFY_RING_H_
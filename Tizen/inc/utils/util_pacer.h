@@ -0,0 +1,144 @@
+/*******************************************************************************
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the License);
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *******************************************************************************/
+
+
+/**
+ * @file util_pacer.h
+ * @since_tizen 2.3
+ * @brief
+ * Send pacing at a fixed rate
+ *
+ * @debugtag UTIL_PACER
+ *
+ * A token bucket: tokens accrue at rate per second up to burst, each send
+ * takes one. Ecore timers do not fire faster than a few milliseconds apart,
+ * so a tick asks how many sends are due and issues them back to back, which
+ * keeps the average on the rate whatever the tick. Sends the stack has not
+ * confirmed yet are counted and capped, a slow link then holds the sender
+ * back instead of queueing without bound. The achieved rate is measured on
+ * confirmed sends, over one second windows.
+ * @example
+
+	util_pacer *pacer = util_pacer_create(200, 8, 16);
+
+	// every tick
+	int n = util_pacer_due(pacer);
+	while (n-- > 0)
+	{
+		if (send(payload, len) == 0) util_pacer_sent(pacer, len);
+		else util_pacer_failed(pacer);
+	}
+
+	// in the send callback
+	util_pacer_completed(pacer, result == 0);
+
+ */
+
+#ifndef _UTIL_PACER_H_
+#define _UTIL_PACER_H_
+
+
+#include <stdbool.h>
+#include <tizen.h>
+#include "logger.h"
+#include <stdlib.h>
+
+
+typedef struct _util_pacer util_pacer;
+
+
+/**
+ * Counters since the last util_pacer_reset()
+ * @since_tizen 2.3
+ */
+typedef struct
+{
+	unsigned long sent;
+	unsigned long completed;
+	unsigned long failed;		/**< refused by the stack or completed with an error */
+	unsigned long long bytes;	/**< of completed sends */
+	int outstanding;
+	int max_outstanding;
+	unsigned long long held_back_us;	/**< time due sends waited on the outstanding cap */
+	double per_second;		/**< completed, over the last one second window */
+	double bytes_per_second;
+} util_pacer_stats;
+
+
+/**
+ * Create a pacer for rate sends per second, at most burst at once and max_outstanding unconfirmed
+ * @since_tizen 2.3
+ */
+util_pacer* util_pacer_create(double rate, int burst, int max_outstanding);
+
+
+/**
+ * Destroy the pacer
+ * @since_tizen 2.3
+ */
+void util_pacer_destroy(util_pacer *pacer);
+
+
+/**
+ * Restart with an empty bucket and zero counters, sends still unconfirmed stay outstanding
+ * @since_tizen 2.3
+ */
+void util_pacer_reset(util_pacer *pacer);
+
+
+/**
+ * Number of sends to issue now
+ * @since_tizen 2.3
+ */
+int util_pacer_due(util_pacer *pacer);
+
+
+/**
+ * A send of bytes was issued
+ * @since_tizen 2.3
+ */
+void util_pacer_sent(util_pacer *pacer, int bytes);
+
+
+/**
+ * A due send could not be issued
+ * @since_tizen 2.3
+ */
+void util_pacer_failed(util_pacer *pacer);
+
+
+/**
+ * The stack is done with the oldest send, ok false if it reported an error
+ * @since_tizen 2.3
+ */
+void util_pacer_completed(util_pacer *pacer, bool ok);
+
+
+/**
+ * Copy the counters, the rates are brought up to date first
+ * @since_tizen 2.3
+ */
+void util_pacer_get_stats(util_pacer *pacer, util_pacer_stats *stats);
+
+
+/**
+ * Dump the counters (tag:UTIL_PACER)
+ * @since_tizen 2.3
+ */
+void util_pacer_info(util_pacer *pacer);
+
+
+#endif // _UTIL_PACER_H_
@@ -0,0 +1,199 @@
+/*******************************************************************************
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the License);
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *******************************************************************************/
+
+
+/**
+ * @file util_read_queue.h
+ * @since_tizen 2.3
+ * @brief
+ * Bulk reads with a bounded number in flight
+ *
+ * @debugtag UTIL_READ_QUEUE
+ *
+ * Add the handles to read, then run: the queue starts up to max_in_flight
+ * reads through the start callback and starts the next one each time a read
+ * is completed, until every handle has a result. Results stay in the order
+ * the handles were added, each with the value, the stack's result code and
+ * the time from start to completion. The queue knows nothing about GATT, the
+ * caller issues the reads and reports them back.
+ * @example
+
+	static bool start_read(void *handle, void *data)
+	{
+		return bt_gatt_client_read_value(handle, read_done, data) == BT_ERROR_NONE;
+	}
+
+	util_read_queue *queue = util_read_queue_create(4, start_read, all_read, view);
+	util_read_queue_add(queue, chr1);
+	util_read_queue_add(queue, chr2);
+	util_read_queue_run(queue);
+
+	// in read_done
+	util_read_queue_complete(queue, handle, result, value, len);
+
+	// in all_read
+	for (i = 0; i < util_read_queue_count(queue); i++)
+	{
+		const util_read_result *r = util_read_queue_get(queue, i);
+	}
+
+ */
+
+#ifndef _UTIL_READ_QUEUE_H_
+#define _UTIL_READ_QUEUE_H_
+
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <tizen.h>
+#include "logger.h"
+#include <stdlib.h>
+
+
+typedef struct _util_read_queue util_read_queue;
+
+
+/**
+ * Issue the read of handle. Return false if it could not be issued, it is then recorded as failed.
+ * @since_tizen 2.3
+ */
+typedef bool (*util_read_queue_start_cb)(void *handle, void *data);
+
+
+/**
+ * Every handle has its result
+ * @since_tizen 2.3
+ */
+typedef void (*util_read_queue_done_cb)(util_read_queue *queue, void *data);
+
+
+/**
+ * State of one read
+ * @since_tizen 2.3
+ */
+typedef enum
+{
+	UTIL_READ_QUEUED,
+	UTIL_READ_IN_FLIGHT,
+	UTIL_READ_DONE,
+	UTIL_READ_NOT_STARTED		/**< the start callback refused it, result means nothing */
+} util_read_state;
+
+
+/**
+ * Result of one read
+ * @since_tizen 2.3
+ */
+typedef struct
+{
+	void *handle;
+	util_read_state state;
+	int result;			/**< as reported to util_read_queue_complete(), only meaningful when UTIL_READ_DONE */
+	unsigned long long start_us;
+	unsigned long long latency_us;
+	int len;
+	uint8_t *value;			/**< copy of the value, NULL if empty or failed */
+} util_read_result;
+
+
+/**
+ * Counters of the last run
+ * @since_tizen 2.3
+ */
+typedef struct
+{
+	int reads;
+	int done;
+	int failed;
+	int max_in_flight;		/**< most reads seen in flight at once */
+	unsigned long long total_us;	/**< from run to the last completion */
+	unsigned long long latency_us;	/**< sum over the reads */
+	unsigned long long max_latency_us;
+	unsigned long long bytes;
+} util_read_queue_stats;
+
+
+/**
+ * Create a queue starting at most max_in_flight reads at once
+ * @since_tizen 2.3
+ */
+util_read_queue* util_read_queue_create(int max_in_flight, util_read_queue_start_cb start_cb, util_read_queue_done_cb done_cb, void *data);
+
+
+/**
+ * Destroy the queue. Reads still in flight are forgotten, their completions must not be reported to it.
+ * @since_tizen 2.3
+ */
+void util_read_queue_destroy(util_read_queue *queue);
+
+
+/**
+ * Add a handle to read, a handle already in the queue is not added twice
+ * @since_tizen 2.3
+ */
+bool util_read_queue_add(util_read_queue *queue, void *handle);
+
+
+/**
+ * Start reading. Handles added while running are read in the same run.
+ * @since_tizen 2.3
+ */
+void util_read_queue_run(util_read_queue *queue);
+
+
+/**
+ * Report a completed read, starts the next one. Unknown handles are ignored.
+ * @since_tizen 2.3
+ */
+void util_read_queue_complete(util_read_queue *queue, void *handle, int result, const void *value, int len);
+
+
+/**
+ * true between util_read_queue_run() and the last completion
+ * @since_tizen 2.3
+ */
+bool util_read_queue_running(util_read_queue *queue);
+
+
+/**
+ * Number of handles added
+ * @since_tizen 2.3
+ */
+int util_read_queue_count(util_read_queue *queue);
+
+
+/**
+ * Result of the handle added index-th. The pointer is only good until the next util_read_queue_add().
+ * @since_tizen 2.3
+ */
+const util_read_result* util_read_queue_get(util_read_queue *queue, int index);
+
+
+/**
+ * Copy the counters
+ * @since_tizen 2.3
+ */
+void util_read_queue_get_stats(util_read_queue *queue, util_read_queue_stats *stats);
+
+
+/**
+ * Dump the counters (tag:UTIL_READ_QUEUE)
+ * @since_tizen 2.3
+ */
+void util_read_queue_info(util_read_queue *queue);
+
+
+#endif // _UTIL_READ_QUEUE_H_
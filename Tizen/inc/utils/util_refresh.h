@@ -0,0 +1,129 @@
+/*******************************************************************************
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the License);
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *******************************************************************************/
+
+
+/**
+ * @file util_refresh.h
+ * @since_tizen 2.3
+ * @brief
+ * Coalesced UI refresh
+ *
+ * @debugtag UTIL_REFRESH
+ *
+ * Scan callbacks arrive far more often than a list needs redrawing. Instead
+ * of refreshing from the callback, request a refresh: the first request arms
+ * an ecore timer, further requests before it fires are folded into the same
+ * refresh. Every refresh is timed, together with how late the timer fired,
+ * which shows how busy the main loop is.
+ * @example
+
+	util_refresh *refresh = util_refresh_create(0.2, list_show, view);
+
+	// in the scan callback
+	util_refresh_request(refresh);
+
+	// scan stopped, show the final state now
+	util_refresh_flush(refresh);
+
+	util_refresh_destroy(refresh);
+
+ */
+
+#ifndef _UTIL_REFRESH_H_
+#define _UTIL_REFRESH_H_
+
+
+#include <stdbool.h>
+#include <tizen.h>
+#include "logger.h"
+#include <stdlib.h>
+
+
+typedef struct _util_refresh util_refresh;
+
+
+/**
+ * Does the actual refresh, on the main loop
+ * @since_tizen 2.3
+ */
+typedef void (*util_refresh_cb)(void *data);
+
+
+/**
+ * Counters kept since the refresher was created
+ * @since_tizen 2.3
+ */
+typedef struct
+{
+	unsigned long requests;
+	unsigned long refreshes;
+	unsigned long long refresh_us;
+	unsigned long long max_refresh_us;
+	unsigned long long late_us;
+	unsigned long long max_late_us;
+} util_refresh_stats;
+
+
+/**
+ * Create a refresher running cb(data) at most once every interval seconds
+ * @since_tizen 2.3
+ */
+util_refresh* util_refresh_create(double interval, util_refresh_cb cb, void *data);
+
+
+/**
+ * Destroy the refresher, a pending refresh is dropped
+ * @since_tizen 2.3
+ */
+void util_refresh_destroy(util_refresh *refresh);
+
+
+/**
+ * Ask for a refresh within the interval
+ * @since_tizen 2.3
+ */
+void util_refresh_request(util_refresh *refresh);
+
+
+/**
+ * Run a pending refresh now
+ * @since_tizen 2.3
+ */
+void util_refresh_flush(util_refresh *refresh);
+
+
+/**
+ * Drop a pending refresh, e.g. when the list is about to be replaced
+ * @since_tizen 2.3
+ */
+void util_refresh_cancel(util_refresh *refresh);
+
+
+/**
+ * Copy the current counters
+ * @since_tizen 2.3
+ */
+void util_refresh_get_stats(util_refresh *refresh, util_refresh_stats *stats);
+
+
+/**
+ * Dump the counters and the main loop time spent per refresh (tag:UTIL_REFRESH)
+ * @since_tizen 2.3
+ */
+void util_refresh_info(util_refresh *refresh);
+
+
+#endif // _UTIL_REFRESH_H_
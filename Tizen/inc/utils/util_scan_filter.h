@@ -0,0 +1,137 @@
+/*******************************************************************************
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the License);
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *******************************************************************************/
+
+
+/**
+ * @file util_scan_filter.h
+ * @since_tizen 2.3
+ * @brief
+ * Scan result filter
+ *
+ * @debugtag UTIL_FILTER
+ *
+ * Compiles a textual filter into a small bytecode program which is run on
+ * the raw advertising and scan response bytes, so unwanted results can be
+ * dropped before anything is allocated for them.
+ *
+ * Syntax: rules separated by '|' match if any rule matches, clauses inside a
+ * rule separated by ',' must all match.
+ *
+ *	uuid=<16, 32 or 128 bit UUID>		service UUID present in any UUID list
+ *	mfr=<id>[/<mask>]					manufacturer ID, both hex
+ *	name=<prefix>						local name starts with prefix
+ *	rssi>=<dBm>							signal at least this strong
+ *
+ * An empty filter accepts everything.
+ * @example
+
+	util_scan_filter *filter = util_scan_filter_compile("uuid=180F,rssi>=-80 | mfr=004C");
+
+	if (!util_scan_filter_match(filter, info->adv_data, info->adv_data_len,
+			info->scan_data, info->scan_data_len, info->rssi))
+		return;
+
+	util_scan_filter_destroy(filter);
+
+ */
+
+#ifndef _UTIL_SCAN_FILTER_H_
+#define _UTIL_SCAN_FILTER_H_
+
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <tizen.h>
+#include "logger.h"
+#include <stdlib.h>
+
+
+typedef struct _util_scan_filter util_scan_filter;
+
+
+/**
+ * Counters kept by a filter
+ * @since_tizen 2.3
+ */
+typedef struct
+{
+	unsigned long evaluated;
+	unsigned long accepted;
+	unsigned long rejected;
+} util_scan_filter_stats;
+
+
+/**
+ * Compile a filter. Returns NULL and logs the position on a syntax error.
+ * @since_tizen 2.3
+ */
+util_scan_filter* util_scan_filter_compile(const char *spec);
+
+
+/**
+ * Destroy a filter, unregistering any controller filters it pushed down
+ * @since_tizen 2.3
+ */
+void util_scan_filter_destroy(util_scan_filter *filter);
+
+
+/**
+ * Run the filter on one scan result
+ * @since_tizen 2.3
+ */
+bool util_scan_filter_match(util_scan_filter *filter, const char *adv_data, int adv_data_len,
+		const char *scan_data, int scan_data_len, int rssi);
+
+
+/**
+ * Register the parts of the filter the controller can evaluate. Every rule
+ * needs at least one clause the controller understands, otherwise nothing is
+ * registered since it would hide results the host filter accepts.
+ * Returns the number of controller filters registered.
+ * @since_tizen 2.4
+ */
+int util_scan_filter_push_down(util_scan_filter *filter);
+
+
+/**
+ * Unregister the controller filters registered by util_scan_filter_push_down()
+ * @since_tizen 2.4
+ */
+void util_scan_filter_remove_push_down(util_scan_filter *filter);
+
+
+/**
+ * Copy the current counters
+ * @since_tizen 2.3
+ */
+void util_scan_filter_get_stats(util_scan_filter *filter, util_scan_filter_stats *stats);
+
+
+/**
+ * Reset the counters
+ * @since_tizen 2.3
+ */
+void util_scan_filter_reset_stats(util_scan_filter *filter);
+
+
+/**
+ * Dump the compiled program and the counters (tag:UTIL_FILTER)
+ * @since_tizen 2.3
+ */
+void util_scan_filter_info(util_scan_filter *filter);
+
+
+#endif // _UTIL_SCAN_FILTER_H_
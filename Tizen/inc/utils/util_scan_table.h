@@ -0,0 +1,154 @@
+/*******************************************************************************
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the License);
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *******************************************************************************/
+
+
+/**
+ * @file util_scan_table.h
+ * @since_tizen 2.3
+ * @brief
+ * Address keyed table of scanned devices
+ *
+ * @debugtag UTIL_SCAN_TABLE
+ *
+ * Keeps one entry per remote address in the order the devices were first
+ * found. Lookups go through an open addressing hash index, so finding a
+ * device and adding a new one are O(1) however many devices are around.
+ * Entries are never moved or copied, the pointer stored for an address stays
+ * valid until the table is cleared, so callers update known devices in place.
+ * @example
+
+	util_scan_table *table = util_scan_table_create(256, free_device);
+
+	device *d = util_scan_table_find(table, info->remote_address);
+	if (d == NULL)
+	{
+		util_scan_table_insert(table, info->remote_address, new_device(info));
+	}
+	else
+	{
+		d->rssi = info->rssi;
+	}
+
+	for (i = 0; i < util_scan_table_count(table); i++)
+	{
+		show(util_scan_table_get(table, i));
+	}
+
+	util_scan_table_destroy(table);
+
+ */
+
+#ifndef _UTIL_SCAN_TABLE_H_
+#define _UTIL_SCAN_TABLE_H_
+
+
+#include <stdbool.h>
+#include <tizen.h>
+#include "logger.h"
+#include <stdlib.h>
+
+
+typedef struct _util_scan_table util_scan_table;
+
+
+/**
+ * Releases the data stored for an address
+ * @since_tizen 2.3
+ */
+typedef void (*util_scan_table_free_cb)(void *data);
+
+
+/**
+ * Counters kept by the table since the last clear
+ * @since_tizen 2.3
+ */
+typedef struct
+{
+	unsigned long lookups;
+	unsigned long hits;
+	unsigned long inserts;
+	unsigned long grows;
+	unsigned long probes;
+	unsigned long max_probes;
+	unsigned long long lookup_ns;
+} util_scan_table_stats;
+
+
+/**
+ * Create an empty table sized for capacity devices, it grows as needed.
+ * free_cb, if not NULL, is called for the stored data on clear and destroy.
+ * @since_tizen 2.3
+ */
+util_scan_table* util_scan_table_create(int capacity, util_scan_table_free_cb free_cb);
+
+
+/**
+ * Destroy the table and the data stored in it
+ * @since_tizen 2.3
+ */
+void util_scan_table_destroy(util_scan_table *table);
+
+
+/**
+ * Release every entry and reset the counters, the memory is kept for the next scan
+ * @since_tizen 2.3
+ */
+void util_scan_table_clear(util_scan_table *table);
+
+
+/**
+ * The data stored for address, NULL if the address is not in the table
+ * @since_tizen 2.3
+ */
+void* util_scan_table_find(util_scan_table *table, const char *address);
+
+
+/**
+ * Append data for a new address. Fails if the address is already in the table or memory runs out.
+ * @since_tizen 2.3
+ */
+bool util_scan_table_insert(util_scan_table *table, const char *address, void *data);
+
+
+/**
+ * Number of devices in the table
+ * @since_tizen 2.3
+ */
+int util_scan_table_count(util_scan_table *table);
+
+
+/**
+ * The data of the index-th device found, 0 being the first
+ * @since_tizen 2.3
+ */
+void* util_scan_table_get(util_scan_table *table, int index);
+
+
+/**
+ * Copy the current counters
+ * @since_tizen 2.3
+ */
+void util_scan_table_get_stats(util_scan_table *table, util_scan_table_stats *stats);
+
+
+/**
+ * Dump the counters and the average lookup cost (tag:UTIL_SCAN_TABLE)
+ * @since_tizen 2.3
+ */
+void util_scan_table_info(util_scan_table *table);
+
+
+#endif // _UTIL_SCAN_TABLE_H_
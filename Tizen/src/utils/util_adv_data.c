@@ -0,0 +1,539 @@
+/*******************************************************************************
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the License);
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *******************************************************************************/
+
+/**
+ *  @file util_adv_data.c
+ *
+ *	@brief
+ *	Advertising data (AD structure) parser
+ *  Implementation of util_adv_data
+ */
+#include "utils/util_adv_data.h"
+
+#include <string.h>
+#include <time.h>
+
+
+// define custom logging for adv parser
+#define __LOG(prio, fmt, arg...) dlog_print(prio, "UTIL_ADV", "%s (%d) > " fmt, __func__, __LINE__, ##arg)
+#define logd(fmt, arg...) __LOG(DLOG_DEBUG, fmt, ##arg)
+#define loge(fmt, arg...) __LOG(DLOG_ERROR, fmt, ##arg)
+#define logi(fmt, arg...) __LOG(DLOG_INFO, fmt, ##arg)
+
+
+// 00000000-0000-1000-8000-00805F9B34FB
+static const uint8_t bt_base_uuid[16] = {
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00,
+	0x80, 0x00, 0x00, 0x80, 0x5F, 0x9B, 0x34, 0xFB
+};
+
+
+/**
+ * @function		util_adv_iter_init
+ * @since_tizen		2.3
+ * @description		Util Adv Iter Init
+ * @parameter		util_adv_iter*: Util Adv Iter Pointer, const char*: Const char Pointer, int: Int
+ * @return		void
+ */
+void util_adv_iter_init(util_adv_iter *iter, const char *data, int len)
+{
+	RETM_IF(NULL == iter, "iter is NULL");
+
+	iter->data = (const uint8_t *) data;
+	iter->len = (data != NULL && len > 0) ? len : 0;
+	iter->pos = 0;
+	iter->malformed = false;
+}
+
+
+/**
+ * @function		util_adv_iter_next_matching
+ * @since_tizen		2.3
+ * @description		Util Adv Iter Next Matching
+ * @parameter		util_adv_iter*: Util Adv Iter Pointer, const util_adv_type_set*: Const Util Adv Type Set Pointer, util_adv_field*: Util Adv Field Pointer
+ * @return		bool
+ */
+bool util_adv_iter_next_matching(util_adv_iter *iter, const util_adv_type_set *types, util_adv_field *field)
+{
+	RETVM_IF(NULL == iter, false, "iter is NULL");
+
+	const uint8_t *data = iter->data;
+	int pos = iter->pos;
+	int len = iter->len;
+
+	while (pos < len)
+	{
+		int field_len = data[pos];
+
+		// a zero length structure terminates the significant part of the payload
+		if (field_len == 0)
+		{
+			break;
+		}
+		if (field_len > len - pos - 1)
+		{
+			iter->malformed = true;
+			break;
+		}
+
+		uint8_t type = data[pos + 1];
+		if (types == NULL || (types->bits[type >> 5] & (1u << (type & 31))))
+		{
+			if (field != NULL)
+			{
+				field->type = type;
+				field->value = data + pos + 2;
+				field->len = field_len - 1;
+			}
+			iter->pos = pos + 1 + field_len;
+			return true;
+		}
+		pos += 1 + field_len;
+	}
+
+	iter->pos = len;
+	return false;
+}
+
+
+/**
+ * @function		util_adv_iter_next
+ * @since_tizen		2.3
+ * @description		Util Adv Iter Next
+ * @parameter		util_adv_iter*: Util Adv Iter Pointer, util_adv_field*: Util Adv Field Pointer
+ * @return		bool
+ */
+bool util_adv_iter_next(util_adv_iter *iter, util_adv_field *field)
+{
+	return util_adv_iter_next_matching(iter, NULL, field);
+}
+
+
+/**
+ * @function		util_adv_type_set_clear
+ * @since_tizen		2.3
+ * @description		Util Adv Type Set Clear
+ * @parameter		util_adv_type_set*: Util Adv Type Set Pointer
+ * @return		void
+ */
+void util_adv_type_set_clear(util_adv_type_set *types)
+{
+	RETM_IF(NULL == types, "types is NULL");
+	memset(types, 0, sizeof(*types));
+}
+
+
+/**
+ * @function		util_adv_type_set_add
+ * @since_tizen		2.3
+ * @description		Util Adv Type Set Add
+ * @parameter		util_adv_type_set*: Util Adv Type Set Pointer, uint8_t: Uint8 T
+ * @return		void
+ */
+void util_adv_type_set_add(util_adv_type_set *types, uint8_t type)
+{
+	RETM_IF(NULL == types, "types is NULL");
+	types->bits[type >> 5] |= 1u << (type & 31);
+}
+
+
+/**
+ * @function		util_adv_type_set_has
+ * @since_tizen		2.3
+ * @description		Util Adv Type Set Has
+ * @parameter		const util_adv_type_set*: Const Util Adv Type Set Pointer, uint8_t: Uint8 T
+ * @return		bool
+ */
+bool util_adv_type_set_has(const util_adv_type_set *types, uint8_t type)
+{
+	RETVM_IF(NULL == types, false, "types is NULL");
+	return (types->bits[type >> 5] & (1u << (type & 31))) != 0;
+}
+
+
+/**
+ * @function		util_adv_types_present
+ * @since_tizen		2.3
+ * @description		Util Adv Types Present
+ * @parameter		const char*: Const char Pointer, int: Int, util_adv_type_set*: Util Adv Type Set Pointer
+ * @return		void
+ */
+void util_adv_types_present(const char *data, int len, util_adv_type_set *present)
+{
+	RETM_IF(NULL == present, "present is NULL");
+
+	util_adv_iter iter;
+	util_adv_field field;
+
+	util_adv_type_set_clear(present);
+	util_adv_iter_init(&iter, data, len);
+	while (util_adv_iter_next(&iter, &field))
+	{
+		util_adv_type_set_add(present, field.type);
+	}
+}
+
+
+/**
+ * @function		util_adv_find
+ * @since_tizen		2.3
+ * @description		Util Adv Find
+ * @parameter		const char*: Const char Pointer, int: Int, uint8_t: Uint8 T, util_adv_field*: Util Adv Field Pointer
+ * @return		bool
+ */
+bool util_adv_find(const char *data, int len, uint8_t type, util_adv_field *field)
+{
+	util_adv_iter iter;
+	util_adv_type_set types;
+
+	util_adv_type_set_clear(&types);
+	util_adv_type_set_add(&types, type);
+	util_adv_iter_init(&iter, data, len);
+
+	return util_adv_iter_next_matching(&iter, &types, field);
+}
+
+
+/**
+ * @function		util_adv_get_flags
+ * @since_tizen		2.3
+ * @description		Util Adv Get Flags
+ * @parameter		const char*: Const char Pointer, int: Int, uint8_t*: Uint8 T Pointer
+ * @return		bool
+ */
+bool util_adv_get_flags(const char *data, int len, uint8_t *flags)
+{
+	util_adv_field field;
+
+	if (!util_adv_find(data, len, UTIL_ADV_TYPE_FLAGS, &field) || field.len < 1)
+	{
+		return false;
+	}
+	if (flags != NULL) *flags = field.value[0];
+	return true;
+}
+
+
+/**
+ * @function		util_adv_get_tx_power
+ * @since_tizen		2.3
+ * @description		Util Adv Get Tx Power
+ * @parameter		const char*: Const char Pointer, int: Int, int8_t*: Int8 T Pointer
+ * @return		bool
+ */
+bool util_adv_get_tx_power(const char *data, int len, int8_t *tx_power)
+{
+	util_adv_field field;
+
+	if (!util_adv_find(data, len, UTIL_ADV_TYPE_TX_POWER, &field) || field.len < 1)
+	{
+		return false;
+	}
+	if (tx_power != NULL) *tx_power = (int8_t) field.value[0];
+	return true;
+}
+
+
+/**
+ * @function		util_adv_get_local_name
+ * @since_tizen		2.3
+ * @description		Util Adv Get Local Name, Complete Name Preferred. The Name Is Not NUL Terminated.
+ * @parameter		const char*: Const char Pointer, int: Int, const char**: Const char Pointer Pointer, int*: Int Pointer, bool*: Bool Pointer
+ * @return		bool
+ */
+bool util_adv_get_local_name(const char *data, int len, const char **name, int *name_len, bool *complete)
+{
+	util_adv_iter iter;
+	util_adv_field field;
+	util_adv_type_set types;
+	bool found = false;
+
+	util_adv_type_set_clear(&types);
+	util_adv_type_set_add(&types, UTIL_ADV_TYPE_NAME_SHORT);
+	util_adv_type_set_add(&types, UTIL_ADV_TYPE_NAME_COMPLETE);
+	util_adv_iter_init(&iter, data, len);
+
+	while (util_adv_iter_next_matching(&iter, &types, &field))
+	{
+		found = true;
+		if (name != NULL) *name = (const char *) field.value;
+		if (name_len != NULL) *name_len = field.len;
+		if (complete != NULL) *complete = (field.type == UTIL_ADV_TYPE_NAME_COMPLETE);
+		if (field.type == UTIL_ADV_TYPE_NAME_COMPLETE)
+		{
+			break;
+		}
+	}
+	return found;
+}
+
+
+/**
+ * @function		util_adv_get_manufacturer_data
+ * @since_tizen		2.3
+ * @description		Util Adv Get Manufacturer Data
+ * @parameter		const char*: Const char Pointer, int: Int, uint16_t*: Uint16 T Pointer, const uint8_t**: Const Uint8 T Pointer Pointer, int*: Int Pointer
+ * @return		bool
+ */
+bool util_adv_get_manufacturer_data(const char *data, int len, uint16_t *company_id, const uint8_t **payload, int *payload_len)
+{
+	util_adv_field field;
+
+	if (!util_adv_find(data, len, UTIL_ADV_TYPE_MANUFACTURER_DATA, &field) || field.len < 2)
+	{
+		return false;
+	}
+	if (company_id != NULL) *company_id = field.value[0] | (field.value[1] << 8);
+	if (payload != NULL) *payload = field.value + 2;
+	if (payload_len != NULL) *payload_len = field.len - 2;
+	return true;
+}
+
+
+/**
+ * @function		util_adv_get_service_data16
+ * @since_tizen		2.3
+ * @description		Util Adv Get Service Data16
+ * @parameter		const char*: Const char Pointer, int: Int, uint16_t: Uint16 T, const uint8_t**: Const Uint8 T Pointer Pointer, int*: Int Pointer
+ * @return		bool
+ */
+bool util_adv_get_service_data16(const char *data, int len, uint16_t uuid16, const uint8_t **payload, int *payload_len)
+{
+	util_adv_iter iter;
+	util_adv_field field;
+	util_adv_type_set types;
+
+	util_adv_type_set_clear(&types);
+	util_adv_type_set_add(&types, UTIL_ADV_TYPE_SERVICE_DATA16);
+	util_adv_iter_init(&iter, data, len);
+
+	while (util_adv_iter_next_matching(&iter, &types, &field))
+	{
+		if (field.len >= 2 && (field.value[0] | (field.value[1] << 8)) == uuid16)
+		{
+			if (payload != NULL) *payload = field.value + 2;
+			if (payload_len != NULL) *payload_len = field.len - 2;
+			return true;
+		}
+	}
+	return false;
+}
+
+
+/**
+ * @function		util_adv_uuid16_to_uuid128
+ * @since_tizen		2.3
+ * @description		Util Adv Uuid16 To Uuid128
+ * @parameter		uint16_t: Uint16 T, uint8_t*: Uint8 T Pointer
+ * @return		void
+ */
+void util_adv_uuid16_to_uuid128(uint16_t uuid16, uint8_t uuid128[16])
+{
+	RETM_IF(NULL == uuid128, "uuid128 is NULL");
+
+	memcpy(uuid128, bt_base_uuid, 16);
+	uuid128[2] = uuid16 >> 8;
+	uuid128[3] = uuid16 & 0xFF;
+}
+
+
+/**
+ * @function		util_adv_has_service_uuid
+ * @since_tizen		2.3
+ * @description		Util Adv Has Service Uuid
+ * @parameter		const char*: Const char Pointer, int: Int, const uint8_t*: Const Uint8 T Pointer
+ * @return		bool
+ */
+bool util_adv_has_service_uuid(const char *data, int len, const uint8_t uuid128[16])
+{
+	RETVM_IF(NULL == uuid128, false, "uuid128 is NULL");
+
+	util_adv_iter iter;
+	util_adv_field field;
+	util_adv_type_set types;
+	int i, j;
+
+	// short forms only exist for UUIDs built on the base UUID
+	bool on_base = (memcmp(uuid128 + 4, bt_base_uuid + 4, 12) == 0);
+	uint32_t short_uuid = ((uint32_t) uuid128[0] << 24) | (uuid128[1] << 16) | (uuid128[2] << 8) | uuid128[3];
+
+	util_adv_type_set_clear(&types);
+	util_adv_type_set_add(&types, UTIL_ADV_TYPE_UUID128_INCOMPLETE);
+	util_adv_type_set_add(&types, UTIL_ADV_TYPE_UUID128_COMPLETE);
+	if (on_base)
+	{
+		util_adv_type_set_add(&types, UTIL_ADV_TYPE_UUID32_INCOMPLETE);
+		util_adv_type_set_add(&types, UTIL_ADV_TYPE_UUID32_COMPLETE);
+		if (short_uuid <= 0xFFFF)
+		{
+			util_adv_type_set_add(&types, UTIL_ADV_TYPE_UUID16_INCOMPLETE);
+			util_adv_type_set_add(&types, UTIL_ADV_TYPE_UUID16_COMPLETE);
+		}
+	}
+
+	util_adv_iter_init(&iter, data, len);
+	while (util_adv_iter_next_matching(&iter, &types, &field))
+	{
+		switch (field.type)
+		{
+		case UTIL_ADV_TYPE_UUID16_INCOMPLETE:
+		case UTIL_ADV_TYPE_UUID16_COMPLETE:
+			for (i = 0; i + 2 <= field.len; i += 2)
+			{
+				if ((uint32_t) (field.value[i] | (field.value[i + 1] << 8)) == short_uuid) return true;
+			}
+			break;
+
+		case UTIL_ADV_TYPE_UUID32_INCOMPLETE:
+		case UTIL_ADV_TYPE_UUID32_COMPLETE:
+			for (i = 0; i + 4 <= field.len; i += 4)
+			{
+				uint32_t v = field.value[i] | (field.value[i + 1] << 8) | (field.value[i + 2] << 16) | ((uint32_t) field.value[i + 3] << 24);
+				if (v == short_uuid) return true;
+			}
+			break;
+
+		default:
+			// 128 bit UUIDs are sent least significant byte first
+			for (i = 0; i + 16 <= field.len; i += 16)
+			{
+				for (j = 0; j < 16 && field.value[i + j] == uuid128[15 - j]; j++);
+				if (j == 16) return true;
+			}
+			break;
+		}
+	}
+	return false;
+}
+
+
+/**
+ * @function		util_adv_has_service_uuid16
+ * @since_tizen		2.3
+ * @description		Util Adv Has Service Uuid16
+ * @parameter		const char*: Const char Pointer, int: Int, uint16_t: Uint16 T
+ * @return		bool
+ */
+bool util_adv_has_service_uuid16(const char *data, int len, uint16_t uuid16)
+{
+	uint8_t uuid128[16];
+
+	util_adv_uuid16_to_uuid128(uuid16, uuid128);
+	return util_adv_has_service_uuid(data, len, uuid128);
+}
+
+
+/**
+ * @function		adv_test_now_ns
+ * @since_tizen		2.3
+ * @description		Monotonic Clock In Nanoseconds
+ * @parameter		NA
+ * @return		static unsigned long long
+ */
+static unsigned long long adv_test_now_ns()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (unsigned long long) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+
+/**
+ * @function		util_adv_data_test
+ * @since_tizen		2.3
+ * @description		Feeds Random Payloads Through Every Entry Point Checking Bounds, Then Times A Typical Payload
+ * @parameter		NA
+ * @return		void
+ */
+void util_adv_data_test()
+{
+	static const uint8_t typical[] = {
+		0x02, UTIL_ADV_TYPE_FLAGS, 0x06,
+		0x05, UTIL_ADV_TYPE_UUID16_COMPLETE, 0x0F, 0x18, 0x0D, 0x18,
+		0x02, UTIL_ADV_TYPE_TX_POWER, 0xF4,
+		0x09, UTIL_ADV_TYPE_NAME_COMPLETE, 'T', 'B', 'T', '-', 'T', 'E', 'S', 'T',
+		0x07, UTIL_ADV_TYPE_MANUFACTURER_DATA, 0x75, 0x00, 0x01, 0x02, 0x03, 0x04
+	};
+
+	uint8_t buffer[62];
+	uint32_t seed = 0x2545F491;
+	unsigned long fields = 0;
+	unsigned long errors = 0;
+	int round, i;
+
+	for (round = 0; round < 100000; round++)
+	{
+		int len = 0;
+		for (i = 0; i < (int) sizeof(buffer); i++)
+		{
+			seed ^= seed << 13; seed ^= seed >> 17; seed ^= seed << 5;
+			buffer[i] = (uint8_t) seed;
+		}
+		len = seed % (sizeof(buffer) + 1);
+		// bias lengths toward plausible values so the walk goes past the first structure
+		if (round & 1)
+		{
+			for (i = 0; i < len; i += buffer[i] + 1) buffer[i] &= 0x0F;
+		}
+
+		const char *data = (const char *) buffer;
+		util_adv_iter iter;
+		util_adv_field field;
+
+		util_adv_iter_init(&iter, data, len);
+		while (util_adv_iter_next(&iter, &field))
+		{
+			fields++;
+			if (field.value < buffer || field.len < 0 || field.value + field.len > buffer + len)
+			{
+				errors++;
+			}
+		}
+
+		const char *name = NULL;
+		int name_len = 0;
+		const uint8_t *payload = NULL;
+		int payload_len = 0;
+		uint16_t company = 0;
+
+		if (util_adv_get_local_name(data, len, &name, &name_len, NULL)
+				&& ((const uint8_t *) name + name_len > buffer + len)) errors++;
+		if (util_adv_get_manufacturer_data(data, len, &company, &payload, &payload_len)
+				&& (payload + payload_len > buffer + len)) errors++;
+		if (util_adv_get_service_data16(data, len, 0xFEAA, &payload, &payload_len)
+				&& (payload + payload_len > buffer + len)) errors++;
+		util_adv_has_service_uuid16(data, len, 0x180F);
+		util_adv_get_flags(data, len, NULL);
+		util_adv_get_tx_power(data, len, NULL);
+	}
+
+	logi("fuzz: 100000 payloads, %lu fields, %lu bound errors %s", fields, errors, errors ? "FAILED" : "OK");
+
+	const int iterations = 1000000;
+	unsigned long hits = 0;
+	unsigned long long start = adv_test_now_ns();
+	for (round = 0; round < iterations; round++)
+	{
+		const char *data = (const char *) typical;
+		hits += util_adv_has_service_uuid16(data, sizeof(typical), 0x180F);
+		hits += util_adv_get_manufacturer_data(data, sizeof(typical), NULL, NULL, NULL);
+	}
+	unsigned long long elapsed = adv_test_now_ns() - start;
+
+	logi("throughput: %d payloads in %llu us, %llu ns/payload, %.1f MB/s (%lu hits)",
+			iterations, elapsed / 1000, elapsed / iterations,
+			elapsed ? (double) iterations * sizeof(typical) * 1000.0 / elapsed : 0.0, hits);
+}
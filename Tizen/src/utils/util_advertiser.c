@@ -0,0 +1,444 @@
+/*******************************************************************************
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the License);
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *******************************************************************************/
+
+/**
+ *  @file util_advertiser.c
+ *
+ *	@brief
+ *	One LE advertiser with payloads updated in place
+ *  Implementation of util_advertiser
+ */
+#include "utils/util_advertiser.h"
+#include "utils/util_clock.h"
+
+#include <Ecore.h>
+#include <bluetooth.h>
+#include <stdio.h>
+#include <string.h>
+
+
+// define custom logging for the advertiser
+#define __LOG(prio, fmt, arg...) dlog_print(prio, "UTIL_ADVERTISER", "%s (%d) > " fmt, __func__, __LINE__, ##arg)
+#define logd(fmt, arg...) __LOG(DLOG_DEBUG, fmt, ##arg)
+#define loge(fmt, arg...) __LOG(DLOG_ERROR, fmt, ##arg)
+#define logi(fmt, arg...) __LOG(DLOG_INFO, fmt, ##arg)
+
+
+#define ADVERTISER_UUID_SIZE	37
+
+
+// define structures
+typedef struct
+{
+	char uuid[ADVERTISER_UUID_SIZE];
+	char data[UTIL_ADVERTISER_MAX_DATA];
+	int len;			// -1 for an empty slot
+} advertiser_slot;
+
+
+struct _util_advertiser
+{
+	bt_advertiser_h handle;
+	bt_adapter_le_advertising_params_s params;
+	bool advertising;
+
+	advertiser_slot slots[UTIL_ADVERTISER_SLOTS];
+	int on_air;			// slot in the packet, -1 before the first payload
+
+	Ecore_Timer *rotate_timer;
+	util_advertiser_rotate_cb rotate_cb;
+	void *rotate_data;
+	util_advertiser_stats stats;
+};
+
+
+/**
+ * @function		_advertiser_state_changed_cb
+ * @since_tizen		2.3
+ * @description		 Advertiser State Changed Cb
+ * @parameter		int: Int, bt_advertiser_h: Bt Advertiser H, bt_adapter_le_advertising_state_e: Bt Adapter Le Advertising State E, void*: Void Pointer
+ * @return		static void
+ */
+static void _advertiser_state_changed_cb(int result, bt_advertiser_h handle, bt_adapter_le_advertising_state_e adv_state, void *user_data)
+{
+	util_advertiser *adv = (util_advertiser*) user_data;
+	RETM_IF(NULL == adv, "adv is NULL");
+
+	logd("result %d, advertising %s", result, adv_state == BT_ADAPTER_LE_ADVERTISING_STARTED ? "started" : "stopped");
+	adv->advertising = (result == BT_ERROR_NONE && adv_state == BT_ADAPTER_LE_ADVERTISING_STARTED);
+}
+
+
+/**
+ * @function		advertiser_start
+ * @since_tizen		2.3
+ * @description		Starts The Stack's Advertiser
+ * @parameter		util_advertiser*: Util Advertiser Pointer
+ * @return		static bool
+ */
+static bool advertiser_start(util_advertiser *adv)
+{
+	int ret = bt_adapter_le_start_advertising(adv->handle, &adv->params, _advertiser_state_changed_cb, adv);
+	RETVM_IF(ret != BT_ERROR_NONE, false, "bt_adapter_le_start_advertising failed: %d", ret);
+
+	adv->advertising = true;
+	adv->stats.starts++;
+	return true;
+}
+
+
+/**
+ * @function		advertiser_write
+ * @since_tizen		2.3
+ * @description		Puts A Slot In The Advertising Packet
+ * @parameter		util_advertiser*: Util Advertiser Pointer, int: Slot
+ * @return		static bool
+ */
+static bool advertiser_write(util_advertiser *adv, int slot)
+{
+	advertiser_slot *s = &adv->slots[slot];
+	int ret;
+
+	ret = bt_adapter_le_clear_advertising_data(adv->handle, BT_ADAPTER_LE_PACKET_ADVERTISING);
+	RETVM_IF(ret != BT_ERROR_NONE, false, "bt_adapter_le_clear_advertising_data failed: %d", ret);
+
+	ret = bt_adapter_le_add_advertising_service_data(adv->handle, BT_ADAPTER_LE_PACKET_ADVERTISING, s->uuid, s->data, s->len);
+	RETVM_IF(ret != BT_ERROR_NONE, false, "bt_adapter_le_add_advertising_service_data failed: %d", ret);
+
+	return true;
+}
+
+
+/**
+ * @function		advertiser_put_on_air
+ * @since_tizen		2.3
+ * @description		Rewrites The Packet With A Slot, Restarts Only If The Stack Refuses It While Advertising
+ * @parameter		util_advertiser*: Util Advertiser Pointer, int: Slot
+ * @return		static bool
+ */
+static bool advertiser_put_on_air(util_advertiser *adv, int slot)
+{
+	util_advertiser_stats *st = &adv->stats;
+	unsigned long long start = util_clock_now_us();
+	bool ok = advertiser_write(adv, slot);
+
+	if (!ok && adv->advertising)
+	{
+		loge("update refused while advertising, restarting");
+		bt_adapter_le_stop_advertising(adv->handle);
+		adv->advertising = false;
+		ok = advertiser_write(adv, slot) && advertiser_start(adv);
+		st->restarts++;
+	}
+
+	unsigned long long spent = util_clock_now_us() - start;
+	st->updates++;
+	st->update_us += spent;
+	if (spent > st->max_update_us)
+	{
+		st->max_update_us = spent;
+	}
+	if (!ok)
+	{
+		st->failed_updates++;
+		return false;
+	}
+
+	adv->on_air = slot;
+	return true;
+}
+
+
+/**
+ * @function		_advertiser_rotate_timer_cb
+ * @since_tizen		2.3
+ * @description		 Advertiser Rotate Timer Cb
+ * @parameter		void*: Void Pointer
+ * @return		static Eina_Bool
+ */
+static Eina_Bool _advertiser_rotate_timer_cb(void *data)
+{
+	util_advertiser *adv = (util_advertiser*) data;
+	RETVM_IF(NULL == adv, ECORE_CALLBACK_CANCEL, "adv is NULL");
+
+	int i;
+	for (i = 1; i <= UTIL_ADVERTISER_SLOTS; i++)
+	{
+		int slot = (adv->on_air + i) % UTIL_ADVERTISER_SLOTS;
+		if (adv->slots[slot].len < 0)
+		{
+			continue;
+		}
+		if (slot == adv->on_air)
+		{
+			break;
+		}
+		if (adv->rotate_cb != NULL)
+		{
+			adv->rotate_cb(adv, slot, adv->rotate_data);
+		}
+		if (advertiser_put_on_air(adv, slot))
+		{
+			adv->stats.rotations++;
+		}
+		break;
+	}
+	return ECORE_CALLBACK_RENEW;
+}
+
+
+/**
+ * @function		util_advertiser_create
+ * @since_tizen		2.3
+ * @description		Util Advertiser Create
+ * @parameter		int: Interval In Milliseconds
+ * @return		util_advertiser*
+ */
+util_advertiser* util_advertiser_create(int interval_ms)
+{
+	RETVM_IF(interval_ms <= 0, NULL, "invalid interval %d", interval_ms);
+
+	util_advertiser *adv = calloc(1, sizeof(util_advertiser));
+	RETVM_IF(!adv, NULL, "calloc failed");
+
+	int ret = bt_adapter_le_create_advertiser(&adv->handle);
+	if (ret != BT_ERROR_NONE)
+	{
+		loge("bt_adapter_le_create_advertiser failed: %d", ret);
+		free(adv);
+		return NULL;
+	}
+
+	ret = bt_adapter_le_set_advertising_device_name(adv->handle, BT_ADAPTER_LE_PACKET_SCAN_RESPONSE, true);
+	if (ret != BT_ERROR_NONE)
+	{
+		loge("bt_adapter_le_set_advertising_device_name failed: %d", ret);
+	}
+
+	int i;
+	for (i = 0; i < UTIL_ADVERTISER_SLOTS; i++)
+	{
+		adv->slots[i].len = -1;
+	}
+	adv->on_air = -1;
+	adv->params.interval_min = interval_ms;
+	adv->params.interval_max = interval_ms;
+
+	return adv;
+}
+
+
+/**
+ * @function		util_advertiser_destroy
+ * @since_tizen		2.3
+ * @description		Util Advertiser Destroy
+ * @parameter		util_advertiser*: Util Advertiser Pointer
+ * @return		void
+ */
+void util_advertiser_destroy(util_advertiser *adv)
+{
+	if (adv == NULL) return;
+
+	util_advertiser_rotate(adv, 0, NULL, NULL);
+	util_advertiser_stop(adv);
+	util_advertiser_info(adv);
+
+	int ret = bt_adapter_le_destroy_advertiser(adv->handle);
+	if (ret != BT_ERROR_NONE)
+	{
+		loge("bt_adapter_le_destroy_advertiser failed: %d", ret);
+	}
+	free(adv);
+}
+
+
+/**
+ * @function		util_advertiser_set_payload
+ * @since_tizen		2.3
+ * @description		Util Advertiser Set Payload
+ * @parameter		util_advertiser*: Util Advertiser Pointer, int: Slot, const char*: UUID, const void*: Data, int: Length
+ * @return		bool
+ */
+bool util_advertiser_set_payload(util_advertiser *adv, int slot, const char *uuid, const void *data, int len)
+{
+	RETVM_IF(NULL == adv, false, "adv is NULL");
+	RETVM_IF(slot < 0 || slot >= UTIL_ADVERTISER_SLOTS, false, "invalid slot %d", slot);
+	RETVM_IF(NULL == uuid || strlen(uuid) >= ADVERTISER_UUID_SIZE, false, "invalid uuid");
+	RETVM_IF(len < 0 || len > UTIL_ADVERTISER_MAX_DATA || (len > 0 && NULL == data), false, "invalid data of %d bytes", len);
+
+	advertiser_slot *s = &adv->slots[slot];
+
+	//Same payload, no need to bother the controller
+	if (s->len == len && strcmp(s->uuid, uuid) == 0 && (len == 0 || memcmp(s->data, data, len) == 0))
+	{
+		return true;
+	}
+
+	snprintf(s->uuid, sizeof(s->uuid), "%s", uuid);
+	if (len > 0)
+	{
+		memcpy(s->data, data, len);
+	}
+	s->len = len;
+
+	if (adv->on_air == -1 || adv->on_air == slot)
+	{
+		return advertiser_put_on_air(adv, slot);
+	}
+	return true;
+}
+
+
+/**
+ * @function		util_advertiser_clear_payload
+ * @since_tizen		2.3
+ * @description		Util Advertiser Clear Payload
+ * @parameter		util_advertiser*: Util Advertiser Pointer, int: Slot
+ * @return		void
+ */
+void util_advertiser_clear_payload(util_advertiser *adv, int slot)
+{
+	RETM_IF(NULL == adv, "adv is NULL");
+	RETM_IF(slot < 0 || slot >= UTIL_ADVERTISER_SLOTS, "invalid slot %d", slot);
+
+	//The packet keeps it until the rotation moves on
+	adv->slots[slot].len = -1;
+}
+
+
+/**
+ * @function		util_advertiser_rotate
+ * @since_tizen		2.3
+ * @description		Util Advertiser Rotate
+ * @parameter		util_advertiser*: Util Advertiser Pointer, double: Period In Seconds, util_advertiser_rotate_cb: Rotate Cb, void*: Void Pointer
+ * @return		bool
+ */
+bool util_advertiser_rotate(util_advertiser *adv, double period, util_advertiser_rotate_cb cb, void *data)
+{
+	RETVM_IF(NULL == adv, false, "adv is NULL");
+	RETVM_IF(period < 0, false, "invalid period %f", period);
+
+	if (adv->rotate_timer != NULL)
+	{
+		ecore_timer_del(adv->rotate_timer);
+		adv->rotate_timer = NULL;
+	}
+	adv->rotate_cb = cb;
+	adv->rotate_data = data;
+	if (period == 0)
+	{
+		return true;
+	}
+
+	adv->rotate_timer = ecore_timer_add(period, _advertiser_rotate_timer_cb, adv);
+	RETVM_IF(NULL == adv->rotate_timer, false, "ecore_timer_add failed");
+	return true;
+}
+
+
+/**
+ * @function		util_advertiser_start
+ * @since_tizen		2.3
+ * @description		Util Advertiser Start
+ * @parameter		util_advertiser*: Util Advertiser Pointer
+ * @return		bool
+ */
+bool util_advertiser_start(util_advertiser *adv)
+{
+	RETVM_IF(NULL == adv, false, "adv is NULL");
+
+	if (adv->advertising)
+	{
+		return true;
+	}
+	return advertiser_start(adv);
+}
+
+
+/**
+ * @function		util_advertiser_stop
+ * @since_tizen		2.3
+ * @description		Util Advertiser Stop
+ * @parameter		util_advertiser*: Util Advertiser Pointer
+ * @return		void
+ */
+void util_advertiser_stop(util_advertiser *adv)
+{
+	RETM_IF(NULL == adv, "adv is NULL");
+
+	if (!adv->advertising)
+	{
+		return;
+	}
+
+	int ret = bt_adapter_le_stop_advertising(adv->handle);
+	if (ret != BT_ERROR_NONE)
+	{
+		loge("bt_adapter_le_stop_advertising failed: %d", ret);
+	}
+	adv->advertising = false;
+}
+
+
+/**
+ * @function		util_advertiser_is_advertising
+ * @since_tizen		2.3
+ * @description		Util Advertiser Is Advertising
+ * @parameter		util_advertiser*: Util Advertiser Pointer
+ * @return		bool
+ */
+bool util_advertiser_is_advertising(util_advertiser *adv)
+{
+	RETVM_IF(NULL == adv, false, "adv is NULL");
+
+	return adv->advertising;
+}
+
+
+/**
+ * @function		util_advertiser_get_stats
+ * @since_tizen		2.3
+ * @description		Util Advertiser Get Stats
+ * @parameter		util_advertiser*: Util Advertiser Pointer, util_advertiser_stats*: Util Advertiser Stats Pointer
+ * @return		void
+ */
+void util_advertiser_get_stats(util_advertiser *adv, util_advertiser_stats *stats)
+{
+	RETM_IF(NULL == adv, "adv is NULL");
+	RETM_IF(NULL == stats, "stats is NULL");
+
+	*stats = adv->stats;
+}
+
+
+/**
+ * @function		util_advertiser_info
+ * @since_tizen		2.3
+ * @description		Util Advertiser Info
+ * @parameter		util_advertiser*: Util Advertiser Pointer
+ * @return		void
+ */
+void util_advertiser_info(util_advertiser *adv)
+{
+	RETM_IF(NULL == adv, "adv is NULL");
+
+	util_advertiser_stats *s = &adv->stats;
+	unsigned long long avg_us = s->updates ? s->update_us / s->updates : 0;
+
+	logi("advertising=%d on air=%d starts=%lu restarts=%lu updates=%lu failed=%lu rotations=%lu update avg=%lluus max=%lluus",
+			adv->advertising, adv->on_air, s->starts, s->restarts, s->updates, s->failed_updates, s->rotations,
+			avg_us, s->max_update_us);
+}
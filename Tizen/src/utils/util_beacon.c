@@ -0,0 +1,604 @@
+/*******************************************************************************
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the License);
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *******************************************************************************/
+
+/**
+ *  @file util_beacon.c
+ *
+ *	@brief
+ *	iBeacon / Eddystone decoder and proximity ranging
+ *  Implementation of util_beacon
+ */
+#include "utils/util_beacon.h"
+#include "utils/util_adv_data.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+
+// define custom logging for beacons
+#define __LOG(prio, fmt, arg...) dlog_print(prio, "UTIL_BEACON", "%s (%d) > " fmt, __func__, __LINE__, ##arg)
+#define logd(fmt, arg...) __LOG(DLOG_DEBUG, fmt, ##arg)
+#define loge(fmt, arg...) __LOG(DLOG_ERROR, fmt, ##arg)
+#define logi(fmt, arg...) __LOG(DLOG_INFO, fmt, ##arg)
+
+
+#define BEACON_APPLE_COMPANY_ID		0x004C
+#define BEACON_EDDYSTONE_UUID		0xFEAA
+#define BEACON_EDDYSTONE_UID		0x00
+#define BEACON_EDDYSTONE_URL		0x10
+#define BEACON_EDDYSTONE_TLM		0x20
+// Eddystone calibrates at 0 m, the usual loss over the first metre is 41 dB
+#define BEACON_EDDYSTONE_0M_TO_1M	41
+#define BEACON_RSSI_SMOOTHING		0.25
+#define BEACON_NIL					-1
+
+
+typedef struct
+{
+	uint64_t key;
+	char address[18];
+	util_beacon_type_e type;
+	char id[UTIL_BEACON_ID_SIZE];
+	bool has_tx_power;
+	int8_t tx_power_1m;
+	double rssi;
+	double distance_m;
+	unsigned long frames;
+	unsigned long long last_seen_ms;
+	bool has_telemetry;
+	uint16_t battery_mv;
+	int16_t temperature_8_8;
+} beacon_entry;
+
+
+// define structures
+struct _util_beacon_tracker
+{
+	beacon_entry *entries;
+	int capacity;
+	int count;
+
+	int *slots;
+	int slot_mask;
+
+	double path_loss_exponent;
+	unsigned long long timeout_ms;
+	unsigned long dropped;
+};
+
+
+static const char *eddystone_url_schemes[] = {
+	"http://www.", "https://www.", "http://", "https://"
+};
+
+static const char *eddystone_url_expansions[] = {
+	".com/", ".org/", ".edu/", ".net/", ".info/", ".biz/", ".gov/",
+	".com", ".org", ".edu", ".net", ".info", ".biz", ".gov"
+};
+
+
+/**
+ * @function		beacon_now_ms
+ * @since_tizen		2.3
+ * @description		Monotonic Clock In Milliseconds
+ * @parameter		NA
+ * @return		static unsigned long long
+ */
+static unsigned long long beacon_now_ms()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (unsigned long long) ts.tv_sec * 1000ULL + ts.tv_nsec / 1000000;
+}
+
+
+/**
+ * @function		beacon_decode_url
+ * @since_tizen		2.3
+ * @description		Expands An Eddystone-URL Encoded Url
+ * @parameter		const uint8_t*: Const Uint8 T Pointer, int: Int, char*: Char Pointer, int: Int
+ * @return		static bool
+ */
+static bool beacon_decode_url(const uint8_t *p, int len, char *url, int size)
+{
+	int used = 0;
+	int i;
+
+	if (len < 1 || p[0] >= sizeof(eddystone_url_schemes) / sizeof(eddystone_url_schemes[0]))
+	{
+		return false;
+	}
+	used = snprintf(url, size, "%s", eddystone_url_schemes[p[0]]);
+
+	for (i = 1; i < len && used < size - 1; i++)
+	{
+		if (p[i] < sizeof(eddystone_url_expansions) / sizeof(eddystone_url_expansions[0]))
+		{
+			used += snprintf(url + used, size - used, "%s", eddystone_url_expansions[p[i]]);
+		}
+		else if (p[i] > 0x20 && p[i] < 0x7F)
+		{
+			url[used++] = (char) p[i];
+			url[used] = '\0';
+		}
+		else
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+
+/**
+ * @function		util_beacon_decode
+ * @since_tizen		2.3
+ * @description		Util Beacon Decode
+ * @parameter		const char*: Const char Pointer, int: Int, util_beacon_frame*: Util Beacon Frame Pointer
+ * @return		bool
+ */
+bool util_beacon_decode(const char *data, int len, util_beacon_frame *frame)
+{
+	RETVM_IF(NULL == frame, false, "frame is NULL");
+
+	util_adv_iter iter;
+	util_adv_field field;
+	util_adv_type_set types;
+
+	frame->type = UTIL_BEACON_NONE;
+	frame->has_tx_power = false;
+
+	// one pass over the payload looking at the two structure types beacons use
+	util_adv_type_set_clear(&types);
+	util_adv_type_set_add(&types, UTIL_ADV_TYPE_MANUFACTURER_DATA);
+	util_adv_type_set_add(&types, UTIL_ADV_TYPE_SERVICE_DATA16);
+	util_adv_iter_init(&iter, data, len);
+
+	while (util_adv_iter_next_matching(&iter, &types, &field))
+	{
+		const uint8_t *v = field.value;
+
+		if (field.type == UTIL_ADV_TYPE_MANUFACTURER_DATA)
+		{
+			// company id, 0x02 0x15, uuid[16], major, minor, tx power
+			if (field.len == 25 && v[0] == (BEACON_APPLE_COMPANY_ID & 0xFF) && v[1] == (BEACON_APPLE_COMPANY_ID >> 8)
+					&& v[2] == 0x02 && v[3] == 0x15)
+			{
+				frame->type = UTIL_BEACON_IBEACON;
+				memcpy(frame->proximity_uuid, v + 4, 16);
+				frame->major = (v[20] << 8) | v[21];
+				frame->minor = (v[22] << 8) | v[23];
+				frame->tx_power_1m = (int8_t) v[24];
+				frame->has_tx_power = true;
+				return true;
+			}
+			continue;
+		}
+
+		if (field.len < 3 || (v[0] | (v[1] << 8)) != BEACON_EDDYSTONE_UUID)
+		{
+			continue;
+		}
+		v += 2;
+		int frame_len = field.len - 2;
+
+		switch (v[0])
+		{
+		case BEACON_EDDYSTONE_UID:
+			if (frame_len < 18) return false;
+			frame->type = UTIL_BEACON_EDDYSTONE_UID;
+			frame->tx_power_1m = (int8_t) v[1] - BEACON_EDDYSTONE_0M_TO_1M;
+			frame->has_tx_power = true;
+			memcpy(frame->namespace_id, v + 2, 10);
+			memcpy(frame->instance_id, v + 12, 6);
+			return true;
+
+		case BEACON_EDDYSTONE_URL:
+			if (frame_len < 3 || !beacon_decode_url(v + 2, frame_len - 2, frame->url, sizeof(frame->url))) return false;
+			frame->type = UTIL_BEACON_EDDYSTONE_URL;
+			frame->tx_power_1m = (int8_t) v[1] - BEACON_EDDYSTONE_0M_TO_1M;
+			frame->has_tx_power = true;
+			return true;
+
+		case BEACON_EDDYSTONE_TLM:
+			// only the unencrypted version 0 layout
+			if (frame_len < 14 || v[1] != 0x00) return false;
+			frame->type = UTIL_BEACON_EDDYSTONE_TLM;
+			frame->battery_mv = (v[2] << 8) | v[3];
+			frame->temperature_8_8 = (int16_t) ((v[4] << 8) | v[5]);
+			frame->adv_count = ((uint32_t) v[6] << 24) | (v[7] << 16) | (v[8] << 8) | v[9];
+			frame->uptime_ds = ((uint32_t) v[10] << 24) | (v[11] << 16) | (v[12] << 8) | v[13];
+			return true;
+
+		default:
+			return false;
+		}
+	}
+
+	return false;
+}
+
+
+/**
+ * @function		util_beacon_type_name
+ * @since_tizen		2.3
+ * @description		Util Beacon Type Name
+ * @parameter		util_beacon_type_e: Util Beacon Type E
+ * @return		const char*
+ */
+const char *util_beacon_type_name(util_beacon_type_e type)
+{
+	switch (type)
+	{
+	case UTIL_BEACON_IBEACON:			return "iBeacon";
+	case UTIL_BEACON_EDDYSTONE_UID:		return "Eddystone-UID";
+	case UTIL_BEACON_EDDYSTONE_URL:		return "Eddystone-URL";
+	case UTIL_BEACON_EDDYSTONE_TLM:		return "Eddystone-TLM";
+	default:							return "None";
+	}
+}
+
+
+/**
+ * @function		beacon_address_key
+ * @since_tizen		2.3
+ * @description		Packs "AA:BB:CC:DD:EE:FF" Into 48 Bits
+ * @parameter		const char*: Const char Pointer
+ * @return		static uint64_t
+ */
+static uint64_t beacon_address_key(const char *address)
+{
+	uint64_t key = 0;
+	const char *p;
+
+	for (p = address; *p != '\0'; p++)
+	{
+		char c = *p;
+		if (c >= '0' && c <= '9') key = (key << 4) | (uint64_t) (c - '0');
+		else if (c >= 'a' && c <= 'f') key = (key << 4) | (uint64_t) (c - 'a' + 10);
+		else if (c >= 'A' && c <= 'F') key = (key << 4) | (uint64_t) (c - 'A' + 10);
+	}
+	return key;
+}
+
+
+/**
+ * @function		beacon_slot_of
+ * @since_tizen		2.3
+ * @description		Home Slot Of A Key
+ * @parameter		util_beacon_tracker*: Util Beacon Tracker Pointer, uint64_t: Uint64 T
+ * @return		static int
+ */
+static int beacon_slot_of(util_beacon_tracker *tracker, uint64_t key)
+{
+	key ^= key >> 29;
+	key *= 0xbf58476d1ce4e5b9ULL;
+	key ^= key >> 32;
+	return (int) (key & tracker->slot_mask);
+}
+
+
+/**
+ * @function		beacon_find
+ * @since_tizen		2.3
+ * @description		Index Of The Entry With key, Or BEACON_NIL. *slot_out Receives The Slot It Would Use.
+ * @parameter		util_beacon_tracker*: Util Beacon Tracker Pointer, uint64_t: Uint64 T, int*: Int Pointer
+ * @return		static int
+ */
+static int beacon_find(util_beacon_tracker *tracker, uint64_t key, int *slot_out)
+{
+	int slot = beacon_slot_of(tracker, key);
+
+	while (tracker->slots[slot] != BEACON_NIL)
+	{
+		if (tracker->entries[tracker->slots[slot]].key == key)
+		{
+			*slot_out = slot;
+			return tracker->slots[slot];
+		}
+		slot = (slot + 1) & tracker->slot_mask;
+	}
+	*slot_out = slot;
+	return BEACON_NIL;
+}
+
+
+/**
+ * @function		beacon_rebuild_index
+ * @since_tizen		2.3
+ * @description		Beacon Rebuild Index
+ * @parameter		util_beacon_tracker*: Util Beacon Tracker Pointer
+ * @return		static void
+ */
+static void beacon_rebuild_index(util_beacon_tracker *tracker)
+{
+	int i, slot;
+
+	memset(tracker->slots, 0xFF, sizeof(int) * (tracker->slot_mask + 1));
+	for (i = 0; i < tracker->count; i++)
+	{
+		beacon_find(tracker, tracker->entries[i].key, &slot);
+		tracker->slots[slot] = i;
+	}
+}
+
+
+/**
+ * @function		util_beacon_tracker_create
+ * @since_tizen		2.3
+ * @description		Util Beacon Tracker Create
+ * @parameter		int: Int, double: Double, int: Int
+ * @return		util_beacon_tracker*
+ */
+util_beacon_tracker* util_beacon_tracker_create(int capacity, double path_loss_exponent, int timeout_ms)
+{
+	RETVM_IF(capacity <= 0, NULL, "invalid capacity %d", capacity);
+
+	util_beacon_tracker *tracker = calloc(1, sizeof(util_beacon_tracker));
+	RETVM_IF(!tracker, NULL, "calloc failed");
+
+	int slot_count = 1;
+	while (slot_count < capacity * 2)
+	{
+		slot_count <<= 1;
+	}
+
+	tracker->capacity = capacity;
+	tracker->slot_mask = slot_count - 1;
+	tracker->path_loss_exponent = (path_loss_exponent > 0) ? path_loss_exponent : 2.0;
+	tracker->timeout_ms = (timeout_ms > 0) ? timeout_ms : 10000;
+	tracker->entries = calloc(capacity, sizeof(beacon_entry));
+	tracker->slots = malloc(sizeof(int) * slot_count);
+
+	if (tracker->entries == NULL || tracker->slots == NULL)
+	{
+		loge("malloc failed");
+		util_beacon_tracker_destroy(tracker);
+		return NULL;
+	}
+
+	util_beacon_tracker_clear(tracker);
+	return tracker;
+}
+
+
+/**
+ * @function		util_beacon_tracker_destroy
+ * @since_tizen		2.3
+ * @description		Util Beacon Tracker Destroy
+ * @parameter		util_beacon_tracker*: Util Beacon Tracker Pointer
+ * @return		void
+ */
+void util_beacon_tracker_destroy(util_beacon_tracker *tracker)
+{
+	if (tracker == NULL) return;
+
+	SAFE_DELETE(tracker->entries);
+	SAFE_DELETE(tracker->slots);
+	free(tracker);
+}
+
+
+/**
+ * @function		util_beacon_tracker_clear
+ * @since_tizen		2.3
+ * @description		Util Beacon Tracker Clear
+ * @parameter		util_beacon_tracker*: Util Beacon Tracker Pointer
+ * @return		void
+ */
+void util_beacon_tracker_clear(util_beacon_tracker *tracker)
+{
+	RETM_IF(NULL == tracker, "tracker is NULL");
+
+	tracker->count = 0;
+	tracker->dropped = 0;
+	memset(tracker->slots, 0xFF, sizeof(int) * (tracker->slot_mask + 1));
+}
+
+
+/**
+ * @function		beacon_format_id
+ * @since_tizen		2.3
+ * @description		Short Identity Text For A Frame
+ * @parameter		const util_beacon_frame*: Const Util Beacon Frame Pointer, char*: Char Pointer, int: Int
+ * @return		static void
+ */
+static void beacon_format_id(const util_beacon_frame *frame, char *id, int size)
+{
+	const uint8_t *u = frame->proximity_uuid;
+	const uint8_t *n = frame->namespace_id;
+	const uint8_t *i = frame->instance_id;
+
+	switch (frame->type)
+	{
+	case UTIL_BEACON_IBEACON:
+		snprintf(id, size, "%02X%02X%02X%02X.. %u/%u", u[0], u[1], u[2], u[3], frame->major, frame->minor);
+		break;
+	case UTIL_BEACON_EDDYSTONE_UID:
+		snprintf(id, size, "%02X%02X%02X%02X.. %02X%02X%02X%02X%02X%02X",
+				n[0], n[1], n[2], n[3], i[0], i[1], i[2], i[3], i[4], i[5]);
+		break;
+	case UTIL_BEACON_EDDYSTONE_URL:
+		snprintf(id, size, "%s", frame->url);
+		break;
+	default:
+		break;
+	}
+}
+
+
+/**
+ * @function		util_beacon_tracker_update
+ * @since_tizen		2.3
+ * @description		Util Beacon Tracker Update
+ * @parameter		util_beacon_tracker*: Util Beacon Tracker Pointer, const char*: Const char Pointer, const util_beacon_frame*: Const Util Beacon Frame Pointer, int: Int
+ * @return		bool
+ */
+bool util_beacon_tracker_update(util_beacon_tracker *tracker, const char *address, const util_beacon_frame *frame, int rssi)
+{
+	RETVM_IF(NULL == tracker, false, "tracker is NULL");
+	RETVM_IF(NULL == address, false, "address is NULL");
+	RETVM_IF(NULL == frame || frame->type == UTIL_BEACON_NONE, false, "not a beacon frame");
+
+	uint64_t key = beacon_address_key(address);
+	int slot;
+	int index = beacon_find(tracker, key, &slot);
+	beacon_entry *entry;
+
+	if (index == BEACON_NIL)
+	{
+		if (tracker->count >= tracker->capacity)
+		{
+			tracker->dropped++;
+			return false;
+		}
+		index = tracker->count++;
+		tracker->slots[slot] = index;
+
+		entry = &tracker->entries[index];
+		memset(entry, 0, sizeof(*entry));
+		entry->key = key;
+		snprintf(entry->address, sizeof(entry->address), "%s", address);
+		entry->rssi = rssi;
+	}
+	else
+	{
+		entry = &tracker->entries[index];
+		entry->rssi += BEACON_RSSI_SMOOTHING * (rssi - entry->rssi);
+	}
+
+	entry->frames++;
+	entry->last_seen_ms = beacon_now_ms();
+
+	if (frame->type == UTIL_BEACON_EDDYSTONE_TLM)
+	{
+		// telemetry is interleaved with the identifying frames of the same device
+		entry->has_telemetry = true;
+		entry->battery_mv = frame->battery_mv;
+		entry->temperature_8_8 = frame->temperature_8_8;
+		if (entry->type == UTIL_BEACON_NONE) entry->type = frame->type;
+	}
+	else
+	{
+		entry->type = frame->type;
+		beacon_format_id(frame, entry->id, sizeof(entry->id));
+	}
+
+	if (frame->has_tx_power)
+	{
+		entry->has_tx_power = true;
+		entry->tx_power_1m = frame->tx_power_1m;
+	}
+	return true;
+}
+
+
+/**
+ * @function		beacon_compare_distance
+ * @since_tizen		2.3
+ * @description		Nearest First, Beacons Without A Distance Last
+ * @parameter		const void*: Const Void Pointer, const void*: Const Void Pointer
+ * @return		static int
+ */
+static int beacon_compare_distance(const void *a, const void *b)
+{
+	const beacon_entry *ea = (const beacon_entry *) a;
+	const beacon_entry *eb = (const beacon_entry *) b;
+
+	if (ea->distance_m < 0 && eb->distance_m < 0) return (eb->rssi > ea->rssi) - (eb->rssi < ea->rssi);
+	if (ea->distance_m < 0) return 1;
+	if (eb->distance_m < 0) return -1;
+	return (ea->distance_m > eb->distance_m) - (ea->distance_m < eb->distance_m);
+}
+
+
+/**
+ * @function		util_beacon_tracker_rank
+ * @since_tizen		2.3
+ * @description		Util Beacon Tracker Rank
+ * @parameter		util_beacon_tracker*: Util Beacon Tracker Pointer, util_beacon_range*: Util Beacon Range Pointer, int: Int
+ * @return		int
+ */
+int util_beacon_tracker_rank(util_beacon_tracker *tracker, util_beacon_range *out, int max)
+{
+	RETVM_IF(NULL == tracker, 0, "tracker is NULL");
+
+	unsigned long long now = beacon_now_ms();
+	int i, kept = 0;
+
+	for (i = 0; i < tracker->count; i++)
+	{
+		beacon_entry *entry = &tracker->entries[i];
+
+		if (now - entry->last_seen_ms > tracker->timeout_ms)
+		{
+			continue;
+		}
+
+		entry->distance_m = entry->has_tx_power
+				? pow(10.0, (entry->tx_power_1m - entry->rssi) / (10.0 * tracker->path_loss_exponent))
+				: -1.0;
+
+		if (kept != i) tracker->entries[kept] = *entry;
+		kept++;
+	}
+
+	// entries only move here, so this is the one place the index has to be rebuilt
+	qsort(tracker->entries, kept, sizeof(beacon_entry), beacon_compare_distance);
+	tracker->count = kept;
+	beacon_rebuild_index(tracker);
+
+	for (i = 0; out != NULL && i < kept && i < max; i++)
+	{
+		beacon_entry *entry = &tracker->entries[i];
+		util_beacon_range *range = &out[i];
+
+		memcpy(range->address, entry->address, sizeof(range->address));
+		memcpy(range->id, entry->id, sizeof(range->id));
+		range->type = entry->type;
+		range->rssi = entry->rssi;
+		range->tx_power_1m = entry->tx_power_1m;
+		range->distance_m = entry->distance_m;
+		range->frames = entry->frames;
+		range->last_seen_ms = entry->last_seen_ms;
+		range->has_telemetry = entry->has_telemetry;
+		range->battery_mv = entry->battery_mv;
+		range->temperature_8_8 = entry->temperature_8_8;
+	}
+
+	if (tracker->dropped > 0)
+	{
+		logi("%lu frames dropped, tracker full (%d)", tracker->dropped, tracker->capacity);
+		tracker->dropped = 0;
+	}
+	return i;
+}
+
+
+/**
+ * @function		util_beacon_tracker_count
+ * @since_tizen		2.3
+ * @description		Util Beacon Tracker Count
+ * @parameter		util_beacon_tracker*: Util Beacon Tracker Pointer
+ * @return		int
+ */
+int util_beacon_tracker_count(util_beacon_tracker *tracker)
+{
+	RETVM_IF(NULL == tracker, 0, "tracker is NULL");
+	return tracker->count;
+}
@@ -0,0 +1,41 @@
+/*******************************************************************************
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the License);
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *******************************************************************************/
+
+/**
+ *  @file util_clock.c
+ *
+ *	@brief
+ *	Monotonic clock
+ *  Implementation of util_clock
+ */
+#include "utils/util_clock.h"
+
+#include <time.h>
+
+
+/**
+ * @function		util_clock_now_us
+ * @since_tizen		2.3
+ * @description		Monotonic Clock In Microseconds
+ * @parameter		NA
+ * @return		unsigned long long
+ */
+unsigned long long util_clock_now_us()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (unsigned long long) ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
@@ -0,0 +1,465 @@
+/*******************************************************************************
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the License);
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *******************************************************************************/
+
+/**
+ *  @file util_event_journal.c
+ *
+ *	@brief
+ *	Binary event journal flushed in the background
+ *  Implementation of util_event_journal
+ */
+#include "utils/util_event_journal.h"
+#include "utils/util_clock.h"
+
+#include <Ecore.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+
+// define custom logging for the event journal
+#define __LOG(prio, fmt, arg...) dlog_print(prio, "UTIL_EVENT_JOURNAL", "%s (%d) > " fmt, __func__, __LINE__, ##arg)
+#define logd(fmt, arg...) __LOG(DLOG_DEBUG, fmt, ##arg)
+#define loge(fmt, arg...) __LOG(DLOG_ERROR, fmt, ##arg)
+#define logi(fmt, arg...) __LOG(DLOG_INFO, fmt, ##arg)
+
+
+// define structures
+struct _util_event_journal
+{
+	int fd;
+	util_event_record *ring;
+	int capacity;
+
+	//Records ever added and ever flushed, the ring index is the count modulo capacity
+	unsigned long long added;
+	unsigned long long flushed;
+	unsigned long long flush_end;	// end of the range the thread is writing
+
+	Ecore_Thread *thread;
+	Ecore_Timer *timer;
+	bool closing;
+
+	//Filled by the thread, read on the main loop once it is done
+	ssize_t written;
+	int write_errno;
+	unsigned long long write_us;
+
+	char addresses[UTIL_EVENT_JOURNAL_MAX_ADDRESSES][18];
+	int n_addresses;
+
+	util_event_journal_stats stats;
+};
+
+
+static void journal_flush_start(util_event_journal *journal);
+
+
+/**
+ * @function		journal_write_range
+ * @since_tizen		2.3
+ * @description		Appends The Records [flushed, flush_end) To The File, At Most Two Pieces Around The Ring End
+ * @parameter		util_event_journal*: Util Event Journal Pointer
+ * @return		static void
+ */
+static void journal_write_range(util_event_journal *journal)
+{
+	unsigned long long start_us = util_clock_now_us();
+	int first = (int)(journal->flushed % journal->capacity);
+	int count = (int)(journal->flush_end - journal->flushed);
+	int head = count < journal->capacity - first ? count : journal->capacity - first;
+
+	struct iovec iov[2];
+	iov[0].iov_base = &journal->ring[first];
+	iov[0].iov_len = head * sizeof(util_event_record);
+	iov[1].iov_base = journal->ring;
+	iov[1].iov_len = (count - head) * sizeof(util_event_record);
+
+	journal->written = writev(journal->fd, iov, count > head ? 2 : 1);
+	journal->write_errno = journal->written < 0 ? errno : 0;
+	journal->write_us = util_clock_now_us() - start_us;
+}
+
+
+/**
+ * @function		journal_write_done
+ * @since_tizen		2.3
+ * @description		Accounts A Finished Write On The Main Loop
+ * @parameter		util_event_journal*: Util Event Journal Pointer
+ * @return		static void
+ */
+static void journal_write_done(util_event_journal *journal)
+{
+	util_event_journal_stats *s = &journal->stats;
+
+	s->flushes++;
+	s->flush_us += journal->write_us;
+	if (journal->write_us > s->max_flush_us)
+	{
+		s->max_flush_us = journal->write_us;
+	}
+
+	if (journal->written < 0)
+	{
+		//The records are lost, keeping them would stall the ring on a full disk
+		s->write_errors++;
+		loge("writev failed: %s", strerror(journal->write_errno));
+	}
+	else
+	{
+		s->bytes += journal->written;
+	}
+	journal->flushed = journal->flush_end;
+}
+
+
+/**
+ * @function		journal_close
+ * @since_tizen		2.3
+ * @description		Writes What Is Left And Frees The Journal
+ * @parameter		util_event_journal*: Util Event Journal Pointer
+ * @return		static void
+ */
+static void journal_close(util_event_journal *journal)
+{
+	if (journal->added > journal->flushed)
+	{
+		journal->flush_end = journal->added;
+		journal_write_range(journal);
+		journal_write_done(journal);
+	}
+
+	util_event_journal_info(journal);
+	close(journal->fd);
+	SAFE_DELETE(journal->ring);
+	free(journal);
+}
+
+
+/**
+ * @function		_journal_flush_blocking_cb
+ * @since_tizen		2.3
+ * @description		 Journal Flush Blocking Cb, In The Ecore Thread
+ * @parameter		void*: Void Pointer, Ecore_Thread*: Ecore Thread Pointer
+ * @return		static void
+ */
+static void _journal_flush_blocking_cb(void *data, Ecore_Thread *thread)
+{
+	journal_write_range((util_event_journal*)data);
+}
+
+
+/**
+ * @function		_journal_flush_end_cb
+ * @since_tizen		2.3
+ * @description		 Journal Flush End Cb
+ * @parameter		void*: Void Pointer, Ecore_Thread*: Ecore Thread Pointer
+ * @return		static void
+ */
+static void _journal_flush_end_cb(void *data, Ecore_Thread *thread)
+{
+	util_event_journal *journal = (util_event_journal*)data;
+
+	journal->thread = NULL;
+	journal_write_done(journal);
+
+	if (journal->closing)
+	{
+		journal_close(journal);
+		return;
+	}
+
+	//Filled up again while the disk was busy
+	if ((journal->added - journal->flushed) * 2 >= (unsigned long long) journal->capacity)
+	{
+		journal_flush_start(journal);
+	}
+}
+
+
+/**
+ * @function		_journal_timer_cb
+ * @since_tizen		2.3
+ * @description		 Journal Timer Cb
+ * @parameter		void*: Void Pointer
+ * @return		static Eina_Bool
+ */
+static Eina_Bool _journal_timer_cb(void *data)
+{
+	journal_flush_start((util_event_journal*)data);
+	return ECORE_CALLBACK_RENEW;
+}
+
+
+/**
+ * @function		journal_flush_start
+ * @since_tizen		2.3
+ * @description		Hands The Pending Records To The Ecore Thread
+ * @parameter		util_event_journal*: Util Event Journal Pointer
+ * @return		static void
+ */
+static void journal_flush_start(util_event_journal *journal)
+{
+	if (journal->thread != NULL || journal->added == journal->flushed)
+	{
+		return;
+	}
+
+	journal->flush_end = journal->added;
+	//Stays an error if the thread is cancelled before it writes
+	journal->written = -1;
+	journal->write_errno = ECANCELED;
+	journal->write_us = 0;
+	journal->thread = ecore_thread_run(_journal_flush_blocking_cb, _journal_flush_end_cb, _journal_flush_end_cb, journal);
+	if (journal->thread == NULL)
+	{
+		//No thread to be had, write on the main loop rather than lose the records
+		logd("ecore_thread_run failed, writing inline");
+		journal_write_range(journal);
+		journal_write_done(journal);
+	}
+}
+
+
+/**
+ * @function		journal_put
+ * @since_tizen		2.3
+ * @description		Copies One Record Into The Ring
+ * @parameter		util_event_journal*: Util Event Journal Pointer, const util_event_record*: Util Event Record Pointer
+ * @return		static void
+ */
+static void journal_put(util_event_journal *journal, const util_event_record *record)
+{
+	int pending = (int)(journal->added - journal->flushed);
+
+	if (pending == journal->capacity)
+	{
+		journal->stats.dropped++;
+		return;
+	}
+
+	journal->ring[journal->added % journal->capacity] = *record;
+	journal->added++;
+	journal->stats.records++;
+
+	pending++;
+	if (pending > journal->stats.max_pending)
+	{
+		journal->stats.max_pending = pending;
+	}
+	if (pending * 2 >= journal->capacity)
+	{
+		journal_flush_start(journal);
+	}
+}
+
+
+/**
+ * @function		util_event_journal_create
+ * @since_tizen		2.3
+ * @description		Util Event Journal Create
+ * @parameter		const char*: Path, int: Capacity, double: Flush Interval
+ * @return		util_event_journal*
+ */
+util_event_journal* util_event_journal_create(const char *path, int capacity, double flush_interval)
+{
+	RETVM_IF(NULL == path, NULL, "path is NULL");
+	RETVM_IF(capacity < 2, NULL, "invalid capacity %d", capacity);
+	RETVM_IF(flush_interval <= 0, NULL, "invalid flush interval %f", flush_interval);
+
+	util_event_journal *journal = calloc(1, sizeof(util_event_journal));
+	RETVM_IF(!journal, NULL, "calloc failed");
+
+	journal->ring = calloc(capacity, sizeof(util_event_record));
+	if (journal->ring == NULL)
+	{
+		loge("calloc failed for %d records", capacity);
+		free(journal);
+		return NULL;
+	}
+	journal->capacity = capacity;
+
+	journal->fd = open(path, O_WRONLY | O_CREAT | O_APPEND, 0644);
+	if (journal->fd < 0)
+	{
+		loge("open %s failed: %s", path, strerror(errno));
+		free(journal->ring);
+		free(journal);
+		return NULL;
+	}
+
+	journal->timer = ecore_timer_add(flush_interval, _journal_timer_cb, journal);
+
+	//The monotonic times of the session are placed on the wall clock through this record
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+
+	util_event_record session;
+	session.time_us = util_clock_now_us();
+	session.type = UTIL_EVENT_SESSION;
+	session.link = UTIL_EVENT_JOURNAL_VERSION;
+	session.handle = (uint32_t) tv.tv_sec;
+	session.length = (uint32_t) tv.tv_usec;
+	session.result = UTIL_EVENT_JOURNAL_MAGIC;
+	journal_put(journal, &session);
+
+	logi("journal %s, %d records of %d bytes", path, capacity, (int) sizeof(util_event_record));
+	return journal;
+}
+
+
+/**
+ * @function		util_event_journal_destroy
+ * @since_tizen		2.3
+ * @description		Util Event Journal Destroy
+ * @parameter		util_event_journal*: Util Event Journal Pointer
+ * @return		void
+ */
+void util_event_journal_destroy(util_event_journal *journal)
+{
+	if (journal == NULL) return;
+
+	if (journal->timer != NULL)
+	{
+		ecore_timer_del(journal->timer);
+		journal->timer = NULL;
+	}
+
+	//The thread is writing from the ring, the end callback closes the journal after it
+	journal->closing = true;
+	if (journal->thread == NULL)
+	{
+		journal_close(journal);
+	}
+}
+
+
+/**
+ * @function		util_event_journal_address
+ * @since_tizen		2.3
+ * @description		Util Event Journal Address
+ * @parameter		util_event_journal*: Util Event Journal Pointer, const char*: Address
+ * @return		int
+ */
+int util_event_journal_address(util_event_journal *journal, const char *address)
+{
+	if (journal == NULL || address == NULL)
+	{
+		return UTIL_EVENT_NO_LINK;
+	}
+
+	int i;
+	for (i = 0; i < journal->n_addresses; i++)
+	{
+		if (strcasecmp(journal->addresses[i], address) == 0)
+		{
+			return i;
+		}
+	}
+	RETVM_IF(journal->n_addresses == UTIL_EVENT_JOURNAL_MAX_ADDRESSES, UTIL_EVENT_NO_LINK, "address table is full");
+
+	snprintf(journal->addresses[i], sizeof(journal->addresses[i]), "%s", address);
+	journal->n_addresses++;
+
+	unsigned int b[6] = { 0 };
+	if (sscanf(address, "%2x:%2x:%2x:%2x:%2x:%2x", &b[0], &b[1], &b[2], &b[3], &b[4], &b[5]) != 6)
+	{
+		logd("%s is not a MAC address", address);
+	}
+	util_event_journal_add(journal, UTIL_EVENT_ADDRESS, i,
+			(b[0] << 24) | (b[1] << 16) | (b[2] << 8) | b[3], (b[4] << 8) | b[5], 0);
+
+	return i;
+}
+
+
+/**
+ * @function		util_event_journal_add
+ * @since_tizen		2.3
+ * @description		Util Event Journal Add
+ * @parameter		util_event_journal*: Util Event Journal Pointer, util_event_type: Type, int: Link, unsigned int: Handle, unsigned int: Length, int: Result
+ * @return		void
+ */
+void util_event_journal_add(util_event_journal *journal, util_event_type type, int link, unsigned int handle, unsigned int length, int result)
+{
+	if (journal == NULL || journal->closing)
+	{
+		return;
+	}
+
+	util_event_record record;
+	record.time_us = util_clock_now_us();
+	record.type = (uint16_t) type;
+	record.link = (uint16_t) link;
+	record.handle = handle;
+	record.length = length;
+	record.result = result;
+	journal_put(journal, &record);
+}
+
+
+/**
+ * @function		util_event_journal_flush
+ * @since_tizen		2.3
+ * @description		Util Event Journal Flush
+ * @parameter		util_event_journal*: Util Event Journal Pointer
+ * @return		void
+ */
+void util_event_journal_flush(util_event_journal *journal)
+{
+	RETM_IF(NULL == journal, "journal is NULL");
+
+	journal_flush_start(journal);
+}
+
+
+/**
+ * @function		util_event_journal_get_stats
+ * @since_tizen		2.3
+ * @description		Util Event Journal Get Stats
+ * @parameter		util_event_journal*: Util Event Journal Pointer, util_event_journal_stats*: Util Event Journal Stats Pointer
+ * @return		void
+ */
+void util_event_journal_get_stats(util_event_journal *journal, util_event_journal_stats *stats)
+{
+	RETM_IF(NULL == journal, "journal is NULL");
+	RETM_IF(NULL == stats, "stats is NULL");
+
+	*stats = journal->stats;
+}
+
+
+/**
+ * @function		util_event_journal_info
+ * @since_tizen		2.3
+ * @description		Util Event Journal Info
+ * @parameter		util_event_journal*: Util Event Journal Pointer
+ * @return		void
+ */
+void util_event_journal_info(util_event_journal *journal)
+{
+	RETM_IF(NULL == journal, "journal is NULL");
+
+	util_event_journal_stats *s = &journal->stats;
+
+	logi("records=%lu dropped=%lu pending max=%d/%d flushes=%lu bytes=%llu errors=%lu flush avg %.2f ms max %.2f ms addresses=%d",
+			s->records, s->dropped, s->max_pending, journal->capacity, s->flushes, s->bytes, s->write_errors,
+			s->flushes ? s->flush_us / 1000.0 / s->flushes : 0.0, s->max_flush_us / 1000.0, journal->n_addresses);
+}
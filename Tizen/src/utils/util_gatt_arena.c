@@ -0,0 +1,393 @@
+/*******************************************************************************
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the License);
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *******************************************************************************/
+
+/**
+ *  @file util_gatt_arena.c
+ *
+ *	@brief
+ *	Attribute database of one GATT connection
+ *  Implementation of util_gatt_arena
+ */
+#include "utils/util_gatt_arena.h"
+#include "utils/util_gatt_names.h"
+
+#include <string.h>
+
+
+// define custom logging for the arena
+#define __LOG(prio, fmt, arg...) dlog_print(prio, "UTIL_GATT_ARENA", "%s (%d) > " fmt, __func__, __LINE__, ##arg)
+#define logd(fmt, arg...) __LOG(DLOG_DEBUG, fmt, ##arg)
+#define loge(fmt, arg...) __LOG(DLOG_ERROR, fmt, ##arg)
+#define logi(fmt, arg...) __LOG(DLOG_INFO, fmt, ##arg)
+
+
+#define ARENA_MIN_CAPACITY	16
+#define ARENA_NIL			-1
+
+
+// define structures
+struct _util_gatt_arena
+{
+	util_gatt_attr *attrs;	// in discovery order
+	int *uuid_tails;		// for the first attribute of each UUID, the last one
+	int capacity;
+	int count;
+
+	// open addressing indexes into attrs, ARENA_NIL when empty
+	int *handle_slots;
+	int *uuid_slots;
+	int slot_mask;
+
+	unsigned long grows;
+};
+
+
+/**
+ * @function		arena_mix
+ * @since_tizen		2.3
+ * @description		64 Bit Finaliser (splitmix64)
+ * @parameter		uint64_t: Uint64 T
+ * @return		static uint64_t
+ */
+static uint64_t arena_mix(uint64_t x)
+{
+	x ^= x >> 30;
+	x *= 0xbf58476d1ce4e5b9ULL;
+	x ^= x >> 27;
+	x *= 0x94d049bb133111ebULL;
+	x ^= x >> 31;
+	return x;
+}
+
+
+/**
+ * @function		arena_uuid_hash
+ * @since_tizen		2.3
+ * @description		FNV-1a Over The UUID Bytes
+ * @parameter		const uint8_t*: Const uint8 T Pointer
+ * @return		static uint64_t
+ */
+static uint64_t arena_uuid_hash(const uint8_t uuid[16])
+{
+	uint64_t hash = 1469598103934665603ULL;
+	int i;
+
+	for (i = 0; i < 16; i++)
+	{
+		hash ^= uuid[i];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+
+/**
+ * @function		arena_handle_slot
+ * @since_tizen		2.3
+ * @description		Finds The Slot Holding handle, Or The Empty Slot Where It Would Go
+ * @parameter		util_gatt_arena*: Util Gatt Arena Pointer, void*: Void Pointer
+ * @return		static int
+ */
+static int arena_handle_slot(util_gatt_arena *arena, void *handle)
+{
+	int slot = (int) (arena_mix((uint64_t) (uintptr_t) handle) & arena->slot_mask);
+
+	while (arena->handle_slots[slot] != ARENA_NIL && arena->attrs[arena->handle_slots[slot]].handle != handle)
+	{
+		slot = (slot + 1) & arena->slot_mask;
+	}
+	return slot;
+}
+
+
+/**
+ * @function		arena_uuid_slot
+ * @since_tizen		2.3
+ * @description		Finds The Slot Holding uuid, Or The Empty Slot Where It Would Go
+ * @parameter		util_gatt_arena*: Util Gatt Arena Pointer, const uint8_t*: Const uint8 T Pointer
+ * @return		static int
+ */
+static int arena_uuid_slot(util_gatt_arena *arena, const uint8_t uuid[16])
+{
+	int slot = (int) (arena_uuid_hash(uuid) & arena->slot_mask);
+
+	while (arena->uuid_slots[slot] != ARENA_NIL && memcmp(arena->attrs[arena->uuid_slots[slot]].uuid, uuid, 16) != 0)
+	{
+		slot = (slot + 1) & arena->slot_mask;
+	}
+	return slot;
+}
+
+
+/**
+ * @function		arena_resize
+ * @since_tizen		2.3
+ * @description		Makes Room For capacity Attributes And Rebuilds The Indexes At Most Half Full
+ * @parameter		util_gatt_arena*: Util Gatt Arena Pointer, int: Int
+ * @return		static bool
+ */
+static bool arena_resize(util_gatt_arena *arena, int capacity)
+{
+	int slot_count = 1;
+	int i;
+
+	while (slot_count < capacity * 2)
+	{
+		slot_count <<= 1;
+	}
+
+	util_gatt_attr *attrs = realloc(arena->attrs, sizeof(util_gatt_attr) * capacity);
+	RETVM_IF(NULL == attrs, false, "realloc failed");
+	arena->attrs = attrs;
+
+	int *tails = realloc(arena->uuid_tails, sizeof(int) * capacity);
+	RETVM_IF(NULL == tails, false, "realloc failed");
+	arena->uuid_tails = tails;
+
+	int *handle_slots = malloc(sizeof(int) * slot_count);
+	int *uuid_slots = malloc(sizeof(int) * slot_count);
+	if (handle_slots == NULL || uuid_slots == NULL)
+	{
+		loge("malloc failed");
+		SAFE_DELETE(handle_slots);
+		SAFE_DELETE(uuid_slots);
+		return false;
+	}
+
+	SAFE_DELETE(arena->handle_slots);
+	SAFE_DELETE(arena->uuid_slots);
+	arena->handle_slots = handle_slots;
+	arena->uuid_slots = uuid_slots;
+	arena->slot_mask = slot_count - 1;
+	arena->capacity = capacity;
+	memset(arena->handle_slots, 0xFF, sizeof(int) * slot_count);
+	memset(arena->uuid_slots, 0xFF, sizeof(int) * slot_count);
+
+	for (i = 0; i < arena->count; i++)
+	{
+		arena->handle_slots[arena_handle_slot(arena, arena->attrs[i].handle)] = i;
+
+		int slot = arena_uuid_slot(arena, arena->attrs[i].uuid);
+		if (arena->uuid_slots[slot] == ARENA_NIL)
+		{
+			arena->uuid_slots[slot] = i;
+		}
+	}
+	return true;
+}
+
+
+/**
+ * @function		util_gatt_arena_create
+ * @since_tizen		2.3
+ * @description		Util Gatt Arena Create
+ * @parameter		int: Int
+ * @return		util_gatt_arena*
+ */
+util_gatt_arena* util_gatt_arena_create(int capacity)
+{
+	RETVM_IF(capacity < 0, NULL, "invalid capacity %d", capacity);
+
+	util_gatt_arena *arena = calloc(1, sizeof(util_gatt_arena));
+	RETVM_IF(!arena, NULL, "calloc failed");
+
+	if (!arena_resize(arena, capacity < ARENA_MIN_CAPACITY ? ARENA_MIN_CAPACITY : capacity))
+	{
+		util_gatt_arena_destroy(arena);
+		return NULL;
+	}
+	return arena;
+}
+
+
+/**
+ * @function		util_gatt_arena_destroy
+ * @since_tizen		2.3
+ * @description		Util Gatt Arena Destroy
+ * @parameter		util_gatt_arena*: Util Gatt Arena Pointer
+ * @return		void
+ */
+void util_gatt_arena_destroy(util_gatt_arena *arena)
+{
+	if (arena == NULL) return;
+
+	SAFE_DELETE(arena->attrs);
+	SAFE_DELETE(arena->uuid_tails);
+	SAFE_DELETE(arena->handle_slots);
+	SAFE_DELETE(arena->uuid_slots);
+	free(arena);
+}
+
+
+/**
+ * @function		util_gatt_arena_add
+ * @since_tizen		2.3
+ * @description		Util Gatt Arena Add
+ * @parameter		util_gatt_arena*: Util Gatt Arena Pointer, util_gatt_attr_type: Util Gatt Attr Type, int: Int, void*: Void Pointer, const char*: Const char Pointer
+ * @return		int
+ */
+int util_gatt_arena_add(util_gatt_arena *arena, util_gatt_attr_type type, int parent, void *handle, const char *uuid)
+{
+	RETVM_IF(NULL == arena, ARENA_NIL, "arena is NULL");
+	RETVM_IF(parent < ARENA_NIL || parent >= arena->count, ARENA_NIL, "invalid parent %d", parent);
+
+	uint8_t bytes[16];
+	RETVM_IF(!util_gatt_uuid_parse(uuid, bytes), ARENA_NIL, "malformed uuid %s", uuid ? uuid : "(null)");
+
+	int existing = arena->handle_slots[arena_handle_slot(arena, handle)];
+	if (existing != ARENA_NIL)
+	{
+		return existing;
+	}
+
+	if (arena->count == arena->capacity)
+	{
+		RETVM_IF(!arena_resize(arena, arena->capacity * 2), ARENA_NIL, "arena full at %d attributes", arena->count);
+		arena->grows++;
+	}
+
+	int index = arena->count++;
+	util_gatt_attr *attr = &arena->attrs[index];
+
+	attr->type = type;
+	attr->handle = handle;
+	attr->parent = parent;
+	attr->first_child = ARENA_NIL;
+	attr->last_child = ARENA_NIL;
+	attr->next_sibling = ARENA_NIL;
+	attr->next_same_uuid = ARENA_NIL;
+	attr->short_uuid = util_gatt_short_uuid(uuid);
+	memcpy(attr->uuid, bytes, 16);
+
+	if (parent != ARENA_NIL)
+	{
+		util_gatt_attr *p = &arena->attrs[parent];
+		if (p->last_child != ARENA_NIL) arena->attrs[p->last_child].next_sibling = index;
+		else p->first_child = index;
+		p->last_child = index;
+	}
+
+	arena->handle_slots[arena_handle_slot(arena, handle)] = index;
+
+	int slot = arena_uuid_slot(arena, bytes);
+	int first = arena->uuid_slots[slot];
+	if (first == ARENA_NIL)
+	{
+		arena->uuid_slots[slot] = index;
+		arena->uuid_tails[index] = index;
+	}
+	else
+	{
+		arena->attrs[arena->uuid_tails[first]].next_same_uuid = index;
+		arena->uuid_tails[first] = index;
+	}
+
+	return index;
+}
+
+
+/**
+ * @function		util_gatt_arena_count
+ * @since_tizen		2.3
+ * @description		Util Gatt Arena Count
+ * @parameter		util_gatt_arena*: Util Gatt Arena Pointer
+ * @return		int
+ */
+int util_gatt_arena_count(util_gatt_arena *arena)
+{
+	RETVM_IF(NULL == arena, 0, "arena is NULL");
+
+	return arena->count;
+}
+
+
+/**
+ * @function		util_gatt_arena_get
+ * @since_tizen		2.3
+ * @description		Util Gatt Arena Get
+ * @parameter		util_gatt_arena*: Util Gatt Arena Pointer, int: Int
+ * @return		const util_gatt_attr*
+ */
+const util_gatt_attr* util_gatt_arena_get(util_gatt_arena *arena, int index)
+{
+	RETVM_IF(NULL == arena, NULL, "arena is NULL");
+	RETVM_IF(index < 0 || index >= arena->count, NULL, "index %d out of range", index);
+
+	return &arena->attrs[index];
+}
+
+
+/**
+ * @function		util_gatt_arena_find_handle
+ * @since_tizen		2.3
+ * @description		Util Gatt Arena Find Handle
+ * @parameter		util_gatt_arena*: Util Gatt Arena Pointer, void*: Void Pointer
+ * @return		int
+ */
+int util_gatt_arena_find_handle(util_gatt_arena *arena, void *handle)
+{
+	RETVM_IF(NULL == arena, ARENA_NIL, "arena is NULL");
+
+	return arena->handle_slots[arena_handle_slot(arena, handle)];
+}
+
+
+/**
+ * @function		util_gatt_arena_find_uuid
+ * @since_tizen		2.3
+ * @description		Util Gatt Arena Find Uuid
+ * @parameter		util_gatt_arena*: Util Gatt Arena Pointer, const char*: Const char Pointer
+ * @return		int
+ */
+int util_gatt_arena_find_uuid(util_gatt_arena *arena, const char *uuid)
+{
+	RETVM_IF(NULL == arena, ARENA_NIL, "arena is NULL");
+
+	uint8_t bytes[16];
+	if (!util_gatt_uuid_parse(uuid, bytes))
+	{
+		return ARENA_NIL;
+	}
+	return arena->uuid_slots[arena_uuid_slot(arena, bytes)];
+}
+
+
+/**
+ * @function		util_gatt_arena_info
+ * @since_tizen		2.3
+ * @description		Util Gatt Arena Info
+ * @parameter		util_gatt_arena*: Util Gatt Arena Pointer
+ * @return		void
+ */
+void util_gatt_arena_info(util_gatt_arena *arena)
+{
+	RETM_IF(NULL == arena, "arena is NULL");
+
+	int counts[3] = { 0, 0, 0 };
+	int i;
+
+	for (i = 0; i < arena->count; i++)
+	{
+		counts[arena->attrs[i].type]++;
+	}
+
+	unsigned long bytes = (unsigned long) arena->capacity * (sizeof(util_gatt_attr) + sizeof(int))
+			+ (unsigned long) (arena->slot_mask + 1) * 2 * sizeof(int);
+
+	logi("services=%d characteristics=%d descriptors=%d attributes=%d/%d grows=%lu bytes=%lu",
+			counts[UTIL_GATT_ATTR_SERVICE], counts[UTIL_GATT_ATTR_CHARACTERISTIC], counts[UTIL_GATT_ATTR_DESCRIPTOR],
+			arena->count, arena->capacity, arena->grows, bytes);
+}
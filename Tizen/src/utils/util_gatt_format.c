@@ -0,0 +1,841 @@
+/*******************************************************************************
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the License);
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *******************************************************************************/
+
+/**
+ *  @file util_gatt_format.c
+ *
+ *	@brief
+ *	Characteristic values decoded by their Presentation Format
+ *  Implementation of util_gatt_format
+ */
+#include "utils/util_gatt_format.h"
+
+#include <stdio.h>
+#include <string.h>
+
+
+// define custom logging for gatt format
+#define __LOG(prio, fmt, arg...) dlog_print(prio, "UTIL_GATT_FORMAT", "%s (%d) > " fmt, __func__, __LINE__, ##arg)
+#define logd(fmt, arg...) __LOG(DLOG_DEBUG, fmt, ##arg)
+#define loge(fmt, arg...) __LOG(DLOG_ERROR, fmt, ##arg)
+#define logi(fmt, arg...) __LOG(DLOG_INFO, fmt, ##arg)
+
+
+#define FORMAT_DESCRIPTOR_SIZE	7
+#define CACHE_MIN_SLOTS		16
+
+
+// how the bytes of each format are read
+typedef enum
+{
+	KIND_HEX,
+	KIND_BOOL,
+	KIND_UINT,
+	KIND_SINT,
+	KIND_IEEE754,
+	KIND_SFLOAT,		// IEEE-11073 16 bit
+	KIND_FLOAT,		// IEEE-11073 32 bit
+	KIND_DUINT16,
+	KIND_UTF8
+} format_kind;
+
+
+typedef struct
+{
+	format_kind kind;
+	uint8_t bytes;		// 0 for variable length
+	uint8_t bits;
+} format_entry;
+
+
+// Presentation Format, format field. Anything past 0x1B is shown as hex.
+static const format_entry formats[] =
+{
+	[0x01] = { KIND_BOOL, 1, 1 },
+	[0x02] = { KIND_UINT, 1, 2 },
+	[0x03] = { KIND_UINT, 1, 4 },
+	[0x04] = { KIND_UINT, 1, 8 },
+	[0x05] = { KIND_UINT, 2, 12 },
+	[0x06] = { KIND_UINT, 2, 16 },
+	[0x07] = { KIND_UINT, 3, 24 },
+	[0x08] = { KIND_UINT, 4, 32 },
+	[0x09] = { KIND_UINT, 6, 48 },
+	[0x0A] = { KIND_UINT, 8, 64 },
+	[0x0B] = { KIND_HEX, 16, 128 },
+	[0x0C] = { KIND_SINT, 1, 8 },
+	[0x0D] = { KIND_SINT, 2, 12 },
+	[0x0E] = { KIND_SINT, 2, 16 },
+	[0x0F] = { KIND_SINT, 3, 24 },
+	[0x10] = { KIND_SINT, 4, 32 },
+	[0x11] = { KIND_SINT, 6, 48 },
+	[0x12] = { KIND_SINT, 8, 64 },
+	[0x13] = { KIND_HEX, 16, 128 },
+	[0x14] = { KIND_IEEE754, 4, 32 },
+	[0x15] = { KIND_IEEE754, 8, 64 },
+	[0x16] = { KIND_SFLOAT, 2, 16 },
+	[0x17] = { KIND_FLOAT, 4, 32 },
+	[0x18] = { KIND_DUINT16, 4, 32 },
+	[0x19] = { KIND_UTF8, 0, 0 },
+	[0x1A] = { KIND_HEX, 0, 0 },	// UTF-16, shown raw
+	[0x1B] = { KIND_HEX, 0, 0 },	// struct
+};
+
+
+// Unit symbols by unit UUID, from the Bluetooth assigned numbers, sorted for the binary search
+static const struct
+{
+	uint16_t unit;
+	const char *symbol;
+} units[] =
+{
+	{ 0x2700, "" },
+	{ 0x2701, "m" },
+	{ 0x2702, "kg" },
+	{ 0x2703, "s" },
+	{ 0x2704, "A" },
+	{ 0x2705, "K" },
+	{ 0x2706, "mol" },
+	{ 0x2707, "cd" },
+	{ 0x2710, "m²" },
+	{ 0x2711, "m³" },
+	{ 0x2712, "m/s" },
+	{ 0x2713, "m/s²" },
+	{ 0x2714, "1/m" },
+	{ 0x2715, "kg/m³" },
+	{ 0x2716, "kg/m²" },
+	{ 0x2717, "m³/kg" },
+	{ 0x2718, "A/m²" },
+	{ 0x2719, "A/m" },
+	{ 0x271A, "mol/m³" },
+	{ 0x271B, "kg/m³" },
+	{ 0x271C, "cd/m²" },
+	{ 0x271D, "" },
+	{ 0x271E, "" },
+	{ 0x2720, "rad" },
+	{ 0x2721, "sr" },
+	{ 0x2722, "Hz" },
+	{ 0x2723, "N" },
+	{ 0x2724, "Pa" },
+	{ 0x2725, "J" },
+	{ 0x2726, "W" },
+	{ 0x2727, "C" },
+	{ 0x2728, "V" },
+	{ 0x2729, "F" },
+	{ 0x272A, "Ω" },
+	{ 0x272B, "S" },
+	{ 0x272C, "Wb" },
+	{ 0x272D, "T" },
+	{ 0x272E, "H" },
+	{ 0x272F, "°C" },
+	{ 0x2730, "lm" },
+	{ 0x2731, "lx" },
+	{ 0x2732, "Bq" },
+	{ 0x2733, "Gy" },
+	{ 0x2734, "Sv" },
+	{ 0x2735, "kat" },
+	{ 0x2740, "Pa s" },
+	{ 0x2741, "N m" },
+	{ 0x2742, "N/m" },
+	{ 0x2743, "rad/s" },
+	{ 0x2744, "rad/s²" },
+	{ 0x2745, "W/m²" },
+	{ 0x2746, "J/K" },
+	{ 0x2747, "J/(kg K)" },
+	{ 0x2748, "J/kg" },
+	{ 0x2749, "W/(m K)" },
+	{ 0x274A, "J/m³" },
+	{ 0x274B, "V/m" },
+	{ 0x274C, "C/m³" },
+	{ 0x274D, "C/m²" },
+	{ 0x274E, "C/m²" },
+	{ 0x274F, "F/m" },
+	{ 0x2750, "H/m" },
+	{ 0x2751, "J/mol" },
+	{ 0x2752, "J/(mol K)" },
+	{ 0x2753, "C/kg" },
+	{ 0x2754, "Gy/s" },
+	{ 0x2755, "W/sr" },
+	{ 0x2756, "W/(m² sr)" },
+	{ 0x2757, "kat/m³" },
+	{ 0x2760, "min" },
+	{ 0x2761, "h" },
+	{ 0x2762, "d" },
+	{ 0x2763, "°" },
+	{ 0x2764, "′" },
+	{ 0x2765, "″" },
+	{ 0x2766, "ha" },
+	{ 0x2767, "L" },
+	{ 0x2768, "t" },
+	{ 0x2780, "bar" },
+	{ 0x2781, "mmHg" },
+	{ 0x2782, "Å" },
+	{ 0x2783, "NM" },
+	{ 0x2784, "b" },
+	{ 0x2785, "kn" },
+	{ 0x2786, "Np" },
+	{ 0x2787, "B" },
+	{ 0x27A0, "yd" },
+	{ 0x27A1, "pc" },
+	{ 0x27A2, "in" },
+	{ 0x27A3, "ft" },
+	{ 0x27A4, "mi" },
+	{ 0x27A5, "psi" },
+	{ 0x27A6, "km/h" },
+	{ 0x27A7, "mph" },
+	{ 0x27A8, "rpm" },
+	{ 0x27A9, "cal" },
+	{ 0x27AA, "kcal" },
+	{ 0x27AB, "kWh" },
+	{ 0x27AC, "°F" },
+	{ 0x27AD, "%" },
+	{ 0x27AE, "‰" },
+	{ 0x27AF, "bpm" },
+	{ 0x27B0, "Ah" },
+	{ 0x27B1, "mg/dL" },
+	{ 0x27B2, "mmol/L" },
+};
+
+
+// define structures
+typedef struct
+{
+	void *handle;		// NULL for a free slot
+	bool has_format;
+	util_gatt_format fmt;
+} cache_slot;
+
+
+struct _util_gatt_format_cache
+{
+	cache_slot *slots;
+	int slot_mask;
+	int count;
+
+	unsigned long hits;
+	unsigned long misses;
+};
+
+
+/**
+ * @function		format_unit_symbol
+ * @since_tizen		2.3
+ * @description		Symbol Of A Unit UUID, NULL If It Is Not In The Table
+ * @parameter		uint16_t: Unit
+ * @return		static const char*
+ */
+static const char* format_unit_symbol(uint16_t unit)
+{
+	static int sorted = -1;
+	int count = (int)(sizeof(units) / sizeof(units[0]));
+	int lo = 0;
+	int hi = count - 1;
+
+	//An entry out of order would make the search miss units silently, check once and fall back to a scan
+	if (sorted < 0)
+	{
+		int i;
+		sorted = 1;
+		for (i = 1; i < count; i++)
+		{
+			if (units[i - 1].unit >= units[i].unit)
+			{
+				loge("unit table out of order at 0x%04X", units[i].unit);
+				sorted = 0;
+				break;
+			}
+		}
+	}
+	if (!sorted)
+	{
+		while (lo < count && units[lo].unit != unit)
+		{
+			lo++;
+		}
+		return lo < count ? units[lo].symbol : NULL;
+	}
+
+	while (lo <= hi)
+	{
+		int mid = (lo + hi) / 2;
+		if (units[mid].unit == unit)
+		{
+			return units[mid].symbol;
+		}
+		if (units[mid].unit < unit)
+			lo = mid + 1;
+		else
+			hi = mid - 1;
+	}
+	return NULL;
+}
+
+
+/**
+ * @function		format_scale
+ * @since_tizen		2.3
+ * @description		Mantissa Times Ten To The Exponent
+ * @parameter		double: Mantissa, int: Exponent
+ * @return		static double
+ */
+static double format_scale(double mantissa, int exponent)
+{
+	for (; exponent > 0; exponent--)
+		mantissa *= 10;
+	for (; exponent < 0; exponent++)
+		mantissa /= 10;
+	return mantissa;
+}
+
+
+/**
+ * @function		format_read_le
+ * @since_tizen		2.3
+ * @description		Little Endian Integer Of Up To 8 Bytes
+ * @parameter		const uint8_t*: Bytes, int: Count
+ * @return		static uint64_t
+ */
+static uint64_t format_read_le(const uint8_t *p, int bytes)
+{
+	uint64_t v = 0;
+	int i;
+
+	for (i = bytes - 1; i >= 0; i--)
+	{
+		v = (v << 8) | p[i];
+	}
+	return v;
+}
+
+
+/**
+ * @function		format_hex
+ * @since_tizen		2.3
+ * @description		Writes Bytes As Hex
+ * @parameter		const uint8_t*: Bytes, int: Length, char*: Buffer, int: Size
+ * @return		static int
+ */
+static int format_hex(const uint8_t *p, int len, char *buf, int size)
+{
+	static const char digits[] = "0123456789ABCDEF";
+	int n = 0;
+	int i;
+
+	for (i = 0; i < len && n + 3 < size; i++)
+	{
+		if (i > 0)
+			buf[n++] = ' ';
+		buf[n++] = digits[p[i] >> 4];
+		buf[n++] = digits[p[i] & 0x0F];
+	}
+	buf[n] = '\0';
+	return n;
+}
+
+
+/**
+ * @function		format_is_text
+ * @since_tizen		2.3
+ * @description		true If The Bytes Are Printable UTF-8
+ * @parameter		const uint8_t*: Bytes, int: Length
+ * @return		static bool
+ */
+static bool format_is_text(const uint8_t *p, int len)
+{
+	int i = 0;
+
+	while (i < len)
+	{
+		int follow;
+
+		if (p[i] < 0x20 || p[i] == 0x7F)
+			return (p[i] == 0 && i == len - 1 && i > 0);	// a trailing NUL is fine
+		else if (p[i] < 0x80)
+			follow = 0;
+		else if ((p[i] & 0xE0) == 0xC0)
+			follow = 1;
+		else if ((p[i] & 0xF0) == 0xE0)
+			follow = 2;
+		else if ((p[i] & 0xF8) == 0xF0)
+			follow = 3;
+		else
+			return false;
+
+		for (i++; follow > 0; follow--, i++)
+		{
+			if (i >= len || (p[i] & 0xC0) != 0x80)
+				return false;
+		}
+	}
+	return len > 0;
+}
+
+
+/**
+ * @function		format_text
+ * @since_tizen		2.3
+ * @description		Writes Text, Cut At The Buffer Size Or At A NUL
+ * @parameter		const uint8_t*: Bytes, int: Length, char*: Buffer, int: Size
+ * @return		static int
+ */
+static int format_text(const uint8_t *p, int len, char *buf, int size)
+{
+	int n = 0;
+
+	while (n < len && n < size - 1 && p[n] != '\0')
+	{
+		buf[n] = p[n];
+		n++;
+	}
+	buf[n] = '\0';
+	return n;
+}
+
+
+/**
+ * @function		format_11073
+ * @since_tizen		2.3
+ * @description		Decodes An IEEE-11073 SFLOAT Or FLOAT, false For The Special Values
+ * @parameter		uint32_t: Raw, bool: Short Float, double*: Value, int*: Decimals, const char**: Special
+ * @return		static bool
+ */
+static bool format_11073(uint32_t raw, bool sfloat, double *value, int *decimals, const char **special)
+{
+	int32_t mantissa;
+	int exponent;
+
+	if (sfloat)
+	{
+		mantissa = raw & 0x0FFF;
+		exponent = (raw >> 12) & 0x0F;
+		if (mantissa >= 0x07FE && mantissa <= 0x0802)
+		{
+			static const char *const names[] = { "+INF", "NaN", "NRes", "Reserved", "-INF" };
+			*special = names[mantissa - 0x07FE];
+			return false;
+		}
+		if (mantissa & 0x0800) mantissa -= 0x1000;
+		if (exponent & 0x08) exponent -= 0x10;
+	}
+	else
+	{
+		mantissa = raw & 0x00FFFFFF;
+		exponent = (int8_t)(raw >> 24);
+		if (mantissa >= 0x007FFFFE && mantissa <= 0x00800002)
+		{
+			static const char *const names[] = { "+INF", "NaN", "NRes", "Reserved", "-INF" };
+			*special = names[mantissa - 0x007FFFFE];
+			return false;
+		}
+		if (mantissa & 0x00800000) mantissa -= 0x01000000;
+	}
+
+	*value = format_scale(mantissa, exponent);
+	*decimals = exponent < 0 ? -exponent : 0;
+	return true;
+}
+
+
+/**
+ * @function		util_gatt_format_parse
+ * @since_tizen		2.3
+ * @description		Util Gatt Format Parse
+ * @parameter		const void*: Descriptor Value, int: Length, util_gatt_format*: Util Gatt Format Pointer
+ * @return		bool
+ */
+bool util_gatt_format_parse(const void *data, int len, util_gatt_format *fmt)
+{
+	RETVM_IF(NULL == data || NULL == fmt, false, "invalid parameter");
+	RETVM_IF(len < FORMAT_DESCRIPTOR_SIZE, false, "descriptor is %d bytes", len);
+
+	const uint8_t *p = (const uint8_t*) data;
+
+	fmt->format = p[0];
+	fmt->exponent = (int8_t) p[1];
+	fmt->unit = p[2] | (p[3] << 8);
+	fmt->name_space = p[4];
+	fmt->description = p[5] | (p[6] << 8);
+
+	return fmt->format != 0;
+}
+
+
+/**
+ * @function		util_gatt_format_decode
+ * @since_tizen		2.3
+ * @description		Util Gatt Format Decode
+ * @parameter		const util_gatt_format*: Util Gatt Format Pointer, const void*: Value, int: Length, double*: Number
+ * @return		bool
+ */
+bool util_gatt_format_decode(const util_gatt_format *fmt, const void *data, int len, double *value)
+{
+	RETVM_IF(NULL == fmt || NULL == value, false, "invalid parameter");
+
+	if (fmt->format >= sizeof(formats) / sizeof(formats[0]) || data == NULL)
+	{
+		return false;
+	}
+
+	const format_entry *e = &formats[fmt->format];
+	const uint8_t *p = (const uint8_t*) data;
+	if (e->bytes == 0 || len < e->bytes)
+	{
+		return false;
+	}
+
+	switch (e->kind)
+	{
+		case KIND_BOOL:
+		case KIND_UINT:
+		{
+			uint64_t raw = format_read_le(p, e->bytes);
+			if (e->bits < 64) raw &= (1ULL << e->bits) - 1;
+			*value = format_scale((double) raw, fmt->exponent);
+			return true;
+		}
+		case KIND_SINT:
+		{
+			uint64_t raw = format_read_le(p, e->bytes);
+			int64_t v = (int64_t) raw;
+			if (e->bits < 64)
+			{
+				raw &= (1ULL << e->bits) - 1;
+				v = (raw & (1ULL << (e->bits - 1))) ? (int64_t)(raw - (1ULL << e->bits)) : (int64_t) raw;
+			}
+			*value = format_scale((double) v, fmt->exponent);
+			return true;
+		}
+		case KIND_IEEE754:
+		{
+			if (e->bytes == 4)
+			{
+				float f;
+				memcpy(&f, p, sizeof(f));
+				*value = f;
+			}
+			else
+			{
+				memcpy(value, p, sizeof(*value));
+			}
+			return true;
+		}
+		case KIND_SFLOAT:
+		case KIND_FLOAT:
+		{
+			int decimals;
+			const char *special;
+			return format_11073((uint32_t) format_read_le(p, e->bytes), e->kind == KIND_SFLOAT, value, &decimals, &special);
+		}
+		default:
+			return false;
+	}
+}
+
+
+/**
+ * @function		util_gatt_format_value
+ * @since_tizen		2.3
+ * @description		Util Gatt Format Value
+ * @parameter		const util_gatt_format*: Util Gatt Format Pointer, const void*: Value, int: Length, char*: Buffer, int: Size
+ * @return		int
+ */
+int util_gatt_format_value(const util_gatt_format *fmt, const void *data, int len, char *buf, int size)
+{
+	RETVM_IF(NULL == buf || size <= 0, 0, "invalid buffer");
+	buf[0] = '\0';
+	if (data == NULL || len <= 0)
+	{
+		return 0;
+	}
+
+	const uint8_t *p = (const uint8_t*) data;
+	const format_entry *e = NULL;
+	int n = 0;
+
+	if (fmt != NULL && fmt->format != 0 && fmt->format < sizeof(formats) / sizeof(formats[0]))
+	{
+		e = &formats[fmt->format];
+	}
+
+	//No descriptor, or a value shorter than its format says
+	if (e == NULL || len < e->bytes)
+	{
+		if (format_is_text(p, len))
+			return format_text(p, len, buf, size);
+		return format_hex(p, len, buf, size);
+	}
+
+	switch (e->kind)
+	{
+		case KIND_BOOL:
+			n = snprintf(buf, size, "%s", (p[0] & 0x01) ? "true" : "false");
+			break;
+		case KIND_UINT:
+		case KIND_SINT:
+		{
+			double value;
+			util_gatt_format_decode(fmt, p, len, &value);
+			if (fmt->exponent == 0 && e->kind == KIND_UINT)
+			{
+				uint64_t raw = format_read_le(p, e->bytes);
+				if (e->bits < 64) raw &= (1ULL << e->bits) - 1;
+				n = snprintf(buf, size, "%llu", (unsigned long long) raw);
+			}
+			else
+			{
+				n = snprintf(buf, size, "%.*f", fmt->exponent < 0 ? -fmt->exponent : 0, value);
+			}
+			break;
+		}
+		case KIND_IEEE754:
+		{
+			double value;
+			util_gatt_format_decode(fmt, p, len, &value);
+			n = snprintf(buf, size, "%g", value);
+			break;
+		}
+		case KIND_SFLOAT:
+		case KIND_FLOAT:
+		{
+			double value;
+			int decimals;
+			const char *special = NULL;
+			if (format_11073((uint32_t) format_read_le(p, e->bytes), e->kind == KIND_SFLOAT, &value, &decimals, &special))
+				n = snprintf(buf, size, "%.*f", decimals, value);
+			else
+				return snprintf(buf, size, "%s", special);
+			break;
+		}
+		case KIND_DUINT16:
+			n = snprintf(buf, size, "%u, %u", p[0] | (p[1] << 8), p[2] | (p[3] << 8));
+			break;
+		case KIND_UTF8:
+			return format_text(p, len, buf, size);
+		default:
+			return format_hex(p, len, buf, size);
+	}
+
+	if (n < 0 || n >= size)
+	{
+		return size - 1;
+	}
+
+	const char *symbol = format_unit_symbol(fmt->unit);
+	if (symbol != NULL && symbol[0] != '\0')
+	{
+		int m = snprintf(buf + n, size - n, " %s", symbol);
+		n = (m < 0 || m >= size - n) ? size - 1 : n + m;
+	}
+	return n;
+}
+
+
+/**
+ * @function		cache_slot_of
+ * @since_tizen		2.3
+ * @description		Slot Holding A Handle, Or The Free Slot Where It Would Go
+ * @parameter		util_gatt_format_cache*: Util Gatt Format Cache Pointer, void*: Handle
+ * @return		static cache_slot*
+ */
+static cache_slot* cache_slot_of(util_gatt_format_cache *cache, void *handle)
+{
+	uint64_t x = (uint64_t)(uintptr_t) handle;
+	x ^= x >> 33;
+	x *= 0xff51afd7ed558ccdULL;
+	x ^= x >> 33;
+
+	int i = (int)(x & cache->slot_mask);
+	while (cache->slots[i].handle != NULL && cache->slots[i].handle != handle)
+	{
+		i = (i + 1) & cache->slot_mask;
+	}
+	return &cache->slots[i];
+}
+
+
+/**
+ * @function		cache_grow
+ * @since_tizen		2.3
+ * @description		Doubles The Slots
+ * @parameter		util_gatt_format_cache*: Util Gatt Format Cache Pointer
+ * @return		static bool
+ */
+static bool cache_grow(util_gatt_format_cache *cache)
+{
+	int n_old = cache->slot_mask + 1;
+	cache_slot *old = cache->slots;
+
+	cache->slots = calloc(n_old * 2, sizeof(cache_slot));
+	if (cache->slots == NULL)
+	{
+		loge("calloc failed for %d slots", n_old * 2);
+		cache->slots = old;
+		return false;
+	}
+	cache->slot_mask = n_old * 2 - 1;
+
+	int i;
+	for (i = 0; i < n_old; i++)
+	{
+		if (old[i].handle != NULL)
+		{
+			*cache_slot_of(cache, old[i].handle) = old[i];
+		}
+	}
+	free(old);
+	return true;
+}
+
+
+/**
+ * @function		util_gatt_format_cache_create
+ * @since_tizen		2.3
+ * @description		Util Gatt Format Cache Create
+ * @parameter		int: Capacity
+ * @return		util_gatt_format_cache*
+ */
+util_gatt_format_cache* util_gatt_format_cache_create(int capacity)
+{
+	util_gatt_format_cache *cache = calloc(1, sizeof(util_gatt_format_cache));
+	RETVM_IF(!cache, NULL, "calloc failed");
+
+	int n = CACHE_MIN_SLOTS;
+	while (n < capacity * 4 / 3)
+	{
+		n *= 2;
+	}
+
+	cache->slots = calloc(n, sizeof(cache_slot));
+	if (cache->slots == NULL)
+	{
+		loge("calloc failed for %d slots", n);
+		free(cache);
+		return NULL;
+	}
+	cache->slot_mask = n - 1;
+
+	return cache;
+}
+
+
+/**
+ * @function		util_gatt_format_cache_destroy
+ * @since_tizen		2.3
+ * @description		Util Gatt Format Cache Destroy
+ * @parameter		util_gatt_format_cache*: Util Gatt Format Cache Pointer
+ * @return		void
+ */
+void util_gatt_format_cache_destroy(util_gatt_format_cache *cache)
+{
+	if (cache == NULL) return;
+
+	util_gatt_format_cache_info(cache);
+	SAFE_DELETE(cache->slots);
+	free(cache);
+}
+
+
+/**
+ * @function		util_gatt_format_cache_put
+ * @since_tizen		2.3
+ * @description		Util Gatt Format Cache Put
+ * @parameter		util_gatt_format_cache*: Util Gatt Format Cache Pointer, void*: Handle, const util_gatt_format*: Util Gatt Format Pointer
+ * @return		bool
+ */
+bool util_gatt_format_cache_put(util_gatt_format_cache *cache, void *handle, const util_gatt_format *fmt)
+{
+	RETVM_IF(NULL == cache, false, "cache is NULL");
+	RETVM_IF(NULL == handle, false, "handle is NULL");
+
+	if ((cache->count + 1) * 4 > (cache->slot_mask + 1) * 3 && !cache_grow(cache))
+	{
+		return false;
+	}
+
+	cache_slot *slot = cache_slot_of(cache, handle);
+	if (slot->handle == NULL)
+	{
+		slot->handle = handle;
+		cache->count++;
+	}
+	slot->has_format = (fmt != NULL);
+	if (fmt != NULL)
+	{
+		slot->fmt = *fmt;
+	}
+	return true;
+}
+
+
+/**
+ * @function		util_gatt_format_cache_has
+ * @since_tizen		2.3
+ * @description		Util Gatt Format Cache Has
+ * @parameter		util_gatt_format_cache*: Util Gatt Format Cache Pointer, void*: Handle
+ * @return		bool
+ */
+bool util_gatt_format_cache_has(util_gatt_format_cache *cache, void *handle)
+{
+	RETVM_IF(NULL == cache, false, "cache is NULL");
+
+	if (handle == NULL)
+	{
+		return false;
+	}
+
+	bool found = (cache_slot_of(cache, handle)->handle != NULL);
+	if (found)
+		cache->hits++;
+	else
+		cache->misses++;
+	return found;
+}
+
+
+/**
+ * @function		util_gatt_format_cache_get
+ * @since_tizen		2.3
+ * @description		Util Gatt Format Cache Get
+ * @parameter		util_gatt_format_cache*: Util Gatt Format Cache Pointer, void*: Handle
+ * @return		const util_gatt_format*
+ */
+const util_gatt_format* util_gatt_format_cache_get(util_gatt_format_cache *cache, void *handle)
+{
+	RETVM_IF(NULL == cache, NULL, "cache is NULL");
+
+	if (handle == NULL)
+	{
+		return NULL;
+	}
+
+	cache_slot *slot = cache_slot_of(cache, handle);
+	return (slot->handle != NULL && slot->has_format) ? &slot->fmt : NULL;
+}
+
+
+/**
+ * @function		util_gatt_format_cache_info
+ * @since_tizen		2.3
+ * @description		Util Gatt Format Cache Info
+ * @parameter		util_gatt_format_cache*: Util Gatt Format Cache Pointer
+ * @return		void
+ */
+void util_gatt_format_cache_info(util_gatt_format_cache *cache)
+{
+	RETM_IF(NULL == cache, "cache is NULL");
+
+	logi("characteristics=%d slots=%d lookups hit=%lu miss=%lu",
+			cache->count, cache->slot_mask + 1, cache->hits, cache->misses);
+}
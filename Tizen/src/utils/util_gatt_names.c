@@ -0,0 +1,459 @@
+/*******************************************************************************
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the License);
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *******************************************************************************/
+
+/**
+ *  @file util_gatt_names.c
+ *
+ *	@brief
+ *	Names of GATT services, characteristics and descriptors
+ *  Implementation of util_gatt_names
+ */
+#include "utils/util_gatt_names.h"
+
+#include <stdio.h>
+#include <string.h>
+
+
+// define custom logging for gatt names
+#define __LOG(prio, fmt, arg...) dlog_print(prio, "UTIL_GATT_NAMES", "%s (%d) > " fmt, __func__, __LINE__, ##arg)
+#define logd(fmt, arg...) __LOG(DLOG_DEBUG, fmt, ##arg)
+#define loge(fmt, arg...) __LOG(DLOG_ERROR, fmt, ##arg)
+#define logi(fmt, arg...) __LOG(DLOG_INFO, fmt, ##arg)
+
+
+// vendor table, kept at most 3/4 full
+#define VENDOR_SLOTS	64
+
+
+// 00000000-0000-1000-8000-00805F9B34FB, a 16 bit UUID goes into bytes 2 and 3
+static const uint8_t base_uuid[16] =
+{
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00,
+	0x80, 0x00, 0x00, 0x80, 0x5F, 0x9B, 0x34, 0xFB
+};
+
+
+// GATT Services, 0x18xx
+static const char *const names_18[256] =
+{
+	[0x00] = "Generic Access",
+	[0x01] = "Generic Attribute",
+	[0x02] = "Immediate Alert",
+	[0x03] = "Link Loss",
+	[0x04] = "Tx Power",
+	[0x05] = "Current Time Service",
+	[0x06] = "Reference Time Update Service",
+	[0x07] = "Next DST Change Service",
+	[0x08] = "Glucose",
+	[0x09] = "Health Thermometer",
+	[0x0A] = "Device Information",
+	[0x0D] = "Heart Rate",
+	[0x0E] = "Phone Alert Status Service",
+	[0x0F] = "Battery Service",
+	[0x10] = "Blood Pressure",
+	[0x11] = "Alert Notification Service",
+	[0x12] = "Human Interface Device",
+	[0x13] = "Scan Parameters",
+	[0x14] = "Running Speed and Cadence",
+	[0x16] = "Cycling Speed and Cadence",
+	[0x18] = "Cycling Power",
+	[0x19] = "Location and Navigation",
+};
+
+// GATT Declarations, 0x28xx
+static const char *const names_28[256] =
+{
+	[0x00] = "Primary Service Declaration",
+	[0x01] = "Secondary Service Declaration",
+	[0x02] = "Include Declaration",
+	[0x03] = "Characteristic Declaration",
+};
+
+// GATT Descriptors, 0x29xx
+static const char *const names_29[256] =
+{
+	[0x00] = "Characteristic Extended Properties",
+	[0x01] = "Characteristic User Description",
+	[0x02] = "Client Characteristic Configuration",
+	[0x03] = "Server Characteristic Configuration",
+	[0x04] = "Characteristic Presentation Format",
+	[0x05] = "Characteristic Aggregate Format",
+	[0x06] = "Valid Range",
+	[0x07] = "External Report Reference",
+	[0x08] = "Report Reference",
+};
+
+// GATT Characteristics, 0x2Axx
+static const char *const names_2a[256] =
+{
+	[0x00] = "Device Name",
+	[0x01] = "Appearance",
+	[0x02] = "Peripheral Privacy Flag",
+	[0x03] = "Reconnection Address",
+	[0x04] = "Peripheral Preferred Connection Parameters",
+	[0x05] = "Service Changed",
+	[0x06] = "Alert Level",
+	[0x07] = "Tx Power Level",
+	[0x08] = "Date Time",
+	[0x09] = "Day of Week",
+	[0x0A] = "Day Date Time",
+	[0x0C] = "Exact Time 256",
+	[0x0D] = "DST Offset",
+	[0x0E] = "Time Zone",
+	[0x0F] = "Local Time Information",
+	[0x11] = "Time with DST",
+	[0x12] = "Time Accuracy",
+	[0x13] = "Time Source",
+	[0x14] = "Reference Time Information",
+	[0x16] = "Time Update Control Point",
+	[0x17] = "Time Update State",
+	[0x18] = "Glucose Measurement",
+	[0x19] = "Battery Level",
+	[0x1C] = "Temperature Measurement",
+	[0x1D] = "Temperature Type",
+	[0x1E] = "Intermediate Temperature",
+	[0x21] = "Measurement Interval",
+	[0x22] = "Boot Keyboard Input Report",
+	[0x23] = "System ID",
+	[0x24] = "Model Number String",
+	[0x25] = "Serial Number String",
+	[0x26] = "Firmware Revision String",
+	[0x27] = "Hardware Revision String",
+	[0x28] = "Software Revision String",
+	[0x29] = "Manufacturer Name String",
+	[0x2A] = "IEEE 11073-20601 Regulatory Certification Data List",
+	[0x2B] = "Current Time",
+	[0x31] = "Scan Refresh",
+	[0x32] = "Boot Keyboard Output Report",
+	[0x33] = "Boot Mouse Input Report",
+	[0x34] = "Glucose Measurement Context",
+	[0x35] = "Blood Pressure Measurement",
+	[0x36] = "Intermediate Cuff Pressure",
+	[0x37] = "Heart Rate Measurement",
+	[0x38] = "Body Sensor Location",
+	[0x39] = "Heart Rate Control Point",
+	[0x3F] = "Alert Status",
+	[0x40] = "Ringer Control Point",
+	[0x41] = "Ringer Setting",
+	[0x42] = "Alert Category ID Bit Mask",
+	[0x43] = "Alert Category ID",
+	[0x44] = "Alert Notification Control Point",
+	[0x45] = "Unread Alert Status",
+	[0x46] = "New Alert",
+	[0x47] = "Supported New Alert Category",
+	[0x48] = "Supported Unread Alert Category",
+	[0x49] = "Blood Pressure Feature",
+	[0x4A] = "HID Information",
+	[0x4B] = "Report Map",
+	[0x4C] = "HID Control Point",
+	[0x4D] = "Report",
+	[0x4E] = "Protocol Mode",
+	[0x4F] = "Scan Interval Window",
+	[0x50] = "PnP ID",
+	[0x51] = "Glucose Feature",
+	[0x52] = "Record Access Control Point",
+	[0x53] = "RSC Measurement",
+	[0x54] = "RSC Feature",
+	[0x55] = "SC Control Point",
+	[0x5B] = "CSC Measurement",
+	[0x5C] = "CSC Feature",
+	[0x5D] = "Sensor Location",
+	[0x63] = "Cycling Power Measurement",
+	[0x64] = "Cycling Power Vector",
+	[0x65] = "Cycling Power Feature",
+	[0x66] = "Cycling Power Control Point",
+	[0x67] = "Location and Speed",
+	[0x68] = "Navigation",
+	[0x69] = "Position Quality",
+	[0x6A] = "LN Feature",
+	[0x6B] = "LN Control Point",
+};
+
+// by the high byte of the 16 bit UUID
+static const char *const *const names_pages[256] =
+{
+	[0x18] = names_18,
+	[0x28] = names_28,
+	[0x29] = names_29,
+	[0x2A] = names_2a,
+};
+
+
+// vendor UUIDs known out of the box
+static const struct
+{
+	const char *uuid;
+	const char *name;
+} vendor_names[] =
+{
+	{"6e400001-b5a3-f393-e0a9-e50e24dcca9e", "Nordic UART Service"},
+	{"6e400002-b5a3-f393-e0a9-e50e24dcca9e", "Nordic UART RX"},
+	{"6e400003-b5a3-f393-e0a9-e50e24dcca9e", "Nordic UART TX"},
+	{"7905f431-b5ce-4e99-a40f-4b1e122d00d0", "Apple Notification Center Service"},
+	{"9fbf120d-6301-42d9-8c58-25e699a21dbd", "ANCS Notification Source"},
+	{"69d1d8f3-45e1-49a8-9821-9bbdfdaad9d9", "ANCS Control Point"},
+	{"22eac6e9-24d6-4bb5-be44-b36ace7c7bfb", "ANCS Data Source"},
+};
+
+
+// define structures
+typedef struct
+{
+	uint8_t uuid[16];
+	const char *name;
+} vendor_entry;
+
+
+static vendor_entry vendor_table[VENDOR_SLOTS];
+static int vendor_count = 0;
+static bool vendor_loaded = false;
+
+
+/**
+ * @function		gatt_hex_value
+ * @since_tizen		2.3
+ * @description		Hex Digit Value
+ * @parameter		char: Char
+ * @return		static int
+ */
+static int gatt_hex_value(char c)
+{
+	if (c >= '0' && c <= '9') return c - '0';
+	if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+	if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+	return -1;
+}
+
+
+/**
+ * @function		gatt_parse_hex
+ * @since_tizen		2.3
+ * @description		Parses count Hex Digit Pairs Into Bytes
+ * @parameter		const char*: Const char Pointer, uint8_t*: Uint8 T Pointer, int: Int
+ * @return		static bool
+ */
+static bool gatt_parse_hex(const char *hex, uint8_t *bytes, int count)
+{
+	int i;
+
+	for (i = 0; i < count; i++)
+	{
+		int hi = gatt_hex_value(hex[2 * i]);
+		int lo = gatt_hex_value(hex[2 * i + 1]);
+		if (hi < 0 || lo < 0)
+		{
+			return false;
+		}
+		bytes[i] = (uint8_t) ((hi << 4) | lo);
+	}
+	return true;
+}
+
+
+/**
+ * @function		gatt_vendor_slot
+ * @since_tizen		2.3
+ * @description		Finds The Slot Holding uuid, Or The Empty Slot Where It Would Go
+ * @parameter		const uint8_t*: Const uint8 T Pointer
+ * @return		static int
+ */
+static int gatt_vendor_slot(const uint8_t uuid[16])
+{
+	uint64_t hash = 1469598103934665603ULL;
+	int i;
+
+	// vendor UUIDs are random already, FNV-1a over the bytes is plenty
+	for (i = 0; i < 16; i++)
+	{
+		hash ^= uuid[i];
+		hash *= 1099511628211ULL;
+	}
+
+	int slot = (int) (hash & (VENDOR_SLOTS - 1));
+	while (vendor_table[slot].name != NULL && memcmp(vendor_table[slot].uuid, uuid, 16) != 0)
+	{
+		slot = (slot + 1) & (VENDOR_SLOTS - 1);
+	}
+	return slot;
+}
+
+
+/**
+ * @function		gatt_vendor_load
+ * @since_tizen		2.3
+ * @description		Fills The Vendor Table On First Use
+ * @parameter		NA
+ * @return		static void
+ */
+static void gatt_vendor_load()
+{
+	unsigned i;
+
+	if (vendor_loaded)
+	{
+		return;
+	}
+	vendor_loaded = true;
+
+	for (i = 0; i < sizeof(vendor_names) / sizeof(vendor_names[0]); i++)
+	{
+		util_gatt_names_register(vendor_names[i].uuid, vendor_names[i].name);
+	}
+}
+
+
+/**
+ * @function		util_gatt_uuid_parse
+ * @since_tizen		2.3
+ * @description		Util Gatt Uuid Parse
+ * @parameter		const char*: Const char Pointer, uint8_t*: Uint8 T Pointer
+ * @return		bool
+ */
+bool util_gatt_uuid_parse(const char *uuid, uint8_t bytes[16])
+{
+	RETVM_IF(NULL == uuid, false, "uuid is NULL");
+	RETVM_IF(NULL == bytes, false, "bytes is NULL");
+
+	size_t len = strlen(uuid);
+
+	switch (len)
+	{
+	case 4:
+		memcpy(bytes, base_uuid, 16);
+		return gatt_parse_hex(uuid, bytes + 2, 2);
+	case 8:
+		memcpy(bytes, base_uuid, 16);
+		return gatt_parse_hex(uuid, bytes, 4);
+	case 36:
+		if (uuid[8] != '-' || uuid[13] != '-' || uuid[18] != '-' || uuid[23] != '-')
+		{
+			return false;
+		}
+		return gatt_parse_hex(uuid, bytes, 4)
+			&& gatt_parse_hex(uuid + 9, bytes + 4, 2)
+			&& gatt_parse_hex(uuid + 14, bytes + 6, 2)
+			&& gatt_parse_hex(uuid + 19, bytes + 8, 2)
+			&& gatt_parse_hex(uuid + 24, bytes + 10, 6);
+	default:
+		return false;
+	}
+}
+
+
+/**
+ * @function		util_gatt_short_uuid
+ * @since_tizen		2.3
+ * @description		Util Gatt Short Uuid
+ * @parameter		const char*: Const char Pointer
+ * @return		int
+ */
+int util_gatt_short_uuid(const char *uuid)
+{
+	uint8_t bytes[16];
+
+	if (!util_gatt_uuid_parse(uuid, bytes))
+	{
+		return -1;
+	}
+
+	// one 12 byte compare against the tail of the Base UUID, the compiler turns it into a couple of word compares
+	if (bytes[0] != 0 || bytes[1] != 0 || memcmp(bytes + 4, base_uuid + 4, 12) != 0)
+	{
+		return -1;
+	}
+	return (bytes[2] << 8) | bytes[3];
+}
+
+
+/**
+ * @function		util_gatt_name
+ * @since_tizen		2.3
+ * @description		Util Gatt Name
+ * @parameter		const char*: Const char Pointer
+ * @return		const char*
+ */
+const char* util_gatt_name(const char *uuid)
+{
+	uint8_t bytes[16];
+
+	if (!util_gatt_uuid_parse(uuid, bytes))
+	{
+		return NULL;
+	}
+
+	if (bytes[0] == 0 && bytes[1] == 0 && memcmp(bytes + 4, base_uuid + 4, 12) == 0)
+	{
+		const char *const *page = names_pages[bytes[2]];
+		return (page != NULL) ? page[bytes[3]] : NULL;
+	}
+
+	gatt_vendor_load();
+	return vendor_table[gatt_vendor_slot(bytes)].name;
+}
+
+
+/**
+ * @function		util_gatt_describe
+ * @since_tizen		2.3
+ * @description		Util Gatt Describe
+ * @parameter		const char*: Const char Pointer, char*: Char Pointer, int: Int
+ * @return		void
+ */
+void util_gatt_describe(const char *uuid, char *buf, int size)
+{
+	RETM_IF(NULL == buf || size <= 0, "no buffer");
+
+	const char *name = util_gatt_name(uuid);
+	int short_uuid = util_gatt_short_uuid(uuid);
+
+	if (short_uuid >= 0)
+	{
+		if (name != NULL) snprintf(buf, size, "%04X %s", short_uuid, name);
+		else snprintf(buf, size, "%04X", short_uuid);
+	}
+	else
+	{
+		snprintf(buf, size, "%s", name != NULL ? name : (uuid != NULL ? uuid : "Unknown"));
+	}
+}
+
+
+/**
+ * @function		util_gatt_names_register
+ * @since_tizen		2.3
+ * @description		Util Gatt Names Register
+ * @parameter		const char*: Const char Pointer, const char*: Const char Pointer
+ * @return		bool
+ */
+bool util_gatt_names_register(const char *uuid, const char *name)
+{
+	RETVM_IF(NULL == name, false, "name is NULL");
+
+	uint8_t bytes[16];
+	RETVM_IF(!util_gatt_uuid_parse(uuid, bytes), false, "malformed uuid %s", uuid ? uuid : "(null)");
+
+	gatt_vendor_load();
+
+	int slot = gatt_vendor_slot(bytes);
+	if (vendor_table[slot].name == NULL)
+	{
+		RETVM_IF(vendor_count >= VENDOR_SLOTS * 3 / 4, false, "vendor table full, %s not registered", uuid);
+		memcpy(vendor_table[slot].uuid, bytes, 16);
+		vendor_count++;
+	}
+	vendor_table[slot].name = name;
+	return true;
+}
@@ -0,0 +1,264 @@
+/*******************************************************************************
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the License);
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *******************************************************************************/
+
+/**
+ *  @file util_gatt_transfer.c
+ *
+ *	@brief
+ *	Timing of GATT reads and writes per ATT MTU
+ *  Implementation of util_gatt_transfer
+ */
+#include "utils/util_gatt_transfer.h"
+#include "utils/util_clock.h"
+
+#include <string.h>
+
+
+// define custom logging for gatt transfers
+#define __LOG(prio, fmt, arg...) dlog_print(prio, "UTIL_GATT_TRANSFER", "%s (%d) > " fmt, __func__, __LINE__, ##arg)
+#define logd(fmt, arg...) __LOG(DLOG_DEBUG, fmt, ##arg)
+#define loge(fmt, arg...) __LOG(DLOG_ERROR, fmt, ##arg)
+#define logi(fmt, arg...) __LOG(DLOG_INFO, fmt, ##arg)
+
+
+// define structures
+typedef struct
+{
+	void *handle;			// NULL when nothing is timed
+	unsigned long long start_us;
+} transfer_timer;
+
+
+struct _util_gatt_transfer
+{
+	int mtu;
+	transfer_timer timers[UTIL_GATT_TRANSFER_OPS];
+	util_gatt_transfer_stats stats[UTIL_GATT_TRANSFER_OPS];
+};
+
+
+static const char *const op_names[UTIL_GATT_TRANSFER_OPS] = { "read", "write" };
+
+
+/**
+ * @function		util_gatt_transfer_create
+ * @since_tizen		2.3
+ * @description		Util Gatt Transfer Create
+ * @parameter		int: MTU
+ * @return		util_gatt_transfer*
+ */
+util_gatt_transfer* util_gatt_transfer_create(int mtu)
+{
+	RETVM_IF(mtu < UTIL_GATT_DEFAULT_MTU, NULL, "invalid mtu %d", mtu);
+
+	util_gatt_transfer *transfers = calloc(1, sizeof(util_gatt_transfer));
+	RETVM_IF(!transfers, NULL, "calloc failed");
+
+	transfers->mtu = mtu;
+	return transfers;
+}
+
+
+/**
+ * @function		util_gatt_transfer_destroy
+ * @since_tizen		2.3
+ * @description		Util Gatt Transfer Destroy
+ * @parameter		util_gatt_transfer*: Util Gatt Transfer Pointer
+ * @return		void
+ */
+void util_gatt_transfer_destroy(util_gatt_transfer *transfers)
+{
+	if (transfers == NULL) return;
+
+	util_gatt_transfer_info(transfers);
+	free(transfers);
+}
+
+
+/**
+ * @function		util_gatt_transfer_set_mtu
+ * @since_tizen		2.3
+ * @description		Util Gatt Transfer Set MTU
+ * @parameter		util_gatt_transfer*: Util Gatt Transfer Pointer, int: MTU
+ * @return		void
+ */
+void util_gatt_transfer_set_mtu(util_gatt_transfer *transfers, int mtu)
+{
+	RETM_IF(NULL == transfers, "transfers is NULL");
+	RETM_IF(mtu < UTIL_GATT_DEFAULT_MTU, "invalid mtu %d", mtu);
+
+	if (mtu == transfers->mtu)
+	{
+		return;
+	}
+
+	util_gatt_transfer_info(transfers);
+	logi("mtu %d -> %d", transfers->mtu, mtu);
+
+	//A transfer in flight keeps its timer, it is counted at the new MTU
+	transfers->mtu = mtu;
+	memset(transfers->stats, 0, sizeof(transfers->stats));
+}
+
+
+/**
+ * @function		util_gatt_transfer_get_mtu
+ * @since_tizen		2.3
+ * @description		Util Gatt Transfer Get MTU
+ * @parameter		util_gatt_transfer*: Util Gatt Transfer Pointer
+ * @return		int
+ */
+int util_gatt_transfer_get_mtu(util_gatt_transfer *transfers)
+{
+	RETVM_IF(NULL == transfers, UTIL_GATT_DEFAULT_MTU, "transfers is NULL");
+
+	return transfers->mtu;
+}
+
+
+/**
+ * @function		util_gatt_transfer_round_trips
+ * @since_tizen		2.3
+ * @description		Util Gatt Transfer Round Trips
+ * @parameter		util_gatt_transfer_op: Operation, int: Length, int: MTU
+ * @return		int
+ */
+int util_gatt_transfer_round_trips(util_gatt_transfer_op op, int len, int mtu)
+{
+	RETVM_IF(mtu < UTIL_GATT_DEFAULT_MTU, 0, "invalid mtu %d", mtu);
+
+	if (op == UTIL_GATT_TRANSFER_READ)
+	{
+		//Read Response and each Read Blob Response carry mtu - 1 bytes, a full last one needs one more to see the end
+		return len / (mtu - 1) + 1;
+	}
+
+	if (len <= mtu - 3)
+	{
+		return 1;
+	}
+	//Prepare Write carries handle and offset besides the opcode, then one Execute Write
+	return (len + mtu - 6) / (mtu - 5) + 1;
+}
+
+
+/**
+ * @function		util_gatt_transfer_begin
+ * @since_tizen		2.3
+ * @description		Util Gatt Transfer Begin
+ * @parameter		util_gatt_transfer*: Util Gatt Transfer Pointer, util_gatt_transfer_op: Operation, void*: Handle
+ * @return		void
+ */
+void util_gatt_transfer_begin(util_gatt_transfer *transfers, util_gatt_transfer_op op, void *handle)
+{
+	RETM_IF(NULL == transfers, "transfers is NULL");
+	RETM_IF(op < 0 || op >= UTIL_GATT_TRANSFER_OPS, "invalid op %d", op);
+	RETM_IF(NULL == handle, "handle is NULL");
+
+	transfer_timer *timer = &transfers->timers[op];
+	if (timer->handle != NULL)
+	{
+		logd("%s of %p never completed", op_names[op], timer->handle);
+	}
+	timer->handle = handle;
+	timer->start_us = util_clock_now_us();
+}
+
+
+/**
+ * @function		util_gatt_transfer_end
+ * @since_tizen		2.3
+ * @description		Util Gatt Transfer End
+ * @parameter		util_gatt_transfer*: Util Gatt Transfer Pointer, util_gatt_transfer_op: Operation, void*: Handle, int: Result, int: Length
+ * @return		double
+ */
+double util_gatt_transfer_end(util_gatt_transfer *transfers, util_gatt_transfer_op op, void *handle, int result, int len)
+{
+	RETVM_IF(NULL == transfers, -1, "transfers is NULL");
+	RETVM_IF(op < 0 || op >= UTIL_GATT_TRANSFER_OPS, -1, "invalid op %d", op);
+
+	transfer_timer *timer = &transfers->timers[op];
+	if (handle == NULL || timer->handle != handle)
+	{
+		return -1;
+	}
+	timer->handle = NULL;
+
+	util_gatt_transfer_stats *s = &transfers->stats[op];
+	unsigned long long us = util_clock_now_us() - timer->start_us;
+
+	s->transfers++;
+	if (result != 0)
+	{
+		s->failed++;
+		return us / 1000.0;
+	}
+
+	s->bytes += len;
+	s->us += us;
+	s->round_trips += util_gatt_transfer_round_trips(op, len, transfers->mtu);
+	if (us > s->max_us)
+	{
+		s->max_us = us;
+	}
+	if (len > s->max_len)
+	{
+		s->max_len = len;
+	}
+	return us / 1000.0;
+}
+
+
+/**
+ * @function		util_gatt_transfer_get_stats
+ * @since_tizen		2.3
+ * @description		Util Gatt Transfer Get Stats
+ * @parameter		util_gatt_transfer*: Util Gatt Transfer Pointer, util_gatt_transfer_op: Operation, util_gatt_transfer_stats*: Util Gatt Transfer Stats Pointer
+ * @return		void
+ */
+void util_gatt_transfer_get_stats(util_gatt_transfer *transfers, util_gatt_transfer_op op, util_gatt_transfer_stats *stats)
+{
+	RETM_IF(NULL == transfers, "transfers is NULL");
+	RETM_IF(op < 0 || op >= UTIL_GATT_TRANSFER_OPS, "invalid op %d", op);
+	RETM_IF(NULL == stats, "stats is NULL");
+
+	*stats = transfers->stats[op];
+}
+
+
+/**
+ * @function		util_gatt_transfer_info
+ * @since_tizen		2.3
+ * @description		Util Gatt Transfer Info
+ * @parameter		util_gatt_transfer*: Util Gatt Transfer Pointer
+ * @return		void
+ */
+void util_gatt_transfer_info(util_gatt_transfer *transfers)
+{
+	RETM_IF(NULL == transfers, "transfers is NULL");
+
+	int op;
+	for (op = 0; op < UTIL_GATT_TRANSFER_OPS; op++)
+	{
+		util_gatt_transfer_stats *s = &transfers->stats[op];
+		unsigned long done = s->transfers - s->failed;
+
+		logi("mtu=%d %s: %lu done %lu failed, %llu bytes in %lu round trips, avg %.1f ms max %.1f ms, %.0f B/s, longest %d bytes",
+				transfers->mtu, op_names[op], done, s->failed, s->bytes, s->round_trips,
+				done ? s->us / 1000.0 / done : 0.0, s->max_us / 1000.0,
+				s->us ? s->bytes * 1000000.0 / s->us : 0.0, s->max_len);
+	}
+}
@@ -0,0 +1,332 @@
+/*******************************************************************************
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the License);
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *******************************************************************************/
+
+/**
+ *  @file util_notify_ring.c
+ *
+ *	@brief
+ *	Bounded store of GATT notifications
+ *  Implementation of util_notify_ring
+ */
+#include "utils/util_notify_ring.h"
+#include "utils/util_clock.h"
+
+#include <string.h>
+
+
+// define custom logging for the notification ring
+#define __LOG(prio, fmt, arg...) dlog_print(prio, "UTIL_NOTIFY_RING", "%s (%d) > " fmt, __func__, __LINE__, ##arg)
+#define logd(fmt, arg...) __LOG(DLOG_DEBUG, fmt, ##arg)
+#define loge(fmt, arg...) __LOG(DLOG_ERROR, fmt, ##arg)
+#define logi(fmt, arg...) __LOG(DLOG_INFO, fmt, ##arg)
+
+
+#define RING_RATE_WINDOW_US	1000000ULL
+// interval and jitter are smoothed with a gain of 1/16, as RTP does for jitter
+#define RING_SMOOTHING		16.0
+
+
+// define structures
+struct _util_notify_ring
+{
+	util_notify_entry *entries;
+	uint8_t *payloads;		// capacity slots of max_payload bytes, entries point into it
+	int capacity;
+	int max_payload;
+	int head;			// next slot to write
+	int count;
+
+	unsigned long long last_us;
+	unsigned long long last_interval_us;
+	unsigned long long window_start_us;
+	unsigned long window_notifications;
+	unsigned long long window_bytes;
+
+	util_notify_stats stats;
+};
+
+
+/**
+ * @function		ring_update_rates
+ * @since_tizen		2.3
+ * @description		Closes The Rate Window Once It Is Over
+ * @parameter		util_notify_ring*: Util Notify Ring Pointer, unsigned long long: Current Time
+ * @return		static void
+ */
+static void ring_update_rates(util_notify_ring *ring, unsigned long long now)
+{
+	unsigned long long elapsed = now - ring->window_start_us;
+	if (elapsed < RING_RATE_WINDOW_US)
+	{
+		return;
+	}
+
+	ring->stats.per_second = ring->window_notifications * 1000000.0 / elapsed;
+	ring->stats.bytes_per_second = ring->window_bytes * 1000000.0 / elapsed;
+	ring->window_start_us = now;
+	ring->window_notifications = 0;
+	ring->window_bytes = 0;
+}
+
+
+/**
+ * @function		ring_update_interval
+ * @since_tizen		2.3
+ * @description		Folds The Time Since The Previous Notification Into Interval And Jitter
+ * @parameter		util_notify_ring*: Util Notify Ring Pointer, unsigned long long: Current Time
+ * @return		static void
+ */
+static void ring_update_interval(util_notify_ring *ring, unsigned long long now)
+{
+	util_notify_stats *s = &ring->stats;
+
+	if (ring->last_us != 0)
+	{
+		unsigned long long interval = now - ring->last_us;
+
+		if (interval > s->max_interval_us)
+		{
+			s->max_interval_us = interval;
+		}
+
+		if (ring->last_interval_us == 0)
+		{
+			s->interval_us = interval;
+		}
+		else
+		{
+			double d = (double) interval - (double) ring->last_interval_us;
+			if (d < 0) d = -d;
+			s->interval_us += (interval - s->interval_us) / RING_SMOOTHING;
+			s->jitter_us += (d - s->jitter_us) / RING_SMOOTHING;
+		}
+		ring->last_interval_us = interval;
+	}
+	ring->last_us = now;
+}
+
+
+/**
+ * @function		util_notify_ring_create
+ * @since_tizen		2.3
+ * @description		Util Notify Ring Create
+ * @parameter		int: Capacity, int: Max Payload
+ * @return		util_notify_ring*
+ */
+util_notify_ring* util_notify_ring_create(int capacity, int max_payload)
+{
+	RETVM_IF(capacity <= 0, NULL, "invalid capacity %d", capacity);
+	RETVM_IF(max_payload <= 0, NULL, "invalid max_payload %d", max_payload);
+
+	util_notify_ring *ring = calloc(1, sizeof(util_notify_ring));
+	RETVM_IF(!ring, NULL, "calloc failed");
+
+	ring->entries = calloc(capacity, sizeof(util_notify_entry));
+	ring->payloads = malloc((size_t) capacity * max_payload);
+	if (ring->entries == NULL || ring->payloads == NULL)
+	{
+		loge("alloc failed for %d x %d bytes", capacity, max_payload);
+		util_notify_ring_destroy(ring);
+		return NULL;
+	}
+
+	int i;
+	for (i = 0; i < capacity; i++)
+	{
+		ring->entries[i].data = ring->payloads + (size_t) i * max_payload;
+	}
+	ring->capacity = capacity;
+	ring->max_payload = max_payload;
+
+	return ring;
+}
+
+
+/**
+ * @function		util_notify_ring_destroy
+ * @since_tizen		2.3
+ * @description		Util Notify Ring Destroy
+ * @parameter		util_notify_ring*: Util Notify Ring Pointer
+ * @return		void
+ */
+void util_notify_ring_destroy(util_notify_ring *ring)
+{
+	if (ring == NULL) return;
+
+	if (ring->entries != NULL && ring->payloads != NULL)
+	{
+		util_notify_ring_info(ring);
+	}
+	SAFE_DELETE(ring->entries);
+	SAFE_DELETE(ring->payloads);
+	free(ring);
+}
+
+
+/**
+ * @function		util_notify_ring_push
+ * @since_tizen		2.3
+ * @description		Util Notify Ring Push
+ * @parameter		util_notify_ring*: Util Notify Ring Pointer, const void*: Payload, int: Length
+ * @return		void
+ */
+void util_notify_ring_push(util_notify_ring *ring, const void *data, int len)
+{
+	RETM_IF(NULL == ring, "ring is NULL");
+	RETM_IF(len < 0 || (len > 0 && NULL == data), "invalid payload");
+
+	unsigned long long now = util_clock_now_us();
+	util_notify_stats *s = &ring->stats;
+
+	if (ring->window_start_us == 0)
+	{
+		ring->window_start_us = now;
+	}
+	ring_update_rates(ring, now);
+	ring_update_interval(ring, now);
+
+	util_notify_entry *e = &ring->entries[ring->head];
+	int kept = len < ring->max_payload ? len : ring->max_payload;
+
+	if (ring->count == ring->capacity)
+	{
+		s->overwritten++;
+	}
+	else
+	{
+		ring->count++;
+	}
+	if (kept < len)
+	{
+		s->truncated++;
+	}
+
+	e->time_us = now;
+	e->len = kept;
+	e->received_len = len;
+	if (kept > 0)
+	{
+		memcpy((uint8_t*) e->data, data, kept);
+	}
+	ring->head = (ring->head + 1) % ring->capacity;
+
+	s->notifications++;
+	s->bytes += len;
+	ring->window_notifications++;
+	ring->window_bytes += len;
+}
+
+
+/**
+ * @function		util_notify_ring_clear
+ * @since_tizen		2.3
+ * @description		Util Notify Ring Clear
+ * @parameter		util_notify_ring*: Util Notify Ring Pointer
+ * @return		void
+ */
+void util_notify_ring_clear(util_notify_ring *ring)
+{
+	RETM_IF(NULL == ring, "ring is NULL");
+
+	ring->head = 0;
+	ring->count = 0;
+	ring->last_us = 0;
+	ring->last_interval_us = 0;
+	ring->window_start_us = 0;
+	ring->window_notifications = 0;
+	ring->window_bytes = 0;
+	memset(&ring->stats, 0, sizeof(ring->stats));
+}
+
+
+/**
+ * @function		util_notify_ring_count
+ * @since_tizen		2.3
+ * @description		Util Notify Ring Count
+ * @parameter		util_notify_ring*: Util Notify Ring Pointer
+ * @return		int
+ */
+int util_notify_ring_count(util_notify_ring *ring)
+{
+	RETVM_IF(NULL == ring, 0, "ring is NULL");
+
+	return ring->count;
+}
+
+
+/**
+ * @function		util_notify_ring_latest
+ * @since_tizen		2.3
+ * @description		Util Notify Ring Latest
+ * @parameter		util_notify_ring*: Util Notify Ring Pointer, int: Age
+ * @return		const util_notify_entry*
+ */
+const util_notify_entry* util_notify_ring_latest(util_notify_ring *ring, int age)
+{
+	RETVM_IF(NULL == ring, NULL, "ring is NULL");
+
+	if (age < 0 || age >= ring->count)
+	{
+		return NULL;
+	}
+
+	int slot = ring->head - 1 - age;
+	if (slot < 0)
+	{
+		slot += ring->capacity;
+	}
+	return &ring->entries[slot];
+}
+
+
+/**
+ * @function		util_notify_ring_get_stats
+ * @since_tizen		2.3
+ * @description		Util Notify Ring Get Stats
+ * @parameter		util_notify_ring*: Util Notify Ring Pointer, util_notify_stats*: Util Notify Stats Pointer
+ * @return		void
+ */
+void util_notify_ring_get_stats(util_notify_ring *ring, util_notify_stats *stats)
+{
+	RETM_IF(NULL == ring, "ring is NULL");
+	RETM_IF(NULL == stats, "stats is NULL");
+
+	//Notifications stopped, the rates must fall to zero rather than keep the last window
+	if (ring->window_start_us != 0)
+	{
+		ring_update_rates(ring, util_clock_now_us());
+	}
+	*stats = ring->stats;
+}
+
+
+/**
+ * @function		util_notify_ring_info
+ * @since_tizen		2.3
+ * @description		Util Notify Ring Info
+ * @parameter		util_notify_ring*: Util Notify Ring Pointer
+ * @return		void
+ */
+void util_notify_ring_info(util_notify_ring *ring)
+{
+	RETM_IF(NULL == ring, "ring is NULL");
+
+	util_notify_stats *s = &ring->stats;
+
+	logi("held=%d/%d notifications=%lu bytes=%llu overwritten=%lu truncated=%lu rate=%.1f/s %.0fB/s interval=%.0fus jitter=%.0fus max=%lluus",
+			ring->count, ring->capacity, s->notifications, s->bytes, s->overwritten, s->truncated,
+			s->per_second, s->bytes_per_second, s->interval_us, s->jitter_us, s->max_interval_us);
+}
@@ -0,0 +1,305 @@
+/*******************************************************************************
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the License);
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *******************************************************************************/
+
+/**
+ *  @file util_pacer.c
+ *
+ *	@brief
+ *	Send pacing at a fixed rate
+ *  Implementation of util_pacer
+ */
+#include "utils/util_pacer.h"
+#include "utils/util_clock.h"
+
+#include <string.h>
+
+
+// define custom logging for the pacer
+#define __LOG(prio, fmt, arg...) dlog_print(prio, "UTIL_PACER", "%s (%d) > " fmt, __func__, __LINE__, ##arg)
+#define logd(fmt, arg...) __LOG(DLOG_DEBUG, fmt, ##arg)
+#define loge(fmt, arg...) __LOG(DLOG_ERROR, fmt, ##arg)
+#define logi(fmt, arg...) __LOG(DLOG_INFO, fmt, ##arg)
+
+
+#define PACER_RATE_WINDOW_US	1000000ULL
+
+
+// define structures
+struct _util_pacer
+{
+	double rate;
+	int burst;
+	int max_outstanding;
+
+	double tokens;
+	unsigned long long last_us;
+	bool held_back;			// the last tick had more due than room
+
+	int *sizes;			// bytes of the unconfirmed sends, oldest first from head
+	int head;
+
+	unsigned long long window_start_us;
+	unsigned long window_completed;
+	unsigned long long window_bytes;
+
+	util_pacer_stats stats;
+};
+
+
+/**
+ * @function		pacer_update_rates
+ * @since_tizen		2.3
+ * @description		Closes The Rate Window Once It Is Over
+ * @parameter		util_pacer*: Util Pacer Pointer, unsigned long long: Current Time
+ * @return		static void
+ */
+static void pacer_update_rates(util_pacer *pacer, unsigned long long now)
+{
+	unsigned long long elapsed = now - pacer->window_start_us;
+	if (elapsed < PACER_RATE_WINDOW_US)
+	{
+		return;
+	}
+
+	pacer->stats.per_second = pacer->window_completed * 1000000.0 / elapsed;
+	pacer->stats.bytes_per_second = pacer->window_bytes * 1000000.0 / elapsed;
+	pacer->window_start_us = now;
+	pacer->window_completed = 0;
+	pacer->window_bytes = 0;
+}
+
+
+/**
+ * @function		util_pacer_create
+ * @since_tizen		2.3
+ * @description		Util Pacer Create
+ * @parameter		double: Rate, int: Burst, int: Max Outstanding
+ * @return		util_pacer*
+ */
+util_pacer* util_pacer_create(double rate, int burst, int max_outstanding)
+{
+	RETVM_IF(rate <= 0, NULL, "invalid rate %f", rate);
+	RETVM_IF(burst <= 0, NULL, "invalid burst %d", burst);
+	RETVM_IF(max_outstanding <= 0, NULL, "invalid max_outstanding %d", max_outstanding);
+
+	util_pacer *pacer = calloc(1, sizeof(util_pacer));
+	RETVM_IF(!pacer, NULL, "calloc failed");
+
+	pacer->sizes = calloc(max_outstanding, sizeof(int));
+	if (pacer->sizes == NULL)
+	{
+		loge("calloc failed");
+		free(pacer);
+		return NULL;
+	}
+
+	pacer->rate = rate;
+	pacer->burst = burst;
+	pacer->max_outstanding = max_outstanding;
+	util_pacer_reset(pacer);
+
+	return pacer;
+}
+
+
+/**
+ * @function		util_pacer_destroy
+ * @since_tizen		2.3
+ * @description		Util Pacer Destroy
+ * @parameter		util_pacer*: Util Pacer Pointer
+ * @return		void
+ */
+void util_pacer_destroy(util_pacer *pacer)
+{
+	if (pacer == NULL) return;
+
+	util_pacer_info(pacer);
+	SAFE_DELETE(pacer->sizes);
+	free(pacer);
+}
+
+
+/**
+ * @function		util_pacer_reset
+ * @since_tizen		2.3
+ * @description		Util Pacer Reset
+ * @parameter		util_pacer*: Util Pacer Pointer
+ * @return		void
+ */
+void util_pacer_reset(util_pacer *pacer)
+{
+	RETM_IF(NULL == pacer, "pacer is NULL");
+
+	//Their completions are still to come, so head and the sizes stay as they are
+	int outstanding = pacer->stats.outstanding;
+
+	pacer->tokens = 0;
+	pacer->last_us = util_clock_now_us();
+	pacer->held_back = false;
+	pacer->window_start_us = pacer->last_us;
+	pacer->window_completed = 0;
+	pacer->window_bytes = 0;
+	memset(&pacer->stats, 0, sizeof(pacer->stats));
+	pacer->stats.outstanding = outstanding;
+	pacer->stats.max_outstanding = outstanding;
+}
+
+
+/**
+ * @function		util_pacer_due
+ * @since_tizen		2.3
+ * @description		Util Pacer Due
+ * @parameter		util_pacer*: Util Pacer Pointer
+ * @return		int
+ */
+int util_pacer_due(util_pacer *pacer)
+{
+	RETVM_IF(NULL == pacer, 0, "pacer is NULL");
+
+	unsigned long long now = util_clock_now_us();
+
+	pacer->tokens += (now - pacer->last_us) * pacer->rate / 1000000.0;
+	if (pacer->tokens > pacer->burst)
+	{
+		pacer->tokens = pacer->burst;
+	}
+	//The same tokens wait tick after tick, so the wait is timed rather than counted
+	if (pacer->held_back)
+	{
+		pacer->stats.held_back_us += now - pacer->last_us;
+	}
+	pacer->last_us = now;
+	pacer_update_rates(pacer, now);
+
+	int due = (int) pacer->tokens;
+	int room = pacer->max_outstanding - pacer->stats.outstanding;
+	pacer->held_back = (due > room);
+	if (pacer->held_back)
+	{
+		due = room;
+	}
+	return due;
+}
+
+
+/**
+ * @function		util_pacer_sent
+ * @since_tizen		2.3
+ * @description		Util Pacer Sent
+ * @parameter		util_pacer*: Util Pacer Pointer, int: Bytes
+ * @return		void
+ */
+void util_pacer_sent(util_pacer *pacer, int bytes)
+{
+	RETM_IF(NULL == pacer, "pacer is NULL");
+	RETM_IF(pacer->stats.outstanding == pacer->max_outstanding, "more sends than were due");
+
+	util_pacer_stats *s = &pacer->stats;
+	int tail = (pacer->head + s->outstanding) % pacer->max_outstanding;
+
+	pacer->sizes[tail] = bytes;
+	pacer->tokens -= 1;
+	s->sent++;
+	s->outstanding++;
+	if (s->outstanding > s->max_outstanding)
+	{
+		s->max_outstanding = s->outstanding;
+	}
+}
+
+
+/**
+ * @function		util_pacer_failed
+ * @since_tizen		2.3
+ * @description		Util Pacer Failed
+ * @parameter		util_pacer*: Util Pacer Pointer
+ * @return		void
+ */
+void util_pacer_failed(util_pacer *pacer)
+{
+	RETM_IF(NULL == pacer, "pacer is NULL");
+
+	//The slot is used up all the same, a refusing stack is not retried faster than the rate
+	pacer->tokens -= 1;
+	pacer->stats.failed++;
+}
+
+
+/**
+ * @function		util_pacer_completed
+ * @since_tizen		2.3
+ * @description		Util Pacer Completed
+ * @parameter		util_pacer*: Util Pacer Pointer, bool: Ok
+ * @return		void
+ */
+void util_pacer_completed(util_pacer *pacer, bool ok)
+{
+	RETM_IF(NULL == pacer, "pacer is NULL");
+
+	util_pacer_stats *s = &pacer->stats;
+	RETM_IF(s->outstanding == 0, "nothing outstanding");
+
+	int bytes = pacer->sizes[pacer->head];
+	pacer->head = (pacer->head + 1) % pacer->max_outstanding;
+	s->outstanding--;
+
+	if (!ok)
+	{
+		s->failed++;
+		return;
+	}
+
+	s->completed++;
+	s->bytes += bytes;
+	pacer->window_completed++;
+	pacer->window_bytes += bytes;
+}
+
+
+/**
+ * @function		util_pacer_get_stats
+ * @since_tizen		2.3
+ * @description		Util Pacer Get Stats
+ * @parameter		util_pacer*: Util Pacer Pointer, util_pacer_stats*: Util Pacer Stats Pointer
+ * @return		void
+ */
+void util_pacer_get_stats(util_pacer *pacer, util_pacer_stats *stats)
+{
+	RETM_IF(NULL == pacer, "pacer is NULL");
+	RETM_IF(NULL == stats, "stats is NULL");
+
+	pacer_update_rates(pacer, util_clock_now_us());
+	*stats = pacer->stats;
+}
+
+
+/**
+ * @function		util_pacer_info
+ * @since_tizen		2.3
+ * @description		Util Pacer Info
+ * @parameter		util_pacer*: Util Pacer Pointer
+ * @return		void
+ */
+void util_pacer_info(util_pacer *pacer)
+{
+	RETM_IF(NULL == pacer, "pacer is NULL");
+
+	util_pacer_stats *s = &pacer->stats;
+
+	logi("rate=%.1f/s sent=%lu completed=%lu failed=%lu bytes=%llu outstanding=%d max=%d/%d held back=%.1fms achieved=%.1f/s %.0fB/s",
+			pacer->rate, s->sent, s->completed, s->failed, s->bytes, s->outstanding, s->max_outstanding,
+			pacer->max_outstanding, s->held_back_us / 1000.0, s->per_second, s->bytes_per_second);
+}
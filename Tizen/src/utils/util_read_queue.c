@@ -0,0 +1,375 @@
+/*******************************************************************************
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the License);
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *******************************************************************************/
+
+/**
+ *  @file util_read_queue.c
+ *
+ *	@brief
+ *	Bulk reads with a bounded number in flight
+ *  Implementation of util_read_queue
+ */
+#include "utils/util_read_queue.h"
+#include "utils/util_clock.h"
+
+#include <string.h>
+
+
+// define custom logging for the read queue
+#define __LOG(prio, fmt, arg...) dlog_print(prio, "UTIL_READ_QUEUE", "%s (%d) > " fmt, __func__, __LINE__, ##arg)
+#define logd(fmt, arg...) __LOG(DLOG_DEBUG, fmt, ##arg)
+#define loge(fmt, arg...) __LOG(DLOG_ERROR, fmt, ##arg)
+#define logi(fmt, arg...) __LOG(DLOG_INFO, fmt, ##arg)
+
+
+#define QUEUE_MIN_CAPACITY	16
+
+
+// define structures
+struct _util_read_queue
+{
+	util_read_result *results;	// in the order the handles were added
+	int capacity;
+	int count;
+	int next;			// first result not started yet
+
+	int *in_flight;			// indices into results, max_in_flight of them
+	int n_in_flight;
+	int max_in_flight;
+
+	util_read_queue_start_cb start_cb;
+	util_read_queue_done_cb done_cb;
+	void *data;
+
+	bool running;
+	unsigned long long run_us;
+	util_read_queue_stats stats;
+};
+
+
+/**
+ * @function		queue_finish
+ * @since_tizen		2.3
+ * @description		Records The Result Of One Read
+ * @parameter		util_read_queue*: Util Read Queue Pointer, int: Index, util_read_state: Final State, int: Result, const void*: Value, int: Length
+ * @return		static void
+ */
+static void queue_finish(util_read_queue *queue, int index, util_read_state state, int result, const void *value, int len)
+{
+	util_read_result *r = &queue->results[index];
+	util_read_queue_stats *s = &queue->stats;
+
+	r->state = state;
+	r->result = result;
+	r->latency_us = util_clock_now_us() - r->start_us;
+	if (value != NULL && len > 0)
+	{
+		r->value = malloc(len);
+		if (r->value != NULL)
+		{
+			memcpy(r->value, value, len);
+			r->len = len;
+		}
+	}
+
+	s->done++;
+	s->bytes += r->len;
+	s->latency_us += r->latency_us;
+	if (r->latency_us > s->max_latency_us)
+	{
+		s->max_latency_us = r->latency_us;
+	}
+	if (state != UTIL_READ_DONE || result != 0)
+	{
+		s->failed++;
+	}
+}
+
+
+/**
+ * @function		queue_pump
+ * @since_tizen		2.3
+ * @description		Starts Reads Until The In Flight Limit, Reports The End Of The Run
+ * @parameter		util_read_queue*: Util Read Queue Pointer
+ * @return		static void
+ */
+static void queue_pump(util_read_queue *queue)
+{
+	while (queue->running && queue->n_in_flight < queue->max_in_flight && queue->next < queue->count)
+	{
+		int index = queue->next++;
+		util_read_result *r = &queue->results[index];
+
+		r->state = UTIL_READ_IN_FLIGHT;
+		r->start_us = util_clock_now_us();
+		queue->in_flight[queue->n_in_flight++] = index;
+		if (queue->n_in_flight > queue->stats.max_in_flight)
+		{
+			queue->stats.max_in_flight = queue->n_in_flight;
+		}
+
+		if (!queue->start_cb(r->handle, queue->data))
+		{
+			loge("read %d could not be started", index);
+			queue->n_in_flight--;
+			queue_finish(queue, index, UTIL_READ_NOT_STARTED, 0, NULL, 0);
+		}
+	}
+
+	if (queue->running && queue->n_in_flight == 0 && queue->next == queue->count)
+	{
+		queue->running = false;
+		queue->stats.total_us = util_clock_now_us() - queue->run_us;
+		util_read_queue_info(queue);
+		if (queue->done_cb != NULL)
+		{
+			queue->done_cb(queue, queue->data);
+		}
+	}
+}
+
+
+/**
+ * @function		util_read_queue_create
+ * @since_tizen		2.3
+ * @description		Util Read Queue Create
+ * @parameter		int: Max In Flight, util_read_queue_start_cb: Start Cb, util_read_queue_done_cb: Done Cb, void*: Void Pointer
+ * @return		util_read_queue*
+ */
+util_read_queue* util_read_queue_create(int max_in_flight, util_read_queue_start_cb start_cb, util_read_queue_done_cb done_cb, void *data)
+{
+	RETVM_IF(max_in_flight <= 0, NULL, "invalid max_in_flight %d", max_in_flight);
+	RETVM_IF(NULL == start_cb, NULL, "start_cb is NULL");
+
+	util_read_queue *queue = calloc(1, sizeof(util_read_queue));
+	RETVM_IF(!queue, NULL, "calloc failed");
+
+	queue->results = calloc(QUEUE_MIN_CAPACITY, sizeof(util_read_result));
+	queue->in_flight = calloc(max_in_flight, sizeof(int));
+	if (queue->results == NULL || queue->in_flight == NULL)
+	{
+		loge("calloc failed");
+		util_read_queue_destroy(queue);
+		return NULL;
+	}
+
+	queue->capacity = QUEUE_MIN_CAPACITY;
+	queue->max_in_flight = max_in_flight;
+	queue->start_cb = start_cb;
+	queue->done_cb = done_cb;
+	queue->data = data;
+
+	return queue;
+}
+
+
+/**
+ * @function		util_read_queue_destroy
+ * @since_tizen		2.3
+ * @description		Util Read Queue Destroy
+ * @parameter		util_read_queue*: Util Read Queue Pointer
+ * @return		void
+ */
+void util_read_queue_destroy(util_read_queue *queue)
+{
+	if (queue == NULL) return;
+
+	if (queue->running)
+	{
+		logi("destroyed with %d reads in flight and %d queued", queue->n_in_flight, queue->count - queue->next);
+	}
+
+	int i;
+	for (i = 0; i < queue->count; i++)
+	{
+		SAFE_DELETE(queue->results[i].value);
+	}
+	SAFE_DELETE(queue->results);
+	SAFE_DELETE(queue->in_flight);
+	free(queue);
+}
+
+
+/**
+ * @function		util_read_queue_add
+ * @since_tizen		2.3
+ * @description		Util Read Queue Add
+ * @parameter		util_read_queue*: Util Read Queue Pointer, void*: Handle
+ * @return		bool
+ */
+bool util_read_queue_add(util_read_queue *queue, void *handle)
+{
+	RETVM_IF(NULL == queue, false, "queue is NULL");
+	RETVM_IF(NULL == handle, false, "handle is NULL");
+
+	int i;
+	for (i = 0; i < queue->count; i++)
+	{
+		if (queue->results[i].handle == handle)
+		{
+			return true;
+		}
+	}
+
+	if (queue->count == queue->capacity)
+	{
+		util_read_result *results = realloc(queue->results, queue->capacity * 2 * sizeof(util_read_result));
+		RETVM_IF(!results, false, "realloc failed for %d reads", queue->capacity * 2);
+		queue->results = results;
+		queue->capacity *= 2;
+	}
+
+	util_read_result *r = &queue->results[queue->count++];
+	memset(r, 0, sizeof(*r));
+	r->handle = handle;
+	r->state = UTIL_READ_QUEUED;
+	queue->stats.reads++;
+
+	queue_pump(queue);
+	return true;
+}
+
+
+/**
+ * @function		util_read_queue_run
+ * @since_tizen		2.3
+ * @description		Util Read Queue Run
+ * @parameter		util_read_queue*: Util Read Queue Pointer
+ * @return		void
+ */
+void util_read_queue_run(util_read_queue *queue)
+{
+	RETM_IF(NULL == queue, "queue is NULL");
+	RETM_IF(queue->running, "already running");
+
+	queue->running = true;
+	queue->run_us = util_clock_now_us();
+	queue_pump(queue);
+}
+
+
+/**
+ * @function		util_read_queue_complete
+ * @since_tizen		2.3
+ * @description		Util Read Queue Complete
+ * @parameter		util_read_queue*: Util Read Queue Pointer, void*: Handle, int: Result, const void*: Value, int: Length
+ * @return		void
+ */
+void util_read_queue_complete(util_read_queue *queue, void *handle, int result, const void *value, int len)
+{
+	RETM_IF(NULL == queue, "queue is NULL");
+
+	int i;
+	for (i = 0; i < queue->n_in_flight; i++)
+	{
+		if (queue->results[queue->in_flight[i]].handle == handle)
+		{
+			break;
+		}
+	}
+	RETM_IF(i == queue->n_in_flight, "no read in flight for %p", handle);
+
+	int index = queue->in_flight[i];
+	queue->in_flight[i] = queue->in_flight[--queue->n_in_flight];
+
+	queue_finish(queue, index, UTIL_READ_DONE, result, value, len);
+	queue_pump(queue);
+}
+
+
+/**
+ * @function		util_read_queue_running
+ * @since_tizen		2.3
+ * @description		Util Read Queue Running
+ * @parameter		util_read_queue*: Util Read Queue Pointer
+ * @return		bool
+ */
+bool util_read_queue_running(util_read_queue *queue)
+{
+	RETVM_IF(NULL == queue, false, "queue is NULL");
+
+	return queue->running;
+}
+
+
+/**
+ * @function		util_read_queue_count
+ * @since_tizen		2.3
+ * @description		Util Read Queue Count
+ * @parameter		util_read_queue*: Util Read Queue Pointer
+ * @return		int
+ */
+int util_read_queue_count(util_read_queue *queue)
+{
+	RETVM_IF(NULL == queue, 0, "queue is NULL");
+
+	return queue->count;
+}
+
+
+/**
+ * @function		util_read_queue_get
+ * @since_tizen		2.3
+ * @description		Util Read Queue Get
+ * @parameter		util_read_queue*: Util Read Queue Pointer, int: Index
+ * @return		const util_read_result*
+ */
+const util_read_result* util_read_queue_get(util_read_queue *queue, int index)
+{
+	RETVM_IF(NULL == queue, NULL, "queue is NULL");
+	RETVM_IF(index < 0 || index >= queue->count, NULL, "index %d out of range", index);
+
+	return &queue->results[index];
+}
+
+
+/**
+ * @function		util_read_queue_get_stats
+ * @since_tizen		2.3
+ * @description		Util Read Queue Get Stats
+ * @parameter		util_read_queue*: Util Read Queue Pointer, util_read_queue_stats*: Util Read Queue Stats Pointer
+ * @return		void
+ */
+void util_read_queue_get_stats(util_read_queue *queue, util_read_queue_stats *stats)
+{
+	RETM_IF(NULL == queue, "queue is NULL");
+	RETM_IF(NULL == stats, "stats is NULL");
+
+	*stats = queue->stats;
+	if (queue->running)
+	{
+		stats->total_us = util_clock_now_us() - queue->run_us;
+	}
+}
+
+
+/**
+ * @function		util_read_queue_info
+ * @since_tizen		2.3
+ * @description		Util Read Queue Info
+ * @parameter		util_read_queue*: Util Read Queue Pointer
+ * @return		void
+ */
+void util_read_queue_info(util_read_queue *queue)
+{
+	RETM_IF(NULL == queue, "queue is NULL");
+
+	util_read_queue_stats *s = &queue->stats;
+	unsigned long long avg_us = s->done ? s->latency_us / s->done : 0;
+
+	logi("reads=%d done=%d failed=%d bytes=%llu in flight max=%d/%d total=%lluus latency avg=%lluus max=%lluus",
+			s->reads, s->done, s->failed, s->bytes, s->max_in_flight, queue->max_in_flight,
+			s->total_us, avg_us, s->max_latency_us);
+}
@@ -0,0 +1,252 @@
+/*******************************************************************************
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the License);
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *******************************************************************************/
+
+/**
+ *  @file util_refresh.c
+ *
+ *	@brief
+ *	Coalesced UI refresh
+ *  Implementation of util_refresh
+ */
+#include "utils/util_refresh.h"
+#include "utils/util_clock.h"
+
+#include <Ecore.h>
+#include <string.h>
+
+
+// define custom logging for refresh
+#define __LOG(prio, fmt, arg...) dlog_print(prio, "UTIL_REFRESH", "%s (%d) > " fmt, __func__, __LINE__, ##arg)
+#define logd(fmt, arg...) __LOG(DLOG_DEBUG, fmt, ##arg)
+#define loge(fmt, arg...) __LOG(DLOG_ERROR, fmt, ##arg)
+#define logi(fmt, arg...) __LOG(DLOG_INFO, fmt, ##arg)
+
+
+#define REFRESH_INFO_EVERY	64
+
+
+// define structures
+struct _util_refresh
+{
+	double interval;
+	util_refresh_cb cb;
+	void *data;
+
+	Ecore_Timer *timer;
+	unsigned long long due_us;
+
+	util_refresh_stats stats;
+};
+
+
+/**
+ * @function		refresh_run
+ * @since_tizen		2.3
+ * @description		Runs The Refresh And Times It
+ * @parameter		util_refresh*: Util Refresh Pointer
+ * @return		static void
+ */
+static void refresh_run(util_refresh *refresh)
+{
+	unsigned long long start = util_clock_now_us();
+	util_refresh_stats *s = &refresh->stats;
+
+	refresh->cb(refresh->data);
+
+	unsigned long long spent = util_clock_now_us() - start;
+	s->refreshes++;
+	s->refresh_us += spent;
+	if (spent > s->max_refresh_us)
+	{
+		s->max_refresh_us = spent;
+	}
+
+	if ((s->refreshes % REFRESH_INFO_EVERY) == 0)
+	{
+		util_refresh_info(refresh);
+	}
+}
+
+
+/**
+ * @function		_refresh_timer_cb
+ * @since_tizen		2.3
+ * @description		Refresh Timer Cb
+ * @parameter		void*: Void Pointer
+ * @return		static Eina_Bool
+ */
+static Eina_Bool _refresh_timer_cb(void *data)
+{
+	util_refresh *refresh = (util_refresh*) data;
+	RETVM_IF(NULL == refresh, ECORE_CALLBACK_CANCEL, "refresh is NULL");
+
+	unsigned long long now = util_clock_now_us();
+	unsigned long long late = (now > refresh->due_us) ? now - refresh->due_us : 0;
+
+	refresh->timer = NULL;
+	refresh->stats.late_us += late;
+	if (late > refresh->stats.max_late_us)
+	{
+		refresh->stats.max_late_us = late;
+	}
+
+	refresh_run(refresh);
+	return ECORE_CALLBACK_CANCEL;
+}
+
+
+/**
+ * @function		util_refresh_create
+ * @since_tizen		2.3
+ * @description		Util Refresh Create
+ * @parameter		double: Double, util_refresh_cb: Util Refresh Cb, void*: Void Pointer
+ * @return		util_refresh*
+ */
+util_refresh* util_refresh_create(double interval, util_refresh_cb cb, void *data)
+{
+	RETVM_IF(interval < 0, NULL, "invalid interval %f", interval);
+	RETVM_IF(NULL == cb, NULL, "cb is NULL");
+
+	util_refresh *refresh = calloc(1, sizeof(util_refresh));
+	RETVM_IF(!refresh, NULL, "calloc failed");
+
+	refresh->interval = interval;
+	refresh->cb = cb;
+	refresh->data = data;
+
+	return refresh;
+}
+
+
+/**
+ * @function		util_refresh_destroy
+ * @since_tizen		2.3
+ * @description		Util Refresh Destroy
+ * @parameter		util_refresh*: Util Refresh Pointer
+ * @return		void
+ */
+void util_refresh_destroy(util_refresh *refresh)
+{
+	if (refresh == NULL) return;
+
+	util_refresh_cancel(refresh);
+	util_refresh_info(refresh);
+	free(refresh);
+}
+
+
+/**
+ * @function		util_refresh_request
+ * @since_tizen		2.3
+ * @description		Util Refresh Request
+ * @parameter		util_refresh*: Util Refresh Pointer
+ * @return		void
+ */
+void util_refresh_request(util_refresh *refresh)
+{
+	RETM_IF(NULL == refresh, "refresh is NULL");
+
+	refresh->stats.requests++;
+
+	if (refresh->timer != NULL)
+	{
+		return;
+	}
+
+	refresh->due_us = util_clock_now_us() + (unsigned long long) (refresh->interval * 1000000);
+	refresh->timer = ecore_timer_add(refresh->interval, _refresh_timer_cb, refresh);
+	if (refresh->timer == NULL)
+	{
+		loge("ecore_timer_add failed, refreshing right away");
+		refresh_run(refresh);
+	}
+}
+
+
+/**
+ * @function		util_refresh_flush
+ * @since_tizen		2.3
+ * @description		Util Refresh Flush
+ * @parameter		util_refresh*: Util Refresh Pointer
+ * @return		void
+ */
+void util_refresh_flush(util_refresh *refresh)
+{
+	RETM_IF(NULL == refresh, "refresh is NULL");
+
+	if (refresh->timer == NULL)
+	{
+		return;
+	}
+
+	util_refresh_cancel(refresh);
+	refresh_run(refresh);
+}
+
+
+/**
+ * @function		util_refresh_cancel
+ * @since_tizen		2.3
+ * @description		Util Refresh Cancel
+ * @parameter		util_refresh*: Util Refresh Pointer
+ * @return		void
+ */
+void util_refresh_cancel(util_refresh *refresh)
+{
+	RETM_IF(NULL == refresh, "refresh is NULL");
+
+	if (refresh->timer != NULL)
+	{
+		ecore_timer_del(refresh->timer);
+		refresh->timer = NULL;
+	}
+}
+
+
+/**
+ * @function		util_refresh_get_stats
+ * @since_tizen		2.3
+ * @description		Util Refresh Get Stats
+ * @parameter		util_refresh*: Util Refresh Pointer, util_refresh_stats*: Util Refresh Stats Pointer
+ * @return		void
+ */
+void util_refresh_get_stats(util_refresh *refresh, util_refresh_stats *stats)
+{
+	RETM_IF(NULL == refresh, "refresh is NULL");
+	RETM_IF(NULL == stats, "stats is NULL");
+
+	*stats = refresh->stats;
+}
+
+
+/**
+ * @function		util_refresh_info
+ * @since_tizen		2.3
+ * @description		Util Refresh Info
+ * @parameter		util_refresh*: Util Refresh Pointer
+ * @return		void
+ */
+void util_refresh_info(util_refresh *refresh)
+{
+	RETM_IF(NULL == refresh, "refresh is NULL");
+
+	util_refresh_stats *s = &refresh->stats;
+	unsigned long long avg_us = s->refreshes ? s->refresh_us / s->refreshes : 0;
+	unsigned long long avg_late_us = s->refreshes ? s->late_us / s->refreshes : 0;
+
+	logi("requests=%lu refreshes=%lu refresh avg=%lluus max=%lluus timer late avg=%lluus max=%lluus",
+			s->requests, s->refreshes, avg_us, s->max_refresh_us, avg_late_us, s->max_late_us);
+}
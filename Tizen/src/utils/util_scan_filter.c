@@ -0,0 +1,781 @@
+/*******************************************************************************
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the License);
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *******************************************************************************/
+
+/**
+ *  @file util_scan_filter.c
+ *
+ *	@brief
+ *	Scan result filter
+ *  Implementation of util_scan_filter
+ */
+#include "utils/util_scan_filter.h"
+#include "utils/util_adv_data.h"
+
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(TIZEN_2_4) || defined(TIZEN_3_0)
+#include <bluetooth.h>
+#include "bluetooth_internal.h"
+#define SCAN_FILTER_PUSH_DOWN
+#endif
+
+
+// define custom logging for filter
+#define __LOG(prio, fmt, arg...) dlog_print(prio, "UTIL_FILTER", "%s (%d) > " fmt, __func__, __LINE__, ##arg)
+#define logd(fmt, arg...) __LOG(DLOG_DEBUG, fmt, ##arg)
+#define logw(fmt, arg...) __LOG(DLOG_WARN, fmt, ##arg)
+#define loge(fmt, arg...) __LOG(DLOG_ERROR, fmt, ##arg)
+#define logi(fmt, arg...) __LOG(DLOG_INFO, fmt, ##arg)
+
+
+#define FILTER_MAX_RULES		16
+#define FILTER_MAX_CLAUSES		8
+#define FILTER_MAX_UUIDS		32
+#define FILTER_MAX_CODE			1024
+#define FILTER_NAME_POOL		256
+
+
+/*
+ * Instruction layout, multi-byte operands little-endian, fail is the
+ * absolute pc of the next rule:
+ *	RSSI	op i8 fail16
+ *	MFR		op id16 mask16 fail16
+ *	UUID	op index8 fail16
+ *	NAME	op offset16 len8 fail16
+ *	ACCEPT	op
+ *	REJECT	op
+ */
+typedef enum
+{
+	OP_REJECT = 0,
+	OP_ACCEPT,
+	OP_RSSI,
+	OP_MFR,
+	OP_UUID,
+	OP_NAME
+} filter_op_e;
+
+
+// clauses are emitted cheapest first, in this order
+typedef enum
+{
+	CLAUSE_RSSI,
+	CLAUSE_MFR,
+	CLAUSE_UUID,
+	CLAUSE_NAME
+} filter_clause_e;
+
+
+typedef struct
+{
+	filter_clause_e kind;
+	int rssi;
+	uint16_t mfr_id;
+	uint16_t mfr_mask;
+	int uuid_index;
+	int name_offset;
+	int name_len;
+} filter_clause;
+
+
+typedef struct
+{
+	filter_clause clauses[FILTER_MAX_CLAUSES];
+	int n_clauses;
+} filter_rule;
+
+
+// define structures
+struct _util_scan_filter
+{
+	uint8_t code[FILTER_MAX_CODE];
+	int code_len;
+
+	uint8_t uuids[FILTER_MAX_UUIDS][16];
+	char uuid_text[FILTER_MAX_UUIDS][37];
+	int n_uuids;
+
+	char names[FILTER_NAME_POOL];
+	int names_len;
+
+	filter_rule rules[FILTER_MAX_RULES];
+	int n_rules;
+
+#ifdef SCAN_FILTER_PUSH_DOWN
+	bt_scan_filter_h pushed[FILTER_MAX_RULES];
+	int n_pushed;
+#endif
+
+	util_scan_filter_stats stats;
+};
+
+
+/**
+ * @function		filter_skip_spaces
+ * @since_tizen		2.3
+ * @description		Filter Skip Spaces
+ * @parameter		const char*: Const char Pointer
+ * @return		static const char*
+ */
+static const char *filter_skip_spaces(const char *p)
+{
+	while (*p == ' ' || *p == '\t') p++;
+	return p;
+}
+
+
+/**
+ * @function		filter_parse_hex16
+ * @since_tizen		2.3
+ * @description		Parses 1 To 4 Hex Digits
+ * @parameter		const char**: Const char Pointer Pointer, uint16_t*: Uint16 T Pointer
+ * @return		static bool
+ */
+static bool filter_parse_hex16(const char **pp, uint16_t *value)
+{
+	const char *p = *pp;
+	unsigned v = 0;
+	int digits = 0;
+
+	if (p[0] == '0' && (p[1] == 'x' || p[1] == 'X')) p += 2;
+	while (isxdigit((unsigned char) *p) && digits < 4)
+	{
+		v = (v << 4) | (isdigit((unsigned char) *p) ? *p - '0' : (tolower((unsigned char) *p) - 'a' + 10));
+		p++;
+		digits++;
+	}
+	if (digits == 0 || isxdigit((unsigned char) *p)) return false;
+
+	*value = (uint16_t) v;
+	*pp = p;
+	return true;
+}
+
+
+/**
+ * @function		filter_parse_uuid
+ * @since_tizen		2.3
+ * @description		Parses A 16, 32 Or 128 Bit UUID Into Its 128 Bit Form
+ * @parameter		util_scan_filter*: Util Scan Filter Pointer, const char**: Const char Pointer Pointer
+ * @return		static int
+ */
+static int filter_parse_uuid(util_scan_filter *filter, const char **pp)
+{
+	const char *p = *pp;
+	uint8_t nibbles[32];
+	int digits = 0;
+	int i;
+
+	while ((isxdigit((unsigned char) *p) || *p == '-') && digits <= 32)
+	{
+		if (*p != '-')
+		{
+			if (digits == 32) return -1;
+			nibbles[digits++] = isdigit((unsigned char) *p) ? *p - '0' : (tolower((unsigned char) *p) - 'a' + 10);
+		}
+		p++;
+	}
+	if (digits != 4 && digits != 8 && digits != 32) return -1;
+	if (filter->n_uuids >= FILTER_MAX_UUIDS) return -1;
+
+	int index = filter->n_uuids++;
+	uint8_t *uuid = filter->uuids[index];
+	char *text = filter->uuid_text[index];
+
+	if (digits == 32)
+	{
+		for (i = 0; i < 16; i++) uuid[i] = (nibbles[2 * i] << 4) | nibbles[2 * i + 1];
+	}
+	else
+	{
+		util_adv_uuid16_to_uuid128(0, uuid);
+		for (i = 0; i < digits / 2; i++) uuid[(4 - digits / 2) + i] = (nibbles[2 * i] << 4) | nibbles[2 * i + 1];
+	}
+
+	if (digits == 4)
+	{
+		snprintf(text, 37, "%02X%02X", uuid[2], uuid[3]);
+	}
+	else
+	{
+		snprintf(text, 37, "%02X%02X%02X%02X-%02X%02X-%02X%02X-%02X%02X-%02X%02X%02X%02X%02X%02X",
+				uuid[0], uuid[1], uuid[2], uuid[3], uuid[4], uuid[5], uuid[6], uuid[7],
+				uuid[8], uuid[9], uuid[10], uuid[11], uuid[12], uuid[13], uuid[14], uuid[15]);
+	}
+
+	*pp = p;
+	return index;
+}
+
+
+/**
+ * @function		filter_parse_clause
+ * @since_tizen		2.3
+ * @description		Filter Parse Clause
+ * @parameter		util_scan_filter*: Util Scan Filter Pointer, const char**: Const char Pointer Pointer, filter_clause*: Filter Clause Pointer
+ * @return		static bool
+ */
+static bool filter_parse_clause(util_scan_filter *filter, const char **pp, filter_clause *clause)
+{
+	const char *p = filter_skip_spaces(*pp);
+
+	memset(clause, 0, sizeof(*clause));
+
+	if (strncmp(p, "uuid=", 5) == 0)
+	{
+		p += 5;
+		clause->kind = CLAUSE_UUID;
+		clause->uuid_index = filter_parse_uuid(filter, &p);
+		if (clause->uuid_index < 0) return false;
+	}
+	else if (strncmp(p, "mfr=", 4) == 0)
+	{
+		p += 4;
+		clause->kind = CLAUSE_MFR;
+		clause->mfr_mask = 0xFFFF;
+		if (!filter_parse_hex16(&p, &clause->mfr_id)) return false;
+		if (*p == '/')
+		{
+			p++;
+			if (!filter_parse_hex16(&p, &clause->mfr_mask)) return false;
+		}
+	}
+	else if (strncmp(p, "name=", 5) == 0)
+	{
+		const char *start = p + 5;
+		const char *end = start;
+
+		while (*end != '\0' && *end != ',' && *end != '|') end++;
+		while (end > start && (end[-1] == ' ' || end[-1] == '\t')) end--;
+
+		int len = end - start;
+		if (len == 0 || len > 255 || filter->names_len + len > FILTER_NAME_POOL) return false;
+
+		clause->kind = CLAUSE_NAME;
+		clause->name_offset = filter->names_len;
+		clause->name_len = len;
+		memcpy(filter->names + filter->names_len, start, len);
+		filter->names_len += len;
+		p = end;
+	}
+	else if (strncmp(p, "rssi>=", 6) == 0)
+	{
+		char *end = NULL;
+		long v = strtol(p + 6, &end, 10);
+		if (end == p + 6 || v < -127 || v > 127) return false;
+
+		clause->kind = CLAUSE_RSSI;
+		clause->rssi = (int) v;
+		p = end;
+	}
+	else
+	{
+		return false;
+	}
+
+	*pp = filter_skip_spaces(p);
+	return true;
+}
+
+
+/**
+ * @function		filter_emit8
+ * @since_tizen		2.3
+ * @description		Filter Emit8
+ * @parameter		util_scan_filter*: Util Scan Filter Pointer, int: Int
+ * @return		static void
+ */
+static void filter_emit8(util_scan_filter *filter, int value)
+{
+	filter->code[filter->code_len++] = (uint8_t) value;
+}
+
+
+/**
+ * @function		filter_emit16
+ * @since_tizen		2.3
+ * @description		Filter Emit16
+ * @parameter		util_scan_filter*: Util Scan Filter Pointer, int: Int
+ * @return		static void
+ */
+static void filter_emit16(util_scan_filter *filter, int value)
+{
+	filter->code[filter->code_len++] = (uint8_t) (value & 0xFF);
+	filter->code[filter->code_len++] = (uint8_t) ((value >> 8) & 0xFF);
+}
+
+
+/**
+ * @function		filter_read16
+ * @since_tizen		2.3
+ * @description		Filter Read16
+ * @parameter		const uint8_t*: Const Uint8 T Pointer
+ * @return		static int
+ */
+static inline int filter_read16(const uint8_t *p)
+{
+	return p[0] | (p[1] << 8);
+}
+
+
+/**
+ * @function		filter_generate
+ * @since_tizen		2.3
+ * @description		Emits The Program For The Parsed Rules
+ * @parameter		util_scan_filter*: Util Scan Filter Pointer
+ * @return		static bool
+ */
+static bool filter_generate(util_scan_filter *filter)
+{
+	int fixups[FILTER_MAX_CLAUSES];
+	int r, c, kind;
+
+	filter->code_len = 0;
+
+	if (filter->n_rules == 0)
+	{
+		filter_emit8(filter, OP_ACCEPT);
+		return true;
+	}
+
+	for (r = 0; r < filter->n_rules; r++)
+	{
+		filter_rule *rule = &filter->rules[r];
+		int n_fixups = 0;
+
+		// worst case 7 bytes per clause plus ACCEPT and the final REJECT
+		if (filter->code_len + rule->n_clauses * 7 + 2 > FILTER_MAX_CODE) return false;
+
+		for (kind = CLAUSE_RSSI; kind <= CLAUSE_NAME; kind++)
+		{
+			for (c = 0; c < rule->n_clauses; c++)
+			{
+				filter_clause *clause = &rule->clauses[c];
+				if ((int) clause->kind != kind) continue;
+
+				switch (clause->kind)
+				{
+				case CLAUSE_RSSI:
+					filter_emit8(filter, OP_RSSI);
+					filter_emit8(filter, clause->rssi);
+					break;
+				case CLAUSE_MFR:
+					filter_emit8(filter, OP_MFR);
+					filter_emit16(filter, clause->mfr_id);
+					filter_emit16(filter, clause->mfr_mask);
+					break;
+				case CLAUSE_UUID:
+					filter_emit8(filter, OP_UUID);
+					filter_emit8(filter, clause->uuid_index);
+					break;
+				case CLAUSE_NAME:
+					filter_emit8(filter, OP_NAME);
+					filter_emit16(filter, clause->name_offset);
+					filter_emit8(filter, clause->name_len);
+					break;
+				}
+				fixups[n_fixups++] = filter->code_len;
+				filter_emit16(filter, 0);
+			}
+		}
+		filter_emit8(filter, OP_ACCEPT);
+
+		for (c = 0; c < n_fixups; c++)
+		{
+			filter->code[fixups[c]] = filter->code_len & 0xFF;
+			filter->code[fixups[c] + 1] = (filter->code_len >> 8) & 0xFF;
+		}
+	}
+	filter_emit8(filter, OP_REJECT);
+	return true;
+}
+
+
+/**
+ * @function		util_scan_filter_compile
+ * @since_tizen		2.3
+ * @description		Util Scan Filter Compile
+ * @parameter		const char*: Const char Pointer
+ * @return		util_scan_filter*
+ */
+util_scan_filter* util_scan_filter_compile(const char *spec)
+{
+	util_scan_filter *filter = calloc(1, sizeof(util_scan_filter));
+	RETVM_IF(!filter, NULL, "calloc failed");
+
+	const char *p = filter_skip_spaces(spec ? spec : "");
+
+	while (*p != '\0')
+	{
+		if (filter->n_rules >= FILTER_MAX_RULES)
+		{
+			loge("too many rules in '%s'", spec);
+			free(filter);
+			return NULL;
+		}
+
+		filter_rule *rule = &filter->rules[filter->n_rules++];
+		for (;;)
+		{
+			if (rule->n_clauses >= FILTER_MAX_CLAUSES
+					|| !filter_parse_clause(filter, &p, &rule->clauses[rule->n_clauses]))
+			{
+				loge("syntax error in '%s' at offset %d", spec, (int) (p - spec));
+				free(filter);
+				return NULL;
+			}
+			rule->n_clauses++;
+
+			if (*p != ',') break;
+			p++;
+		}
+
+		if (*p == '|')
+		{
+			p = filter_skip_spaces(p + 1);
+			if (*p == '\0')
+			{
+				loge("empty rule at the end of '%s'", spec);
+				free(filter);
+				return NULL;
+			}
+		}
+		else if (*p != '\0')
+		{
+			loge("syntax error in '%s' at offset %d", spec, (int) (p - spec));
+			free(filter);
+			return NULL;
+		}
+	}
+
+	if (!filter_generate(filter))
+	{
+		loge("filter '%s' too large", spec);
+		free(filter);
+		return NULL;
+	}
+
+	logi("compiled '%s': %d rules, %d bytes of code", spec ? spec : "", filter->n_rules, filter->code_len);
+	return filter;
+}
+
+
+/**
+ * @function		util_scan_filter_destroy
+ * @since_tizen		2.3
+ * @description		Util Scan Filter Destroy
+ * @parameter		util_scan_filter*: Util Scan Filter Pointer
+ * @return		void
+ */
+void util_scan_filter_destroy(util_scan_filter *filter)
+{
+	if (filter == NULL) return;
+
+	util_scan_filter_remove_push_down(filter);
+	free(filter);
+}
+
+
+/**
+ * @function		filter_match_mfr
+ * @since_tizen		2.3
+ * @description		Filter Match Mfr
+ * @parameter		const char*: Const char Pointer, int: Int, uint16_t: Uint16 T, uint16_t: Uint16 T
+ * @return		static bool
+ */
+static bool filter_match_mfr(const char *data, int len, uint16_t id, uint16_t mask)
+{
+	uint16_t company;
+
+	return util_adv_get_manufacturer_data(data, len, &company, NULL, NULL) && ((company & mask) == (id & mask));
+}
+
+
+/**
+ * @function		filter_match_name
+ * @since_tizen		2.3
+ * @description		Filter Match Name
+ * @parameter		const char*: Const char Pointer, int: Int, const char*: Const char Pointer, int: Int
+ * @return		static bool
+ */
+static bool filter_match_name(const char *data, int len, const char *prefix, int prefix_len)
+{
+	const char *name;
+	int name_len;
+
+	return util_adv_get_local_name(data, len, &name, &name_len, NULL)
+			&& name_len >= prefix_len && memcmp(name, prefix, prefix_len) == 0;
+}
+
+
+/**
+ * @function		util_scan_filter_match
+ * @since_tizen		2.3
+ * @description		Util Scan Filter Match
+ * @parameter		util_scan_filter*: Util Scan Filter Pointer, const char*: Const char Pointer, int: Int, const char*: Const char Pointer, int: Int, int: Int
+ * @return		bool
+ */
+bool util_scan_filter_match(util_scan_filter *filter, const char *adv_data, int adv_data_len,
+		const char *scan_data, int scan_data_len, int rssi)
+{
+	if (filter == NULL) return true;
+
+	const uint8_t *code = filter->code;
+	int pc = 0;
+	bool pass;
+
+	filter->stats.evaluated++;
+
+	for (;;)
+	{
+		switch (code[pc])
+		{
+		case OP_ACCEPT:
+			filter->stats.accepted++;
+			return true;
+
+		case OP_RSSI:
+			pass = rssi >= (int8_t) code[pc + 1];
+			pc = pass ? pc + 4 : filter_read16(code + pc + 2);
+			break;
+
+		case OP_MFR:
+			pass = filter_match_mfr(adv_data, adv_data_len, filter_read16(code + pc + 1), filter_read16(code + pc + 3))
+					|| filter_match_mfr(scan_data, scan_data_len, filter_read16(code + pc + 1), filter_read16(code + pc + 3));
+			pc = pass ? pc + 7 : filter_read16(code + pc + 5);
+			break;
+
+		case OP_UUID:
+			pass = util_adv_has_service_uuid(adv_data, adv_data_len, filter->uuids[code[pc + 1]])
+					|| util_adv_has_service_uuid(scan_data, scan_data_len, filter->uuids[code[pc + 1]]);
+			pc = pass ? pc + 4 : filter_read16(code + pc + 2);
+			break;
+
+		case OP_NAME:
+			pass = filter_match_name(adv_data, adv_data_len, filter->names + filter_read16(code + pc + 1), code[pc + 3])
+					|| filter_match_name(scan_data, scan_data_len, filter->names + filter_read16(code + pc + 1), code[pc + 3]);
+			pc = pass ? pc + 6 : filter_read16(code + pc + 4);
+			break;
+
+		case OP_REJECT:
+		default:
+			filter->stats.rejected++;
+			return false;
+		}
+	}
+}
+
+
+/**
+ * @function		util_scan_filter_push_down
+ * @since_tizen		2.4
+ * @description		Util Scan Filter Push Down
+ * @parameter		util_scan_filter*: Util Scan Filter Pointer
+ * @return		int
+ */
+int util_scan_filter_push_down(util_scan_filter *filter)
+{
+	RETVM_IF(NULL == filter, 0, "filter is NULL");
+
+#ifdef SCAN_FILTER_PUSH_DOWN
+	int r, c, ret;
+
+	util_scan_filter_remove_push_down(filter);
+
+	if (filter->n_rules == 0)
+	{
+		return 0;
+	}
+
+	// the controller only knows exact manufacturer IDs and service UUIDs
+	for (r = 0; r < filter->n_rules; r++)
+	{
+		bool pushable = false;
+		for (c = 0; c < filter->rules[r].n_clauses; c++)
+		{
+			filter_clause *clause = &filter->rules[r].clauses[c];
+			if (clause->kind == CLAUSE_UUID || (clause->kind == CLAUSE_MFR && clause->mfr_mask == 0xFFFF))
+			{
+				pushable = true;
+			}
+		}
+		if (!pushable)
+		{
+			logw("rule %d has nothing the controller can filter on, filtering on the host only", r);
+			return 0;
+		}
+	}
+
+	for (r = 0; r < filter->n_rules; r++)
+	{
+		bt_scan_filter_h handle = NULL;
+		bool has_uuid = false;
+		bool has_mfr = false;
+
+		ret = bt_adapter_le_create_scan_filter(&handle);
+		if (ret != BT_ERROR_NONE)
+		{
+			loge("bt_adapter_le_create_scan_filter failed: %d", ret);
+			break;
+		}
+
+		// one value per field, any further clauses stay host side
+		for (c = 0; c < filter->rules[r].n_clauses; c++)
+		{
+			filter_clause *clause = &filter->rules[r].clauses[c];
+			if (clause->kind == CLAUSE_UUID && !has_uuid)
+			{
+				ret = bt_adapter_le_scan_filter_set_service_uuid(handle, filter->uuid_text[clause->uuid_index]);
+				has_uuid = (ret == BT_ERROR_NONE);
+			}
+			else if (clause->kind == CLAUSE_MFR && clause->mfr_mask == 0xFFFF && !has_mfr)
+			{
+				ret = bt_adapter_le_scan_filter_set_manufacturer_data(handle, clause->mfr_id, "", 0);
+				has_mfr = (ret == BT_ERROR_NONE);
+			}
+		}
+
+		if ((!has_uuid && !has_mfr) || bt_adapter_le_register_scan_filter(handle) != BT_ERROR_NONE)
+		{
+			loge("unable to register controller filter for rule %d", r);
+			bt_adapter_le_destroy_scan_filter(handle);
+			break;
+		}
+		filter->pushed[filter->n_pushed++] = handle;
+	}
+
+	if (filter->n_pushed != filter->n_rules)
+	{
+		// a partial set would hide results of the rules that did not make it
+		util_scan_filter_remove_push_down(filter);
+		return 0;
+	}
+
+	logi("%d controller filters registered", filter->n_pushed);
+	return filter->n_pushed;
+#else
+	logd("controller filtering needs Tizen 2.4");
+	return 0;
+#endif
+}
+
+
+/**
+ * @function		util_scan_filter_remove_push_down
+ * @since_tizen		2.4
+ * @description		Util Scan Filter Remove Push Down
+ * @parameter		util_scan_filter*: Util Scan Filter Pointer
+ * @return		void
+ */
+void util_scan_filter_remove_push_down(util_scan_filter *filter)
+{
+	RETM_IF(NULL == filter, "filter is NULL");
+
+#ifdef SCAN_FILTER_PUSH_DOWN
+	int i;
+
+	for (i = 0; i < filter->n_pushed; i++)
+	{
+		bt_adapter_le_unregister_scan_filter(filter->pushed[i]);
+		bt_adapter_le_destroy_scan_filter(filter->pushed[i]);
+	}
+	filter->n_pushed = 0;
+#endif
+}
+
+
+/**
+ * @function		util_scan_filter_get_stats
+ * @since_tizen		2.3
+ * @description		Util Scan Filter Get Stats
+ * @parameter		util_scan_filter*: Util Scan Filter Pointer, util_scan_filter_stats*: Util Scan Filter Stats Pointer
+ * @return		void
+ */
+void util_scan_filter_get_stats(util_scan_filter *filter, util_scan_filter_stats *stats)
+{
+	RETM_IF(NULL == filter, "filter is NULL");
+	RETM_IF(NULL == stats, "stats is NULL");
+
+	*stats = filter->stats;
+}
+
+
+/**
+ * @function		util_scan_filter_reset_stats
+ * @since_tizen		2.3
+ * @description		Util Scan Filter Reset Stats
+ * @parameter		util_scan_filter*: Util Scan Filter Pointer
+ * @return		void
+ */
+void util_scan_filter_reset_stats(util_scan_filter *filter)
+{
+	RETM_IF(NULL == filter, "filter is NULL");
+
+	memset(&filter->stats, 0, sizeof(filter->stats));
+}
+
+
+/**
+ * @function		util_scan_filter_info
+ * @since_tizen		2.3
+ * @description		Util Scan Filter Info
+ * @parameter		util_scan_filter*: Util Scan Filter Pointer
+ * @return		void
+ */
+void util_scan_filter_info(util_scan_filter *filter)
+{
+	RETM_IF(NULL == filter, "filter is NULL");
+
+	const uint8_t *code = filter->code;
+	int pc = 0;
+
+	while (pc < filter->code_len)
+	{
+		switch (code[pc])
+		{
+		case OP_RSSI:
+			logi("%04d RSSI   >= %d else %d", pc, (int8_t) code[pc + 1], filter_read16(code + pc + 2));
+			pc += 4;
+			break;
+		case OP_MFR:
+			logi("%04d MFR    %04X/%04X else %d", pc, filter_read16(code + pc + 1), filter_read16(code + pc + 3), filter_read16(code + pc + 5));
+			pc += 7;
+			break;
+		case OP_UUID:
+			logi("%04d UUID   %s else %d", pc, filter->uuid_text[code[pc + 1]], filter_read16(code + pc + 2));
+			pc += 4;
+			break;
+		case OP_NAME:
+			logi("%04d NAME   '%.*s' else %d", pc, code[pc + 3], filter->names + filter_read16(code + pc + 1), filter_read16(code + pc + 4));
+			pc += 6;
+			break;
+		case OP_ACCEPT:
+			logi("%04d ACCEPT", pc);
+			pc += 1;
+			break;
+		default:
+			logi("%04d REJECT", pc);
+			pc += 1;
+			break;
+		}
+	}
+
+	util_scan_filter_stats *s = &filter->stats;
+	logi("evaluated=%lu accepted=%lu rejected=%lu (%.1f%% rejected before allocation)",
+			s->evaluated, s->accepted, s->rejected, s->evaluated ? 100.0 * s->rejected / s->evaluated : 0.0);
+}
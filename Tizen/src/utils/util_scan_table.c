@@ -0,0 +1,425 @@
+/*******************************************************************************
+ * Copyright (c) 2014 Samsung Electronics Co., Ltd.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the License);
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *******************************************************************************/
+
+/**
+ *  @file util_scan_table.c
+ *
+ *	@brief
+ *	Address keyed table of scanned devices
+ *  Implementation of util_scan_table
+ */
+#include "utils/util_scan_table.h"
+
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+
+// define custom logging for the scan table
+#define __LOG(prio, fmt, arg...) dlog_print(prio, "UTIL_SCAN_TABLE", "%s (%d) > " fmt, __func__, __LINE__, ##arg)
+#define logd(fmt, arg...) __LOG(DLOG_DEBUG, fmt, ##arg)
+#define loge(fmt, arg...) __LOG(DLOG_ERROR, fmt, ##arg)
+#define logi(fmt, arg...) __LOG(DLOG_INFO, fmt, ##arg)
+
+
+#define TABLE_MIN_CAPACITY	16
+#define TABLE_NIL			-1
+
+
+// define structures
+typedef struct
+{
+	uint64_t key;
+	void *data;
+} table_entry;
+
+
+struct _util_scan_table
+{
+	table_entry *entries;	// in the order the devices were found
+	int capacity;
+	int count;
+
+	int *slots;	// open addressing index into entries, TABLE_NIL when empty
+	int slot_mask;
+
+	util_scan_table_free_cb free_cb;
+	util_scan_table_stats stats;
+};
+
+
+/**
+ * @function		table_now_ns
+ * @since_tizen		2.3
+ * @description		Monotonic Clock In Nanoseconds
+ * @parameter		NA
+ * @return		static unsigned long long
+ */
+static unsigned long long table_now_ns()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (unsigned long long) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+
+/**
+ * @function		table_hex_value
+ * @since_tizen		2.3
+ * @description		Hex Digit Value
+ * @parameter		char: Char
+ * @return		static int
+ */
+static int table_hex_value(char c)
+{
+	if (c >= '0' && c <= '9') return c - '0';
+	if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+	if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+	return -1;
+}
+
+
+/**
+ * @function		table_address_key
+ * @since_tizen		2.3
+ * @description		Packs "AA:BB:CC:DD:EE:FF" into 48 bits, anything else is FNV-1a hashed
+ * @parameter		const char*: Const char Pointer
+ * @return		static uint64_t
+ */
+static uint64_t table_address_key(const char *address)
+{
+	uint64_t key = 0;
+	int digits = 0;
+	const char *p;
+
+	for (p = address; *p != '\0'; p++)
+	{
+		int v = table_hex_value(*p);
+		if (v >= 0)
+		{
+			key = (key << 4) | (uint64_t) v;
+			digits++;
+		}
+		else if (*p != ':' && *p != '-')
+		{
+			break;
+		}
+	}
+
+	if (*p == '\0' && digits == 12)
+	{
+		return key;
+	}
+
+	key = 1469598103934665603ULL;
+	for (p = address; *p != '\0'; p++)
+	{
+		key ^= (uint8_t) *p;
+		key *= 1099511628211ULL;
+	}
+	// keep hashed keys out of the 48 bit address space
+	return key | (1ULL << 63);
+}
+
+
+/**
+ * @function		table_mix
+ * @since_tizen		2.3
+ * @description		64 Bit Finaliser (splitmix64)
+ * @parameter		uint64_t: Uint64 T
+ * @return		static uint64_t
+ */
+static uint64_t table_mix(uint64_t x)
+{
+	x ^= x >> 30;
+	x *= 0xbf58476d1ce4e5b9ULL;
+	x ^= x >> 27;
+	x *= 0x94d049bb133111ebULL;
+	x ^= x >> 31;
+	return x;
+}
+
+
+/**
+ * @function		table_slot_find
+ * @since_tizen		2.3
+ * @description		Finds The Slot Holding key, Or The Empty Slot Where It Would Go
+ * @parameter		util_scan_table*: Util Scan Table Pointer, uint64_t: Uint64 T
+ * @return		static int
+ */
+static int table_slot_find(util_scan_table *table, uint64_t key)
+{
+	int slot = (int) (table_mix(key) & table->slot_mask);
+	unsigned long probes = 1;
+
+	while (table->slots[slot] != TABLE_NIL && table->entries[table->slots[slot]].key != key)
+	{
+		slot = (slot + 1) & table->slot_mask;
+		probes++;
+	}
+
+	table->stats.probes += probes;
+	if (probes > table->stats.max_probes)
+	{
+		table->stats.max_probes = probes;
+	}
+	return slot;
+}
+
+
+/**
+ * @function		table_resize
+ * @since_tizen		2.3
+ * @description		Makes Room For capacity Entries And Rebuilds The Index At Most Half Full
+ * @parameter		util_scan_table*: Util Scan Table Pointer, int: Int
+ * @return		static bool
+ */
+static bool table_resize(util_scan_table *table, int capacity)
+{
+	int slot_count = 1;
+	int i;
+
+	while (slot_count < capacity * 2)
+	{
+		slot_count <<= 1;
+	}
+
+	table_entry *entries = realloc(table->entries, sizeof(table_entry) * capacity);
+	RETVM_IF(NULL == entries, false, "realloc failed");
+	table->entries = entries;
+	table->capacity = capacity;
+
+	if (table->slots == NULL || slot_count != table->slot_mask + 1)
+	{
+		int *slots = malloc(sizeof(int) * slot_count);
+		RETVM_IF(NULL == slots, false, "malloc failed");
+
+		SAFE_DELETE(table->slots);
+		table->slots = slots;
+		table->slot_mask = slot_count - 1;
+		memset(table->slots, 0xFF, sizeof(int) * slot_count);
+
+		for (i = 0; i < table->count; i++)
+		{
+			table->slots[table_slot_find(table, table->entries[i].key)] = i;
+		}
+	}
+	return true;
+}
+
+
+/**
+ * @function		util_scan_table_create
+ * @since_tizen		2.3
+ * @description		Util Scan Table Create
+ * @parameter		int: Int, util_scan_table_free_cb: Util Scan Table Free Cb
+ * @return		util_scan_table*
+ */
+util_scan_table* util_scan_table_create(int capacity, util_scan_table_free_cb free_cb)
+{
+	RETVM_IF(capacity < 0, NULL, "invalid capacity %d", capacity);
+
+	util_scan_table *table = calloc(1, sizeof(util_scan_table));
+	RETVM_IF(!table, NULL, "calloc failed");
+
+	table->free_cb = free_cb;
+
+	if (!table_resize(table, capacity < TABLE_MIN_CAPACITY ? TABLE_MIN_CAPACITY : capacity))
+	{
+		util_scan_table_destroy(table);
+		return NULL;
+	}
+
+	logi("created: capacity=%d slots=%d", table->capacity, table->slot_mask + 1);
+	return table;
+}
+
+
+/**
+ * @function		util_scan_table_destroy
+ * @since_tizen		2.3
+ * @description		Util Scan Table Destroy
+ * @parameter		util_scan_table*: Util Scan Table Pointer
+ * @return		void
+ */
+void util_scan_table_destroy(util_scan_table *table)
+{
+	if (table == NULL) return;
+
+	if (table->slots != NULL)
+	{
+		util_scan_table_clear(table);
+	}
+	SAFE_DELETE(table->entries);
+	SAFE_DELETE(table->slots);
+	free(table);
+}
+
+
+/**
+ * @function		util_scan_table_clear
+ * @since_tizen		2.3
+ * @description		Util Scan Table Clear
+ * @parameter		util_scan_table*: Util Scan Table Pointer
+ * @return		void
+ */
+void util_scan_table_clear(util_scan_table *table)
+{
+	RETM_IF(NULL == table, "table is NULL");
+
+	int i;
+
+	if (table->free_cb != NULL)
+	{
+		for (i = 0; i < table->count; i++)
+		{
+			table->free_cb(table->entries[i].data);
+		}
+	}
+
+	memset(table->slots, 0xFF, sizeof(int) * (table->slot_mask + 1));
+	memset(&table->stats, 0, sizeof(table->stats));
+	table->count = 0;
+}
+
+
+/**
+ * @function		util_scan_table_find
+ * @since_tizen		2.3
+ * @description		Util Scan Table Find
+ * @parameter		util_scan_table*: Util Scan Table Pointer, const char*: Const char Pointer
+ * @return		void*
+ */
+void* util_scan_table_find(util_scan_table *table, const char *address)
+{
+	RETVM_IF(NULL == table, NULL, "table is NULL");
+	RETVM_IF(NULL == address, NULL, "address is NULL");
+
+	unsigned long long start = table_now_ns();
+	int index = table->slots[table_slot_find(table, table_address_key(address))];
+
+	table->stats.lookups++;
+	if (index != TABLE_NIL)
+	{
+		table->stats.hits++;
+	}
+	table->stats.lookup_ns += table_now_ns() - start;
+
+	if ((table->stats.lookups & 0x3FFF) == 0)
+	{
+		util_scan_table_info(table);
+	}
+	return (index != TABLE_NIL) ? table->entries[index].data : NULL;
+}
+
+
+/**
+ * @function		util_scan_table_insert
+ * @since_tizen		2.3
+ * @description		Util Scan Table Insert
+ * @parameter		util_scan_table*: Util Scan Table Pointer, const char*: Const char Pointer, void*: Void Pointer
+ * @return		bool
+ */
+bool util_scan_table_insert(util_scan_table *table, const char *address, void *data)
+{
+	RETVM_IF(NULL == table, false, "table is NULL");
+	RETVM_IF(NULL == address, false, "address is NULL");
+
+	uint64_t key = table_address_key(address);
+	int slot = table_slot_find(table, key);
+
+	RETVM_IF(table->slots[slot] != TABLE_NIL, false, "%s is already in the table", address);
+
+	if (table->count == table->capacity)
+	{
+		RETVM_IF(!table_resize(table, table->capacity * 2), false, "table full at %d devices", table->count);
+		table->stats.grows++;
+		// the index was rebuilt, look for the slot again
+		slot = table_slot_find(table, key);
+	}
+
+	table->entries[table->count].key = key;
+	table->entries[table->count].data = data;
+	table->slots[slot] = table->count++;
+	table->stats.inserts++;
+	return true;
+}
+
+
+/**
+ * @function		util_scan_table_count
+ * @since_tizen		2.3
+ * @description		Util Scan Table Count
+ * @parameter		util_scan_table*: Util Scan Table Pointer
+ * @return		int
+ */
+int util_scan_table_count(util_scan_table *table)
+{
+	RETVM_IF(NULL == table, 0, "table is NULL");
+
+	return table->count;
+}
+
+
+/**
+ * @function		util_scan_table_get
+ * @since_tizen		2.3
+ * @description		Util Scan Table Get
+ * @parameter		util_scan_table*: Util Scan Table Pointer, int: Int
+ * @return		void*
+ */
+void* util_scan_table_get(util_scan_table *table, int index)
+{
+	RETVM_IF(NULL == table, NULL, "table is NULL");
+	RETVM_IF(index < 0 || index >= table->count, NULL, "index %d out of range", index);
+
+	return table->entries[index].data;
+}
+
+
+/**
+ * @function		util_scan_table_get_stats
+ * @since_tizen		2.3
+ * @description		Util Scan Table Get Stats
+ * @parameter		util_scan_table*: Util Scan Table Pointer, util_scan_table_stats*: Util Scan Table Stats Pointer
+ * @return		void
+ */
+void util_scan_table_get_stats(util_scan_table *table, util_scan_table_stats *stats)
+{
+	RETM_IF(NULL == table, "table is NULL");
+	RETM_IF(NULL == stats, "stats is NULL");
+
+	*stats = table->stats;
+}
+
+
+/**
+ * @function		util_scan_table_info
+ * @since_tizen		2.3
+ * @description		Util Scan Table Info
+ * @parameter		util_scan_table*: Util Scan Table Pointer
+ * @return		void
+ */
+void util_scan_table_info(util_scan_table *table)
+{
+	RETM_IF(NULL == table, "table is NULL");
+
+	util_scan_table_stats *s = &table->stats;
+	unsigned long long avg_ns = s->lookups ? s->lookup_ns / s->lookups : 0;
+
+	logi("devices=%d/%d lookups=%lu hits=%lu inserts=%lu grows=%lu probes=%lu max_probes=%lu avg=%lluns",
+			table->count, table->capacity, s->lookups, s->hits, s->inserts, s->grows, s->probes, s->max_probes, avg_ns);
+}
@@ -36,11 +36,14 @@
 #include "utils/config.h"
 #include "utils/ui-utils.h"
 #include "utils/util_state_object.h"
+#include "utils/util_refresh.h"
 #include "view/tbt-bluetooth-view.h"
 #include "view/tbt-common-view.h"
 
 #define IS_ON_OFF_APP_AVAILABLE false
 #define BT_PUSH_FILE_NAME "dial.png"
+//Discovery results are redrawn at most this often (seconds)
+#define BT_DISCOVERY_REFRESH_INTERVAL 0.25
 
 
 
@@ -88,6 +91,8 @@ struct _bluetooth_view
 	common_view* view;
 
 	GList *devices_list;
+	GList *shown_devices_tail;
+	util_refresh *devices_refresh;
 	GList *bonded_devices_list;
 	GList *selected_device_profile_list;
 	GList *service_list;
@@ -141,6 +146,7 @@ static int create_rfcomm_server(bluetooth_view *this);
 static Evas_Object *add_control_layout(bluetooth_view *this, Evas_Object *parent);
 static void update_view_controls(bluetooth_view *this);
 static void discovered_devices_list_show(bluetooth_view *this);
+static void _devices_refresh_cb(void *data);
 static bool is_new_device_found(bluetooth_view *this, bt_adapter_device_discovery_info_s *discovery_info);
 static void set_connected_profiles(bluetooth_view *this);
 static int update_bonded_devices(bluetooth_view *this);
@@ -258,6 +264,7 @@ bluetooth_view *bluetooth_view_add(Evas_Object *navi, tbt_info *tbt_info, Elm_Ob
 	RETVM_IF(!this->bluetooth_list, NULL, "elm_list_add failed");
 	evas_object_data_set(this->bluetooth_list, "bluetooth_view", this);
 	elm_object_part_content_set(this->view->layout, "bluetooth_list", this->bluetooth_list);
+	this->devices_refresh = util_refresh_create(BT_DISCOVERY_REFRESH_INTERVAL, _devices_refresh_cb, this);
 
 	if(strcmp(tbt_info->layout_group, "bluetooth_viewer_cancel_check") == 0)
 	{
@@ -487,20 +494,22 @@ static void update_view_controls(bluetooth_view *this)
 				elm_object_disabled_set(this->bluetooth_btn, EINA_TRUE);
 				elm_object_text_set(this->bluetooth_btn, "Discover");
 				ui_utils_label_set_text(this->bluetooth_label, "Discovery Started...", "left");
-				discovered_devices_list_show(this);
+				util_refresh_request(this->devices_refresh);
 			}
 			else if(this->discovery_state == BT_ADAPTER_DEVICE_DISCOVERY_FOUND)
 			{
 				elm_object_disabled_set(this->bluetooth_btn, EINA_TRUE);
 				elm_object_text_set(this->bluetooth_btn, "Discover");
 				ui_utils_label_set_text(this->bluetooth_label, "Discovery Found...", "left");
-				discovered_devices_list_show(this);
+				util_refresh_request(this->devices_refresh);
 			}
 			else if(this->discovery_state == BT_ADAPTER_DEVICE_DISCOVERY_FINISHED)
 			{
 //				result = bt_adapter_stop_device_discovery();
 //				RETM_IF(result != BT_ERROR_NONE, "bt_adapter_stop_device_discovery fail > Error = %s", get_bluetooth_error(result));
 				this->discovery_state = BT_ADAPTER_DEVICE_DISCOVERY_NONE;
+				//Show the last devices found right away
+				util_refresh_flush(this->devices_refresh);
 
 				elm_object_disabled_set(this->bluetooth_btn, EINA_FALSE);
 				elm_object_text_set(this->bluetooth_btn, "Discover");
@@ -838,15 +847,24 @@ static void discovered_devices_list_show(bluetooth_view *this)
 	DBG(" discovered_devices_list_show ");
 	RETM_IF(NULL == this, "view is NULL");
 
-	elm_list_clear(this->bluetooth_list);
-
-	int ret;
 	GList *l;
 	bt_adapter_device_discovery_info_s *device_info;
 
-	for(l = this->devices_list; l != NULL; l = l->next)
+	//Devices are only ever appended, rows already in the list stay; start over only if someone else cleared it
+	if(this->shown_devices_tail == NULL)
+	{
+		elm_list_clear(this->bluetooth_list);
+		l = this->devices_list;
+	}
+	else
+	{
+		l = this->shown_devices_tail->next;
+	}
+
+	for(; l != NULL; l = l->next)
 	{
 		device_info = (bt_adapter_device_discovery_info_s*)l->data;
+		this->shown_devices_tail = l;
 
 		if(NULL != device_info)
 		{
@@ -856,7 +874,10 @@ static void discovered_devices_list_show(bluetooth_view *this)
 			}
 			else
 			{
-				elm_list_item_append(this->bluetooth_list, format_string("%s(Paired)", device_info->remote_name), NULL, NULL, _device_item_selected_cb, device_info);
+				//The list copies the label
+				char *label = format_string("%s(Paired)", device_info->remote_name);
+				elm_list_item_append(this->bluetooth_list, label, NULL, NULL, _device_item_selected_cb, device_info);
+				SAFE_DELETE(label);
 				elm_object_disabled_set(this->action_btn, EINA_FALSE);
 
 			}
@@ -868,6 +889,23 @@ static void discovered_devices_list_show(bluetooth_view *this)
 }
 
 
+/**
+ * @function		_devices_refresh_cb
+ * @since_tizen		2.3
+ * @description		 Devices Refresh Cb
+ * @parameter		void*: Void Pointer
+ * @return		static void
+ */
+static void _devices_refresh_cb(void *data)
+{
+	bluetooth_view *this = NULL;
+	this = (bluetooth_view*)data;
+	RETM_IF(NULL == this, "view is NULL");
+
+	discovered_devices_list_show(this);
+}
+
+
 /**
  * @function		set_connected_profiles
  * @since_tizen		2.3
@@ -1322,6 +1360,7 @@ static void _control_button_pressed_cb(void *data, Evas_Object *obj, void *event
 
 		GList *l;
 		elm_list_clear(this->bluetooth_list);
+		this->shown_devices_tail = NULL;
 		elm_object_text_set(this->bluetooth_label, "Connected Service Classes:");
 		for(l = this->service_list; l != NULL; l = l->next)
 		{
@@ -1536,6 +1575,10 @@ static void _adapter_device_discovery_state_changed_cb(int result, bt_adapter_de
 
    if(this->discovery_state == BT_ADAPTER_DEVICE_DISCOVERY_STARTED)
    {
+	   //The rows point into the device list, take them down with it
+	   util_refresh_cancel(this->devices_refresh);
+	   elm_list_clear(this->bluetooth_list);
+	   this->shown_devices_tail = NULL;
 	   g_list_free_full(this->devices_list, bluetooth_list_free_func_cb);
 	   this->devices_list = NULL;
    }
@@ -2165,6 +2208,7 @@ static bool _adapter_device_connected_profile_cb(bt_profile_e profile, void *dat
 		str = format_string("%s(Profiles)",this->selected_device_info->remote_name);
 		ui_utils_label_set_text(this->bluetooth_label,str , "left");
 		elm_list_clear(this->bluetooth_list);
+		this->shown_devices_tail = NULL;
 		elm_list_item_append(this->bluetooth_list, this->selected_device_info->remote_name, NULL, NULL, NULL, NULL);
 		SAFE_DELETE(str);
 	}
@@ -2367,6 +2411,10 @@ static void _app_destroy_cb(void* this)
 	view = (bluetooth_view*)this;
 	RETM_IF(NULL == view, "view is NULL");
 
+	//Before anything can return early, the timer must not fire on a dead view
+	util_refresh_destroy(view->devices_refresh);
+	view->devices_refresh = NULL;
+
 	#ifdef DEVICE_TYPE_WEARABLE
 		if(get_device_type() == DEVICE_WEARABLE_320_X_320)
 		{
@@ -2967,7 +3015,9 @@ switch(now)
 
 				elm_object_disabled_set(this->action_btn, EINA_FALSE);
 				evas_object_data_set(this->bluetooth_list, "bluetooth_view", this);
-				elm_object_item_text_set(this->selected_device_item, format_string("%s(Paired)", this->selected_device_info->remote_name));
+				char *label = format_string("%s(Paired)", this->selected_device_info->remote_name);
+				elm_object_item_text_set(this->selected_device_item, label);
+				SAFE_DELETE(label);
 				#ifdef TIZEN_3_0
 					ui_utils_label_set_text(this->bluetooth_label, "Paired", "left");
 				#endif
@@ -32,11 +32,67 @@
 #include "utils/logger.h"
 #include "utils/config.h"
 #include "utils/ui-utils.h"
+#include "utils/util_scan_table.h"
+#include "utils/util_adv_data.h"
+#include "utils/util_scan_filter.h"
+#include "utils/util_beacon.h"
+#include "utils/util_refresh.h"
+#include "utils/util_gatt_names.h"
+#include "utils/util_gatt_arena.h"
+#include "utils/util_notify_ring.h"
+#include "utils/util_read_queue.h"
+#include "utils/util_pacer.h"
+#include "utils/util_advertiser.h"
+#include "utils/util_gatt_format.h"
+#include "utils/util_gatt_transfer.h"
+#include "utils/util_event_journal.h"
 #include "view/tbt-bluetoothle-view.h"
 #include "view/tbt-common-view.h"
 #include "bluetooth_internal.h"
 
 #define BT_ADAPTER_DEVICE_DISCOVERY_NONE -1
+#define BT_LE_SCAN_TABLE_CAPACITY 256
+//Scan filter, see util_scan_filter.h for the syntax. Empty accepts every device.
+#define BT_LE_SCAN_FILTER ""
+#define BT_LE_BEACON_CAPACITY 128
+#define BT_LE_BEACON_PATH_LOSS 2.0
+#define BT_LE_BEACON_TIMEOUT_MS 10000
+#define BT_LE_BEACON_RANKED 5
+//Scan results are redrawn at most this often (seconds)
+#define BT_LE_SCAN_REFRESH_INTERVAL 0.25
+//Initial size of the attribute arena, it doubles as needed
+#define BT_LE_GATT_ARENA_CAPACITY 64
+//Notifications kept, bytes kept of each (largest attribute value, ATT MTU 517 - 3), how many are shown and how many bytes of each
+#define BT_LE_NOTIFY_CAPACITY 256
+#define BT_LE_NOTIFY_MAX_PAYLOAD 512
+#define BT_LE_NOTIFY_SHOWN 5
+#define BT_LE_NOTIFY_SHOWN_BYTES 32
+#define BT_LE_NOTIFY_REFRESH_INTERVAL 0.5
+//Reads kept in flight by Read All
+#define BT_LE_BULK_READ_IN_FLIGHT 4
+#define BT_LE_BULK_READ_SHOWN_BYTES 16
+#define BT_LE_VALUE_TEXT_SIZE 256
+//Peripherals the GATT client keeps connected at once, the table remembers a few more
+#define BT_LE_MAX_LINKS 4
+#define BT_LE_LINK_TABLE_CAPACITY 16
+//Throughput test service of the GATT server. Rate in notifications per second, payload at most the ATT MTU - 3.
+#define BT_LE_STREAM_SERVICE_UUID "a5f0c1e0-7a4d-4b7e-9d2f-0c1a2b3c4d5e"
+#define BT_LE_STREAM_CHAR_UUID "a5f0c1e1-7a4d-4b7e-9d2f-0c1a2b3c4d5e"
+#define BT_LE_STREAM_RATE 100
+#define BT_LE_STREAM_PAYLOAD 20
+#define BT_LE_STREAM_TICK 0.01
+#define BT_LE_STREAM_BURST 8
+#define BT_LE_STREAM_MAX_OUTSTANDING 16
+#define BT_LE_STREAM_REPORT_TICKS 100
+//The GATT server advertises its battery level, alternating with an Eddystone-TLM frame
+#define BT_LE_ADV_INTERVAL_MS 500
+#define BT_LE_ADV_ROTATE_PERIOD 2.0
+#define BT_LE_ADV_SLOT_BATTERY 0
+#define BT_LE_ADV_SLOT_TLM 1
+//Event journal in TBT_LOGGING_DIR, records kept between flushes and how often they go to the file (seconds)
+#define BT_LE_JOURNAL_FILE "tbt-ble-journal.bin"
+#define BT_LE_JOURNAL_CAPACITY 1024
+#define BT_LE_JOURNAL_FLUSH_INTERVAL 1.0
 
 typedef enum
 {
@@ -61,9 +117,32 @@ typedef struct {
 	bt_gatt_h desc;
 } gatt_handle_t;
 
+//Where the database walk is adding attributes
+typedef struct {
+	util_gatt_arena *arena;
+	int parent;
+} attribute_walk_t;
+
+//One peripheral of the GATT client, everything cached for it lives and dies with its connection
+typedef struct {
+	bluetoothle_view *view;
+	char *address;
+	bt_gatt_client_h client;		//NULL while disconnected, the entry stays for the next connection
+	util_gatt_arena *attributes;
+	util_gatt_format_cache *formats;
+	bt_gatt_h format_pending;
+	util_read_queue *bulk_read;		//results of the last Read All stay until the next one or a disconnect
+	int bulk_formats;
+	bool bulk_unseen;			//Read All finished while another link was selected
+	util_gatt_transfer *transfers;		//kept across connections, the figures are per link
+	double read_ms;
+	bt_gatt_h write_back_h;
+	double connected_since;
+	int journal_link;		//address index in the journal
+} gatt_link_t;
+
 bt_gatt_server_h server;
 gatt_handle_t battery_h;
-bt_advertiser_h advertiser;
 
 
 
@@ -71,6 +150,10 @@ bt_advertiser_h advertiser;
 struct _bluetoothle_view
 {
 	Evas_Object* bluetoothle_list;
+	Evas_Object* devices_genlist;
+	Elm_Genlist_Item_Class *device_itc;
+	int n_device_items;
+	util_refresh *devices_refresh;
 	Evas_Object* bluetoothle_label;
 	Evas_Object *bluetoothle_btn;
 	Evas_Object *read_btn;
@@ -78,27 +161,56 @@ struct _bluetoothle_view
 	Evas_Object *write_btn;
 	Evas_Object *expand_btn;
 	Evas_Object *services_btn;
+	Evas_Object *read_all_btn;
+	Evas_Object *stream_btn;
+	Evas_Object *write_back_btn;
+	Evas_Object *links_btn;
 	Evas_Object *character_btn;
 	Evas_Object *bluetoothle_btn2;
 	bt_adapter_state_e adapter_state;
 	bt_adapter_visibility_mode_e visibility_mode;
 	common_view* view;
-	char *remote_addr;
 
 	bt_adapter_le_device_scan_result_info_s *scan_info;
 	bt_adapter_le_device_discovery_state_e discovery_state;
 
 	Elm_Object_Item *selected_device_item;
 
-	GList *devices_list;
-	GList *log_list;
-	bt_gatt_client_h client;
+	util_scan_table *devices;
+	util_scan_filter *scan_filter;
+	util_beacon_tracker *beacons;
+	Ecore_Timer *beacon_timer;
 	bt_gatt_h gatt_handle;
 	bt_gatt_h characterstic_h, service_h, descriptor_h;
 	bool is_read_completed;
 
-	bt_gatt_h all_characteristics[1000];
-	int n_characteristics;
+	//Connection table keyed by address, the buttons act on the selected link
+	util_scan_table *links;
+	gatt_link_t *link;
+	gatt_link_t *connecting;		//asked for by the user, selected once it is up
+
+	//Timeline of scans, connections and transfers, NULL when there is no logging directory
+	util_event_journal *journal;
+
+	//Notifications of the watched characteristic, shown in a fixed set of rows
+	bt_gatt_h notify_h;
+	gatt_link_t *notify_link;
+	util_notify_ring *notifications;
+	util_refresh *notify_refresh;
+	Elm_Object_Item *notify_stats_item;
+	Elm_Object_Item *notify_items[BT_LE_NOTIFY_SHOWN];
+
+	//Throughput stream of the GATT server, notifications go out only while a client is subscribed
+	bt_gatt_h stream_chr;
+	bool stream_subscribed;
+	util_pacer *stream_pacer;
+	Ecore_Timer *stream_timer;
+	unsigned int stream_seq;
+	unsigned long stream_ticks;
+
+	//Created on the first battery level change, kept until the view goes
+	util_advertiser *advertiser;
+	double advertising_since;
 
 	bt_gatt_type_e type;
 	bool is_int;
@@ -109,11 +221,15 @@ static void _app_destroy_cb(void* this);
 static void init_bluetooth(void* user_data);
 static void _adapter_state_changed_cb(int result, bt_adapter_state_e adapter_state, void *user_data);
 static void discover_bluetooth_le(void* user_data);
+static Eina_Bool _beacon_rank_timer_cb(void *data);
 static void  _bt_adapter_le_scan_result_cb(int result, bt_adapter_le_device_scan_result_info_s *info, void *user_data);
-static bool is_new_scanned_device_found(bluetoothle_view *this, bt_adapter_le_device_scan_result_info_s *discovery_info);
-static gint bluetooth_list_find_func_cb(gconstpointer a, gconstpointer b);
+static void update_scanned_device(bt_adapter_le_device_scan_result_info_s *device_info, bt_adapter_le_device_scan_result_info_s *info);
 static void bluetooth_list_free_func_cb(gpointer data);
+static char *copy_adv_payload(const char *payload, int len);
 static void update_view_controls(bluetoothle_view *this);
+static void _devices_refresh_cb(void *data);
+static void show_list(bluetoothle_view *this, Evas_Object *list);
+static char *_device_text_get_cb(void *data, Evas_Object *obj, const char *part);
 static void discovered_devices_list_show(bluetoothle_view *this);
 static void _device_item_selected_cb(void *data, Evas_Object *obj, void *event_info);
 static void _sevice_selected_cb(void *data, Evas_Object *obj, void *event_info);
@@ -142,172 +258,29 @@ static void _bt_gatt_client_write_request_completed_cb(int result, bt_gatt_h req
 static void _bt_gatt_client_read_request_completed_cb(int result, bt_gatt_h request_handle, void *user_data);
 static bool _bt_gatt_foreach_descriptors_cb(int total, int index, bt_gatt_h gatt_handle, void *user_data);
 static void _bt_gatt_client_characteristic_value_changed_cb(bt_gatt_h characteristic, char *value, int len, void *user_data);
-static void log_list_free_func_cb(gpointer data);
+static void load_attributes(gatt_link_t *link);
+static void release_attributes(gatt_link_t *link);
+static void watch_notifications(bluetoothle_view *this, bt_gatt_h characteristic);
+static void _notify_refresh_cb(void *data);
+static void _read_all_button_pressed_cb(void *user_data, Evas_Object *obj, void *event_info);
+static void _read_service_item_cb(void *data, Evas_Object *obj, void *event_info);
+static void bulk_read_start(bluetoothle_view *this, bt_gatt_h service_h);
+static void bulk_read_show(bluetoothle_view *this, gatt_link_t *link);
+static void _stream_button_pressed_cb(void *user_data, Evas_Object *obj, void *event_info);
+static void register_stream_service(bluetoothle_view *this);
+static void stream_stop(bluetoothle_view *this);
+static void _write_back_button_pressed_cb(void *user_data, Evas_Object *obj, void *event_info);
+static void update_att_mtu(gatt_link_t *link);
+static void _links_button_pressed_cb(void *user_data, Evas_Object *obj, void *event_info);
+static void link_free_cb(void *data);
+static void link_select(bluetoothle_view *this, gatt_link_t *link);
+static gatt_link_t *link_find_or_add(bluetoothle_view *this, const char *address);
+static int links_connected(bluetoothle_view *this);
+static void link_connect(bluetoothle_view *this, gatt_link_t *link);
+static void link_journal_add(gatt_link_t *link, util_event_type type, bt_gatt_h h, int len, int result);
 
 int scan_cb_count = 0;
 
-int bt_gatt_get_specification_name(const char *uuid, char **name)
-{
-	int i;
-	int offset = 0;
-	static struct {
-		const char *uuid;
-		const char *specification_name;
-	} bt_uuid_name[] = {
-		/* GATT Services */
-		{"1800", "Generic Access"},
-		{"1801", "Generic Attribute"},
-		{"1802", "Immediate Alert"},
-		{"1803", "Link Loss"},
-		{"1804", "Tx Power"},
-		{"1805", "Current Time Service"},
-		{"1806", "Reference Time Update Service"},
-		{"1807", "Next DST Change Service"},
-		{"1808", "Glucose"},
-		{"1809", "Health Thermometer"},
-		{"180A", "Device Information"},
-		{"180D", "Heart Rate"},
-		{"180e", "Phone Alert Status Service"},
-		{"180F", "Battery Service"},
-		{"1810", "Blood Pressure"},
-		{"1811", "Alert Notification Service"},
-		{"1812", "Human Interface Device"},
-		{"1813", "Scan Parameters"},
-		{"1814", "Running Speed and Cadence"},
-		{"1816", "Cycling Speed and Cadence"},
-		{"1818", "Cycling Power"},
-		{"1819", "Location and Navigation"},
-
-		/* GATT Declarations */
-		{"2800", "Primary Service Declaration"},
-		{"2801", "Secondary Service Declaration"},
-		{"2802", "Include Declaration"},
-		{"2803", "Characteristic Declaration"},
-
-		/* GATT Descriptors */
-		{"2900", "Characteristic Extended Properties"},
-		{"2901", "Characteristic User Description"},
-		{"2902", "Client Characteristic Configuration"},
-		{"2903", "Server Characteristic Configuration"},
-		{"2904", "Characteristic Format"},
-		{"2905", "Characteristic Aggregate Formate"},
-		{"2906", "Valid Range"},
-		{"2907", "External Report Reference"},
-		{"2908", "Report Reference"},
-
-		/* GATT Characteristics */
-
-		{"2a43", "Alert Category ID"},
-		{"2a42", "Alert Category ID Bit Mask"},
-		{"2a06", "Alert Level"},
-		{"2a44", "Alert Notification Control Point"},
-		{"2a3f", "Alert Status"},
-		{"2a01", "Appearance"},
-		{"2a19", "Battery Level"},
-		{"2a49", "Blood Pressure Feature"},
-		{"2a35", "Blood Pressure Measurement"},
-		{"2a38", "Body Sensor Location"},
-		{"2a22", "Boot Keyboard Input Report"},
-		{"2a32", "Boot Keyboard Output Report"},
-		{"2a33", "Boot Mouse Input Report"},
-		{"2a5c", "CSC Feature"},
-		{"2a5b", "CSC Measurement"},
-		{"2a2b", "Current Time"},
-		{"2a66", "Cycling Power Control Point"},
-		{"2a65", "Cycling Power Feature"},
-		{"2a63", "Cycling Power Measurement"},
-		{"2a64", "Cycling Power Vector"},
-		{"2a08", "Date Time"},
-		{"2a0a", "Day Date Time"},
-		{"2a09", "Day of Week"},
-		{"2a00", "Device Name"},
-		{"2a0d", "DST Offset"},
-		{"2a0c", "Exact Time 256"},
-		{"2a26", "Firmware Revision String"},
-		{"2a51", "Glucose Feature"},
-		{"2a18", "Glucose Measurement"},
-		{"2a34", "Glucose Measurement Context"},
-		{"2a27", "Hardware Revision String"},
-		{"2a39", "Heart Rate Control Point"},
-		{"2a37", "Heart Rate Measurement"},
-		{"2a4c", "HID Control Point"},
-		{"2a4a", "HID Information"},
-		{"2a2a", "IEEE 11073-20601 Regulatory Certification Data List"},
-		{"2a36", "Intermediate Cuff Pressure"},
-		{"2a1e", "Intermediate Temperature"},
-		{"2a6b", "LN Control Point"},
-		{"2a6a", "LN Feature"},
-		{"2a0f", "Local Time Information"},
-		{"2a67", "Location and Speed"},
-		{"2a29", "Manufacturer Name String"},
-		{"2a21", "Measurement Interval"},
-		{"2a24", "Model Number String"},
-		{"2a68", "Navigation"},
-		{"2a46", "New Alert"},
-		{"2a04", "Peripheral Preferred Connection Parameters"},
-		{"2a02", "Peripheral Privacy Flag"},
-		{"2a50", "PnP ID"},
-		{"2a69", "Position Quality"},
-		{"2a4e", "Protocol Mode"},
-		{"2a03", "Reconnection Address"},
-		{"2a52", "Record Access Control Point"},
-		{"2a14", "Reference Time Information"},
-		{"2a4d", "Report"},
-		{"2a4b", "Report Map"},
-		{"2a40", "Ringer Control Point"},
-		{"2a41", "Ringer Setting"},
-		{"2a54", "RSC Feature"},
-		{"2a53", "RSC Measurement"},
-		{"2a55", "SC Control Point"},
-		{"2a4f", "Scan Interval Window"},
-		{"2a31", "Scan Refresh"},
-		{"2a5d", "Sensor Location"},
-		{"2a25", "Serial Number String"},
-		{"2a05", "Service Changed"},
-		{"2a28", "Software Revision String"},
-		{"2a47", "Supported New Alert Category"},
-		{"2a48", "Supported Unread Alert Category"},
-		{"2a23", "System ID"},
-		{"2a1c", "Temperature Measurement"},
-		{"2a1d", "Temperature Type"},
-		{"2a12", "Time Accuracy"},
-		{"2a13", "Time Source"},
-		{"2a16", "Time Update Control Point"},
-		{"2a17", "Time Update State"},
-		{"2a11", "Time with DST"},
-		{"2a0e", "Time Zone"},
-		{"2a07", "Tx Power Level"},
-		{"2a45", "Unread Alert Status"},
-
-		{NULL, NULL}
-	};
-#if 0
-	if (strlen(uuid) >= 8)
-		offset = 4;
-
-	for (i = 0; bt_uuid_name[i].uuid; i++) {
-		if (!g_ascii_strncasecmp(uuid + offset, bt_uuid_name[i].uuid, 4)) {
-			*name = g_strdup(bt_uuid_name[i].specification_name);
-			return BT_ERROR_NONE;
-		}
-	}
-
-	*name = g_strdup("Unknown");
-#else
-
-	*name = (char *)malloc(sizeof(char)*5);
-	*(*name) = *(uuid + 4);
-	*(*name + 1) = *(uuid + 5);
-	*(*name + 2) = *(uuid + 6);
-	*(*name + 3) = *(uuid + 7);
-	*(*name + 4) = '\0';
-
-#endif
-
-
-	return BT_ERROR_NONE;
-}
-
 
 /**
  * @function		bluetoothle_view_add
@@ -340,6 +313,17 @@ bluetoothle_view *bluetoothle_view_add(Evas_Object *navi, tbt_info *tbt_info, El
 	this->scan_info = NULL;
 	this->is_read_completed = true;
 	this->is_int = true;
+	this->devices = util_scan_table_create(BT_LE_SCAN_TABLE_CAPACITY, bluetooth_list_free_func_cb);
+	this->links = util_scan_table_create(BT_LE_LINK_TABLE_CAPACITY, link_free_cb);
+	this->scan_filter = util_scan_filter_compile(BT_LE_SCAN_FILTER);
+	this->beacons = util_beacon_tracker_create(BT_LE_BEACON_CAPACITY, BT_LE_BEACON_PATH_LOSS, BT_LE_BEACON_TIMEOUT_MS);
+
+	if (TBT_LOGGING_DIR != NULL)
+	{
+		char *journal_path = format_string("%s/%s", TBT_LOGGING_DIR, BT_LE_JOURNAL_FILE);
+		this->journal = util_event_journal_create(journal_path, BT_LE_JOURNAL_CAPACITY, BT_LE_JOURNAL_FLUSH_INTERVAL);
+		SAFE_DELETE(journal_path);
+	}
 
 	//Add Label, Button and List
     this->bluetoothle_label = ui_utils_label_add(this->view->layout, "BLE");
@@ -353,6 +337,24 @@ bluetoothle_view *bluetoothle_view_add(Evas_Object *navi, tbt_info *tbt_info, El
 	evas_object_size_hint_weight_set(this->bluetoothle_list, EVAS_HINT_EXPAND, EVAS_HINT_EXPAND);
 	evas_object_size_hint_align_set(this->bluetoothle_list, EVAS_HINT_FILL, EVAS_HINT_FILL);
 
+	//Scan results get their own genlist, only the visible rows are realized however many devices are found
+	this->devices_genlist = elm_genlist_add(this->view->layout);
+	RETVM_IF(!this->devices_genlist, NULL, "elm_genlist_add failed");
+	evas_object_data_set(this->devices_genlist, "bluetooth_view", this);
+	elm_genlist_homogeneous_set(this->devices_genlist, EINA_TRUE);
+	elm_genlist_mode_set(this->devices_genlist, ELM_LIST_COMPRESS);
+	evas_object_size_hint_weight_set(this->devices_genlist, EVAS_HINT_EXPAND, EVAS_HINT_EXPAND);
+	evas_object_size_hint_align_set(this->devices_genlist, EVAS_HINT_FILL, EVAS_HINT_FILL);
+
+	this->device_itc = elm_genlist_item_class_new();
+	RETVM_IF(!this->device_itc, NULL, "elm_genlist_item_class_new failed");
+	this->device_itc->item_style = "default";
+	this->device_itc->func.text_get = _device_text_get_cb;
+
+	this->devices_refresh = util_refresh_create(BT_LE_SCAN_REFRESH_INTERVAL, _devices_refresh_cb, this);
+	this->notifications = util_notify_ring_create(BT_LE_NOTIFY_CAPACITY, BT_LE_NOTIFY_MAX_PAYLOAD);
+	this->notify_refresh = util_refresh_create(BT_LE_NOTIFY_REFRESH_INTERVAL, _notify_refresh_cb, this);
+
 	Evas_Object *control = add_control_layout(this, this->view->layout);
 	elm_object_part_content_set(this->view->layout, "controlr_part", control);
 
@@ -378,11 +380,30 @@ static void discover_bluetooth_le(void* user_data)
 	this = (bluetoothle_view*)user_data;
 	RETM_IF(NULL == this, "view is NULL");
 
-	g_list_free_full(this->devices_list, bluetooth_list_free_func_cb);
-	this->devices_list = NULL;
+	//The rows point into the table, take them down first
+	util_refresh_cancel(this->devices_refresh);
+	elm_genlist_clear(this->devices_genlist);
+	this->n_device_items = 0;
+	util_scan_table_clear(this->devices);
+
+	if (this->scan_filter != NULL)
+	{
+		util_scan_filter_reset_stats(this->scan_filter);
+		util_scan_filter_push_down(this->scan_filter);
+	}
+
+	if (this->beacons != NULL)
+	{
+		util_beacon_tracker_clear(this->beacons);
+		if (this->beacon_timer == NULL)
+		{
+			this->beacon_timer = ecore_timer_add(1, _beacon_rank_timer_cb, this);
+		}
+	}
 
 	ui_utils_label_set_text(this->bluetoothle_label, "Device Discovery Started", "left");
 	result = bt_adapter_le_start_scan(_bt_adapter_le_scan_result_cb, this);
+	util_event_journal_add(this->journal, UTIL_EVENT_SCAN_START, UTIL_EVENT_NO_LINK, UTIL_EVENT_NO_HANDLE, 0, result);
 	RETM_IF(result != BT_ERROR_NONE, "bt_adapter_le_start_scan failed --> error: %s", get_bluetooth_error(result));
 }
 
@@ -471,35 +492,6 @@ static void _adapter_state_changed_cb(int result, bt_adapter_state_e adapter_sta
 }
 
 
-/**
- * @function		is_new_scanned_device_found
- * @since_tizen		2.3
- * @description		Is New Scanned Device Found
- * @parameter		bluetoothle_view*: Bluetoothle View Pointer, bt_adapter_le_device_scan_result_info_s*: Bt Adapter Le Device Scan Result Info S Pointer
- * @return		static bool
- */
-static bool is_new_scanned_device_found(bluetoothle_view *this, bt_adapter_le_device_scan_result_info_s *discovery_info)
-{
-
-	DBG(" is_new_scanned_device_found ");
-	RETVM_IF(NULL == this, NULL, "view is NULL");
-	RETVM_IF(NULL == discovery_info, NULL, "discovery_info is NULL");
-
-	GList *old_device = NULL;
-	int result = false;
-
-
-	old_device = g_list_find_custom (this->devices_list, discovery_info, bluetooth_list_find_func_cb);
-
-	if(old_device == NULL)
-	{
-		result = true;
-	}
-
-	return result;
-}
-
-
 /**
  * @function		add_control_layout
  * @since_tizen		2.3
@@ -541,9 +533,20 @@ static Evas_Object *add_control_layout(bluetoothle_view *this, Evas_Object *pare
 		this->disconnect_btn = ui_utils_push_button_add(this, table, "Disconnect", _disconnect_button_pressed_cb);
 		elm_table_pack(table, this->disconnect_btn, 1, 1, 1, 1);
 
+		this->read_all_btn = ui_utils_push_button_add(this, table, "Read All", _read_all_button_pressed_cb);
+		elm_table_pack(table, this->read_all_btn, 0, 2, 2, 1);
+
+		this->write_back_btn = ui_utils_push_button_add(this, table, "Write Back", _write_back_button_pressed_cb);
+		elm_table_pack(table, this->write_back_btn, 0, 3, 1, 1);
+
+		this->links_btn = ui_utils_push_button_add(this, table, "Links", _links_button_pressed_cb);
+		elm_table_pack(table, this->links_btn, 1, 3, 1, 1);
+
 //		set_control_btn_state(SERVICE_LISTED, this);
 		elm_object_disabled_set(this->services_btn, EINA_TRUE);
 		elm_object_disabled_set(this->disconnect_btn, EINA_TRUE);
+		elm_object_disabled_set(this->read_all_btn, EINA_TRUE);
+		elm_object_disabled_set(this->write_back_btn, EINA_TRUE);
 
     }
 	else if(this->view->tbt_info->apptype == TBT_APP_BLE_GATT_SERVER)
@@ -569,6 +572,10 @@ static Evas_Object *add_control_layout(bluetoothle_view *this, Evas_Object *pare
 		this->read_btn = ui_utils_push_button_add(this, table, "Change Battery Level", _battery_level_change_cb);
 		elm_table_pack(table, this->read_btn, 0, 1, 3, 1);
 
+		this->stream_btn = ui_utils_push_button_add(this, table, "Start Stream", _stream_button_pressed_cb);
+		elm_table_pack(table, this->stream_btn, 0, 2, 3, 1);
+		elm_object_disabled_set(this->stream_btn, EINA_TRUE);
+
 //		this->write_btn = ui_utils_push_button_add(this, table, "Write", _write_button_pressed_cb);
 //		elm_table_pack(table, this->write_btn, 0, 2, 1, 1);
 
@@ -687,13 +694,44 @@ void __bt_gatt_server_notification_state_change_cb (bool notify,
 	DBG("gatt_handle %s", (char *)gatt_handle);
 }
 
-static void __bt_adapter_le_advertising_state_changed_cb(int result,
-		bt_advertiser_h advertiser, bt_adapter_le_advertising_state_e adv_state, void *user_data)
+/**
+ * @function		advertise_tlm
+ * @since_tizen		2.3
+ * @description		Eddystone-TLM Frame: No Battery Voltage Or Temperature, Estimated Frame Count And Uptime
+ * @parameter		bluetoothle_view*: Bluetoothle View Pointer
+ * @return		static void
+ */
+static void advertise_tlm(bluetoothle_view *this)
+{
+	double up = ecore_time_get() - this->advertising_since;
+	unsigned int frames = (unsigned int) (up * 1000 / BT_LE_ADV_INTERVAL_MS);
+	unsigned int tenths = (unsigned int) (up * 10);
+	char tlm[14] = {0x20, 0x00, 0x00, 0x00, (char)0x80, 0x00,
+			frames >> 24, frames >> 16, frames >> 8, frames,
+			tenths >> 24, tenths >> 16, tenths >> 8, tenths};
+
+	util_advertiser_set_payload(this->advertiser, BT_LE_ADV_SLOT_TLM, "feaa", tlm, sizeof(tlm));
+}
+
+
+/**
+ * @function		_advertiser_rotate_cb
+ * @since_tizen		2.3
+ * @description		 Advertiser Rotate Cb
+ * @parameter		util_advertiser*: Util Advertiser Pointer, int: Int, void*: Void Pointer
+ * @return		static void
+ */
+static void _advertiser_rotate_cb(util_advertiser *adv, int slot, void *data)
 {
-	DBG("Result : %d", result);
-	DBG("Advertiser : %p", advertiser);
-	DBG("Advertising %s [%d]", adv_state == BT_ADAPTER_LE_ADVERTISING_STARTED ?
-				"started" : "stopped", adv_state);
+	bluetoothle_view *this = NULL;
+	this = (bluetoothle_view*)data;
+	RETM_IF(NULL == this, "view is NULL");
+
+	//Counters must be current when the frame goes out
+	if (slot == BT_LE_ADV_SLOT_TLM)
+	{
+		advertise_tlm(this);
+	}
 }
 
 
@@ -721,29 +759,33 @@ static void _battery_level_change_cb(void *user_data, Evas_Object *obj, void *ev
 	if (ret == BT_ERROR_NONE)
 		ui_utils_label_set_text(this->bluetoothle_label, "Set Value", "left");
 
-
-	/* Create Advertiser */
-	bt_adapter_le_advertising_params_s adv_params = { 0, };
-	adv_params.interval_min= 500;
-	adv_params.interval_max= 500;
-
-	bt_adapter_le_advertising_state_changed_cb cb;
-	cb = __bt_adapter_le_advertising_state_changed_cb;
-
-
-
-	ret = bt_adapter_le_create_advertiser (&advertiser);
-	DBG("create advertiser: %s \n", __bt_get_error_message(ret));
-	if (ret == BT_ERROR_NONE)
+	//One advertiser for the whole view, later presses only rewrite its packet
+	if (this->advertiser == NULL)
+	{
+		this->advertiser = util_advertiser_create(BT_LE_ADV_INTERVAL_MS);
+		RETM_IF(NULL == this->advertiser, "util_advertiser_create failed");
+		this->advertising_since = ecore_time_get();
+		util_advertiser_rotate(this->advertiser, BT_LE_ADV_ROTATE_PERIOD, _advertiser_rotate_cb, this);
 		ui_utils_label_set_text(this->bluetoothle_label, "Create Advertiser", "left");
+	}
 
-	ret = bt_adapter_le_start_advertising(advertiser, &adv_params, cb, NULL);
-	DBG("advertising start: %s \n", __bt_get_error_message(ret));
-	if (ret == BT_ERROR_NONE)
-		ui_utils_label_set_text(this->bluetoothle_label, "Advertising Start", "left");
-
+	util_advertiser_set_payload(this->advertiser, BT_LE_ADV_SLOT_BATTERY, "180f", char_value, 1);
+	advertise_tlm(this);
 
+	if (!util_advertiser_is_advertising(this->advertiser))
+	{
+		if (util_advertiser_start(this->advertiser))
+			ui_utils_label_set_text(this->bluetoothle_label, "Advertising Start", "left");
+	}
+	else
+	{
+		util_advertiser_stats stats;
+		util_advertiser_get_stats(this->advertiser, &stats);
 
+		char *str = format_string("Advertising %d%%, %lu updates, %lu restarts", char_value[0], stats.updates, stats.restarts);
+		ui_utils_label_set_text(this->bluetoothle_label, str, "left");
+		SAFE_DELETE(str);
+	}
 }
 
 
@@ -820,16 +862,322 @@ static void _register_button_pressed_cb(void *user_data, Evas_Object *obj, void
 	battery_h.chr = characteristic;
 	battery_h.desc = descriptor;
 
+	register_stream_service(this);
+
+}
+
+
+/**
+ * @function		_stream_notification_state_cb
+ * @since_tizen		2.3
+ * @description		 Stream Notification State Cb
+ * @parameter		bool: Bool, bt_gatt_server_h: Bt Gatt Server H, bt_gatt_h: Bt Gatt H, void*: Void Pointer
+ * @return		static void
+ */
+static void _stream_notification_state_cb(bool notify, bt_gatt_server_h server, bt_gatt_h gatt_handle, void *user_data)
+{
+	DBG("_stream_notification_state_cb: %d", notify);
+	bluetoothle_view *this = NULL;
+	this = (bluetoothle_view*)user_data;
+	RETM_IF(NULL == this, "view is NULL");
+
+	this->stream_subscribed = notify;
+
+	//Measure from the moment a client listens, not from the button press
+	if (notify && this->stream_pacer != NULL)
+	{
+		util_pacer_reset(this->stream_pacer);
+	}
+	if (this->stream_timer != NULL)
+	{
+		ui_utils_label_set_text(this->bluetoothle_label, notify ? "Streaming" : "Waiting for Subscriber", "left");
+	}
+}
+
+
+/**
+ * @function		register_stream_service
+ * @since_tizen		2.3
+ * @description		Registers The Throughput Test Service
+ * @parameter		bluetoothle_view*: Bluetoothle View Pointer
+ * @return		static void
+ */
+static void register_stream_service(bluetoothle_view *this)
+{
+	int ret;
+	bt_gatt_h service = NULL;
+	bt_gatt_h characteristic = NULL;
+	bt_gatt_h descriptor = NULL;
+	char char_value[BT_LE_STREAM_PAYLOAD] = {0, };
+	char desc_value[2] = {0, 0}; // Notification & Indication disabled
+
+	ret = bt_gatt_service_create(BT_LE_STREAM_SERVICE_UUID, BT_GATT_SERVICE_TYPE_PRIMARY, &service);
+	RETM_IF(ret != BT_ERROR_NONE, "bt_gatt_service_create : %s", __bt_get_error_message(ret));
+
+	ret = bt_gatt_characteristic_create(BT_LE_STREAM_CHAR_UUID, BT_GATT_PERMISSION_READ, BT_GATT_PROPERTY_NOTIFY,
+			char_value, sizeof(char_value), &characteristic);
+	RETM_IF(ret != BT_ERROR_NONE, "bt_gatt_characteristic_create : %s", __bt_get_error_message(ret));
+
+	bt_gatt_server_set_notification_state_change_cb(characteristic, _stream_notification_state_cb, this);
+	ret = bt_gatt_service_add_characteristic(service, characteristic);
+	RETM_IF(ret != BT_ERROR_NONE, "bt_gatt_service_add_characteristic : %s", __bt_get_error_message(ret));
+
+	ret = bt_gatt_descriptor_create("2902", BT_GATT_PERMISSION_READ | BT_GATT_PERMISSION_WRITE,
+			desc_value, sizeof(desc_value), &descriptor);
+	RETM_IF(ret != BT_ERROR_NONE, "bt_gatt_descriptor_create : %s", __bt_get_error_message(ret));
+
+	ret = bt_gatt_characteristic_add_descriptor(characteristic, descriptor);
+	RETM_IF(ret != BT_ERROR_NONE, "bt_gatt_characteristic_add_descriptor : %s", __bt_get_error_message(ret));
+
+	ret = bt_gatt_server_register_service(server, service);
+	RETM_IF(ret != BT_ERROR_NONE, "bt_gatt_server_register_service : %s", __bt_get_error_message(ret));
+
+	this->stream_chr = characteristic;
+	elm_object_disabled_set(this->stream_btn, EINA_FALSE);
+}
+
+
+/**
+ * @function		_stream_notification_sent_cb
+ * @since_tizen		2.3
+ * @description		 Stream Notification Sent Cb
+ * @parameter		int: Int, const char*: Const Char Pointer, bt_gatt_server_h: Bt Gatt Server H, bt_gatt_h: Bt Gatt H, bool: Bool, void*: Void Pointer
+ * @return		static void
+ */
+static void _stream_notification_sent_cb(int result, const char *remote_address,
+		bt_gatt_server_h server, bt_gatt_h characteristic, bool completed, void *user_data)
+{
+	bluetoothle_view *this = NULL;
+	this = (bluetoothle_view*)user_data;
+	RETM_IF(NULL == this, "view is NULL");
+
+	util_event_journal_add(this->journal, UTIL_EVENT_NOTIFY_SENT, util_event_journal_address(this->journal, remote_address),
+			UTIL_EVENT_NO_HANDLE, 0, result);
+
+	//Called per client, the notification is done once all of them have it
+	if (completed && this->stream_pacer != NULL)
+	{
+		util_pacer_completed(this->stream_pacer, result == BT_ERROR_NONE);
+	}
+}
+
+
+/**
+ * @function		stream_send
+ * @since_tizen		2.3
+ * @description		Sends One Notification: Sequence Number, Milliseconds Since Start, Then A Fill Pattern
+ * @parameter		bluetoothle_view*: Bluetoothle View Pointer
+ * @return		static bool
+ */
+static bool stream_send(bluetoothle_view *this)
+{
+	char payload[BT_LE_STREAM_PAYLOAD];
+	unsigned int ms = (unsigned int) (ecore_time_get() * 1000);
+	unsigned int seq = this->stream_seq;
+	int i;
+
+	for (i = 0; i < BT_LE_STREAM_PAYLOAD; i++)
+	{
+		if (i < 4)
+			payload[i] = (seq >> (8 * i)) & 0xFF;
+		else if (i < 8)
+			payload[i] = (ms >> (8 * (i - 4))) & 0xFF;
+		else
+			payload[i] = (seq + i) & 0xFF;
+	}
+
+	int ret = bt_gatt_set_value(this->stream_chr, payload, sizeof(payload));
+	RETVM_IF(ret != BT_ERROR_NONE, false, "bt_gatt_set_value : %s", __bt_get_error_message(ret));
+
+#ifdef TIZEN_3_0
+	ret = bt_gatt_server_notify_characteristic_changed_value(this->stream_chr, _stream_notification_sent_cb, NULL, this);
+#else
+	ret = bt_gatt_server_notify(this->stream_chr, false, _stream_notification_sent_cb, this);
+#endif
+	RETVM_IF(ret != BT_ERROR_NONE, false, "bt_gatt_server_notify : %s", __bt_get_error_message(ret));
+
+	this->stream_seq++;
+	return true;
+}
+
+
+/**
+ * @function		_stream_timer_cb
+ * @since_tizen		2.3
+ * @description		Sends The Notifications Due Since The Last Tick
+ * @parameter		void*: Void Pointer
+ * @return		static Eina_Bool
+ */
+static Eina_Bool _stream_timer_cb(void *data)
+{
+	bluetoothle_view *this = NULL;
+	this = (bluetoothle_view*)data;
+	RETVM_IF(NULL == this, ECORE_CALLBACK_CANCEL, "view is NULL");
+
+	if (!this->stream_subscribed)
+	{
+		return ECORE_CALLBACK_RENEW;
+	}
+
+	int due = util_pacer_due(this->stream_pacer);
+	while (due-- > 0)
+	{
+		if (stream_send(this))
+			util_pacer_sent(this->stream_pacer, BT_LE_STREAM_PAYLOAD);
+		else
+			util_pacer_failed(this->stream_pacer);
+	}
+
+	if ((++this->stream_ticks % BT_LE_STREAM_REPORT_TICKS) == 0)
+	{
+		util_pacer_stats stats;
+		util_pacer_get_stats(this->stream_pacer, &stats);
+
+		char *str = format_string("%.1f/s of %d, %.0f B/s, failed %lu",
+				stats.per_second, BT_LE_STREAM_RATE, stats.bytes_per_second, stats.failed);
+		ui_utils_label_set_text(this->bluetoothle_label, str, "left");
+		SAFE_DELETE(str);
+	}
+	return ECORE_CALLBACK_RENEW;
+}
+
+
+/**
+ * @function		stream_stop
+ * @since_tizen		2.3
+ * @description		Stream Stop
+ * @parameter		bluetoothle_view*: Bluetoothle View Pointer
+ * @return		static void
+ */
+static void stream_stop(bluetoothle_view *this)
+{
+	RETM_IF(NULL == this, "view is NULL");
+
+	if (this->stream_timer != NULL)
+	{
+		ecore_timer_del(this->stream_timer);
+		this->stream_timer = NULL;
+	}
+	if (this->stream_pacer != NULL)
+	{
+		util_pacer_info(this->stream_pacer);
+	}
+}
+
+
+/**
+ * @function		_stream_button_pressed_cb
+ * @since_tizen		2.3
+ * @description		 Stream Button Pressed Cb
+ * @parameter		void*: Void Pointer, Evas_Object*: Evas Object Pointer, void*: Void Pointer
+ * @return		static void
+ */
+static void _stream_button_pressed_cb(void *user_data, Evas_Object *obj, void *event_info)
+{
+	DBG("_stream_button_pressed_cb");
+	RETM_IF(NULL == user_data, "data is NULL");
+	bluetoothle_view *this = NULL;
+	this = (bluetoothle_view*)user_data;
+	RETM_IF(NULL == this->stream_chr, "stream service is not registered");
+
+	if (this->stream_timer != NULL)
+	{
+		stream_stop(this);
+		elm_object_text_set(this->stream_btn, "Start Stream");
+		ui_utils_label_set_text(this->bluetoothle_label, "Stream Stopped", "left");
+		return;
+	}
+
+	if (this->stream_pacer == NULL)
+	{
+		this->stream_pacer = util_pacer_create(BT_LE_STREAM_RATE, BT_LE_STREAM_BURST, BT_LE_STREAM_MAX_OUTSTANDING);
+		RETM_IF(NULL == this->stream_pacer, "util_pacer_create failed");
+	}
+	util_pacer_reset(this->stream_pacer);
+	this->stream_ticks = 0;
+
+	this->stream_timer = ecore_timer_add(BT_LE_STREAM_TICK, _stream_timer_cb, this);
+	RETM_IF(NULL == this->stream_timer, "ecore_timer_add failed");
+
+	elm_object_text_set(this->stream_btn, "Stop Stream");
+	ui_utils_label_set_text(this->bluetoothle_label, this->stream_subscribed ? "Streaming" : "Waiting for Subscriber", "left");
+}
+
+
+/**
+ * @function		_beacon_rank_timer_cb
+ * @since_tizen		2.3
+ * @description		Publishes The Nearest Beacons Once A Second While Scanning
+ * @parameter		void*: Void Pointer
+ * @return		static Eina_Bool
+ */
+static Eina_Bool _beacon_rank_timer_cb(void *data)
+{
+	bluetoothle_view *this = (bluetoothle_view*)data;
+	RETVM_IF(NULL == this, ECORE_CALLBACK_CANCEL, "view is NULL");
+
+	util_beacon_range ranked[BT_LE_BEACON_RANKED];
+	char label[LABEL_MAX_LEN];
+	int count, i;
+
+	count = util_beacon_tracker_rank(this->beacons, ranked, BT_LE_BEACON_RANKED);
+	for (i = 0; i < count; i++)
+	{
+		DBG("beacon %d: %s %s %s rssi %.1f tx %d distance %.2f m", i, ranked[i].address,
+				util_beacon_type_name(ranked[i].type), ranked[i].id, ranked[i].rssi, ranked[i].tx_power_1m, ranked[i].distance_m);
+		if (ranked[i].has_telemetry)
+		{
+			DBG("beacon %d: battery %u mV temperature %.1f C", i, ranked[i].battery_mv, ranked[i].temperature_8_8 / 256.0);
+		}
+	}
+
+	if (count > 0)
+	{
+		if (ranked[0].distance_m >= 0)
+		{
+			snprintf(label, sizeof(label), "%d beacons, nearest %s %s %.1f m", util_beacon_tracker_count(this->beacons),
+					util_beacon_type_name(ranked[0].type), ranked[0].id, ranked[0].distance_m);
+		}
+		else
+		{
+			snprintf(label, sizeof(label), "%d beacons, nearest %s %s", util_beacon_tracker_count(this->beacons),
+					util_beacon_type_name(ranked[0].type), ranked[0].address);
+		}
+		ui_utils_label_set_text(this->bluetoothle_label, label, "left");
+	}
 
+	return ECORE_CALLBACK_RENEW;
 }
+
+
 Ecore_Task_Cb _scan_stop_cb(void *data)
 {
 	DBG("scan stop callback");
 	bluetoothle_view *this = NULL;
 	this = (bluetoothle_view*)data;
-	ui_utils_label_set_text(this->bluetoothle_label, "Device Scan Stopped", "left");
+	int result = bt_adapter_le_stop_scan();
+	util_event_journal_add(this->journal, UTIL_EVENT_SCAN_STOP, UTIL_EVENT_NO_LINK, UTIL_EVENT_NO_HANDLE, 0, result);
+
+	if (this->beacon_timer != NULL)
+	{
+		ecore_timer_del(this->beacon_timer);
+		this->beacon_timer = NULL;
+	}
+
+	if (this->scan_filter != NULL)
+	{
+		util_scan_filter_stats stats;
+		char label[LABEL_MAX_LEN];
 
-	bt_adapter_le_stop_scan();
+		util_scan_filter_get_stats(this->scan_filter, &stats);
+		util_scan_filter_info(this->scan_filter);
+		snprintf(label, sizeof(label), "Device Scan Stopped, %lu of %lu results filtered", stats.rejected, stats.evaluated);
+		ui_utils_label_set_text(this->bluetoothle_label, label, "left");
+	}
+	else
+	{
+		ui_utils_label_set_text(this->bluetoothle_label, "Device Scan Stopped", "left");
+	}
 
 	return ECORE_CALLBACK_CANCEL;
 }
@@ -879,9 +1227,11 @@ static void _disconnect_button_pressed_cb(void *user_data, Evas_Object *obj, voi
 	result = bt_gatt_get_type(this->gatt_handle, &type);
 	RETM_IF(result != BT_ERROR_NONE, "bt_gatt_get_type error: %s", get_bluetooth_error(result));
 
-	bt_gatt_disconnect(this->remote_addr);
+	RETM_IF(NULL == this->link, "no link selected");
+	bt_gatt_disconnect(this->link->address);
 	ui_utils_label_set_text(this->bluetoothle_label, "Device Disconnected", "left");
 	elm_list_clear(this->bluetoothle_list);
+	show_list(this, this->bluetoothle_list);
 }
 
 /**
@@ -899,69 +1249,117 @@ static void _services_button_pressed_cb(void *user_data, Evas_Object *obj, void
 	this = (bluetoothle_view*)user_data;
 
 	int result;
+	RETM_IF(NULL == this->link || NULL == this->link->client, "not connected");
 	elm_list_clear(this->bluetoothle_list);
-	result = bt_gatt_client_foreach_services(this->client, _bt_gatt_foreach_services_cb, this);
+	show_list(this, this->bluetoothle_list);
+	result = bt_gatt_client_foreach_services(this->link->client, _bt_gatt_foreach_services_cb, this);
 }
 
-void __read_complete_cb(int result, bt_gatt_h h, void *data)
+/**
+ * @function		show_read_value
+ * @since_tizen		2.3
+ * @description		Shows The Value Of A Characteristic Decoded By Its Cached Format, Then Frees It
+ * @parameter		gatt_link_t*: Link Of The Characteristic, bt_gatt_h: Characteristic Handle, char*: Value, int: Length
+ * @return		static void
+ */
+static void show_read_value(gatt_link_t *link, bt_gatt_h h, char *value, int len)
 {
-	int ret;
-	char *str = NULL;
-	char *value = NULL;
-	int len = 0;
-	bool hex_format = false;
-	int i;
+	bluetoothle_view *this = link->view;
+	const util_gatt_format *fmt = link->formats ? util_gatt_format_cache_get(link->formats, h) : NULL;
+	char text[BT_LE_VALUE_TEXT_SIZE];
+	int n = snprintf(text, sizeof(text), "Read Value : ");
+	n += util_gatt_format_value(fmt, value, len, text + n, sizeof(text) - n);
+	g_free(value);
 
-	bluetoothle_view *this = NULL;
-	this = (bluetoothle_view*)data;
+	if (link->read_ms >= 0 && n < (int)sizeof(text))
+	{
+		snprintf(text + n, sizeof(text) - n, "<br>%d bytes in %.1f ms, MTU %d",
+				len, link->read_ms, util_gatt_transfer_get_mtu(link->transfers));
+	}
+	DBG("%s", text);
 
-	ret = bt_gatt_get_value(h, &value, &len);
-	if (ret != BT_ERROR_NONE) {
-		DBG("bt_gatt_get_value is failed : %d", ret);
-		return;
+	Evas_Object *popup;
+	popup = ui_utils_popup_add(this->view->navi, "Characteristic Value");
+	elm_object_text_set(popup, text);
+
+	//The value stays in the handle, Write Back sends it as it was read
+	link->write_back_h = h;
+	if (link == this->link)
+	{
+		elm_object_disabled_set(this->write_back_btn, EINA_FALSE);
 	}
+}
 
 
-	for (i = 0; i < len; i++)
-		if (isalnum(value[i]) == 0) {
-			hex_format = true;
-			break;
-		}
+/**
+ * @function		_presentation_format_read_cb
+ * @since_tizen		2.3
+ * @description		 Presentation Format Read Cb
+ * @parameter		int: Int, bt_gatt_h: Bt Gatt H, void*: Void Pointer
+ * @return		static void
+ */
+static void _presentation_format_read_cb(int result, bt_gatt_h desc, void *data)
+{
+	gatt_link_t *link = (gatt_link_t*)data;
+	RETM_IF(NULL == link, "link is NULL");
+	//Disconnected while the descriptor was read
+	RETM_IF(NULL == link->format_pending, "no characteristic waits for its format");
 
-	if (hex_format) {
-		str = g_malloc0(len * 5 + 1);
-		/* Fix : NULL_RETURNS */
-		if (!str) {
-			DBG("BT_ERROR_OUT_OF_MEMORY");
-			goto fail;
-		}
-		for (i = 0; i < len; i++) {
-			if (i > 0)
-				str[i * 5 - 1] = ' ';
+	bt_gatt_h h = link->format_pending;
+	link->format_pending = NULL;
 
-			snprintf(&str[i * 5], 5, "0x%02X", value[i]);
-		}
-	} else {
-		str = g_malloc0(len + 1);
-		/* Fix : NULL_RETURNS */
-		if (!str) {
-			DBG("BT_ERROR_OUT_OF_MEMORY");
-			goto fail;
-		}
-		memcpy(str, value, len);
+	util_gatt_format fmt;
+	char *value = NULL;
+	int len = 0;
+	bool parsed = false;
+
+	if (result == BT_ERROR_NONE && bt_gatt_get_value(desc, &value, &len) == BT_ERROR_NONE)
+	{
+		parsed = util_gatt_format_parse(value, len, &fmt);
+		g_free(value);
 	}
 
-	DBG("Value : %s", str);
-	str = format_string("Read Value : %s", str);
+	//A descriptor that can not be read counts as none, it is not asked again
+	util_gatt_format_cache_put(link->formats, h, parsed ? &fmt : NULL);
 
-	Evas_Object *popup;
-	popup = ui_utils_popup_add(this->view->navi, "Characteristic Value");
-	elm_object_text_set(popup, str);
+	value = NULL;
+	len = 0;
+	RETM_IF(bt_gatt_get_value(h, &value, &len) != BT_ERROR_NONE, "bt_gatt_get_value failed");
+	show_read_value(link, h, value, len);
+}
 
-	g_free(str);
-fail:
-	g_free(value);
 
+void __read_complete_cb(int result, bt_gatt_h h, void *data)
+{
+	gatt_link_t *link = (gatt_link_t*)data;
+	RETM_IF(NULL == link, "link is NULL");
+
+	//The stack assembles a long value from its Read Blob responses, it is copied out once here
+	char *value = NULL;
+	int len = 0;
+	if (result == BT_ERROR_NONE)
+	{
+		result = bt_gatt_get_value(h, &value, &len);
+	}
+	link->read_ms = util_gatt_transfer_end(link->transfers, UTIL_GATT_TRANSFER_READ, h, result, len);
+	link_journal_add(link, UTIL_EVENT_READ_DONE, h, len, result);
+	RETM_IF(result != BT_ERROR_NONE, "read failed: %s", get_bluetooth_error(result));
+
+	//The Presentation Format is read once per characteristic, before its first value is shown
+	if (link->formats != NULL && link->format_pending == NULL && !util_gatt_format_cache_has(link->formats, h))
+	{
+		bt_gatt_h desc = NULL;
+		if (bt_gatt_characteristic_get_descriptor(h, "2904", &desc) == BT_ERROR_NONE && desc != NULL
+				&& bt_gatt_client_read_value(desc, _presentation_format_read_cb, link) == BT_ERROR_NONE)
+		{
+			link->format_pending = h;
+			g_free(value);
+			return;
+		}
+		util_gatt_format_cache_put(link->formats, h, NULL);
+	}
+
+	show_read_value(link, h, value, len);
 }
 
 
@@ -982,6 +1380,7 @@ static void _read_button_pressed_cb(void *user_data, Evas_Object *obj, void *eve
 	bluetoothle_view *this;
 	this = evas_object_data_get(obj, "bluetooth_view");
 	elm_list_clear(this->bluetoothle_list);
+	show_list(this, this->bluetoothle_list);
 
 	int result;
 	bt_gatt_type_e type;
@@ -1006,7 +1405,9 @@ static void _read_button_pressed_cb(void *user_data, Evas_Object *obj, void *eve
 
 
 		result = bt_gatt_client_read_value(this->characterstic_h, _bt_gatt_client_read_request_completed_cb, this);
-		RETM_IF(result != BT_ERROR_NONE, "bt_gatt_client_set_characteristic_value_changed_cb error: %s", get_bluetooth_error(result));
+		RETM_IF(result != BT_ERROR_NONE, "bt_gatt_client_read_value error: %s", get_bluetooth_error(result));
+
+		watch_notifications(this, this->characterstic_h);
 
 
 	}
@@ -1067,7 +1468,103 @@ static void _read_button_pressed_cb2(void *user_data, Evas_Object *obj, void *ev
 	this = evas_object_data_get(obj, "bluetooth_view");
 
 	bt_gatt_h gatt_handle = (bt_gatt_h)user_data;
-	bt_gatt_client_read_value(gatt_handle, __read_complete_cb, this);
+	gatt_link_t *link = this->link;
+	RETM_IF(NULL == link || NULL == link->client, "not connected");
+
+	update_att_mtu(link);
+	util_gatt_transfer_begin(link->transfers, UTIL_GATT_TRANSFER_READ, gatt_handle);
+	link_journal_add(link, UTIL_EVENT_READ, gatt_handle, 0, BT_ERROR_NONE);
+	int result = bt_gatt_client_read_value(gatt_handle, __read_complete_cb, link);
+	if (result != BT_ERROR_NONE)
+	{
+		util_gatt_transfer_end(link->transfers, UTIL_GATT_TRANSFER_READ, gatt_handle, result, 0);
+		link_journal_add(link, UTIL_EVENT_READ_DONE, gatt_handle, 0, result);
+		ERR("bt_gatt_client_read_value error: %s", get_bluetooth_error(result));
+	}
+}
+
+
+/**
+ * @function		_write_back_completed_cb
+ * @since_tizen		2.3
+ * @description		 Write Back Completed Cb
+ * @parameter		int: Int, bt_gatt_h: Bt Gatt H, void*: Void Pointer
+ * @return		static void
+ */
+static void _write_back_completed_cb(int result, bt_gatt_h h, void *user_data)
+{
+	gatt_link_t *link = (gatt_link_t*)user_data;
+	RETM_IF(NULL == link, "link is NULL");
+	bluetoothle_view *this = link->view;
+
+	char *value = NULL;
+	int len = 0;
+	if (bt_gatt_get_value(h, &value, &len) == BT_ERROR_NONE)
+	{
+		g_free(value);
+	}
+
+	int mtu = util_gatt_transfer_get_mtu(link->transfers);
+	double ms = util_gatt_transfer_end(link->transfers, UTIL_GATT_TRANSFER_WRITE, h, result, len);
+	link_journal_add(link, UTIL_EVENT_WRITE_DONE, h, len, result);
+
+	char* str;
+	if (result == BT_ERROR_NONE)
+	{
+		str = format_string("Wrote %d bytes in %.1f ms, %d round trips at MTU %d",
+				len, ms, util_gatt_transfer_round_trips(UTIL_GATT_TRANSFER_WRITE, len, mtu), mtu);
+	}
+	else
+	{
+		str = format_string("Write failed: %s", get_bluetooth_error(result));
+	}
+	ui_utils_label_set_text(this->bluetoothle_label, str, "left");
+	SAFE_DELETE(str);
+}
+
+
+/**
+ * @function		_write_back_button_pressed_cb
+ * @since_tizen		2.3
+ * @description		 Write Back Button Pressed Cb
+ * @parameter		void*: Void Pointer, Evas_Object*: Evas Object Pointer, void*: Void Pointer
+ * @return		static void
+ */
+static void _write_back_button_pressed_cb(void *user_data, Evas_Object *obj, void *event_info)
+{
+	DBG("_write_back_button_pressed_cb");
+	RETM_IF(NULL == user_data, "data is NULL");
+
+	bluetoothle_view *this = NULL;
+	this = (bluetoothle_view*)user_data;
+	gatt_link_t *link = this->link;
+	RETM_IF(NULL == link || NULL == link->client, "not connected");
+	RETM_IF(NULL == link->write_back_h, "nothing read yet");
+
+	char *value = NULL;
+	int len = 0;
+	int result = bt_gatt_get_value(link->write_back_h, &value, &len);
+	RETM_IF(result != BT_ERROR_NONE, "bt_gatt_get_value error: %s", get_bluetooth_error(result));
+	g_free(value);
+
+	update_att_mtu(link);
+
+	//Without response a value has to fit one PDU, a longer one goes as Prepare Write requests and an Execute Write
+	if (len > util_gatt_transfer_get_mtu(link->transfers) - 3)
+	{
+		result = bt_gatt_characteristic_set_write_type(link->write_back_h, BT_GATT_WRITE_TYPE_WRITE);
+		RETM_IF(result != BT_ERROR_NONE, "bt_gatt_characteristic_set_write_type error: %s", get_bluetooth_error(result));
+	}
+
+	util_gatt_transfer_begin(link->transfers, UTIL_GATT_TRANSFER_WRITE, link->write_back_h);
+	link_journal_add(link, UTIL_EVENT_WRITE, link->write_back_h, len, BT_ERROR_NONE);
+	result = bt_gatt_client_write_value(link->write_back_h, _write_back_completed_cb, link);
+	if (result != BT_ERROR_NONE)
+	{
+		util_gatt_transfer_end(link->transfers, UTIL_GATT_TRANSFER_WRITE, link->write_back_h, result, len);
+		link_journal_add(link, UTIL_EVENT_WRITE_DONE, link->write_back_h, len, result);
+		ERR("bt_gatt_client_write_value error: %s", get_bluetooth_error(result));
+	}
 }
 
 /**
@@ -1291,67 +1788,85 @@ switch(state)
 
 
 /**
- * @function		bluetooth_list_find_func_cb
+ * @function		bluetooth_list_free_func_cb
  * @since_tizen		2.3
- * @description		Bluetooth List Find Func Cb
- * @parameter		gconstpointer: Gconstpointer
- * @return		static gint
+ * @description		Bluetooth List Free Func Cb
+ * @parameter		gpointer: Gpointer
+ * @return		static void
  */
-static gint bluetooth_list_find_func_cb(gconstpointer a, gconstpointer b)
+static void bluetooth_list_free_func_cb(gpointer data)
 {
-	DBG(" bluetooth_list_find_func_cb ");
-
-	if(a && b)
-	{
-		bt_adapter_le_device_scan_result_info_s * device_info_a;
-		device_info_a = (bt_adapter_le_device_scan_result_info_s*)a;
-		RETVM_IF(NULL == device_info_a, -1, "device_info_a is NULL");
-
-		bt_adapter_le_device_scan_result_info_s * device_info_b;
-		device_info_b = (bt_adapter_le_device_scan_result_info_s*)b;
-		RETVM_IF(NULL == device_info_b, -1, "device_info_b is NULL");
-
-		RETVM_IF(NULL == device_info_a->remote_address, -1, "device_info_a->remote_address is NULL");
-		RETVM_IF(NULL == device_info_b->remote_address, -1, "device_info_b->remote_address is NULL");
-
-		return strcmp(device_info_a->remote_address, device_info_b->remote_address);
-	}
-	else
+	if(data)
 	{
-		return -1;
+		bt_adapter_le_device_scan_result_info_s *device_info = (bt_adapter_le_device_scan_result_info_s*)data;
+		SAFE_DELETE(device_info->remote_address);
+		SAFE_DELETE(device_info->adv_data);
+		SAFE_DELETE(device_info->scan_data);
+		free(data);
 	}
-
 }
 
 
 /**
- * @function		bluetooth_list_free_func_cb
+ * @function		copy_adv_payload
  * @since_tizen		2.3
- * @description		Bluetooth List Free Func Cb
- * @parameter		gpointer: Gpointer
- * @return		static void
+ * @description		Copy Adv Payload
+ * @parameter		const char*: Const char Pointer, int: Int
+ * @return		static char*
  */
-static void bluetooth_list_free_func_cb(gpointer data)
+static char *copy_adv_payload(const char *payload, int len)
 {
-	if(data)
+	if (payload == NULL || len <= 0)
 	{
-		free(data);
+		return NULL;
 	}
+
+	char *copy = malloc(len);
+	RETVM_IF(NULL == copy, NULL, "malloc failed");
+	memcpy(copy, payload, len);
+	return copy;
 }
 
 
 /**
- * @function		log_list_free_func_cb
+ * @function		update_scanned_device
  * @since_tizen		2.3
- * @description		Log List Free Func Cb
- * @parameter		gpointer: Gpointer
+ * @description		Update Scanned Device
+ * @parameter		bt_adapter_le_device_scan_result_info_s*: Bt Adapter Le Device Scan Result Info S Pointer, bt_adapter_le_device_scan_result_info_s*: Bt Adapter Le Device Scan Result Info S Pointer
  * @return		static void
  */
-static void log_list_free_func_cb(gpointer data)
+static void update_scanned_device(bt_adapter_le_device_scan_result_info_s *device_info, bt_adapter_le_device_scan_result_info_s *info)
 {
-	if(data)
+	device_info->rssi = info->rssi;
+	device_info->address_type = info->address_type;
+
+	//Most advertisers repeat the same payload, overwrite it where it is
+	if (device_info->adv_data != NULL && device_info->adv_data_len == info->adv_data_len)
 	{
-		free(data);
+		memcpy(device_info->adv_data, info->adv_data, info->adv_data_len);
+	}
+	else
+	{
+		SAFE_DELETE(device_info->adv_data);
+		device_info->adv_data = copy_adv_payload(info->adv_data, info->adv_data_len);
+		device_info->adv_data_len = device_info->adv_data ? info->adv_data_len : 0;
+	}
+
+	//An empty scan response (passive scan, or not received this time) keeps the last one
+	if (info->scan_data == NULL || info->scan_data_len <= 0)
+	{
+		return;
+	}
+
+	if (device_info->scan_data != NULL && device_info->scan_data_len == info->scan_data_len)
+	{
+		memcpy(device_info->scan_data, info->scan_data, info->scan_data_len);
+	}
+	else
+	{
+		SAFE_DELETE(device_info->scan_data);
+		device_info->scan_data = copy_adv_payload(info->scan_data, info->scan_data_len);
+		device_info->scan_data_len = device_info->scan_data ? info->scan_data_len : 0;
 	}
 }
 
@@ -1375,28 +1890,58 @@ static void  _bt_adapter_le_scan_result_cb(int result, bt_adapter_le_device_scan
 
 	if (info != NULL)
 	{
+		//Drop unwanted results on the raw bytes, before anything is allocated for them
+		if (!util_scan_filter_match(this->scan_filter, info->adv_data, info->adv_data_len,
+				info->scan_data, info->scan_data_len, info->rssi))
+		{
+			return;
+		}
+
 		this->scan_info = info;
 
-		if (is_new_scanned_device_found(this, info) == true)
+		//Beacons are ranged on every advertisement, not only the first one of a device
+		if (this->beacons != NULL)
+		{
+			util_beacon_frame frame;
+			if (util_beacon_decode(info->adv_data, info->adv_data_len, &frame)
+				|| util_beacon_decode(info->scan_data, info->scan_data_len, &frame))
+			{
+				util_beacon_tracker_update(this->beacons, info->remote_address, &frame, info->rssi);
+			}
+		}
+
+		bt_adapter_le_device_scan_result_info_s *device_info;
+		device_info = util_scan_table_find(this->devices, info->remote_address);
+
+		if (device_info != NULL)
+		{
+			//Known device, keep its entry (and the list item pointing at it) and refresh the data
+			update_scanned_device(device_info, info);
+		}
+		else
 		{
-			bt_adapter_le_device_scan_result_info_s *device_info;
 			device_info = malloc(sizeof(bt_adapter_le_device_scan_result_info_s));
 			DBG("BLE remote_address: %s", info->remote_address);
 			if (device_info != NULL)
 			{
 				memcpy(device_info, info,	sizeof(bt_adapter_le_device_scan_result_info_s));
 				device_info->remote_address = strdup(info->remote_address);
-				device_info->adv_data = strdup(info->adv_data);
-				if (info->scan_data)
-					device_info->scan_data = strdup(info->scan_data);
-
-				//Hold the last deviceinfo pointer;
-				this->devices_list = g_list_append(this->devices_list, (gpointer) device_info);
+				//Payloads are binary, copy by length
+				device_info->adv_data = copy_adv_payload(info->adv_data, info->adv_data_len);
+				device_info->adv_data_len = device_info->adv_data ? info->adv_data_len : 0;
+				device_info->scan_data = copy_adv_payload(info->scan_data, info->scan_data_len);
+				device_info->scan_data_len = device_info->scan_data ? info->scan_data_len : 0;
+
+				if (!util_scan_table_insert(this->devices, info->remote_address, device_info))
+				{
+					bluetooth_list_free_func_cb(device_info);
+				}
 			}
 		}
 	}
 
-	update_view_controls(this);
+	//Redraw once per interval, not once per advertisement
+	util_refresh_request(this->devices_refresh);
 }
 
 /**
@@ -1416,18 +1961,17 @@ static bool _bt_gatt_foreach_services_cb(int total, int index, bt_gatt_h gatt_ha
 	const char* uuid;
 	result = bt_gatt_get_uuid(gatt_handle, &uuid);
 	DBG("uuid: %s", uuid);
-	bt_gatt_client_get_service(this->client, uuid, &gatt_handle);
+	bt_gatt_client_get_service(this->link->client, uuid, &gatt_handle);
 
 	elm_object_text_set(this->bluetoothle_label, "Services of the Selected Device");
 #if 1
+	char name[64];
 	char* str = NULL;
-	bt_gatt_get_specification_name(uuid, &str);
-	if (str)
-		str = format_string("Service ID: %s", str);
-	else
-		str = format_string("%d. Unknown", index);
+	util_gatt_describe(uuid, name, sizeof(name));
+	str = format_string("Service ID: %s", name);
 
-	if ((*(uuid+4) == '1') && (*(uuid+5) == '8') && (*(uuid+6) == '0') && (*(uuid+7) == '1'))
+	//Generic Attribute has nothing to browse
+	if (util_gatt_short_uuid(uuid) == 0x1801)
 		elm_list_item_append(this->bluetoothle_list, str, NULL, NULL, NULL, gatt_handle);
 	else
 		elm_list_item_append(this->bluetoothle_list, str, NULL, NULL, _sevice_selected_cb, gatt_handle);
@@ -1459,7 +2003,7 @@ static bool _bt_gatt_foreach_services_cb2(int total, int index, bt_gatt_h gatt_h
 	bt_gatt_get_uuid(gatt_handle, &uuid);
 	DBG("uuid: %s", uuid);
 
-	bt_gatt_client_get_service(this->client, uuid, &(this->service_h));
+	bt_gatt_client_get_service(this->link->client, uuid, &(this->service_h));
 	bt_gatt_service_foreach_characteristics (this->service_h, _bt_gatt_foreach_characterstics_cb2, this);
 
 
@@ -1509,10 +2053,10 @@ bool __bt_gatt_client_foreach_desc_cb(int total, int index, bt_gatt_h desc_handl
 	bt_gatt_get_uuid(desc_handle, &uuid);
 	DBG("uuid: %s", uuid);
 
+	char name[64];
 	char* str = NULL;
-	bt_gatt_get_specification_name(uuid, &str);
-	if (str)
-		str = format_string("  - descriptor ID: %s", str);
+	util_gatt_describe(uuid, name, sizeof(name));
+	str = format_string("  - descriptor ID: %s", name);
 
 	elm_list_item_append(this->bluetoothle_list, str, NULL, NULL, NULL, desc_handle);
 
@@ -1544,17 +2088,17 @@ static bool _bt_gatt_foreach_characterstics_cb(int total, int index, bt_gatt_h g
 	ui_utils_label_set_text(this->bluetoothle_label, "Characteristics and Descriptors", "left");
 
 #if 0
+	char name[64];
 	char* str = NULL;
-	bt_gatt_get_specification_name(uuid, &str);
-	if (str)
-		str = format_string("%d. %s", index, str);
+	util_gatt_describe(uuid, name, sizeof(name));
+	str = format_string("%d. %s", index, name);
 
 	elm_list_item_append(this->bluetoothle_list, str, NULL, NULL, _read_button_pressed_cb2, gatt_handle);
 #else
+	char name[64];
 	char* str = NULL;
-	bt_gatt_get_specification_name(uuid, &str);
-	if (str)
-		str = format_string("Characteristic ID: %s", str);
+	util_gatt_describe(uuid, name, sizeof(name));
+	str = format_string("Characteristic ID: %s", name);
 
 	elm_list_item_append(this->bluetoothle_list, str, NULL, NULL, _read_button_pressed_cb2, gatt_handle);
 
@@ -1606,124 +2150,613 @@ static bool _bt_gatt_foreach_characterstics_cb2(int total, int index, bt_gatt_h
  */
 static void _bt_gatt_client_characteristic_value_changed_cb(bt_gatt_h characteristic, char *value, int len, void *user_data)
 {
-	DBG("_bt_gatt_foreach_descriptors_cb");
 	RETM_IF(NULL == user_data, "data is NULL");
 	bluetoothle_view *this = NULL;
 	this = (bluetoothle_view*)user_data;
-	RETM_IF(NULL == this, "view is NULL");
-
-	DBG("value: %s, len %d", value, len);
-
-	char* str;
-
-	str = format_string("characteristics value changed");
-	elm_list_item_append(this->bluetoothle_list, str, NULL, NULL, NULL, NULL);
-	SAFE_DELETE(str);
-	str = format_string("value %s length %d", value, len);
-	elm_list_item_append(this->bluetoothle_list, str, NULL, NULL, NULL, NULL);
-	SAFE_DELETE(str);
 
+	//Store only, the rows are redrawn by the refresh at most every BT_LE_NOTIFY_REFRESH_INTERVAL
+	util_notify_ring_push(this->notifications, value, len);
+	if (this->notify_link != NULL)
+	{
+		link_journal_add(this->notify_link, UTIL_EVENT_NOTIFY, characteristic, len, BT_ERROR_NONE);
+	}
+	util_refresh_request(this->notify_refresh);
 }
 
 
 /**
- * @function		_bt_gatt_foreach_descriptors_cb
+ * @function		watch_notifications
  * @since_tizen		2.3
- * @description		 Bt Gatt Foreach Descriptors Cb
- * @parameter		int: Int, void*: Void Pointer
- * @return		static bool
+ * @description		Watch Notifications
+ * @parameter		bluetoothle_view*: Bluetoothle View Pointer, bt_gatt_h: Bt Gatt H
+ * @return		static void
  */
-static bool _bt_gatt_foreach_descriptors_cb(int total, int index, bt_gatt_h gatt_handle, void *user_data)
+static void watch_notifications(bluetoothle_view *this, bt_gatt_h characteristic)
 {
-	DBG("_bt_gatt_foreach_descriptors_cb");
-	RETVM_IF(NULL == user_data, false, "data is NULL");
-	bluetoothle_view *this = NULL;
-	this = (bluetoothle_view*)user_data;
-	RETVM_IF(NULL == this,false, "view is NULL");
-	DBG("Total: %d index: %d", total, index);
-	elm_list_clear(this->bluetoothle_list);
-
-	this->gatt_handle = gatt_handle;
+	RETM_IF(NULL == this, "view is NULL");
 
-	char* str;
 	int result;
-#if 0
-	bt_gatt_h characteristic;
-	result = bt_gatt_descriptor_get_characteristic(gatt_handle, &characteristic);
-	RETVM_IF(result != BT_ERROR_NONE,false, "bt_gatt_descriptor_get_characteristic error: %s", get_bluetooth_error(result));
+	int properties = 0;
 
-	char* characteristic_uuid;
-	result = bt_gatt_get_uuid(characteristic, &characteristic_uuid);
-	RETVM_IF(result != BT_ERROR_NONE,false, "bt_gatt_get_uuid error: %s", get_bluetooth_error(result));
-	RETVM_IF(NULL == characteristic_uuid,false, "characteristic_uuid is null");
-	DBG("characteristic_uuid: %s", characteristic_uuid);
-#endif
+	if (characteristic == this->notify_h)
+	{
+		return;
+	}
 
-	char* descriptor_uuid;
-	result = bt_gatt_get_uuid(gatt_handle, &descriptor_uuid);
-	RETVM_IF(result != BT_ERROR_NONE,false,"bt_gatt_get_uuid error: %s", get_bluetooth_error(result));
-	RETVM_IF(NULL == descriptor_uuid,false, "descriptor_uuid is null");
-	DBG("descriptor_uuid: %s", descriptor_uuid);
-	this->descriptor_h = gatt_handle;
+	result = bt_gatt_characteristic_get_properties(characteristic, &properties);
+	RETM_IF(result != BT_ERROR_NONE, "bt_gatt_characteristic_get_properties error: %s", get_bluetooth_error(result));
+	if ((properties & (BT_GATT_PROPERTY_NOTIFY | BT_GATT_PROPERTY_INDICATE)) == 0)
+	{
+		return;
+	}
 
-	str = format_string("Descriptor %d uuid: %s", index, descriptor_uuid);
-	elm_list_item_append(this->bluetoothle_list, str, NULL, NULL, _descriptor_selected_cb, descriptor_uuid);
-	SAFE_DELETE(str);
-//	SAFE_DELETE(characteristic_uuid);
-	SAFE_DELETE(descriptor_uuid);
-	return true;
+	if (this->notify_h != NULL)
+	{
+		bt_gatt_client_unset_characteristic_value_changed_cb(this->notify_h);
+		this->notify_h = NULL;
+	}
+	util_refresh_cancel(this->notify_refresh);
+	util_notify_ring_clear(this->notifications);
+
+	result = bt_gatt_client_set_characteristic_value_changed_cb(characteristic, _bt_gatt_client_characteristic_value_changed_cb, this);
+	RETM_IF(result != BT_ERROR_NONE, "bt_gatt_client_set_characteristic_value_changed_cb error: %s", get_bluetooth_error(result));
+	this->notify_h = characteristic;
+	this->notify_link = this->link;
 }
 
 
 /**
- * @function		_bt_gatt_client_write_request_completed_cb
+ * @function		_notify_item_del_cb
  * @since_tizen		2.3
- * @description		 Bt Gatt Client Write Request Completed Cb
- * @parameter		int: Int, void*: Void Pointer
+ * @description		 Notify Item Del Cb
+ * @parameter		void*: Void Pointer, Evas_Object*: Evas Object Pointer, void*: Void Pointer
  * @return		static void
  */
-static void _bt_gatt_client_write_request_completed_cb(int result, bt_gatt_h request_handle, void *user_data)
+static void _notify_item_del_cb(void *data, Evas_Object *obj, void *event_info)
 {
-	DBG("_bt_gatt_client_write_request_completed_cb");
-	RETM_IF(NULL == user_data, "data is NULL");
-	bluetoothle_view *this = NULL;
-	this = (bluetoothle_view*)user_data;
-	RETM_IF(NULL == this,"view is NULL");
-
-	set_control_btn_state(CHARACTERISTIC_WRITTEN, this);
+	//The list was cleared under us, the row is added again on the next refresh
+	Elm_Object_Item **slot = (Elm_Object_Item**)data;
+	if (slot != NULL)
+	{
+		*slot = NULL;
+	}
 }
 
 
 /**
- * @function		_bt_gatt_client_read_request_completed_cb
+ * @function		notify_row_set
  * @since_tizen		2.3
- * @description		 Bt Gatt Client Read Request Completed Cb
- * @parameter		int: Int, void*: Void Pointer
+ * @description		Notify Row Set
+ * @parameter		bluetoothle_view*: Bluetoothle View Pointer, Elm_Object_Item**: Row, const char*: Text
  * @return		static void
  */
-static void _bt_gatt_client_read_request_completed_cb(int result, bt_gatt_h request_handle, void *user_data)
+static void notify_row_set(bluetoothle_view *this, Elm_Object_Item **slot, const char *text)
 {
+	if (*slot != NULL)
+	{
+		elm_object_item_text_set(*slot, text);
+		return;
+	}
 
+	*slot = elm_list_item_append(this->bluetoothle_list, text, NULL, NULL, NULL, slot);
+	RETM_IF(NULL == *slot, "elm_list_item_append failed");
+	elm_object_item_del_cb_set(*slot, _notify_item_del_cb);
+}
 
-	DBG("_bt_gatt_client_read_request_completed_cb");
-//	RETM_IF(NULL == user_data, "data is NULL");
-	bluetoothle_view *this = NULL;
-	this = (bluetoothle_view*)user_data;
-//	RETM_IF(NULL == this,"view is NULL");
-	this->is_read_completed = true;
-	char* value;
-	int value_length;
-	result = bt_gatt_get_value(this->characterstic_h, &value, &value_length);
-//	RETM_IF(result != BT_ERROR_NONE, "bt_gatt_get_value failed --> error: %s", get_bluetooth_error(result));
-	DBG("value: %s, value_length: %d", value, value_length);
-
-	char* str;
-	str = format_string("value %s len %d", value, value_length);
-	elm_list_item_append(this->bluetoothle_list, str, NULL, NULL, NULL, NULL);
-	SAFE_DELETE(str);
 
-	DBG("read completed");
-//	set_control_btn_state(CHARACTERISTIC_READ, this);
+/**
+ * @function		notifications_show
+ * @since_tizen		2.3
+ * @description		Notifications Show
+ * @parameter		bluetoothle_view*: Bluetoothle View Pointer
+ * @return		static void
+ */
+static void notifications_show(bluetoothle_view *this)
+{
+	RETM_IF(NULL == this, "view is NULL");
+
+	util_notify_stats stats;
+	util_notify_ring_get_stats(this->notifications, &stats);
+
+	char str[BT_LE_NOTIFY_SHOWN_BYTES * 3 + 64];
+	snprintf(str, sizeof(str), "%.1f/s %.0f B/s, jitter %.1f ms, dropped %lu, cut %lu",
+			stats.per_second, stats.bytes_per_second, stats.jitter_us / 1000.0, stats.overwritten, stats.truncated);
+
+	bool added = (this->notify_stats_item == NULL);
+	notify_row_set(this, &this->notify_stats_item, str);
+
+	int i;
+	for (i = 0; i < BT_LE_NOTIFY_SHOWN; i++)
+	{
+		const util_notify_entry *e = util_notify_ring_latest(this->notifications, i);
+		if (e == NULL)
+		{
+			break;
+		}
+
+		int n = 0;
+		int j;
+		for (j = 0; j < e->len && j < BT_LE_NOTIFY_SHOWN_BYTES; j++)
+		{
+			n += snprintf(str + n, sizeof(str) - n, j ? " %02X" : "%02X", e->data[j]);
+		}
+		//Only the head of a long value fits the row, the whole of it stays in the ring
+		if (j < e->received_len)
+		{
+			snprintf(str + n, sizeof(str) - n, " .. (%d B)", e->received_len);
+		}
+
+		added |= (this->notify_items[i] == NULL);
+		notify_row_set(this, &this->notify_items[i], str);
+	}
+
+	if (added)
+	{
+		elm_list_go(this->bluetoothle_list);
+	}
+}
+
+
+/**
+ * @function		_notify_refresh_cb
+ * @since_tizen		2.3
+ * @description		 Notify Refresh Cb
+ * @parameter		void*: Void Pointer
+ * @return		static void
+ */
+static void _notify_refresh_cb(void *data)
+{
+	bluetoothle_view *this = NULL;
+	this = (bluetoothle_view*)data;
+	RETM_IF(NULL == this, "view is NULL");
+
+	notifications_show(this);
+}
+
+
+/**
+ * @function		_read_all_button_pressed_cb
+ * @since_tizen		2.3
+ * @description		 Read All Button Pressed Cb
+ * @parameter		void*: Void Pointer, Evas_Object*: Evas Object Pointer, void*: Void Pointer
+ * @return		static void
+ */
+static void _read_all_button_pressed_cb(void *user_data, Evas_Object *obj, void *event_info)
+{
+	DBG("_read_all_button_pressed_cb");
+	RETM_IF(NULL == user_data, "data is NULL");
+
+	bulk_read_start((bluetoothle_view*)user_data, NULL);
+}
+
+
+/**
+ * @function		_read_service_item_cb
+ * @since_tizen		2.3
+ * @description		 Read Service Item Cb
+ * @parameter		void*: Void Pointer, Evas_Object*: Evas Object Pointer, void*: Void Pointer
+ * @return		static void
+ */
+static void _read_service_item_cb(void *data, Evas_Object *obj, void *event_info)
+{
+	DBG("_read_service_item_cb");
+	RETM_IF(NULL == obj, "obj is NULL");
+
+	bluetoothle_view *this;
+	this = evas_object_data_get(obj, "bluetooth_view");
+	elm_list_item_selected_set(event_info, EINA_FALSE);
+
+	bulk_read_start(this, (bt_gatt_h)data);
+}
+
+
+/**
+ * @function		bulk_read_add
+ * @since_tizen		2.3
+ * @description		Queues A Characteristic If It Is Readable, Followed By Its Presentation Format If That Is Not Known Yet
+ * @parameter		gatt_link_t*: Link, bt_gatt_h: Bt Gatt H
+ * @return		static void
+ */
+static void bulk_read_add(gatt_link_t *link, bt_gatt_h characteristic)
+{
+	int properties = 0;
+	int result = bt_gatt_characteristic_get_properties(characteristic, &properties);
+	RETM_IF(result != BT_ERROR_NONE, "bt_gatt_characteristic_get_properties error: %s", get_bluetooth_error(result));
+
+	if (!(properties & BT_GATT_PROPERTY_READ))
+	{
+		return;
+	}
+	util_read_queue_add(link->bulk_read, characteristic);
+
+	//Results keep the order they were added in, the descriptor right after is how bulk_read_formats() finds its characteristic
+	if (link->formats != NULL && !util_gatt_format_cache_has(link->formats, characteristic))
+	{
+		bt_gatt_h desc = NULL;
+		if (bt_gatt_characteristic_get_descriptor(characteristic, "2904", &desc) == BT_ERROR_NONE && desc != NULL)
+		{
+			util_read_queue_add(link->bulk_read, desc);
+		}
+		else
+		{
+			util_gatt_format_cache_put(link->formats, characteristic, NULL);
+		}
+	}
+}
+
+
+/**
+ * @function		bulk_read_is_format
+ * @since_tizen		2.3
+ * @description		Whether A Read All Result Is A Presentation Format Rather Than A Value
+ * @parameter		const util_read_result*: Util Read Result Pointer
+ * @return		static bool
+ */
+static bool bulk_read_is_format(const util_read_result *r)
+{
+	bt_gatt_type_e type;
+	return r != NULL && bt_gatt_get_type((bt_gatt_h)r->handle, &type) == BT_ERROR_NONE && type == BT_GATT_TYPE_DESCRIPTOR;
+}
+
+
+/**
+ * @function		bulk_read_formats
+ * @since_tizen		2.3
+ * @description		Caches The Presentation Formats Read All Fetched, Each For The Characteristic Before It
+ * @parameter		gatt_link_t*: Link, util_read_queue*: Util Read Queue Pointer
+ * @return		static int
+ */
+static int bulk_read_formats(gatt_link_t *link, util_read_queue *queue)
+{
+	int formats = 0;
+	int i;
+	for (i = 1; i < util_read_queue_count(queue); i++)
+	{
+		const util_read_result *d = util_read_queue_get(queue, i);
+		if (!bulk_read_is_format(d))
+		{
+			continue;
+		}
+
+		//A descriptor that can not be read counts as none, as with a single read
+		util_gatt_format fmt;
+		bool parsed = d->state == UTIL_READ_DONE && d->result == BT_ERROR_NONE
+				&& util_gatt_format_parse(d->value, d->len, &fmt);
+		if (link->formats != NULL)
+		{
+			util_gatt_format_cache_put(link->formats, util_read_queue_get(queue, i - 1)->handle, parsed ? &fmt : NULL);
+		}
+		formats++;
+	}
+	return formats;
+}
+
+
+/**
+ * @function		_bulk_read_add_cb
+ * @since_tizen		2.3
+ * @description		 Bulk Read Add Cb
+ * @parameter		int: Int, int: Int, bt_gatt_h: Bt Gatt H, void*: Void Pointer
+ * @return		static bool
+ */
+static bool _bulk_read_add_cb(int total, int index, bt_gatt_h gatt_handle, void *user_data)
+{
+	bulk_read_add((gatt_link_t*)user_data, gatt_handle);
+	return true;
+}
+
+
+/**
+ * @function		_bulk_read_completed_cb
+ * @since_tizen		2.3
+ * @description		 Bulk Read Completed Cb
+ * @parameter		int: Int, bt_gatt_h: Bt Gatt H, void*: Void Pointer
+ * @return		static void
+ */
+static void _bulk_read_completed_cb(int result, bt_gatt_h request_handle, void *user_data)
+{
+	gatt_link_t *link = (gatt_link_t*)user_data;
+	RETM_IF(NULL == link, "link is NULL");
+	//Disconnected while the read was in flight
+	RETM_IF(NULL == link->bulk_read, "no bulk read running");
+
+	char *value = NULL;
+	int len = 0;
+	if (result == BT_ERROR_NONE && bt_gatt_get_value(request_handle, &value, &len) != BT_ERROR_NONE)
+	{
+		len = 0;
+	}
+
+	util_read_queue_complete(link->bulk_read, request_handle, result, value, len);
+	g_free(value);
+}
+
+
+/**
+ * @function		_bulk_read_start_cb
+ * @since_tizen		2.3
+ * @description		 Bulk Read Start Cb
+ * @parameter		void*: Void Pointer, void*: Void Pointer
+ * @return		static bool
+ */
+static bool _bulk_read_start_cb(void *handle, void *data)
+{
+	int result = bt_gatt_client_read_value((bt_gatt_h)handle, _bulk_read_completed_cb, data);
+	RETVM_IF(result != BT_ERROR_NONE, false, "bt_gatt_client_read_value error: %s", get_bluetooth_error(result));
+	return true;
+}
+
+
+/**
+ * @function		format_read_value
+ * @since_tizen		2.3
+ * @description		Formats A Value By The Cached Format Of Its Characteristic, As Text Or Hex Without One
+ * @parameter		gatt_link_t*: Link, const util_read_result*: Util Read Result Pointer, char*: Buffer, int: Size
+ * @return		static void
+ */
+static void format_read_value(gatt_link_t *link, const util_read_result *r, char *buf, int size)
+{
+	const util_gatt_format *fmt = link->formats ? util_gatt_format_cache_get(link->formats, r->handle) : NULL;
+	if (fmt != NULL)
+	{
+		util_gatt_format_value(fmt, r->value, r->len, buf, size);
+		return;
+	}
+
+	int shown = r->len < BT_LE_BULK_READ_SHOWN_BYTES ? r->len : BT_LE_BULK_READ_SHOWN_BYTES;
+	int n = util_gatt_format_value(NULL, r->value, shown, buf, size);
+	if (shown < r->len && n + 3 < size)
+	{
+		snprintf(buf + n, size - n, " ..");
+	}
+}
+
+
+/**
+ * @function		_bulk_read_done_cb
+ * @since_tizen		2.3
+ * @description		 Bulk Read Done Cb
+ * @parameter		util_read_queue*: Util Read Queue Pointer, void*: Void Pointer
+ * @return		static void
+ */
+static void _bulk_read_done_cb(util_read_queue *queue, void *data)
+{
+	gatt_link_t *link = (gatt_link_t*)data;
+	RETM_IF(NULL == link, "link is NULL");
+	bluetoothle_view *this = link->view;
+
+	util_read_queue_stats stats;
+	util_read_queue_get_stats(queue, &stats);
+	link_journal_add(link, UTIL_EVENT_READ_ALL_DONE, NULL, stats.done, stats.failed);
+	link->bulk_formats = bulk_read_formats(link, queue);
+
+	//Another link was selected meanwhile, the results are shown when this one is selected again
+	if (link != this->link)
+	{
+		link->bulk_unseen = true;
+		return;
+	}
+	bulk_read_show(this, link);
+}
+
+
+/**
+ * @function		bulk_read_show
+ * @since_tizen		2.3
+ * @description		Lists The Results Of The Last Read All Of A Link
+ * @parameter		bluetoothle_view*: Bluetoothle View Pointer, gatt_link_t*: Link
+ * @return		static void
+ */
+static void bulk_read_show(bluetoothle_view *this, gatt_link_t *link)
+{
+	RETM_IF(NULL == link->bulk_read, "no Read All results");
+	util_read_queue *queue = link->bulk_read;
+	link->bulk_unseen = false;
+
+	util_read_queue_stats stats;
+	util_read_queue_get_stats(queue, &stats);
+
+	elm_list_clear(this->bluetoothle_list);
+	show_list(this, this->bluetoothle_list);
+	ui_utils_label_set_text(this->bluetoothle_label, "Read All Results", "left");
+
+	char* str;
+	str = format_string("%d read (%d formats), %d failed in %.1f ms, latency avg %.1f ms max %.1f ms",
+			stats.done, link->bulk_formats, stats.failed, stats.total_us / 1000.0,
+			stats.done ? stats.latency_us / 1000.0 / stats.done : 0.0, stats.max_latency_us / 1000.0);
+	elm_list_item_append(this->bluetoothle_list, str, NULL, NULL, NULL, NULL);
+	SAFE_DELETE(str);
+
+	int i;
+	for (i = 0; i < util_read_queue_count(queue); i++)
+	{
+		const util_read_result *r = util_read_queue_get(queue, i);
+		char name[64];
+		char value[BT_LE_BULK_READ_SHOWN_BYTES * 3 + 8];
+		char *uuid = NULL;
+
+		//Already applied to the value before it
+		if (bulk_read_is_format(r))
+		{
+			continue;
+		}
+
+		if (bt_gatt_get_uuid((bt_gatt_h)r->handle, &uuid) == BT_ERROR_NONE)
+		{
+			util_gatt_describe(uuid, name, sizeof(name));
+		}
+		else
+		{
+			snprintf(name, sizeof(name), "?");
+		}
+		SAFE_DELETE(uuid);
+
+		if (r->state == UTIL_READ_NOT_STARTED)
+		{
+			str = format_string("%s: not started", name);
+		}
+		else if (r->result == BT_ERROR_NONE)
+		{
+			format_read_value(link, r, value, sizeof(value));
+			str = format_string("%s: %s (%.1f ms)", name, value, r->latency_us / 1000.0);
+		}
+		else
+		{
+			str = format_string("%s: %s (%.1f ms)", name, get_bluetooth_error(r->result), r->latency_us / 1000.0);
+		}
+		elm_list_item_append(this->bluetoothle_list, str, NULL, NULL, _read_button_pressed_cb2, r->handle);
+		SAFE_DELETE(str);
+	}
+	elm_list_go(this->bluetoothle_list);
+}
+
+
+/**
+ * @function		bulk_read_start
+ * @since_tizen		2.3
+ * @description		Reads Every Readable Characteristic Of A Service, Or Of The Device When service_h Is NULL
+ * @parameter		bluetoothle_view*: Bluetoothle View Pointer, bt_gatt_h: Bt Gatt H
+ * @return		static void
+ */
+static void bulk_read_start(bluetoothle_view *this, bt_gatt_h service_h)
+{
+	RETM_IF(NULL == this, "view is NULL");
+	gatt_link_t *link = this->link;
+	RETM_IF(NULL == link || NULL == link->client, "not connected");
+
+	if (link->bulk_read != NULL && util_read_queue_running(link->bulk_read))
+	{
+		DBG("Read All already running");
+		return;
+	}
+
+	util_read_queue_destroy(link->bulk_read);
+	link->bulk_unseen = false;
+	link->bulk_read = util_read_queue_create(BT_LE_BULK_READ_IN_FLIGHT, _bulk_read_start_cb, _bulk_read_done_cb, link);
+	RETM_IF(NULL == link->bulk_read, "util_read_queue_create failed");
+
+	if (service_h != NULL)
+	{
+		bt_gatt_service_foreach_characteristics(service_h, _bulk_read_add_cb, link);
+	}
+	else
+	{
+		int i;
+		for (i = 0; i < util_gatt_arena_count(link->attributes); i++)
+		{
+			const util_gatt_attr *attr = util_gatt_arena_get(link->attributes, i);
+			if (attr->type == UTIL_GATT_ATTR_CHARACTERISTIC)
+			{
+				bulk_read_add(link, (bt_gatt_h)attr->handle);
+			}
+		}
+	}
+
+	ui_utils_label_set_text(this->bluetoothle_label, "Reading..", "left");
+	link_journal_add(link, UTIL_EVENT_READ_ALL, NULL, util_read_queue_count(link->bulk_read), BT_ERROR_NONE);
+	util_read_queue_run(link->bulk_read);
+}
+
+
+/**
+ * @function		_bt_gatt_foreach_descriptors_cb
+ * @since_tizen		2.3
+ * @description		 Bt Gatt Foreach Descriptors Cb
+ * @parameter		int: Int, void*: Void Pointer
+ * @return		static bool
+ */
+static bool _bt_gatt_foreach_descriptors_cb(int total, int index, bt_gatt_h gatt_handle, void *user_data)
+{
+	DBG("_bt_gatt_foreach_descriptors_cb");
+	RETVM_IF(NULL == user_data, false, "data is NULL");
+	bluetoothle_view *this = NULL;
+	this = (bluetoothle_view*)user_data;
+	RETVM_IF(NULL == this,false, "view is NULL");
+	DBG("Total: %d index: %d", total, index);
+	elm_list_clear(this->bluetoothle_list);
+	show_list(this, this->bluetoothle_list);
+
+	this->gatt_handle = gatt_handle;
+
+	char* str;
+	int result;
+#if 0
+	bt_gatt_h characteristic;
+	result = bt_gatt_descriptor_get_characteristic(gatt_handle, &characteristic);
+	RETVM_IF(result != BT_ERROR_NONE,false, "bt_gatt_descriptor_get_characteristic error: %s", get_bluetooth_error(result));
+
+	char* characteristic_uuid;
+	result = bt_gatt_get_uuid(characteristic, &characteristic_uuid);
+	RETVM_IF(result != BT_ERROR_NONE,false, "bt_gatt_get_uuid error: %s", get_bluetooth_error(result));
+	RETVM_IF(NULL == characteristic_uuid,false, "characteristic_uuid is null");
+	DBG("characteristic_uuid: %s", characteristic_uuid);
+#endif
+
+	char* descriptor_uuid;
+	result = bt_gatt_get_uuid(gatt_handle, &descriptor_uuid);
+	RETVM_IF(result != BT_ERROR_NONE,false,"bt_gatt_get_uuid error: %s", get_bluetooth_error(result));
+	RETVM_IF(NULL == descriptor_uuid,false, "descriptor_uuid is null");
+	DBG("descriptor_uuid: %s", descriptor_uuid);
+	this->descriptor_h = gatt_handle;
+
+	str = format_string("Descriptor %d uuid: %s", index, descriptor_uuid);
+	elm_list_item_append(this->bluetoothle_list, str, NULL, NULL, _descriptor_selected_cb, descriptor_uuid);
+	SAFE_DELETE(str);
+//	SAFE_DELETE(characteristic_uuid);
+	SAFE_DELETE(descriptor_uuid);
+	return true;
+}
+
+
+/**
+ * @function		_bt_gatt_client_write_request_completed_cb
+ * @since_tizen		2.3
+ * @description		 Bt Gatt Client Write Request Completed Cb
+ * @parameter		int: Int, void*: Void Pointer
+ * @return		static void
+ */
+static void _bt_gatt_client_write_request_completed_cb(int result, bt_gatt_h request_handle, void *user_data)
+{
+	DBG("_bt_gatt_client_write_request_completed_cb");
+	RETM_IF(NULL == user_data, "data is NULL");
+	bluetoothle_view *this = NULL;
+	this = (bluetoothle_view*)user_data;
+	RETM_IF(NULL == this,"view is NULL");
+
+	set_control_btn_state(CHARACTERISTIC_WRITTEN, this);
+}
+
+
+/**
+ * @function		_bt_gatt_client_read_request_completed_cb
+ * @since_tizen		2.3
+ * @description		 Bt Gatt Client Read Request Completed Cb
+ * @parameter		int: Int, void*: Void Pointer
+ * @return		static void
+ */
+static void _bt_gatt_client_read_request_completed_cb(int result, bt_gatt_h request_handle, void *user_data)
+{
+
+
+	DBG("_bt_gatt_client_read_request_completed_cb");
+//	RETM_IF(NULL == user_data, "data is NULL");
+	bluetoothle_view *this = NULL;
+	this = (bluetoothle_view*)user_data;
+//	RETM_IF(NULL == this,"view is NULL");
+	this->is_read_completed = true;
+	char* value;
+	int value_length;
+	result = bt_gatt_get_value(this->characterstic_h, &value, &value_length);
+//	RETM_IF(result != BT_ERROR_NONE, "bt_gatt_get_value failed --> error: %s", get_bluetooth_error(result));
+	DBG("value: %s, value_length: %d", value, value_length);
+
+	char* str;
+	str = format_string("value %s len %d", value, value_length);
+	elm_list_item_append(this->bluetoothle_list, str, NULL, NULL, NULL, NULL);
+	SAFE_DELETE(str);
+
+	DBG("read completed");
+//	set_control_btn_state(CHARACTERISTIC_READ, this);
 }
 
 
@@ -1759,6 +2792,90 @@ static void update_view_controls(bluetoothle_view *this)
 }
 
 
+/**
+ * @function		_devices_refresh_cb
+ * @since_tizen		2.3
+ * @description		 Devices Refresh Cb
+ * @parameter		void*: Void Pointer
+ * @return		static void
+ */
+static void _devices_refresh_cb(void *data)
+{
+	bluetoothle_view *this = NULL;
+	this = (bluetoothle_view*)data;
+	RETM_IF(NULL == this, "view is NULL");
+
+	update_view_controls(this);
+}
+
+
+/**
+ * @function		show_list
+ * @since_tizen		2.3
+ * @description		Show List
+ * @parameter		bluetoothle_view*: Bluetoothle View Pointer, Evas_Object*: Evas Object Pointer
+ * @return		static void
+ */
+static void show_list(bluetoothle_view *this, Evas_Object *list)
+{
+	RETM_IF(NULL == this, "view is NULL");
+
+	Evas_Object *shown = elm_object_part_content_get(this->view->layout, "bluetoothle_list");
+	if (shown == list)
+	{
+		return;
+	}
+
+	//Leaving the scan results, a refresh still pending must not bring them back
+	if (list != this->devices_genlist)
+	{
+		util_refresh_cancel(this->devices_refresh);
+	}
+
+	if (shown != NULL)
+	{
+		elm_object_part_content_unset(this->view->layout, "bluetoothle_list");
+		evas_object_hide(shown);
+	}
+	elm_object_part_content_set(this->view->layout, "bluetoothle_list", list);
+	evas_object_show(list);
+}
+
+
+/**
+ * @function		_device_text_get_cb
+ * @since_tizen		2.3
+ * @description		 Device Text Get Cb
+ * @parameter		void*: Void Pointer, Evas_Object*: Evas Object Pointer, const char*: Const char Pointer
+ * @return		static char*
+ */
+static char *_device_text_get_cb(void *data, Evas_Object *obj, const char *part)
+{
+	bt_adapter_le_device_scan_result_info_s *device_info;
+	device_info = (bt_adapter_le_device_scan_result_info_s*)data;
+	RETVM_IF(NULL == device_info, NULL, "device_info is NULL");
+
+	const char *name = NULL;
+	int name_len = 0;
+	char label[64];
+
+	if (strcmp(part, "elm.text") != 0)
+	{
+		return NULL;
+	}
+
+	//Read the name straight out of the payload instead of asking the stack for a copy
+	if (util_adv_get_local_name(device_info->adv_data, device_info->adv_data_len, &name, &name_len, NULL)
+		|| util_adv_get_local_name(device_info->scan_data, device_info->scan_data_len, &name, &name_len, NULL))
+	{
+		snprintf(label, sizeof(label), "%.*s", name_len, name);
+		return strdup(label);
+	}
+
+	return strdup(device_info->remote_address);
+}
+
+
 /**
  * @function		discovered_devices_list_show
  * @since_tizen		2.3
@@ -1771,38 +2888,30 @@ static void discovered_devices_list_show(bluetoothle_view *this)
 	DBG(" discovered_devices_list_show ");
 	RETM_IF(NULL == this, "view is NULL");
 
-	elm_list_clear(this->bluetoothle_list);
+	show_list(this, this->devices_genlist);
 
-	GList *l;
+	int i;
+	int count = util_scan_table_count(this->devices);
 	bt_adapter_le_device_scan_result_info_s *device_info;
 
-	for(l = this->devices_list; l != NULL; l = l->next)
+	//Devices already shown were updated in place, only their visible rows need redrawing
+	if (this->n_device_items > 0)
+	{
+		elm_genlist_realized_items_update(this->devices_genlist);
+	}
+
+	//The table keeps the order devices were found in, so new ones are simply appended
+	for(i = this->n_device_items; i < count; i++)
 	{
-		device_info = (bt_adapter_le_device_scan_result_info_s*)l->data;
+		device_info = (bt_adapter_le_device_scan_result_info_s*)util_scan_table_get(this->devices, i);
 
 		if(NULL != device_info)
 		{
-			char* name = NULL;
-			bt_adapter_le_get_scan_result_device_name(device_info, BT_ADAPTER_LE_PACKET_ADVERTISING, &name);
-
-			if(name != NULL)
-			{
-				elm_list_item_append(this->bluetoothle_list, name, NULL, NULL, _device_item_selected_cb, device_info);
-			}
-			else
-			{
-				bt_adapter_le_get_scan_result_device_name(device_info, BT_ADAPTER_LE_PACKET_SCAN_RESPONSE, &name);
-
-				if (name != NULL)
-					elm_list_item_append(this->bluetoothle_list, name, NULL, NULL, _device_item_selected_cb, device_info);
-				else
-					elm_list_item_append(this->bluetoothle_list, device_info->remote_address, NULL, NULL, _device_item_selected_cb, device_info);
-			}
+			elm_genlist_item_append(this->devices_genlist, this->device_itc, device_info, NULL,
+					ELM_GENLIST_ITEM_NONE, _device_item_selected_cb, device_info);
 		}
 	}
-
-	elm_list_go(this->bluetoothle_list);
-	evas_object_show(this->bluetoothle_list);
+	this->n_device_items = count;
 }
 
 
@@ -1833,17 +2942,23 @@ static void _device_item_selected_cb(void *data, Evas_Object *obj, void *event_i
 
 	Elm_Object_Item *item;
 	item = (Elm_Object_Item*)event_info;
-	elm_list_item_selected_set(item, EINA_TRUE);
+	elm_genlist_item_selected_set(item, EINA_TRUE);
 	this->selected_device_item = item;
 
 	result = bt_adapter_le_stop_scan();
 //	RETM_IF(result != BT_ERROR_NONE, "bt_adapter_le_stop_scan fail > Error = %d", result);
-
-	this->remote_addr = device_info->remote_address;
-	result = bt_gatt_connect(device_info->remote_address, false);
-	DBG("bt_gatt_connect %s", get_bluetooth_error(result));
-//	RETM_IF(result != BT_ERROR_NONE, "bt_gatt_connect failed --> error: %s", get_bluetooth_error(result));
-	elm_object_text_set(this->bluetoothle_label, "Device Connecting");
+	util_event_journal_add(this->journal, UTIL_EVENT_SCAN_STOP, UTIL_EVENT_NO_LINK, UTIL_EVENT_NO_HANDLE, 0, result);
+
+	//The link keeps its own copy of the address, the device list is freed when a new discovery starts
+	gatt_link_t *link = link_find_or_add(this, device_info->remote_address);
+	RETM_IF(NULL == link, "link_find_or_add failed");
+	if (link->client != NULL)
+	{
+		//Already connected, switching to it keeps the other links up
+		link_select(this, link);
+		return;
+	}
+	link_connect(this, link);
 }
 
 
@@ -1862,9 +2977,12 @@ static void _sevice_selected_cb(void *data, Evas_Object *obj, void *event_info)
 	bluetoothle_view *this;
 	this = evas_object_data_get(obj, "bluetooth_view");
 	elm_list_clear(this->bluetoothle_list);
+	show_list(this, this->bluetoothle_list);
 	bt_gatt_h service_h = (bt_gatt_h)data;
 	this->service_h = service_h;
 
+	elm_list_item_append(this->bluetoothle_list, "Read all characteristics", NULL, NULL, _read_service_item_cb, service_h);
+
 	DBG("gatt_handle type service");
 	result = bt_gatt_service_foreach_characteristics(service_h, _bt_gatt_foreach_characterstics_cb, this);
 }
@@ -1993,37 +3111,473 @@ static void _bt_gatt_connection_state_changed_cb(int result, bool connected, con
 
 	int ret;
 
-	if(connected)
+	if(this->view->tbt_info->apptype != TBT_APP_BLE_GATT_CLIENT)
 	{
-		elm_object_text_set(this->bluetoothle_label, "Device Connected");
-		elm_object_disabled_set(this->disconnect_btn, EINA_FALSE);
+		elm_object_text_set(this->bluetoothle_label, connected ? "Device Connected" : "Device Disconnected");
+		elm_object_disabled_set(this->disconnect_btn, connected ? EINA_FALSE : EINA_TRUE);
+		return;
+	}
 
+	//Every link gets its own state, the view follows the selected one
+	gatt_link_t *link = connected ? link_find_or_add(this, remote_address) : util_scan_table_find(this->links, remote_address);
+	RETM_IF(NULL == link, "no link for %s", remote_address);
+	link_journal_add(link, connected ? UTIL_EVENT_CONNECTED : UTIL_EVENT_DISCONNECTED, NULL, 0, result);
 
-		if(this->view->tbt_info->apptype == TBT_APP_BLE_GATT_CLIENT)
+	if(connected)
+	{
+		if (link->client == NULL)
 		{
-			elm_list_clear(this->bluetoothle_list);
-			ret = bt_gatt_client_create(remote_address, &this->client);
+			ret = bt_gatt_client_create(remote_address, &link->client);
 			RETM_IF(ret != BT_ERROR_NONE, "bt_gatt_client_create error: %s", get_bluetooth_error(ret));
+			link->connected_since = ecore_time_get();
+			load_attributes(link);
 
-			ret = bt_gatt_client_foreach_services(this->client, _bt_gatt_foreach_services_cb, this);
-			RETM_IF(ret != BT_ERROR_NONE, "bt_gatt_client_foreach_services error: %s", get_bluetooth_error(ret));
-			elm_object_disabled_set(this->services_btn, EINA_FALSE);
-
-			char* client_remote_address;
-			ret = bt_gatt_client_get_remote_address(this->client, &client_remote_address);
-			RETM_IF(ret != BT_ERROR_NONE, "bt_gatt_client_get_remote_address error: %s", get_bluetooth_error(ret));
-			DBG("client_remote_address: %s", client_remote_address);
+#ifdef TIZEN_3_0
+			//Records of a few hundred bytes then take one or two round trips instead of a dozen
+			ret = bt_gatt_client_request_att_mtu_change(link->client, UTIL_GATT_MAX_MTU);
+			if (ret != BT_ERROR_NONE)
+			{
+				DBG("bt_gatt_client_request_att_mtu_change error: %s", get_bluetooth_error(ret));
+			}
+#endif
 		}
 
+		//A link coming up by itself does not take the screen from a selected one
+		if (this->link == NULL || this->link->client == NULL || this->link == link || this->connecting == link)
+		{
+			this->connecting = NULL;
+			link_select(this, link);
+		}
 	}
 	else
 	{
-		elm_object_text_set(this->bluetoothle_label, "Device Disconnected");
-		elm_object_disabled_set(this->services_btn, EINA_TRUE);
-		elm_object_disabled_set(this->disconnect_btn, EINA_TRUE);
+		if (link == this->connecting)
+		{
+			this->connecting = NULL;
+		}
+		release_attributes(link);
+		if (link->client != NULL)
+		{
+			bt_gatt_client_destroy(link->client);
+			link->client = NULL;
+		}
+
+		//The stack drops the subscription with the connection
+		if (link == this->notify_link)
+		{
+			util_refresh_cancel(this->notify_refresh);
+			this->notify_h = NULL;
+			this->notify_link = NULL;
+		}
+
+		if (link == this->link)
+		{
+			elm_object_text_set(this->bluetoothle_label, "Device Disconnected");
+			elm_object_disabled_set(this->services_btn, EINA_TRUE);
+			elm_object_disabled_set(this->disconnect_btn, EINA_TRUE);
+			elm_object_disabled_set(this->read_all_btn, EINA_TRUE);
+			elm_object_disabled_set(this->write_back_btn, EINA_TRUE);
+		}
+	}
+
+}
+
+
+/**
+ * @function		_attribute_walk_descriptor_cb
+ * @since_tizen		2.3
+ * @description		 Attribute Walk Descriptor Cb
+ * @parameter		int: Int, int: Int, bt_gatt_h: Bt Gatt H, void*: Void Pointer
+ * @return		static bool
+ */
+static bool _attribute_walk_descriptor_cb(int total, int index, bt_gatt_h gatt_handle, void *user_data)
+{
+	attribute_walk_t *walk = (attribute_walk_t*)user_data;
+	char *uuid = NULL;
+
+	if (bt_gatt_get_uuid(gatt_handle, &uuid) == BT_ERROR_NONE)
+	{
+		util_gatt_arena_add(walk->arena, UTIL_GATT_ATTR_DESCRIPTOR, walk->parent, gatt_handle, uuid);
+		SAFE_DELETE(uuid);
+	}
+	return true;
+}
+
+
+/**
+ * @function		_attribute_walk_characteristic_cb
+ * @since_tizen		2.3
+ * @description		 Attribute Walk Characteristic Cb
+ * @parameter		int: Int, int: Int, bt_gatt_h: Bt Gatt H, void*: Void Pointer
+ * @return		static bool
+ */
+static bool _attribute_walk_characteristic_cb(int total, int index, bt_gatt_h gatt_handle, void *user_data)
+{
+	attribute_walk_t *walk = (attribute_walk_t*)user_data;
+	char *uuid = NULL;
+	int service = walk->parent;
+
+	if (bt_gatt_get_uuid(gatt_handle, &uuid) == BT_ERROR_NONE)
+	{
+		walk->parent = util_gatt_arena_add(walk->arena, UTIL_GATT_ATTR_CHARACTERISTIC, service, gatt_handle, uuid);
+		SAFE_DELETE(uuid);
+		if (walk->parent >= 0)
+		{
+			bt_gatt_characteristic_foreach_descriptors(gatt_handle, _attribute_walk_descriptor_cb, walk);
+		}
+		walk->parent = service;
+	}
+	return true;
+}
+
+
+/**
+ * @function		_attribute_walk_service_cb
+ * @since_tizen		2.3
+ * @description		 Attribute Walk Service Cb
+ * @parameter		int: Int, int: Int, bt_gatt_h: Bt Gatt H, void*: Void Pointer
+ * @return		static bool
+ */
+static bool _attribute_walk_service_cb(int total, int index, bt_gatt_h gatt_handle, void *user_data)
+{
+	attribute_walk_t *walk = (attribute_walk_t*)user_data;
+	char *uuid = NULL;
+	int parent = walk->parent;
+	int count = util_gatt_arena_count(walk->arena);
+
+	if (bt_gatt_get_uuid(gatt_handle, &uuid) == BT_ERROR_NONE)
+	{
+		walk->parent = util_gatt_arena_add(walk->arena, UTIL_GATT_ATTR_SERVICE, parent, gatt_handle, uuid);
+		SAFE_DELETE(uuid);
+		//A service included from several places is walked once
+		if (walk->parent >= 0 && util_gatt_arena_count(walk->arena) > count)
+		{
+			bt_gatt_service_foreach_included_services(gatt_handle, _attribute_walk_service_cb, walk);
+			bt_gatt_service_foreach_characteristics(gatt_handle, _attribute_walk_characteristic_cb, walk);
+		}
+		walk->parent = parent;
+	}
+	return true;
+}
+
+
+/**
+ * @function		update_att_mtu
+ * @since_tizen		2.3
+ * @description		Takes The MTU Negotiated With The Device Of A Link
+ * @parameter		gatt_link_t*: Link
+ * @return		static void
+ */
+static void update_att_mtu(gatt_link_t *link)
+{
+#ifdef TIZEN_3_0
+	unsigned int mtu = 0;
+	if (link->client != NULL && bt_gatt_client_get_att_mtu(link->client, &mtu) == BT_ERROR_NONE)
+	{
+		if ((int) mtu != util_gatt_transfer_get_mtu(link->transfers))
+		{
+			link_journal_add(link, UTIL_EVENT_MTU, NULL, mtu, BT_ERROR_NONE);
+		}
+		util_gatt_transfer_set_mtu(link->transfers, mtu);
+	}
+#endif
+}
+
+
+/**
+ * @function		load_attributes
+ * @since_tizen		2.3
+ * @description		Walks The Whole Database Of A Connected Device Into The Arena Of Its Link
+ * @parameter		gatt_link_t*: Link
+ * @return		static void
+ */
+static void load_attributes(gatt_link_t *link)
+{
+	RETM_IF(NULL == link, "link is NULL");
+
+	release_attributes(link);
+	link->attributes = util_gatt_arena_create(BT_LE_GATT_ARENA_CAPACITY);
+	RETM_IF(NULL == link->attributes, "util_gatt_arena_create failed");
+	link->formats = util_gatt_format_cache_create(BT_LE_GATT_ARENA_CAPACITY);
+	//A new connection starts at the default MTU until the exchange
+	util_gatt_transfer_set_mtu(link->transfers, UTIL_GATT_DEFAULT_MTU);
+
+	attribute_walk_t walk = { link->attributes, -1 };
+	int result = bt_gatt_client_foreach_services(link->client, _attribute_walk_service_cb, &walk);
+	RETM_IF(result != BT_ERROR_NONE, "bt_gatt_client_foreach_services error: %s", get_bluetooth_error(result));
+
+	util_gatt_arena_info(link->attributes);
+}
+
+
+/**
+ * @function		release_attributes
+ * @since_tizen		2.3
+ * @description		Frees The Attribute Database Of A Link In One Go
+ * @parameter		gatt_link_t*: Link
+ * @return		static void
+ */
+static void release_attributes(gatt_link_t *link)
+{
+	RETM_IF(NULL == link, "link is NULL");
+
+	//Read All results hold the same handles
+	util_read_queue_destroy(link->bulk_read);
+	link->bulk_read = NULL;
+	link->bulk_unseen = false;
+
+	util_gatt_format_cache_destroy(link->formats);
+	link->formats = NULL;
+	link->format_pending = NULL;
+	link->write_back_h = NULL;
+
+	util_gatt_arena_destroy(link->attributes);
+	link->attributes = NULL;
+}
+
+
+/**
+ * @function		link_free_cb
+ * @since_tizen		2.3
+ * @description		 Link Free Cb
+ * @parameter		void*: Void Pointer
+ * @return		static void
+ */
+static void link_free_cb(void *data)
+{
+	gatt_link_t *link = (gatt_link_t*)data;
+	if (link == NULL) return;
+
+	release_attributes(link);
+	if (link->client != NULL)
+	{
+		bt_gatt_client_destroy(link->client);
+	}
+	util_gatt_transfer_destroy(link->transfers);
+	SAFE_DELETE(link->address);
+	free(link);
+}
+
+
+/**
+ * @function		link_find_or_add
+ * @since_tizen		2.3
+ * @description		The Link Of An Address, Added Disconnected If It Is New
+ * @parameter		bluetoothle_view*: Bluetoothle View Pointer, const char*: Address
+ * @return		static gatt_link_t*
+ */
+static gatt_link_t *link_find_or_add(bluetoothle_view *this, const char *address)
+{
+	gatt_link_t *link = util_scan_table_find(this->links, address);
+	if (link != NULL)
+	{
+		return link;
+	}
+
+	link = calloc(1, sizeof(gatt_link_t));
+	RETVM_IF(!link, NULL, "calloc failed");
+	link->view = this;
+	link->address = strdup(address);
+	link->transfers = util_gatt_transfer_create(UTIL_GATT_DEFAULT_MTU);
+	link->journal_link = util_event_journal_address(this->journal, address);
+	if (link->address == NULL || link->transfers == NULL || !util_scan_table_insert(this->links, address, link))
+	{
+		link_free_cb(link);
+		return NULL;
+	}
+	return link;
+}
+
+
+/**
+ * @function		links_connected
+ * @since_tizen		2.3
+ * @description		Number Of Links With A Connected Client
+ * @parameter		bluetoothle_view*: Bluetoothle View Pointer
+ * @return		static int
+ */
+static int links_connected(bluetoothle_view *this)
+{
+	int n = 0;
+	int i;
+
+	for (i = 0; i < util_scan_table_count(this->links); i++)
+	{
+		gatt_link_t *link = util_scan_table_get(this->links, i);
+		if (link->client != NULL)
+		{
+			n++;
+		}
+	}
+	return n;
+}
+
+
+/**
+ * @function		link_connect
+ * @since_tizen		2.3
+ * @description		Connects The Device Of A Link Unless BT_LE_MAX_LINKS Are Up
+ * @parameter		bluetoothle_view*: Bluetoothle View Pointer, gatt_link_t*: Link
+ * @return		static void
+ */
+static void link_connect(bluetoothle_view *this, gatt_link_t *link)
+{
+	if (links_connected(this) >= BT_LE_MAX_LINKS)
+	{
+		char *str = format_string("At most %d devices can be connected", BT_LE_MAX_LINKS);
+		ui_utils_label_set_text(this->bluetoothle_label, str, "left");
+		SAFE_DELETE(str);
+		return;
+	}
+
+	int result = bt_gatt_connect(link->address, false);
+	DBG("bt_gatt_connect %s", get_bluetooth_error(result));
+	link_journal_add(link, UTIL_EVENT_CONNECT, NULL, 0, result);
+	if (result == BT_ERROR_NONE)
+	{
+		this->connecting = link;
+	}
+	elm_object_text_set(this->bluetoothle_label, "Device Connecting");
+}
+
+
+/**
+ * @function		link_select
+ * @since_tizen		2.3
+ * @description		Points The Buttons At A Link And Lists Its Services
+ * @parameter		bluetoothle_view*: Bluetoothle View Pointer, gatt_link_t*: Link
+ * @return		static void
+ */
+static void link_select(bluetoothle_view *this, gatt_link_t *link)
+{
+	this->link = link;
+	bool up = (link != NULL && link->client != NULL);
+
+	elm_object_disabled_set(this->services_btn, up ? EINA_FALSE : EINA_TRUE);
+	elm_object_disabled_set(this->disconnect_btn, up ? EINA_FALSE : EINA_TRUE);
+	elm_object_disabled_set(this->read_all_btn, up ? EINA_FALSE : EINA_TRUE);
+	elm_object_disabled_set(this->write_back_btn, (up && link->write_back_h != NULL) ? EINA_FALSE : EINA_TRUE);
+	RETM_IF(!up, "link is not connected");
+
+	if (link->bulk_unseen)
+	{
+		bulk_read_show(this, link);
+		return;
+	}
+
+	char *str = format_string("Connected to %s", link->address);
+	ui_utils_label_set_text(this->bluetoothle_label, str, "left");
+	SAFE_DELETE(str);
+
+	elm_list_clear(this->bluetoothle_list);
+	show_list(this, this->bluetoothle_list);
+	int ret = bt_gatt_client_foreach_services(link->client, _bt_gatt_foreach_services_cb, this);
+	RETM_IF(ret != BT_ERROR_NONE, "bt_gatt_client_foreach_services error: %s", get_bluetooth_error(ret));
+}
+
+
+/**
+ * @function		link_journal_add
+ * @since_tizen		2.3
+ * @description		Records An Event Of A Link, The Attribute Goes By Its Index In The Arena
+ * @parameter		gatt_link_t*: Link, util_event_type: Type, bt_gatt_h: Bt Gatt H, int: Length, int: Result
+ * @return		static void
+ */
+static void link_journal_add(gatt_link_t *link, util_event_type type, bt_gatt_h h, int len, int result)
+{
+	bluetoothle_view *this = link->view;
+	if (this->journal == NULL)
+	{
+		return;
+	}
+
+	int index = (h != NULL && link->attributes != NULL) ? util_gatt_arena_find_handle(link->attributes, h) : -1;
+	util_event_journal_add(this->journal, type, link->journal_link, index >= 0 ? index : UTIL_EVENT_NO_HANDLE, len, result);
+}
 
+
+/**
+ * @function		_link_item_selected_cb
+ * @since_tizen		2.3
+ * @description		 Link Item Selected Cb
+ * @parameter		void*: Void Pointer, Evas_Object*: Evas Object Pointer, void*: Void Pointer
+ * @return		static void
+ */
+static void _link_item_selected_cb(void *data, Evas_Object *obj, void *event_info)
+{
+	DBG("_link_item_selected_cb");
+	RETM_IF(NULL == obj, "obj is NULL");
+
+	bluetoothle_view *this;
+	this = evas_object_data_get(obj, "bluetooth_view");
+	elm_list_item_selected_set(event_info, EINA_FALSE);
+
+	gatt_link_t *link = (gatt_link_t*)data;
+	if (link->client == NULL)
+	{
+		//Reconnect a link that went down, the other links stay as they are
+		link_connect(this, link);
+		return;
 	}
+	link_select(this, link);
+}
+
+
+/**
+ * @function		_links_button_pressed_cb
+ * @since_tizen		2.3
+ * @description		 Links Button Pressed Cb
+ * @parameter		void*: Void Pointer, Evas_Object*: Evas Object Pointer, void*: Void Pointer
+ * @return		static void
+ */
+static void _links_button_pressed_cb(void *user_data, Evas_Object *obj, void *event_info)
+{
+	DBG("_links_button_pressed_cb");
+	RETM_IF(NULL == user_data, "data is NULL");
+
+	bluetoothle_view *this = NULL;
+	this = (bluetoothle_view*)user_data;
+
+	elm_list_clear(this->bluetoothle_list);
+	show_list(this, this->bluetoothle_list);
+
+	char *str = format_string("%d of %d links connected", links_connected(this), BT_LE_MAX_LINKS);
+	ui_utils_label_set_text(this->bluetoothle_label, str, "left");
+	SAFE_DELETE(str);
+
+	int i;
+	for (i = 0; i < util_scan_table_count(this->links); i++)
+	{
+		gatt_link_t *link = util_scan_table_get(this->links, i);
+		util_gatt_transfer_stats rd, wr;
+		util_gatt_transfer_get_stats(link->transfers, UTIL_GATT_TRANSFER_READ, &rd);
+		util_gatt_transfer_get_stats(link->transfers, UTIL_GATT_TRANSFER_WRITE, &wr);
+
+		unsigned long reads = rd.transfers - rd.failed;
+		unsigned long writes = wr.transfers - wr.failed;
+		unsigned long long bytes = rd.bytes + wr.bytes;
+		unsigned long long us = rd.us + wr.us;
+
+		//Read All latency is measured by its queue, the single reads and writes by the transfer counters
+		util_read_queue_stats bulk;
+		memset(&bulk, 0, sizeof(bulk));
+		if (link->bulk_read != NULL)
+		{
+			util_read_queue_get_stats(link->bulk_read, &bulk);
+		}
 
+		str = format_string("%s%s %s %.0fs, MTU %d | read %lu avg %.1f ms | write %lu avg %.1f ms | %.0f B/s | Read All %d avg %.1f ms",
+				link == this->link ? "* " : "", link->address,
+				link->client ? "up" : "down", link->client ? ecore_time_get() - link->connected_since : 0.0,
+				util_gatt_transfer_get_mtu(link->transfers),
+				reads, reads ? rd.us / 1000.0 / reads : 0.0,
+				writes, writes ? wr.us / 1000.0 / writes : 0.0,
+				us ? bytes * 1000000.0 / us : 0.0,
+				bulk.done, bulk.done ? bulk.latency_us / 1000.0 / bulk.done : 0.0);
+		elm_list_item_append(this->bluetoothle_list, str, NULL, NULL, _link_item_selected_cb, link);
+		SAFE_DELETE(str);
+	}
+	elm_list_go(this->bluetoothle_list);
 }
 
 
@@ -2042,17 +3596,92 @@ void _app_destroy_cb(void* this)
 
 	int result;
 
+	//Before anything can return early, the timer must not fire on a dead view
+	util_refresh_destroy(view->devices_refresh);
+	view->devices_refresh = NULL;
+	util_refresh_destroy(view->notify_refresh);
+	view->notify_refresh = NULL;
+	stream_stop(view);
+	util_pacer_destroy(view->stream_pacer);
+	view->stream_pacer = NULL;
+	util_advertiser_destroy(view->advertiser);
+	view->advertiser = NULL;
+	util_notify_ring_destroy(view->notifications);
+	view->notifications = NULL;
+	//Closed before the links go, their callbacks record nothing from here on
+	util_event_journal_destroy(view->journal);
+	view->journal = NULL;
+
+	//The rows may outlive the view with the layout, they must not write back into it
+	int i;
+	for (i = 0; i < BT_LE_NOTIFY_SHOWN; i++)
+	{
+		if (view->notify_items[i] != NULL)
+		{
+			elm_object_item_del_cb_set(view->notify_items[i], NULL);
+		}
+	}
+	if (view->notify_stats_item != NULL)
+	{
+		elm_object_item_del_cb_set(view->notify_stats_item, NULL);
+	}
 
 	if(view->view->tbt_info->apptype == TBT_APP_BLE_GATT_CLIENT)
 	{
 		bt_adapter_le_stop_scan();
-		result = bt_gatt_client_destroy(view->client);
-		RETM_IF(result != BT_ERROR_NONE, "bt_gatt_client_destroy error: %s", get_bluetooth_error(result));
-		result = bt_gatt_client_unset_characteristic_value_changed_cb(view->characterstic_h);
-		RETM_IF(result != BT_ERROR_NONE, "bt_gatt_client_unset_characteristic_value_changed_cb error: %s", get_bluetooth_error(result));
+		if (view->notify_h != NULL)
+		{
+			//Logged only, the teardown below must run whatever the stack says
+			result = bt_gatt_client_unset_characteristic_value_changed_cb(view->notify_h);
+			if (result != BT_ERROR_NONE)
+			{
+				ERR("bt_gatt_client_unset_characteristic_value_changed_cb error: %s", get_bluetooth_error(result));
+			}
+			view->notify_h = NULL;
+		}
 	}
+	//Every link destroys its own client
+	view->link = NULL;
+	util_scan_table_destroy(view->links);
+	view->links = NULL;
 	result = bt_gatt_unset_connection_state_changed_cb();
-	RETM_IF(result != BT_ERROR_NONE, "bt_gatt_unset_connection_state_changed_cb error: %s", get_bluetooth_error(result));
+	if (result != BT_ERROR_NONE)
+	{
+		ERR("bt_gatt_unset_connection_state_changed_cb error: %s", get_bluetooth_error(result));
+	}
+
+	util_scan_filter_destroy(view->scan_filter);
+	view->scan_filter = NULL;
+
+	if (view->beacon_timer != NULL)
+	{
+		ecore_timer_del(view->beacon_timer);
+		view->beacon_timer = NULL;
+	}
+	util_beacon_tracker_destroy(view->beacons);
+	view->beacons = NULL;
+
+	//Only the list in the layout goes down with it
+	Evas_Object *shown = elm_object_part_content_get(view->view->layout, "bluetoothle_list");
+	elm_genlist_clear(view->devices_genlist);
+	if (shown != view->devices_genlist)
+	{
+		evas_object_del(view->devices_genlist);
+	}
+	else
+	{
+		evas_object_del(view->bluetoothle_list);
+	}
+	view->devices_genlist = NULL;
+	if (view->device_itc != NULL)
+	{
+		elm_genlist_item_class_free(view->device_itc);
+		view->device_itc = NULL;
+	}
+
+	util_scan_table_info(view->devices);
+	util_scan_table_destroy(view->devices);
+	view->devices = NULL;
 
 	SAFE_DELETE(view->view);
 	SAFE_DELETE(view);
@@ -0,0 +1,105 @@
+#!/usr/bin/env python
+#
+# Copyright (c) 2014 Samsung Electronics Co., Ltd.
+#
+#  Licensed under the Apache License, Version 2.0 (the License);
+#  you may not use this file except in compliance with the License.
+#  You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+#  Unless required by applicable law or agreed to in writing, software
+#  distributed under the License is distributed on an "AS IS" BASIS,
+#  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#  See the License for the specific language governing permissions and
+#  limitations under the License.
+#
+# Prints a journal written by util_event_journal as a timeline.
+#
+#   sdb pull <TBT_LOGGING_DIR>/tbt-ble-journal.bin
+#   tbt_journal_decode.py tbt-ble-journal.bin [-a address]
+#
+# The record layout is util_event_record in inc/utils/util_event_journal.h.
+
+import datetime
+import struct
+import sys
+
+RECORD = struct.Struct('<QHHIIi')
+MAGIC = 0x4A544254
+VERSION = 1
+NO_LINK = 0xFFFF
+NO_HANDLE = 0xFFFFFFFF
+
+SESSION = 0
+ADDRESS = 1
+
+EVENTS = [
+	'SESSION', 'ADDRESS', 'SCAN_START', 'SCAN_STOP',
+	'CONNECT', 'CONNECTED', 'DISCONNECTED',
+	'READ', 'READ_DONE', 'WRITE', 'WRITE_DONE', 'NOTIFY',
+	'MTU', 'READ_ALL', 'READ_ALL_DONE', 'NOTIFY_SENT',
+]
+
+
+def records(data):
+	tail = len(data) % RECORD.size
+	if tail:
+		sys.stderr.write('ignoring %d trailing bytes\n' % tail)
+	for offset in range(0, len(data) - tail, RECORD.size):
+		yield RECORD.unpack_from(data, offset)
+
+
+def decode(path, only=None):
+	with open(path, 'rb') as f:
+		data = f.read()
+
+	addresses = {}
+	start_us = None
+	wall = None
+	last_us = None
+
+	for time_us, kind, link, handle, length, result in records(data):
+		if kind == SESSION:
+			if result != MAGIC or link != VERSION:
+				sys.stderr.write('not a version %d journal session, stopping\n' % VERSION)
+				return
+			# Indexes and the monotonic clock start over with each session
+			addresses = {}
+			start_us = last_us = time_us
+			wall = datetime.datetime.fromtimestamp(handle + length / 1e6)
+			print('== session %s' % wall.strftime('%Y-%m-%d %H:%M:%S.%f'))
+			continue
+
+		if start_us is None:
+			sys.stderr.write('record before any session, stopping\n')
+			return
+
+		if kind == ADDRESS:
+			raw = struct.pack('>IH', handle, length & 0xFFFF)
+			addresses[link] = ':'.join('%02X' % b for b in bytearray(raw))
+			continue
+
+		address = addresses.get(link, '-') if link != NO_LINK else '-'
+		if only and address.upper() != only.upper():
+			continue
+
+		at = wall + datetime.timedelta(microseconds=time_us - start_us)
+		name = EVENTS[kind] if kind < len(EVENTS) else 'TYPE_%d' % kind
+		attribute = '-' if handle == NO_HANDLE else str(handle)
+		print('%s %+10.3f ms  %-13s %-17s attr %-5s len %-6d result %d' % (
+				at.strftime('%H:%M:%S.%f'), (time_us - last_us) / 1000.0,
+				name, address, attribute, length, result))
+		last_us = time_us
+
+
+def main(argv):
+	if len(argv) not in (2, 4) or (len(argv) == 4 and argv[2] != '-a'):
+		sys.stderr.write('usage: %s journal.bin [-a address]\n' % argv[0])
+		return 2
+	decode(argv[1], argv[3] if len(argv) == 4 else None)
+	return 0
+
+
+if __name__ == '__main__':
+	sys.exit(main(sys.argv))